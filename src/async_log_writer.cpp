@@ -0,0 +1,221 @@
+/**
+ * @file async_log_writer.cpp
+ * @brief Ring-buffered log writer implementation
+ */
+
+#include "async_log_writer.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <chrono>
+
+struct AsyncLogWriter::Record {
+    std::atomic<quint64> sequence{0};
+    qint64 timestamp = 0;
+    const char *level = nullptr;    // nullptr for raw text in message
+    QString component;
+    QString message;
+    QString details;
+};
+
+AsyncLogWriter::AsyncLogWriter(const QString &filePath, const Options &options)
+    : m_filePath(filePath)
+    , m_options(options)
+    , m_file(filePath)
+{
+    quint64 capacity = 2;
+    while (capacity < static_cast<quint64>(qMax(options.capacity, 2))) {
+        capacity <<= 1;
+    }
+    m_records.reset(new Record[capacity]);
+    m_mask = capacity - 1;
+    for (quint64 i = 0; i < capacity; ++i) {
+        m_records[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_open = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    if (m_open) {
+        m_thread = std::thread(&AsyncLogWriter::run, this);
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopping.store(true);
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+    m_file.close();
+}
+
+bool AsyncLogWriter::append(const char *level, const QString &component, const QString &message,
+                            const QString &details)
+{
+    return enqueue(QDateTime::currentMSecsSinceEpoch(), level, component, message, details);
+}
+
+bool AsyncLogWriter::appendRaw(const QString &text)
+{
+    return enqueue(0, nullptr, QString(), text, QString());
+}
+
+bool AsyncLogWriter::enqueue(qint64 timestamp, const char *level, const QString &component,
+                             const QString &message, const QString &details)
+{
+    if (!m_open) {
+        return false;
+    }
+
+    // A slot is free for position p when its sequence equals p; claim it by
+    // advancing the write position, fill it, then publish with p + 1
+    quint64 position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Record *record;
+    for (;;) {
+        record = &m_records[position & m_mask];
+        quint64 sequence = record->sequence.load(std::memory_order_acquire);
+        qint64 difference = static_cast<qint64>(sequence - position);
+        if (difference == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->timestamp = timestamp;
+    record->level = level;
+    record->component = component;
+    record->message = message;
+    record->details = details;
+    record->sequence.store(position + 1, std::memory_order_release);
+
+    // Wake the writer early only under pressure; otherwise it polls. Producers
+    // racing past the half-way mark all see >=, and the flag lets only the
+    // first of them notify until the writer drains again.
+    quint64 queued = position + 1 - m_dequeuePosition.load(std::memory_order_relaxed);
+    if (queued >= (m_mask + 1) / 2 && !m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        // Taking the mutex orders the notify after the writer's predicate check
+        { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+bool AsyncLogWriter::flush(int timeoutMs)
+{
+    std::unique_lock<std::timed_mutex> lock(m_drainMutex, std::defer_lock);
+    if (!lock.try_lock_for(std::chrono::milliseconds(timeoutMs))) {
+        return false;
+    }
+    drainLocked();
+    return true;
+}
+
+void AsyncLogWriter::run()
+{
+    while (!m_stopping.load()) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_options.flushIntervalMs), [this] {
+                return m_stopping.load() ||
+                       m_enqueuePosition.load() - m_dequeuePosition.load() >= (m_mask + 1) / 2;
+            });
+        }
+        std::lock_guard<std::timed_mutex> lock(m_drainMutex);
+        drainLocked();
+    }
+    std::lock_guard<std::timed_mutex> lock(m_drainMutex);
+    drainLocked();
+}
+
+void AsyncLogWriter::drainLocked()
+{
+    // Cleared before reading, so producers that fill the ring during this
+    // pass wake the writer for the next one
+    m_wakePending.store(false, std::memory_order_release);
+
+    QByteArray batch;
+    quint64 position = m_dequeuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Record &record = m_records[position & m_mask];
+        if (record.sequence.load(std::memory_order_acquire) != position + 1) {
+            break;  // Empty, or claimed but not yet published
+        }
+
+        if (!record.level) {
+            batch.append(record.message.toUtf8()).append('\n');
+        } else {
+            qint64 second = record.timestamp / 1000;
+            if (second != m_lastSecond) {
+                m_lastSecond = second;
+                m_lastTimestamp = QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("yyyy-MM-dd HH:mm:ss").toUtf8();
+            }
+            batch.append('[').append(m_lastTimestamp).append("] [").append(record.level).append("] [")
+                 .append(record.component.toUtf8()).append("] ").append(record.message.toUtf8());
+            if (!record.details.isEmpty()) {
+                batch.append("\n  Details: ").append(record.details.toUtf8());
+            }
+            batch.append('\n');
+        }
+
+        // Release the strings here rather than when the slot is reused
+        record.component = QString();
+        record.message = QString();
+        record.details = QString();
+        record.sequence.store(position + m_mask + 1, std::memory_order_release);
+        ++position;
+    }
+    m_dequeuePosition.store(position, std::memory_order_relaxed);
+
+    quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        batch.append(QString("[%1 log messages dropped, buffer full]\n").arg(dropped - m_reportedDropped).toUtf8());
+        m_reportedDropped = dropped;
+    }
+
+    if (batch.isEmpty()) {
+        return;
+    }
+    rotateIfNeeded(batch.size());
+    m_file.write(batch);
+    m_file.flush();
+}
+
+void AsyncLogWriter::rotateIfNeeded(qint64 incomingBytes)
+{
+    if (m_options.maxFileSize <= 0 || m_file.size() == 0 || m_file.size() + incomingBytes <= m_options.maxFileSize) {
+        return;
+    }
+
+    m_file.close();
+    if (m_options.maxFiles <= 1) {
+        QFile::remove(m_filePath);
+    } else {
+        QFile::remove(rotatedPath(m_options.maxFiles - 1));
+        for (int index = m_options.maxFiles - 2; index >= 0; --index) {
+            QFile::rename(rotatedPath(index), rotatedPath(index + 1));
+        }
+    }
+    m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+QString AsyncLogWriter::rotatedPath(int index) const
+{
+    if (index == 0) {
+        return m_filePath;
+    }
+    QFileInfo info(m_filePath);
+    QString name = info.completeBaseName() + '.' + QString::number(index);
+    if (!info.suffix().isEmpty()) {
+        name += '.' + info.suffix();
+    }
+    return info.dir().filePath(name);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file async_log_writer.h
+ * @brief Log file writer fed through a lock-free ring buffer
+ *
+ * Producers only copy the record into a slot of a bounded multi-producer
+ * ring (the sequence-numbered design by D. Vyukov): one CAS on the write
+ * position, no locks, no formatting and no I/O. The QStrings are implicitly
+ * shared, so copying them is a reference count increment.
+ *
+ * A background thread wakes periodically, or early when the ring is half
+ * full, formats everything queued since the last pass into one buffer and
+ * writes it with a single write() and flush(). When the file would grow past
+ * the size limit it is rotated to <name>.1.<suffix>, <name>.2.<suffix>, ...
+ * keeping at most maxFiles files.
+ *
+ * When the ring is full new records are dropped and counted rather than
+ * blocking the caller; the count is logged with the next batch.
+ */
+
+#ifndef ASYNC_LOG_WRITER_H
+#define ASYNC_LOG_WRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class AsyncLogWriter
+{
+public:
+    struct Options {
+        qint64 maxFileSize = 10 * 1024 * 1024;  ///< 0 disables rotation
+        int maxFiles = 5;                       ///< Current file included
+        int capacity = 8192;                    ///< Ring slots, rounded up to a power of two
+        int flushIntervalMs = 200;
+    };
+
+    /**
+     * @brief Opens (appending to) the log file and starts the writer thread
+     */
+    explicit AsyncLogWriter(const QString &filePath, const Options &options = Options());
+
+    /**
+     * @brief Stops the writer thread after writing everything still queued
+     */
+    ~AsyncLogWriter();
+
+    bool isOpen() const { return m_open; }
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Queues one "[time] [level] [component] message" record
+     * @param level Must point to a string literal; it is formatted later
+     * @return false if the ring was full and the record was dropped
+     */
+    bool append(const char *level, const QString &component, const QString &message,
+                const QString &details = QString());
+
+    /**
+     * @brief Queues text that is written as-is, e.g. a banner
+     */
+    bool appendRaw(const QString &text);
+
+    /**
+     * @brief Writes everything queued so far on the calling thread
+     * @param timeoutMs How long to wait for a batch the writer thread is
+     *        writing. Crash handlers pass a short timeout so a writer that
+     *        was interrupted mid-batch cannot block them for good.
+     * @return false if the timeout expired
+     */
+    bool flush(int timeoutMs = 1000);
+
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record;
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    bool enqueue(qint64 timestamp, const char *level, const QString &component,
+                 const QString &message, const QString &details);
+    void run();
+    void drainLocked();
+    void rotateIfNeeded(qint64 incomingBytes);
+    QString rotatedPath(int index) const;
+
+    QString m_filePath;
+    Options m_options;
+    QFile m_file;
+    bool m_open = false;
+
+    std::unique_ptr<Record[]> m_records;
+    quint64 m_mask = 0;
+    alignas(64) std::atomic<quint64> m_enqueuePosition{0};
+    alignas(64) std::atomic<quint64> m_dequeuePosition{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<bool> m_wakePending{false};   // An early wake was sent and not yet drained
+    quint64 m_reportedDropped = 0;
+
+    std::timed_mutex m_drainMutex;          // One consumer at a time: the thread or flush()
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+
+    qint64 m_lastSecond = -1;               // Timestamp formatting cache, writer side only
+    QByteArray m_lastTimestamp;
+};
+
+#endif // ASYNC_LOG_WRITER_H
@@ -1,4 +1,6 @@
 #include "crash_handler.h"
+#include "async_log_writer.h"
+#include "security_config_manager.h"
 #include "version.h"
 
 #include <QCoreApplication>
@@ -8,7 +10,8 @@
 #include <QSysInfo>
 #include <QApplication>
 #include <QWidget>
-#include <QStringConverter>
+#include <QFile>
+#include <QTextStream>
 
 // Forward declare Windows types to avoid conflicts with pe_structures.h
 #ifdef Q_OS_WIN
@@ -26,8 +29,7 @@ CrashHandler* CrashHandler::s_instance = nullptr;
 #endif
 
 CrashHandler::CrashHandler()
-    : m_logFile(nullptr)
-    , m_logStream(nullptr)
+    : m_logWriter(nullptr)
     , m_loggingEnabled(false)
 {
 #ifdef Q_OS_WIN
@@ -37,13 +39,11 @@ CrashHandler::CrashHandler()
 
 CrashHandler::~CrashHandler()
 {
-    if (m_loggingEnabled && m_logFile && m_logStream) {
+    if (m_loggingEnabled && m_logWriter) {
         logInfo("CrashHandler", "Crash handler shutting down");
-        m_logStream->flush();
-        m_logFile->close();
-        delete m_logStream;
-        delete m_logFile;
     }
+    // Writes whatever is still queued before the thread exits
+    delete m_logWriter;
 }
 
 CrashHandler& CrashHandler::getInstance()
@@ -71,28 +71,33 @@ void CrashHandler::initialize()
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
     m_logFilePath = logsDir + "/pehint_crash_" + timestamp + ".log";
     
-    m_logFile = new QFile(m_logFilePath);
-    if (m_logFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        m_logStream = new QTextStream(m_logFile);
-        // Use Qt6 compatible encoding setting
-        m_logStream->setEncoding(QStringConverter::Utf8);
-        
-        // Write header directly to avoid recursion
-        *m_logStream << "=== PEHint Crash Handler Started ===" << Qt::endl;
-        *m_logStream << "Timestamp: " << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") << Qt::endl;
-        *m_logStream << "Version: " << PEHINT_VERSION_MAJOR << "." << PEHINT_VERSION_MINOR << "." << PEHINT_VERSION_PATCH << Qt::endl;
-        *m_logStream << "OS: " << QSysInfo::prettyProductName() << Qt::endl;
-        *m_logStream << "Architecture: " << QSysInfo::currentCpuArchitecture() << Qt::endl;
-        *m_logStream << "Working Directory: " << QDir::currentPath() << Qt::endl;
-        *m_logStream << "Application Path: " << QCoreApplication::applicationFilePath() << Qt::endl;
-        *m_logStream << "=====================================" << Qt::endl;
-        m_logStream->flush();
+    // Rotation limits come from the [Logging] group of security_config.ini
+    AsyncLogWriter::Options options;
+    {
+        SecurityConfigManager config;
+        options.maxFileSize = config.getValue("Logging/max_log_file_size_mb", 10).toLongLong() * 1024 * 1024;
+        options.maxFiles = config.getValue("Logging/max_log_files", 5).toInt();
+    }
+    
+    m_logWriter = new AsyncLogWriter(m_logFilePath, options);
+    if (m_logWriter->isOpen()) {
+        // Session banner, queued ahead of the first timestamped record
+        QTextStream header;
+        QString banner;
+        header.setString(&banner);
+        header << "=== PEHint Crash Handler Started ===" << '\n';
+        header << "Timestamp: " << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") << '\n';
+        header << "Version: " << PEHINT_VERSION_MAJOR << "." << PEHINT_VERSION_MINOR << "." << PEHINT_VERSION_PATCH << '\n';
+        header << "OS: " << QSysInfo::prettyProductName() << '\n';
+        header << "Architecture: " << QSysInfo::currentCpuArchitecture() << '\n';
+        header << "Working Directory: " << QDir::currentPath() << '\n';
+        header << "Application Path: " << QCoreApplication::applicationFilePath() << '\n';
+        header << "=====================================";
+        header.flush();
+        m_logWriter->appendRaw(banner);
         
-        // Write initialization messages directly to avoid recursion
-        QString timestamp2 = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-        *m_logStream << QString("[%1] [INFO] [CrashHandler] Crash handling system initialized successfully").arg(timestamp2) << Qt::endl;
-        *m_logStream << QString("[%1] [INFO] [CrashHandler] Log file: %2").arg(timestamp2, m_logFilePath) << Qt::endl;
-        m_logStream->flush();
+        writeToLog("INFO", "CrashHandler", "Crash handling system initialized successfully");
+        writeToLog("INFO", "CrashHandler", QString("Log file: %1").arg(m_logFilePath));
         
         // Also output to console for immediate visibility
         qDebug() << "Crash handling system initialized successfully";
@@ -152,11 +157,7 @@ void CrashHandler::setupWindowsCrashHandling()
         throw std::runtime_error(crashType.toStdString());
     });
     
-    if (m_loggingEnabled) {
-        QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-        *m_logStream << QString("[%1] [INFO] [CrashHandler] Windows crash handling initialized").arg(timestamp) << Qt::endl;
-        m_logStream->flush();
-    }
+    writeToLog("INFO", "CrashHandler", "Windows crash handling initialized");
 #endif
 }
 
@@ -165,10 +166,9 @@ void CrashHandler::setupQtCrashHandling()
     // Setup Qt signal handlers for application termination
     if (qApp) {
         connect(qApp, &QApplication::aboutToQuit, this, [this]() {
-            if (m_loggingEnabled) {
-                QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-                *m_logStream << QString("[%1] [INFO] [CrashHandler] Application about to quit").arg(timestamp) << Qt::endl;
-                m_logStream->flush();
+            writeToLog("INFO", "CrashHandler", "Application about to quit");
+            if (m_logWriter) {
+                m_logWriter->flush();
             }
         });
         
@@ -185,20 +185,14 @@ void CrashHandler::setupQtCrashHandling()
                 default: stateStr = "Unknown state"; break;
             }
             
-            QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-            *m_logStream << QString("[%1] [INFO] [CrashHandler] %2").arg(timestamp, stateStr) << Qt::endl;
-            m_logStream->flush();
+            writeToLog("INFO", "CrashHandler", stateStr);
         });
     }
     
     // Handle Qt fatal errors
     qInstallMessageHandler(qtMessageHandler);
     
-    if (m_loggingEnabled) {
-        QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-        *m_logStream << QString("[%1] [INFO] [CrashHandler] Qt crash handling initialized").arg(timestamp) << Qt::endl;
-        m_logStream->flush();
-    }
+    writeToLog("INFO", "CrashHandler", "Qt crash handling initialized");
 }
 
 void CrashHandler::qtMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -290,15 +284,11 @@ void CrashHandler::logCrashInfo(const QString &crashType, const QString &details
 {
     QString crashMessage = QString("CRASH DETECTED: %1").arg(crashType);
     
-    // Write to log file immediately
-    if (m_loggingEnabled && m_logFile && m_logStream) {
-        QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-        QString logEntry = QString("[%1] [CRASH] [%2] %3\n  Details: %4")
-                          .arg(timestamp, "CrashHandler", crashMessage, details);
-        
-        *m_logStream << logEntry << Qt::endl;
-        m_logStream->flush();
-        m_logFile->flush();
+    // Write the buffered tail and the crash record before anything else can fail.
+    // The timeout keeps a writer thread stopped mid-batch from hanging the handler.
+    if (m_loggingEnabled && m_logWriter) {
+        m_logWriter->append("CRASH", "CrashHandler", crashMessage, details);
+        m_logWriter->flush(500);
     }
     
     // Also write to a separate crash log file
@@ -376,7 +366,7 @@ void CrashHandler::createCrashDump(const QString &crashType, const QString &deta
 
 void CrashHandler::logError(const QString &component, const QString &message, const QString &details)
 {
-    if (!m_loggingEnabled || !m_logFile || !m_logStream) {
+    if (!m_loggingEnabled || !m_logWriter) {
         return;
     }
     
@@ -389,7 +379,7 @@ void CrashHandler::logError(const QString &component, const QString &message, co
 
 void CrashHandler::logWarning(const QString &component, const QString &message, const QString &details)
 {
-    if (!m_loggingEnabled || !m_logFile || !m_logStream) {
+    if (!m_loggingEnabled || !m_logWriter) {
         return;
     }
     
@@ -402,22 +392,14 @@ void CrashHandler::logWarning(const QString &component, const QString &message,
 
 void CrashHandler::logInfo(const QString &component, const QString &message)
 {
-    if (!m_loggingEnabled || !m_logFile || !m_logStream) {
-        return;
-    }
-    
     writeToLog("INFO", component, message);
-    qDebug() << "[INFO]" << component << ":" << message;
 }
 
+// Info and debug records go to the log file only. They used to be echoed
+// through qDebug, which the message handler fed back into the log.
 void CrashHandler::logDebug(const QString &component, const QString &message)
 {
-    if (!m_loggingEnabled || !m_logFile || !m_logStream) {
-        return;
-    }
-    
     writeToLog("DEBUG", component, message);
-    qDebug() << "[DEBUG]" << component << ":" << message;
 }
 
 QString CrashHandler::getLogFilePath() const
@@ -425,20 +407,11 @@ QString CrashHandler::getLogFilePath() const
     return m_logFilePath;
 }
 
-void CrashHandler::writeToLog(const QString &level, const QString &component, const QString &message, const QString &details)
+void CrashHandler::writeToLog(const char *level, const QString &component, const QString &message, const QString &details)
 {
-    if (!m_loggingEnabled || !m_logFile || !m_logStream) {
+    if (!m_loggingEnabled || !m_logWriter) {
         return;
     }
     
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-    QString logEntry = QString("[%1] [%2] [%3] %4")
-                      .arg(timestamp, level, component, message);
-    
-    if (!details.isEmpty()) {
-        logEntry += QString("\n  Details: %1").arg(details);
-    }
-    
-    *m_logStream << logEntry << Qt::endl;
-    m_logStream->flush();
+    m_logWriter->append(level, component, message, details);
 }
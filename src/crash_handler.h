@@ -3,8 +3,6 @@
 
 #include <QObject>
 #include <QString>
-#include <QFile>
-#include <QTextStream>
 
 // Forward declarations for Windows types to avoid conflicts
 #ifdef Q_OS_WIN
@@ -15,6 +13,8 @@ typedef long LONG;
 #define WINAPI __stdcall
 #endif
 
+class AsyncLogWriter;
+
 class CrashHandler : public QObject
 {
     Q_OBJECT
@@ -51,8 +51,8 @@ private:
     // Setup Qt crash handling
     void setupQtCrashHandling();
     
-    // Write to log file
-    void writeToLog(const QString &level, const QString &component, const QString &message, const QString &details = "");
+    // Queue a record for the log writer thread; never blocks or touches the file
+    void writeToLog(const char *level, const QString &component, const QString &message, const QString &details = "");
     
     // Create crash dump file
     void createCrashDump(const QString &crashType, const QString &details);
@@ -64,8 +64,7 @@ private:
     static void qtMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
 
 private:
-    QFile *m_logFile;
-    QTextStream *m_logStream;
+    AsyncLogWriter *m_logWriter;
     QString m_logFilePath;
     bool m_loggingEnabled;
     
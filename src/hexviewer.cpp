@@ -1,5 +1,6 @@
 #include "hexviewer.h"
 #include "language_manager.h"
+#include "pe_utils.h"
 #include <QTextCursor>
 #include <QTextCharFormat>
 #include <QScrollBar>
@@ -741,28 +742,15 @@ QByteArray HexViewer::parseHexPattern(const QString &pattern)
 QList<HexViewer::SearchResult> HexViewer::findPatternInData(const QByteArray &pattern, bool caseSensitive)
 {
     QList<SearchResult> results;
-    if (pattern.isEmpty() || m_data.isEmpty()) return results;
+    const QList<qint64> offsets = PEUtils::findPattern(m_data, pattern, caseSensitive);
+    results.reserve(offsets.size());
     
-    QByteArray searchData = m_data;
-    QByteArray searchPattern = pattern;
-    
-    if (!caseSensitive) {
-        searchData = searchData.toLower();
-        searchPattern = searchPattern.toLower();
-    }
-    
-    int offset = 0;
-    while (true) {
-        int index = searchData.indexOf(searchPattern, offset);
-        if (index == -1) break;
-        
+    for (qint64 offset : offsets) {
         SearchResult result;
-        result.offset = index;
+        result.offset = offset;
         result.length = pattern.size();
         result.pattern = pattern;
         results.append(result);
-        
-        offset = index + 1; // Continue searching from next position
     }
     
     return results;
@@ -230,30 +230,15 @@ QStringList LanguageManager::getAvailableLanguages() const
 QString LanguageManager::getString(const QString &key, const QString &defaultValue) const
 {
     if (!m_initialized) {
-        qDebug() << "LanguageManager not initialized, returning:" << (defaultValue.isEmpty() ? key : defaultValue);
         return defaultValue.isEmpty() ? key : defaultValue;
     }
     
-    // Try to get from configuration first
-    QString value = m_strings.value(key, "");
+    // UI strings are stored both with and without the "UI/" prefix, so one lookup covers both
+    QString value = m_strings.value(key);
     if (!value.isEmpty()) {
-        qDebug() << "Found string for key" << key << ":" << value;
         return value;
     }
     
-    // If key starts with "UI/", try without the prefix
-    QString alternativeKey = key;
-    if (key.startsWith("UI/")) {
-        alternativeKey = key.mid(3); // Remove "UI/" prefix
-        value = m_strings.value(alternativeKey, "");
-        if (!value.isEmpty()) {
-            qDebug() << "Found string for alternative key" << alternativeKey << ":" << value;
-            return value;
-        }
-    }
-    
-    qDebug() << "String not found for key:" << key << "in" << m_strings.keys();
-    
     // Fallback to Qt's translation system
     QString qtTranslation = QCoreApplication::translate("PEHint", key.toUtf8().constData());
     if (!qtTranslation.isEmpty() && qtTranslation != key) {
@@ -276,6 +261,38 @@ QString LanguageManager::getString(const QString &key, const QString &paramName,
     return getString(key, params, defaultValue);
 }
 
+int LanguageManager::stringId(const QString &key) const
+{
+    return m_stringIds.value(key, -1);
+}
+
+QString LanguageManager::string(int id, const char *key) const
+{
+    if (id >= 0 && id < m_catalog.size() && !m_catalog[id].isEmpty()) {
+        return m_catalog[id];
+    }
+    return QString::fromLatin1(key);
+}
+
+QString LanguageManager::string(int id, const char *key, const QString &paramName, const QString &paramValue) const
+{
+    QString text = string(id, key);
+    text.replace(QLatin1Char('{') + paramName + QLatin1Char('}'), paramValue);
+    return text;
+}
+
+int LanguageManager::CachedStringId::get() const
+{
+    int id = m_id.load(std::memory_order_relaxed);
+    if (id < 0) {
+        id = LanguageManager::getInstance().stringId(QLatin1String(m_key));
+        if (id >= 0) {
+            m_id.store(id, std::memory_order_relaxed);
+        }
+    }
+    return id;
+}
+
 bool LanguageManager::hasString(const QString &key) const
 {
     if (!m_initialized) {
@@ -432,6 +449,8 @@ bool LanguageManager::loadLanguageConfiguration()
     
     qDebug() << "Total loaded strings:" << m_strings.size();
     
+    rebuildCatalog();
+    
     // Debug: Print some loaded strings
     qDebug() << "Sample loaded strings:";
     int count = 0;
@@ -443,6 +462,25 @@ bool LanguageManager::loadLanguageConfiguration()
     return m_strings.size() > 0;
 }
 
+void LanguageManager::rebuildCatalog()
+{
+    // The first file loaded is the default language, which defines every key
+    if (m_stringIds.isEmpty()) {
+        m_catalogKeys = m_strings.keys();
+        m_stringIds.reserve(m_catalogKeys.size());
+        for (int id = 0; id < m_catalogKeys.size(); ++id) {
+            m_stringIds.insert(m_catalogKeys[id], id);
+        }
+    }
+    
+    // Keys missing from another language leave an empty slot, which LANG turns back into the key
+    QVector<QString> catalog(m_catalogKeys.size());
+    for (int id = 0; id < m_catalogKeys.size(); ++id) {
+        catalog[id] = m_strings.value(m_catalogKeys[id]);
+    }
+    m_catalog.swap(catalog);
+}
+
 QString LanguageManager::substituteParameters(const QString &text, const QMap<QString, QString> &params) const
 {
     QString result = text;
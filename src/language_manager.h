@@ -4,9 +4,12 @@
 #include <QObject>
 #include <QString>
 #include <QMap>
+#include <QHash>
 #include <QSettings>
 #include <QTranslator>
 #include <QLocale>
+#include <QVector>
+#include <atomic>
 
 /**
  * @file language_manager.h
@@ -31,6 +34,7 @@
  * - Support for Qt's built-in translation system (.ts files)
  * - Configuration-based string management
  * - Template string support with parameter substitution
+ * - Flat string catalog for the LANG macros (see stringId())
  */
 
 class LanguageManager : public QObject
@@ -102,6 +106,46 @@ public:
      */
     QString getString(const QString &key, const QString &paramName, const QString &paramValue, const QString &defaultValue = "") const;
 
+    /**
+     * @brief Catalog slot of a string key
+     * @param key Key as written in LANG(), e.g. "UI/resource_id"
+     * @return Slot index, or -1 if the key is not in the default language file
+     * 
+     * Slots are assigned once, when the default language file is first
+     * loaded, and stay valid across language switches. The LANG macros
+     * resolve their key here once per call site and afterwards only index
+     * the catalog, without hashing, map lookups or logging.
+     */
+    int stringId(const QString &key) const;
+
+    /**
+     * @brief Catalog string for a slot from stringId()
+     * @param id Slot index; negative if the key was not found
+     * @param key Returned as-is when the slot has no string in this language
+     */
+    QString string(int id, const char *key) const;
+
+    /**
+     * @brief Catalog string with one {paramName} placeholder substituted
+     */
+    QString string(int id, const char *key, const QString &paramName, const QString &paramValue) const;
+
+    /**
+     * @brief Per-call-site cache of a catalog slot, used by LANG_ID
+     * 
+     * Misses are not cached, since a call site may run before initialize().
+     */
+    class CachedStringId
+    {
+    public:
+        explicit CachedStringId(const char *key) : m_key(key) {}
+        int get() const;
+
+    private:
+        const char *m_key;
+        mutable std::atomic<int> m_id{-1};
+    };
+
     /**
      * @brief Check if a string key exists
      * @param key String key to check
@@ -169,6 +213,11 @@ private:
      */
     bool loadLanguageConfiguration();
 
+    /**
+     * @brief Fills the catalog from m_strings, assigning slots on the first load
+     */
+    void rebuildCatalog();
+
     /**
      * @brief Substitute parameters in a string
      * @param text Text with parameters
@@ -204,15 +253,20 @@ private:
     QStringList m_availableLanguages;
     QMap<QString, QString> m_strings;
     QMap<QString, QString> m_languageNames;
+    QHash<QString, int> m_stringIds;      ///< Key to catalog slot; fixed after the first load
+    QStringList m_catalogKeys;            ///< Slot to key
+    QVector<QString> m_catalog;           ///< Slot to string in the current language
     QSettings *m_settings;
     QTranslator *m_qtTranslator;
     QTranslator *m_appTranslator;
     bool m_initialized;
 };
 
-// Convenience macro for getting strings
-#define LANG(key) LanguageManager::getInstance().getString(key)
-#define LANG_PARAM(key, paramName, paramValue) LanguageManager::getInstance().getString(key, paramName, paramValue)
+// Convenience macros for getting strings. LANG and LANG_PARAM take literal
+// keys and resolve them to a catalog slot once per call site.
+#define LANG_ID(key) ([]() { static const LanguageManager::CachedStringId id(key); return id.get(); }())
+#define LANG(key) LanguageManager::getInstance().string(LANG_ID(key), key)
+#define LANG_PARAM(key, paramName, paramValue) LanguageManager::getInstance().string(LANG_ID(key), key, paramName, paramValue)
 #define LANG_PARAMS(key, params) LanguageManager::getInstance().getString(key, params)
 
 #endif // LANGUAGE_MANAGER_H
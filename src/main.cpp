@@ -1,9 +1,17 @@
 #include "mainwindow.h"
+#include "pe_command_line.h"
 
 #include <QApplication>
+#include <QCoreApplication>
 
 int main(int argc, char *argv[])
 {
+    // Batch commands run without a GUI so they work on headless machines
+    if (PECommandLine::isCommandLineInvocation(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return PECommandLine::run(app.arguments());
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
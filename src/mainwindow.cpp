@@ -29,6 +29,7 @@
 #include "language_manager.h"
 #include "crash_handler.h"
 #include "pe_utils.h"
+#include "pe_hash_index.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QApplication>
@@ -77,6 +78,7 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize PE Parser - NEW ARCHITECTURE: Using modular PEParserNew
     // This replaces the old monolithic PEParser that violated SRP
     m_peParser = new PEParserNew(this);
+    m_peParser->setExportIndex(PEExportIndex::load(PEExportIndex::defaultPath()));
     
     // Initialize Security Analyzer - NEW: For security analysis and malicious detection
     m_securityAnalyzer = new PESecurityAnalyzer(this);
@@ -565,6 +567,39 @@ void MainWindow::on_action_Save_Report_triggered()
             if (content.isEmpty()) {
                 content = LANG("UI/field_no_explanation");
             }
+            QString similarityHash = m_peParser->getFileContentDigest().similarityHash;
+            if (!m_peParser->getImportHash().isEmpty() || !m_peParser->getExportHash().isEmpty() ||
+                !m_peParser->getRichHeaderHash().isEmpty() || !m_peParser->getPdbKey().isEmpty() ||
+                !similarityHash.isEmpty()) {
+                content += "\n\n" + LANG("UI/report_fingerprints_title") + "\n";
+                if (!m_peParser->getImportHash().isEmpty()) {
+                    content += LANG_PARAM("UI/file_info_imphash", "hash", m_peParser->getImportHash()) + "\n";
+                }
+                if (!m_peParser->getExportHash().isEmpty()) {
+                    content += LANG_PARAM("UI/file_info_exphash", "hash", m_peParser->getExportHash()) + "\n";
+                }
+                if (!m_peParser->getRichHeaderHash().isEmpty()) {
+                    content += LANG_PARAM("UI/file_info_richhash", "hash", m_peParser->getRichHeaderHash()) + "\n";
+                }
+                if (!m_peParser->getPdbKey().isEmpty()) {
+                    content += LANG_PARAM("UI/file_info_pdb", "hash", m_peParser->getPdbKey()) + "\n";
+                }
+                if (!similarityHash.isEmpty()) {
+                    content += LANG_PARAM("UI/file_info_similarity", "hash", similarityHash) + "\n";
+                }
+                
+                // Per-section digests let a reader match sections that survived repacking
+                const QList<const IMAGE_SECTION_HEADER*> &sections = m_peParser->getDataModel().getSections();
+                const QList<PEDataModel::ContentDigest> &sectionDigests = m_peParser->getSectionContentDigests();
+                for (int i = 0; i < sections.size() && i < sectionDigests.size(); ++i) {
+                    const char *name = reinterpret_cast<const char*>(sections[i]->Name);
+                    QMap<QString, QString> sectionParams;
+                    sectionParams["name"] = QString::fromLatin1(name, static_cast<int>(qstrnlen(name, 8)));
+                    sectionParams["hash"] = sectionDigests[i].similarityHash.isEmpty() ? QStringLiteral("-") : sectionDigests[i].similarityHash;
+                    sectionParams["entropy"] = QString::number(sectionDigests[i].entropy, 'f', 2);
+                    content += LANG_PARAMS("UI/report_section_similarity", sectionParams) + "\n";
+                }
+            }
             stream << content;
             file.close();
             showInfo(LANG("UI/menu_save_report"), LANG("UI/info_save_success"));
@@ -820,7 +855,7 @@ void MainWindow::onSecurityAnalysis()
     }
     
     // Perform security analysis
-    SecurityAnalysisResult result = m_securityAnalyzer->analyzeFile(m_currentFilePath);
+    SecurityAnalysisResult result = m_securityAnalyzer->analyzeFile(m_currentFilePath, &m_peParser->getDataModel());
     
     // Hide progress
     if (m_uiManager) {
@@ -846,6 +881,9 @@ void MainWindow::onSecurityAnalysis()
     analysisText += "</p>";
     // Add risk score information
     analysisText += QString("<p><b>%1:</b> %2/100</p>").arg(LANG("UI/security_risk_score_label")).arg(result.riskScore);
+    if (!result.digitalSignatureStatus.isEmpty()) {
+        analysisText += QString("<p><b>%1:</b> %2</p>").arg(LANG("UI/security_digital_signature_label"), result.digitalSignatureStatus.toHtmlEscaped());
+    }
     
     if (!result.detectedIssues.isEmpty()) {
         analysisText += QString("<p><b>%1:</b></p><ul>").arg(LANG("UI/security_issues_found"));
@@ -975,7 +1013,47 @@ void MainWindow::updateFileInfo()
     params["size"] = getFileSizeString(fileInfo.size());
     QString info = LANG_PARAMS("UI/file_info_format", params);
     
+    // Show the fingerprints and how many indexed samples share them. The GUI
+    // only reads the index; samples are added with the --hash command line mode.
+    const QString samplePath = fileInfo.absoluteFilePath();
+    QStringList hashLabels;
+    QStringList hashTooltips;
+    PEHashIndex hashIndex;
+    struct DisplayedHash {
+        PEHashIndex::HashKind kind;
+        QString hash;
+        const char *labelKey;
+        const char *matchesKey;
+    };
+    const QList<DisplayedHash> hashes = {
+        {PEHashIndex::HashKind::ImportHash, m_peParser->getImportHash(), "UI/file_info_imphash", "UI/file_info_imphash_matches"},
+        {PEHashIndex::HashKind::ExportHash, m_peParser->getExportHash(), "UI/file_info_exphash", "UI/file_info_exphash_matches"},
+        {PEHashIndex::HashKind::RichHash, m_peParser->getRichHeaderHash(), "UI/file_info_richhash", "UI/file_info_richhash_matches"},
+        {PEHashIndex::HashKind::PdbKey, m_peParser->getPdbKey(), "UI/file_info_pdb", "UI/file_info_pdb_matches"}
+    };
+    for (const DisplayedHash &hash : hashes) {
+        if (hash.hash.isEmpty()) {
+            continue;
+        }
+        QStringList others = hashIndex.findSamples(hash.kind, hash.hash);
+        others.removeAll(samplePath);
+        QMap<QString, QString> hashParams;
+        hashParams["hash"] = hash.hash;
+        hashParams["count"] = QString::number(others.size());
+        hashLabels.append(LANG_PARAMS(hash.labelKey, hashParams));
+        hashTooltips.append(LANG_PARAMS(hash.matchesKey, hashParams));
+    }
+    if (!hashLabels.isEmpty()) {
+        info += " | " + hashLabels.join(" | ");
+    }
+    
+    QString similarityHash = m_peParser->getFileContentDigest().similarityHash;
+    if (!similarityHash.isEmpty()) {
+        hashTooltips.append(LANG_PARAM("UI/file_info_similarity", "hash", similarityHash));
+    }
+    
     m_uiManager->m_fileInfoLabel->setText(info);
+    m_uiManager->m_fileInfoLabel->setToolTip(hashTooltips.join("\n"));
     m_uiManager->m_refreshButton->setEnabled(true);
     m_uiManager->m_copyButton->setEnabled(true);
     m_uiManager->m_saveButton->setEnabled(true);
@@ -1079,7 +1157,9 @@ void MainWindow::updateAnalysisDisplay()
             for (const PEDataModel::ExportFunctionEntry &entry : exports) {
                 QTreeWidgetItem *item = new QTreeWidgetItem(m_uiManager->m_exportsTree);
                 item->setText(0, entry.name);
-                if (entry.rva != 0) {
+                if (!entry.forwarder.isEmpty()) {
+                    item->setText(1, LANG_PARAM("UI/import_forwarded_to", "target", entry.forwarder));
+                } else if (entry.rva != 0) {
                     item->setText(1, PEUtils::formatHexWidth(entry.rva, 8));
                 } else {
                     item->setText(1, "");
@@ -1679,6 +1759,9 @@ void MainWindow::populateImportFunctions(const QString &moduleName)
     for (const PEDataModel::ImportFunctionEntry &entry : functions) {
         QTreeWidgetItem *item = new QTreeWidgetItem(m_uiManager->m_importFunctionsTree);
         item->setText(0, entry.name);
+        if (!entry.forwardedTo.isEmpty()) {
+            item->setToolTip(0, LANG_PARAM("UI/import_forwarded_to", "target", entry.forwardedTo));
+        }
         if (entry.thunkRVA != 0) {
             item->setText(1, PEUtils::formatHexWidth(entry.thunkRVA, 8));
         } else {
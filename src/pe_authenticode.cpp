@@ -0,0 +1,382 @@
+/**
+ * @file pe_authenticode.cpp
+ * @brief Implementation of offline Authenticode digest computation
+ *
+ * IMPLEMENTATION NOTES:
+ * - The image is hashed linearly, skipping the three excluded ranges. For
+ *   files whose certificate table is the last thing in the file (which
+ *   signing tools require) this equals the section-ordered hash from the
+ *   specification.
+ * - The PKCS#7 blob is walked with a minimal DER reader that accepts only
+ *   definite lengths, which is all Authenticode allows.
+ */
+
+#include "pe_authenticode.h"
+#include "pe_structures.h"
+#include "language_manager.h"
+#include <QFile>
+#include <QIODevice>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+struct DerElement {
+    quint8 tag = 0;
+    qsizetype contentOffset = 0;
+    qsizetype length = 0;
+
+    qsizetype end() const { return contentOffset + length; }
+};
+
+const quint8 OID_SIGNED_DATA[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };
+const quint8 OID_SPC_INDIRECT_DATA[] = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04 };
+const quint8 OID_MD5[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x02, 0x05 };
+const quint8 OID_SHA1[] = { 0x2B, 0x0E, 0x03, 0x02, 0x1A };
+const quint8 OID_SHA256[] = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01 };
+const quint8 OID_SHA384[] = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02 };
+const quint8 OID_SHA512[] = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03 };
+
+// Reads one DER tag/length header at pos; the content must fit before limit
+bool readDer(const QByteArray &data, qsizetype pos, qsizetype limit, quint8 expectedTag, DerElement &out)
+{
+    if (pos < 0 || pos + 2 > limit || limit > data.size()) {
+        return false;
+    }
+
+    const quint8 *bytes = reinterpret_cast<const quint8*>(data.constData());
+    out.tag = bytes[pos];
+    if (out.tag != expectedTag) {
+        return false;
+    }
+
+    qsizetype headerSize = 2;
+    qsizetype length = bytes[pos + 1];
+    if (length & 0x80) {
+        int lengthBytes = static_cast<int>(length & 0x7F);
+        if (lengthBytes == 0 || lengthBytes > 4 || pos + 2 + lengthBytes > limit) {
+            return false;
+        }
+        length = 0;
+        for (int i = 0; i < lengthBytes; ++i) {
+            length = (length << 8) | bytes[pos + 2 + i];
+        }
+        headerSize += lengthBytes;
+    }
+
+    if (length < 0 || pos + headerSize + length > limit) {
+        return false;
+    }
+
+    out.contentOffset = pos + headerSize;
+    out.length = length;
+    return true;
+}
+
+template <size_t N>
+bool oidEquals(const QByteArray &data, const DerElement &oid, const quint8 (&encoded)[N])
+{
+    return oid.length == static_cast<qsizetype>(N) &&
+           std::memcmp(data.constData() + oid.contentOffset, encoded, N) == 0;
+}
+
+QString algorithmName(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Md5: return QStringLiteral("MD5");
+        case QCryptographicHash::Sha1: return QStringLiteral("SHA-1");
+        case QCryptographicHash::Sha256: return QStringLiteral("SHA-256");
+        case QCryptographicHash::Sha384: return QStringLiteral("SHA-384");
+        case QCryptographicHash::Sha512: return QStringLiteral("SHA-512");
+        default: return QStringLiteral("?");
+    }
+}
+
+bool readAt(QIODevice *device, qint64 offset, void *buffer, qint64 size)
+{
+    return device->seek(offset) && device->read(static_cast<char*>(buffer), size) == size;
+}
+
+} // namespace
+
+PEAuthenticode::Result PEAuthenticode::verifyFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Result result;
+        result.error = LANG("UI/file_status_not_found");
+        return result;
+    }
+
+    return verifyDevice(&file);
+}
+
+PEAuthenticode::Result PEAuthenticode::verifyDevice(QIODevice *device)
+{
+    Result result;
+
+    ImageLayout layout = readLayout(device, &result.error);
+    if (!layout.valid) {
+        return result;
+    }
+
+    if (layout.certificateTableSize == 0) {
+        // Unsigned: still report the image hash, which is what catalogs index
+        result.algorithmName = algorithmName(result.algorithm);
+        result.computedDigest = computeImageHash(device, layout, result.algorithm);
+        return result;
+    }
+
+    if (layout.certificateTableSize > MAX_CERTIFICATE_TABLE_SIZE) {
+        result.error = LANG("UI/signature_error_certificate_table");
+        return result;
+    }
+
+    QByteArray certificateTable(static_cast<qsizetype>(layout.certificateTableSize), Qt::Uninitialized);
+    if (!readAt(device, layout.certificateTableOffset, certificateTable.data(), certificateTable.size())) {
+        result.error = LANG("UI/signature_error_certificate_table");
+        return result;
+    }
+
+    result.pkcs7 = extractPKCS7(certificateTable);
+    result.hasSignature = !result.pkcs7.isEmpty();
+    if (!result.hasSignature) {
+        return result;
+    }
+
+    if (!parseSignedDigest(result.pkcs7, result.algorithm, result.signedDigest)) {
+        result.error = LANG("UI/signature_error_malformed_pkcs7");
+        return result;
+    }
+
+    result.algorithmName = algorithmName(result.algorithm);
+    result.computedDigest = computeImageHash(device, layout, result.algorithm);
+    if (result.computedDigest.isEmpty()) {
+        result.error = LANG("UI/signature_error_read");
+        return result;
+    }
+
+    result.digestMatches = result.computedDigest == result.signedDigest;
+    return result;
+}
+
+PEAuthenticode::ImageLayout PEAuthenticode::readLayout(QIODevice *device, QString *error)
+{
+    ImageLayout layout;
+    auto fail = [&](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return layout;
+    };
+
+    if (!device || !device->isOpen() || device->isSequential()) {
+        return fail(LANG("UI/signature_error_read"));
+    }
+
+    layout.fileSize = device->size();
+
+    IMAGE_DOS_HEADER dosHeader;
+    if (!readAt(device, 0, &dosHeader, sizeof(dosHeader)) || dosHeader.e_magic != IMAGE_DOS_SIGNATURE ||
+        dosHeader.e_lfanew < 0) {
+        return fail(LANG("UI/signature_error_not_pe"));
+    }
+
+    quint32 signature = 0;
+    IMAGE_FILE_HEADER fileHeader;
+    quint16 magic = 0;
+    const qint64 fileHeaderOffset = static_cast<qint64>(dosHeader.e_lfanew) + sizeof(quint32);
+    const qint64 optionalHeaderOffset = fileHeaderOffset + sizeof(IMAGE_FILE_HEADER);
+    if (!readAt(device, dosHeader.e_lfanew, &signature, sizeof(signature)) || signature != IMAGE_NT_SIGNATURE ||
+        !readAt(device, fileHeaderOffset, &fileHeader, sizeof(fileHeader)) ||
+        !readAt(device, optionalHeaderOffset, &magic, sizeof(magic))) {
+        return fail(LANG("UI/signature_error_not_pe"));
+    }
+
+    // CheckSum sits at the same offset in both layouts; the directories do not
+    qint64 dataDirectoryOffset = 0;
+    if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+        dataDirectoryOffset = optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory);
+    } else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+        dataDirectoryOffset = optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory);
+    } else {
+        return fail(LANG("UI/signature_error_not_pe"));
+    }
+
+    layout.checkSumOffset = optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+    layout.securityDirectoryOffset = dataDirectoryOffset + IMAGE_DIRECTORY_ENTRY_SECURITY * sizeof(IMAGE_DATA_DIRECTORY);
+
+    quint32 numberOfRvaAndSizes = 0;
+    IMAGE_DATA_DIRECTORY securityDirectory = {};
+    if (!readAt(device, dataDirectoryOffset - sizeof(quint32), &numberOfRvaAndSizes, sizeof(numberOfRvaAndSizes)) ||
+        layout.securityDirectoryOffset + static_cast<qint64>(sizeof(IMAGE_DATA_DIRECTORY)) > layout.fileSize) {
+        return fail(LANG("UI/signature_error_not_pe"));
+    }
+    bool hasSecurityEntry = numberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_SECURITY &&
+                            layout.securityDirectoryOffset + static_cast<qint64>(sizeof(IMAGE_DATA_DIRECTORY)) <=
+                                optionalHeaderOffset + fileHeader.SizeOfOptionalHeader;
+    if (hasSecurityEntry &&
+        !readAt(device, layout.securityDirectoryOffset, &securityDirectory, sizeof(securityDirectory))) {
+        return fail(LANG("UI/signature_error_read"));
+    }
+
+    // The security directory holds a file offset, not an RVA
+    if (securityDirectory.VirtualAddress != 0 && securityDirectory.Size != 0) {
+        if (static_cast<qint64>(securityDirectory.VirtualAddress) + securityDirectory.Size > layout.fileSize ||
+            static_cast<qint64>(securityDirectory.VirtualAddress) < layout.securityDirectoryOffset + static_cast<qint64>(sizeof(IMAGE_DATA_DIRECTORY))) {
+            return fail(LANG("UI/signature_error_certificate_table"));
+        }
+        layout.certificateTableOffset = securityDirectory.VirtualAddress;
+        layout.certificateTableSize = securityDirectory.Size;
+    }
+
+    layout.valid = true;
+    return layout;
+}
+
+QByteArray PEAuthenticode::computeImageHash(QIODevice *device, const ImageLayout &layout,
+                                            QCryptographicHash::Algorithm algorithm)
+{
+    if (!device || !layout.valid) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(algorithm);
+    QByteArray buffer(static_cast<qsizetype>(qMin(HASH_CHUNK_SIZE, qMax<qint64>(layout.fileSize, 1))), Qt::Uninitialized);
+
+    auto hashRange = [&](qint64 start, qint64 end) {
+        if (end <= start) {
+            return true;
+        }
+        if (!device->seek(start)) {
+            return false;
+        }
+        while (start < end) {
+            qint64 bytesRead = device->read(buffer.data(), qMin<qint64>(buffer.size(), end - start));
+            if (bytesRead <= 0) {
+                return false;
+            }
+            hash.addData(QByteArrayView(buffer.constData(), bytesRead));
+            start += bytesRead;
+        }
+        return true;
+    };
+
+    const qint64 certificateStart = layout.certificateTableSize != 0 ? layout.certificateTableOffset : layout.fileSize;
+    const qint64 certificateEnd = certificateStart + layout.certificateTableSize;
+
+    bool ok = hashRange(0, layout.checkSumOffset) &&
+              hashRange(layout.checkSumOffset + sizeof(quint32), layout.securityDirectoryOffset) &&
+              hashRange(layout.securityDirectoryOffset + sizeof(IMAGE_DATA_DIRECTORY), certificateStart) &&
+              hashRange(certificateEnd, layout.fileSize);
+
+    // The file without its certificate table is hashed as if zero-padded to a multiple of 8
+    const qint64 remainder = (layout.fileSize - layout.certificateTableSize) % 8;
+    if (ok && remainder != 0) {
+        hash.addData(QByteArray(static_cast<qsizetype>(8 - remainder), '\0'));
+    }
+
+    return ok ? hash.result() : QByteArray();
+}
+
+QByteArray PEAuthenticode::extractPKCS7(const QByteArray &certificateTable)
+{
+    const qsizetype headerSize = offsetof(WIN_CERTIFICATE, bCertificate);
+    qsizetype pos = 0;
+
+    while (pos + headerSize <= certificateTable.size()) {
+        WIN_CERTIFICATE header;
+        std::memcpy(&header, certificateTable.constData() + pos, headerSize);
+        if (header.dwLength < headerSize || pos + static_cast<qsizetype>(header.dwLength) > certificateTable.size()) {
+            break;
+        }
+
+        if (header.wCertificateType == WIN_CERT_TYPE_PKCS_SIGNED_DATA) {
+            // Drop the alignment padding that follows the DER structure
+            QByteArray blob = certificateTable.mid(pos + headerSize, header.dwLength - headerSize);
+            DerElement contentInfo;
+            if (readDer(blob, 0, blob.size(), 0x30, contentInfo)) {
+                blob.truncate(contentInfo.end());
+            }
+            return blob;
+        }
+
+        // Entries are 8-byte aligned
+        pos += (static_cast<qsizetype>(header.dwLength) + 7) & ~static_cast<qsizetype>(7);
+    }
+
+    return QByteArray();
+}
+
+bool PEAuthenticode::parseSignedDigest(const QByteArray &pkcs7,
+                                       QCryptographicHash::Algorithm &algorithm,
+                                       QByteArray &digest)
+{
+    // ContentInfo ::= SEQUENCE { contentType OID, [0] EXPLICIT SignedData }
+    DerElement contentInfo, contentType, explicitContent, signedData;
+    if (!readDer(pkcs7, 0, pkcs7.size(), 0x30, contentInfo) ||
+        !readDer(pkcs7, contentInfo.contentOffset, contentInfo.end(), 0x06, contentType) ||
+        !oidEquals(pkcs7, contentType, OID_SIGNED_DATA) ||
+        !readDer(pkcs7, contentType.end(), contentInfo.end(), 0xA0, explicitContent) ||
+        !readDer(pkcs7, explicitContent.contentOffset, explicitContent.end(), 0x30, signedData)) {
+        return false;
+    }
+
+    // SignedData ::= SEQUENCE { version, digestAlgorithms SET, encapContentInfo, ... }
+    DerElement version, digestAlgorithms, encapContent, encapType, encapExplicit;
+    if (!readDer(pkcs7, signedData.contentOffset, signedData.end(), 0x02, version) ||
+        !readDer(pkcs7, version.end(), signedData.end(), 0x31, digestAlgorithms) ||
+        !readDer(pkcs7, digestAlgorithms.end(), signedData.end(), 0x30, encapContent) ||
+        !readDer(pkcs7, encapContent.contentOffset, encapContent.end(), 0x06, encapType) ||
+        !oidEquals(pkcs7, encapType, OID_SPC_INDIRECT_DATA) ||
+        !readDer(pkcs7, encapType.end(), encapContent.end(), 0xA0, encapExplicit)) {
+        return false;
+    }
+
+    // SpcIndirectDataContent ::= SEQUENCE { data, messageDigest DigestInfo }
+    DerElement indirectData, attribute, digestInfo, algorithmId, algorithmOid, digestValue;
+    if (!readDer(pkcs7, encapExplicit.contentOffset, encapExplicit.end(), 0x30, indirectData) ||
+        !readDer(pkcs7, indirectData.contentOffset, indirectData.end(), 0x30, attribute) ||
+        !readDer(pkcs7, attribute.end(), indirectData.end(), 0x30, digestInfo) ||
+        !readDer(pkcs7, digestInfo.contentOffset, digestInfo.end(), 0x30, algorithmId) ||
+        !readDer(pkcs7, algorithmId.contentOffset, algorithmId.end(), 0x06, algorithmOid) ||
+        !readDer(pkcs7, algorithmId.end(), digestInfo.end(), 0x04, digestValue)) {
+        return false;
+    }
+
+    if (oidEquals(pkcs7, algorithmOid, OID_SHA256)) {
+        algorithm = QCryptographicHash::Sha256;
+    } else if (oidEquals(pkcs7, algorithmOid, OID_SHA1)) {
+        algorithm = QCryptographicHash::Sha1;
+    } else if (oidEquals(pkcs7, algorithmOid, OID_SHA384)) {
+        algorithm = QCryptographicHash::Sha384;
+    } else if (oidEquals(pkcs7, algorithmOid, OID_SHA512)) {
+        algorithm = QCryptographicHash::Sha512;
+    } else if (oidEquals(pkcs7, algorithmOid, OID_MD5)) {
+        algorithm = QCryptographicHash::Md5;
+    } else {
+        return false;
+    }
+
+    digest = pkcs7.mid(digestValue.contentOffset, digestValue.length);
+    return true;
+}
+
+QString PEAuthenticode::describe(const Result &result)
+{
+    if (!result.hasSignature) {
+        return result.error.isEmpty() ? LANG("UI/signature_status_unsigned") : result.error;
+    }
+
+    if (!result.error.isEmpty()) {
+        return LANG_PARAM("UI/signature_status_error", "error", result.error);
+    }
+
+    QMap<QString, QString> params;
+    params["algorithm"] = result.algorithmName;
+    params["signed"] = QString::fromLatin1(result.signedDigest.toHex());
+    params["computed"] = QString::fromLatin1(result.computedDigest.toHex());
+
+    return result.digestMatches ? LANG_PARAMS("UI/signature_status_digest_match", params)
+                                : LANG_PARAMS("UI/signature_status_digest_mismatch", params);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file pe_authenticode.h
+ * @brief Offline Authenticode digest computation for PEHint
+ *
+ * Computes the Authenticode PE image hash in one streaming pass over the
+ * file and compares it with the digest stored in the embedded PKCS#7
+ * SignedData (SpcIndirectDataContent). No platform trust APIs are used, so
+ * the check behaves the same on every operating system.
+ *
+ * SCOPE:
+ * - Image hash: whole file except the CheckSum field, the security data
+ *   directory entry and the certificate table
+ * - PKCS#7 extraction from the WIN_CERTIFICATE table
+ * - Digest comparison only; certificate chains and signer signatures are
+ *   not validated
+ */
+
+#ifndef PE_AUTHENTICODE_H
+#define PE_AUTHENTICODE_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+class QIODevice;
+
+class PEAuthenticode
+{
+public:
+    /**
+     * @brief File ranges that take part in (or are excluded from) the hash
+     */
+    struct ImageLayout {
+        bool valid = false;
+        qint64 fileSize = 0;
+        qint64 checkSumOffset = 0;          ///< OptionalHeader.CheckSum (4 bytes)
+        qint64 securityDirectoryOffset = 0; ///< DataDirectory[4] entry (8 bytes)
+        quint32 certificateTableOffset = 0; ///< File offset, not an RVA
+        quint32 certificateTableSize = 0;
+    };
+
+    /**
+     * @brief Outcome of an Authenticode digest check
+     */
+    struct Result {
+        bool hasSignature = false;
+        bool digestMatches = false;
+        QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256;
+        QString algorithmName;
+        QByteArray computedDigest;
+        QByteArray signedDigest;
+        QByteArray pkcs7;                   ///< DER encoded ContentInfo
+        QString error;
+    };
+
+    /**
+     * @brief Verifies the embedded signature digest of a file on disk
+     */
+    static Result verifyFile(const QString &filePath);
+
+    /**
+     * @brief Verifies the embedded signature digest of a seekable device
+     *
+     * Only the headers and the certificate table are held in memory; the
+     * image itself is hashed in fixed-size chunks.
+     */
+    static Result verifyDevice(QIODevice *device);
+
+    /**
+     * @brief Reads the header fields needed to compute the image hash
+     */
+    static ImageLayout readLayout(QIODevice *device, QString *error = nullptr);
+
+    /**
+     * @brief Computes the Authenticode image hash with the given algorithm
+     *
+     * Everything but CheckSum, the security directory entry and the
+     * certificate table is hashed, followed by zero bytes up to a multiple
+     * of 8, as signing tools pad unaligned images.
+     */
+    static QByteArray computeImageHash(QIODevice *device, const ImageLayout &layout,
+                                       QCryptographicHash::Algorithm algorithm);
+
+    /**
+     * @brief Returns the first PKCS#7 SignedData blob of a certificate table
+     */
+    static QByteArray extractPKCS7(const QByteArray &certificateTable);
+
+    /**
+     * @brief Extracts the digest algorithm and value from SpcIndirectDataContent
+     * @return false if the blob is not an Authenticode SignedData structure
+     */
+    static bool parseSignedDigest(const QByteArray &pkcs7,
+                                  QCryptographicHash::Algorithm &algorithm,
+                                  QByteArray &digest);
+
+    /**
+     * @brief Formats a result as a user-facing status line
+     */
+    static QString describe(const Result &result);
+
+private:
+    static constexpr qint64 HASH_CHUNK_SIZE = 1024 * 1024;
+    static constexpr quint32 MAX_CERTIFICATE_TABLE_SIZE = 64 * 1024 * 1024;
+};
+
+#endif // PE_AUTHENTICODE_H
@@ -0,0 +1,161 @@
+#include "pe_byte_source.h"
+#include <QDir>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+PEByteSource::PEByteSource()
+{
+}
+
+PEByteSource::~PEByteSource()
+{
+    close();
+}
+
+bool PEByteSource::openFile(const QString &filePath, qint64 memoryLimit)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    // The file stays open while mapped; closing it would unmap the view
+    if (m_file.size() > memoryLimit) {
+        return mapFile(m_file);
+    }
+
+    m_data = m_file.readAll();
+    m_file.close();
+    return true;
+}
+
+void PEByteSource::setBuffer(const QByteArray &data)
+{
+    close();
+    m_data = data;
+}
+
+bool PEByteSource::readDevice(QIODevice *device, qint64 memoryLimit)
+{
+    close();
+
+    if (!device || !device->isReadable()) {
+        m_errorString = QStringLiteral("Device is not open for reading");
+        return false;
+    }
+
+    // A named regular file can be mapped instead of copied
+    QFile *file = qobject_cast<QFile*>(device);
+    if (file && !file->isSequential() && !file->fileName().isEmpty()) {
+        return openFile(file->fileName(), memoryLimit);
+    }
+
+    QByteArray head;
+    for (;;) {
+        QByteArray chunk = device->read(STREAM_CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            // Pipes, sockets and processes may just not have data yet
+            if (device->waitForReadyRead(-1)) {
+                continue;
+            }
+            break;
+        }
+        head.append(chunk);
+        if (head.size() > memoryLimit) {
+            return spill(device, head);
+        }
+    }
+
+    m_data = head;
+    return true;
+}
+
+void PEByteSource::close()
+{
+    m_data.clear();
+    if (m_mapped) {
+        if (m_spillFile) {
+            m_spillFile->unmap(m_mapped);
+        } else {
+            m_file.unmap(m_mapped);
+        }
+        m_mapped = nullptr;
+    }
+    m_file.close();
+    m_spillFile.reset();
+    m_errorString.clear();
+}
+
+QString PEByteSource::backingFilePath() const
+{
+    if (m_spillFile) {
+        return m_spillFile->fileName();
+    }
+    return m_mapped ? m_file.fileName() : QString();
+}
+
+void PEByteSource::releasePages()
+{
+    if (!m_mapped) {
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    // Clean file pages: dropping them only costs a re-read on the next access
+    madvise(m_mapped, static_cast<size_t>(m_data.size()), MADV_DONTNEED);
+#endif
+    // Windows trims clean mapped pages from the working set under pressure
+}
+
+bool PEByteSource::mapFile(QFile &file)
+{
+    const qint64 size = file.size();
+    if (size == 0) {
+        return true;
+    }
+
+    m_mapped = file.map(0, size);
+    if (!m_mapped) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    m_data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_mapped), size);
+    return true;
+}
+
+bool PEByteSource::spill(QIODevice *device, const QByteArray &head)
+{
+    m_spillFile.reset(new QTemporaryFile(QDir::temp().filePath(QStringLiteral("pehint-XXXXXX.bin"))));
+    if (!m_spillFile->open() || m_spillFile->write(head) != head.size()) {
+        m_errorString = m_spillFile->errorString();
+        m_spillFile.reset();
+        return false;
+    }
+
+    for (;;) {
+        QByteArray chunk = device->read(STREAM_CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            if (device->waitForReadyRead(-1)) {
+                continue;
+            }
+            break;
+        }
+        if (m_spillFile->write(chunk) != chunk.size()) {
+            m_errorString = m_spillFile->errorString();
+            m_spillFile.reset();
+            return false;
+        }
+    }
+
+    if (!m_spillFile->flush()) {
+        m_errorString = m_spillFile->errorString();
+        m_spillFile.reset();
+        return false;
+    }
+    return mapFile(*m_spillFile);
+}
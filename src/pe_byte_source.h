@@ -0,0 +1,94 @@
+/**
+ * @file pe_byte_source.h
+ * @brief Contiguous view of a PE image from a file, a buffer or a stream
+ *
+ * The parsers read an image through one bounds-checked QByteArray. A byte
+ * source provides that array and owns whatever backs it:
+ *
+ *   Memory   A buffer handed in by the caller (shared, not copied), or a
+ *            file or stream small enough to read whole
+ *   Mapped   A read-only mapping of a file larger than the memory limit,
+ *            or of the temporary file a large stream was spilled to
+ *
+ * Sequential devices (stdin, pipes, sockets, QProcess) are read in chunks
+ * while they fit the memory limit; once they do not, what was read so far
+ * and the rest of the stream go to a temporary file that is then mapped,
+ * so no stream is ever held in memory beyond the limit.
+ */
+
+#ifndef PE_BYTE_SOURCE_H
+#define PE_BYTE_SOURCE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QScopedPointer>
+#include <QString>
+#include <QTemporaryFile>
+#include <QtGlobal>
+
+class PEByteSource
+{
+public:
+    PEByteSource();
+    ~PEByteSource();
+
+    PEByteSource(const PEByteSource &) = delete;
+    PEByteSource &operator=(const PEByteSource &) = delete;
+
+    /**
+     * @brief Reads a file, or maps it if it is larger than memoryLimit
+     */
+    bool openFile(const QString &filePath, qint64 memoryLimit);
+
+    /**
+     * @brief Uses a buffer that is already in memory
+     */
+    void setBuffer(const QByteArray &data);
+
+    /**
+     * @brief Reads an open device to its end
+     * @param memoryLimit Streams beyond this size are spilled to a temporary file
+     *
+     * Files are opened by name so they can be mapped; every other device
+     * is treated as a stream.
+     */
+    bool readDevice(QIODevice *device, qint64 memoryLimit);
+
+    /**
+     * @brief Releases the data, the mapping and any spill file
+     */
+    void close();
+
+    const QByteArray &data() const { return m_data; }
+    qint64 size() const { return m_data.size(); }
+    bool isMapped() const { return m_mapped != nullptr; }
+
+    /**
+     * @brief File a mapped source reads from, for stages that stream it separately
+     *
+     * The spill file for spilled streams; empty for in-memory sources.
+     */
+    QString backingFilePath() const;
+
+    /**
+     * @brief Drops the resident pages of a mapping; no-op for memory sources
+     */
+    void releasePages();
+
+    QString errorString() const { return m_errorString; }
+
+    static constexpr qint64 STREAM_CHUNK_SIZE = 1024 * 1024;
+
+private:
+    bool mapFile(QFile &file);
+    bool spill(QIODevice *device, const QByteArray &head);
+
+    QFile m_file;
+    QScopedPointer<QTemporaryFile> m_spillFile;
+    uchar *m_mapped = nullptr;
+    QByteArray m_data;
+    QString m_errorString;
+};
+
+#endif // PE_BYTE_SOURCE_H
@@ -0,0 +1,425 @@
+/**
+ * @file pe_clr_metadata.cpp
+ * @brief Lazy reader for .NET (ECMA-335) metadata
+ */
+
+#include "pe_clr_metadata.h"
+#include "pe_structures.h"
+#include <cstring>
+
+namespace {
+
+// Column kinds. Values below 0x40 are simple indexes into that table.
+enum ColumnKind : quint8 {
+    U16 = 0x40,
+    U32,
+    StringIndex,
+    GuidIndex,
+    BlobIndex,
+    TypeDefOrRef,
+    HasConstant,
+    HasCustomAttribute,
+    HasFieldMarshal,
+    HasDeclSecurity,
+    MemberRefParent,
+    HasSemantics,
+    MethodDefOrRef,
+    MemberForwarded,
+    Implementation,
+    CustomAttributeType,
+    ResolutionScope,
+    TypeOrMethodDef,
+    End = 0xFF
+};
+
+// ECMA-335 II.22, in table ID order. Constant.Type is a byte plus a padding byte.
+const quint8 SCHEMA[PEClrMetadata::TABLE_COUNT][PEClrMetadata::MAX_COLUMNS + 1] = {
+    /* 0x00 Module                 */ {U16, StringIndex, GuidIndex, GuidIndex, GuidIndex, End},
+    /* 0x01 TypeRef                */ {ResolutionScope, StringIndex, StringIndex, End},
+    /* 0x02 TypeDef                */ {U32, StringIndex, StringIndex, TypeDefOrRef, 0x04, 0x06, End},
+    /* 0x03 FieldPtr               */ {0x04, End},
+    /* 0x04 Field                  */ {U16, StringIndex, BlobIndex, End},
+    /* 0x05 MethodPtr              */ {0x06, End},
+    /* 0x06 MethodDef              */ {U32, U16, U16, StringIndex, BlobIndex, 0x08, End},
+    /* 0x07 ParamPtr               */ {0x08, End},
+    /* 0x08 Param                  */ {U16, U16, StringIndex, End},
+    /* 0x09 InterfaceImpl          */ {0x02, TypeDefOrRef, End},
+    /* 0x0A MemberRef              */ {MemberRefParent, StringIndex, BlobIndex, End},
+    /* 0x0B Constant               */ {U16, HasConstant, BlobIndex, End},
+    /* 0x0C CustomAttribute        */ {HasCustomAttribute, CustomAttributeType, BlobIndex, End},
+    /* 0x0D FieldMarshal           */ {HasFieldMarshal, BlobIndex, End},
+    /* 0x0E DeclSecurity           */ {U16, HasDeclSecurity, BlobIndex, End},
+    /* 0x0F ClassLayout            */ {U16, U32, 0x02, End},
+    /* 0x10 FieldLayout            */ {U32, 0x04, End},
+    /* 0x11 StandAloneSig          */ {BlobIndex, End},
+    /* 0x12 EventMap               */ {0x02, 0x14, End},
+    /* 0x13 EventPtr               */ {0x14, End},
+    /* 0x14 Event                  */ {U16, StringIndex, TypeDefOrRef, End},
+    /* 0x15 PropertyMap            */ {0x02, 0x17, End},
+    /* 0x16 PropertyPtr            */ {0x17, End},
+    /* 0x17 Property               */ {U16, StringIndex, BlobIndex, End},
+    /* 0x18 MethodSemantics        */ {U16, 0x06, HasSemantics, End},
+    /* 0x19 MethodImpl             */ {0x02, MethodDefOrRef, MethodDefOrRef, End},
+    /* 0x1A ModuleRef              */ {StringIndex, End},
+    /* 0x1B TypeSpec               */ {BlobIndex, End},
+    /* 0x1C ImplMap                */ {U16, MemberForwarded, StringIndex, 0x1A, End},
+    /* 0x1D FieldRVA               */ {U32, 0x04, End},
+    /* 0x1E EncLog                 */ {U32, U32, End},
+    /* 0x1F EncMap                 */ {U32, End},
+    /* 0x20 Assembly               */ {U32, U16, U16, U16, U16, U32, BlobIndex, StringIndex, StringIndex, End},
+    /* 0x21 AssemblyProcessor      */ {U32, End},
+    /* 0x22 AssemblyOS             */ {U32, U32, U32, End},
+    /* 0x23 AssemblyRef            */ {U16, U16, U16, U16, U32, BlobIndex, StringIndex, StringIndex, BlobIndex, End},
+    /* 0x24 AssemblyRefProcessor   */ {U32, 0x23, End},
+    /* 0x25 AssemblyRefOS          */ {U32, U32, U32, 0x23, End},
+    /* 0x26 File                   */ {U32, StringIndex, BlobIndex, End},
+    /* 0x27 ExportedType           */ {U32, U32, StringIndex, StringIndex, Implementation, End},
+    /* 0x28 ManifestResource       */ {U32, U32, StringIndex, Implementation, End},
+    /* 0x29 NestedClass            */ {0x02, 0x02, End},
+    /* 0x2A GenericParam           */ {U16, U16, TypeOrMethodDef, StringIndex, End},
+    /* 0x2B MethodSpec             */ {MethodDefOrRef, BlobIndex, End},
+    /* 0x2C GenericParamConstraint */ {0x2A, TypeDefOrRef, End}
+};
+
+// Tables a coded index can point at (ECMA-335 II.24.2.6); 0xFF marks unused tags
+struct CodedIndex {
+    quint8 tagBits;
+    quint8 tables[22];
+    quint8 tableCount;
+};
+
+const CodedIndex CODED_INDEXES[] = {
+    /* TypeDefOrRef        */ {2, {0x02, 0x01, 0x1B}, 3},
+    /* HasConstant         */ {2, {0x04, 0x08, 0x17}, 3},
+    /* HasCustomAttribute  */ {5, {0x06, 0x04, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x00, 0x0E, 0x17, 0x14,
+                                   0x11, 0x1A, 0x1B, 0x20, 0x23, 0x26, 0x27, 0x28, 0x2A, 0x2C, 0x2B}, 22},
+    /* HasFieldMarshal     */ {1, {0x04, 0x08}, 2},
+    /* HasDeclSecurity     */ {2, {0x02, 0x06, 0x20}, 3},
+    /* MemberRefParent     */ {3, {0x02, 0x01, 0x1A, 0x06, 0x1B}, 5},
+    /* HasSemantics        */ {1, {0x14, 0x17}, 2},
+    /* MethodDefOrRef      */ {1, {0x06, 0x0A}, 2},
+    /* MemberForwarded     */ {1, {0x04, 0x06}, 2},
+    /* Implementation      */ {2, {0x26, 0x23, 0x27}, 3},
+    /* CustomAttributeType */ {3, {0xFF, 0xFF, 0x06, 0x0A, 0xFF}, 5},
+    /* ResolutionScope     */ {2, {0x00, 0x1A, 0x23, 0x01}, 4},
+    /* TypeOrMethodDef     */ {1, {0x02, 0x06}, 2}
+};
+
+// Heap size flags of the table stream header
+const quint8 HEAP_STRINGS_WIDE = 0x01;
+const quint8 HEAP_GUID_WIDE = 0x02;
+const quint8 HEAP_BLOB_WIDE = 0x04;
+const quint8 HEAP_EXTRA_DATA = 0x40;    // An extra dword follows the row counts
+
+// Stream names are at most 32 bytes including the terminator
+const int MAX_STREAM_NAME = 32;
+const int MAX_STREAMS = 16;
+
+// Length prefix of #Blob and #US entries (ECMA-335 II.24.2.4). Fails if the
+// prefix or the data it announces runs past the end of the heap.
+bool readCompressedLength(const uchar *pos, quint32 available, quint32 &length, quint32 &prefix)
+{
+    if ((pos[0] & 0x80) == 0) {
+        length = pos[0];
+        prefix = 1;
+    } else if ((pos[0] & 0xC0) == 0x80 && available >= 2) {
+        length = ((pos[0] & 0x3Fu) << 8) | pos[1];
+        prefix = 2;
+    } else if ((pos[0] & 0xE0) == 0xC0 && available >= 4) {
+        length = ((pos[0] & 0x1Fu) << 24) | (static_cast<quint32>(pos[1]) << 16) | (pos[2] << 8) | pos[3];
+        prefix = 4;
+    } else {
+        return false;
+    }
+    return length <= available - prefix;
+}
+
+} // namespace
+
+PEClrMetadata PEClrMetadata::open(const QByteArray &fileData, quint32 fileOffset, quint32 size)
+{
+    PEClrMetadata metadata;
+    metadata.m_data = fileData;
+
+    quint64 rootEnd = qMin<quint64>(static_cast<quint64>(fileOffset) + size, static_cast<quint64>(fileData.size()));
+    if (static_cast<quint64>(fileOffset) + 16 > rootEnd || metadata.readUInt(fileOffset, 4) != CLR_METADATA_SIGNATURE) {
+        return metadata;
+    }
+
+    // Signature, major, minor, reserved, then the padded version string
+    quint32 versionLength = metadata.readUInt(fileOffset + 12, 4);
+    quint64 position = static_cast<quint64>(fileOffset) + 16;
+    if (versionLength > 255 || position + versionLength + 4 > rootEnd) {
+        return metadata;
+    }
+    const char *versionText = fileData.constData() + position;
+    metadata.m_version = QString::fromLatin1(versionText, static_cast<int>(qstrnlen(versionText, versionLength)));
+    position += (versionLength + 3) & ~3u;
+
+    // Flags (unused), then the stream count
+    int streamCount = static_cast<int>(metadata.readUInt(position + 2, 2));
+    position += 4;
+    for (int i = 0; i < streamCount && i < MAX_STREAMS; ++i) {
+        if (position + 8 >= rootEnd) {
+            break;
+        }
+        quint32 streamOffset = metadata.readUInt(position, 4);
+        quint32 streamSize = metadata.readUInt(position + 4, 4);
+        const char *name = fileData.constData() + position + 8;
+        int nameLength = static_cast<int>(qstrnlen(name, static_cast<size_t>(qMin<quint64>(MAX_STREAM_NAME, rootEnd - position - 8))));
+        position += 8 + ((nameLength + 4) & ~3);
+
+        // Offsets are relative to the root; streams outside the directory are dropped
+        if (streamOffset > size || streamSize > size - streamOffset ||
+            static_cast<quint64>(fileOffset) + streamOffset + streamSize > static_cast<quint64>(fileData.size())) {
+            continue;
+        }
+        Stream stream;
+        stream.name = QString::fromLatin1(name, nameLength);
+        stream.fileOffset = fileOffset + streamOffset;
+        stream.size = streamSize;
+        metadata.m_streams.append(stream);
+    }
+
+    // The first stream of each name wins, as in the CLR loader
+    const Stream *tableStream = nullptr;
+    for (const Stream &stream : metadata.m_streams) {
+        if ((stream.name == "#~" || stream.name == "#-") && !tableStream) {
+            tableStream = &stream;
+            metadata.m_uncompressed = stream.name == "#-";
+        } else if (stream.name == "#Strings" && metadata.m_stringHeap.name.isEmpty()) {
+            metadata.m_stringHeap = stream;
+        } else if (stream.name == "#US" && metadata.m_userStringHeap.name.isEmpty()) {
+            metadata.m_userStringHeap = stream;
+        } else if (stream.name == "#GUID" && metadata.m_guidHeap.name.isEmpty()) {
+            metadata.m_guidHeap = stream;
+        } else if (stream.name == "#Blob" && metadata.m_blobHeap.name.isEmpty()) {
+            metadata.m_blobHeap = stream;
+        }
+    }
+
+    metadata.m_valid = tableStream && metadata.parseTableStream(tableStream->fileOffset, tableStream->size);
+    return metadata;
+}
+
+bool PEClrMetadata::parseTableStream(quint32 fileOffset, quint32 size)
+{
+    // Reserved, major, minor, heap sizes, reserved, valid mask, sorted mask
+    if (size < 24) {
+        return false;
+    }
+    quint8 heapSizes = static_cast<quint8>(readUInt(fileOffset + 6, 1));
+    quint64 validMask = static_cast<quint64>(readUInt(fileOffset + 8, 4)) |
+                        (static_cast<quint64>(readUInt(fileOffset + 12, 4)) << 32);
+
+    quint64 position = static_cast<quint64>(fileOffset) + 24;
+    quint64 streamEnd = static_cast<quint64>(fileOffset) + size;
+    for (int table = 0; table < 64; ++table) {
+        if (!(validMask & (1ULL << table))) {
+            continue;
+        }
+        if (position + 4 > streamEnd) {
+            return false;
+        }
+        quint32 rows = readUInt(position, 4);
+        if (table < TABLE_COUNT) {
+            m_rowCounts[table] = rows;
+        } else if (rows != 0) {
+            // Tables past GenericParamConstraint have no known layout; the ones
+            // described here all precede them, so only later data is lost
+            m_truncated = true;
+        }
+        position += 4;
+    }
+    if (heapSizes & HEAP_EXTRA_DATA) {
+        position += 4;
+    }
+
+    int stringSize = (heapSizes & HEAP_STRINGS_WIDE) ? 4 : 2;
+    int guidSize = (heapSizes & HEAP_GUID_WIDE) ? 4 : 2;
+    int blobSize = (heapSizes & HEAP_BLOB_WIDE) ? 4 : 2;
+
+    auto columnSize = [&](quint8 kind) -> int {
+        if (kind < TABLE_COUNT) {
+            return m_rowCounts[kind] > 0xFFFF ? 4 : 2;
+        }
+        switch (kind) {
+        case U16: return 2;
+        case U32: return 4;
+        case StringIndex: return stringSize;
+        case GuidIndex: return guidSize;
+        case BlobIndex: return blobSize;
+        default: {
+            const CodedIndex &coded = CODED_INDEXES[kind - TypeDefOrRef];
+            quint32 maxRows = 0;
+            for (int i = 0; i < coded.tableCount; ++i) {
+                if (coded.tables[i] != 0xFF) {
+                    maxRows = qMax(maxRows, m_rowCounts[coded.tables[i]]);
+                }
+            }
+            return maxRows < (1u << (16 - coded.tagBits)) ? 2 : 4;
+        }
+        }
+    };
+
+    for (int table = 0; table < TABLE_COUNT; ++table) {
+        quint32 rowSize = 0;
+        for (int column = 0; column < MAX_COLUMNS && SCHEMA[table][column] != End; ++column) {
+            int width = columnSize(SCHEMA[table][column]);
+            m_columnOffsets[table][column] = static_cast<quint8>(rowSize);
+            m_columnSizes[table][column] = static_cast<quint8>(width);
+            rowSize += width;
+        }
+        m_rowSizes[table] = rowSize;
+        m_tableOffsets[table] = position;
+
+        // Keep only the rows that lie inside the stream
+        quint64 tableSize = static_cast<quint64>(m_rowCounts[table]) * rowSize;
+        if (position + tableSize > streamEnd) {
+            m_rowCounts[table] = static_cast<quint32>((streamEnd - qMin(position, streamEnd)) / rowSize);
+            m_truncated = true;
+            tableSize = static_cast<quint64>(m_rowCounts[table]) * rowSize;
+        }
+        position += tableSize;
+    }
+    return true;
+}
+
+quint32 PEClrMetadata::readUInt(quint64 fileOffset, int size) const
+{
+    if (fileOffset + size > static_cast<quint64>(m_data.size())) {
+        return 0;
+    }
+    quint32 value = 0;
+    std::memcpy(&value, m_data.constData() + fileOffset, size);
+    return value;
+}
+
+quint32 PEClrMetadata::rowCount(int table) const
+{
+    return (table >= 0 && table < TABLE_COUNT) ? m_rowCounts[table] : 0;
+}
+
+quint32 PEClrMetadata::value(int table, quint32 row, int column) const
+{
+    if (table < 0 || table >= TABLE_COUNT || row == 0 || row > m_rowCounts[table] ||
+        column < 0 || column >= MAX_COLUMNS || m_columnSizes[table][column] == 0) {
+        return 0;
+    }
+    quint64 offset = m_tableOffsets[table] + static_cast<quint64>(row - 1) * m_rowSizes[table] + m_columnOffsets[table][column];
+    return readUInt(offset, m_columnSizes[table][column]);
+}
+
+QString PEClrMetadata::string(quint32 index) const
+{
+    if (index >= m_stringHeap.size) {
+        return QString();
+    }
+    const char *text = m_data.constData() + m_stringHeap.fileOffset + index;
+    return QString::fromUtf8(text, static_cast<qsizetype>(qstrnlen(text, m_stringHeap.size - index)));
+}
+
+QString PEClrMetadata::userString(quint32 index) const
+{
+    // Same length prefix as #Blob; the UTF-16 text is followed by one flag byte
+    if (index >= m_userStringHeap.size) {
+        return QString();
+    }
+    const uchar *pos = reinterpret_cast<const uchar*>(m_data.constData()) + m_userStringHeap.fileOffset + index;
+    quint32 length = 0;
+    quint32 prefix = 0;
+    if (!readCompressedLength(pos, m_userStringHeap.size - index, length, prefix) || length == 0) {
+        return QString();
+    }
+    return QString::fromUtf16(reinterpret_cast<const char16_t*>(pos + prefix), static_cast<qsizetype>(length / 2));
+}
+
+QUuid PEClrMetadata::guid(quint32 index) const
+{
+    if (index == 0 || static_cast<quint64>(index) * 16 > m_guidHeap.size) {
+        return QUuid();
+    }
+    const uchar *data = reinterpret_cast<const uchar*>(m_data.constData()) + m_guidHeap.fileOffset + (index - 1) * 16;
+    quint32 l;
+    quint16 w1, w2;
+    std::memcpy(&l, data, 4);
+    std::memcpy(&w1, data + 4, 2);
+    std::memcpy(&w2, data + 6, 2);
+    return QUuid(l, w1, w2, data[8], data[9], data[10], data[11], data[12], data[13], data[14], data[15]);
+}
+
+QByteArray PEClrMetadata::blob(quint32 index) const
+{
+    if (index >= m_blobHeap.size) {
+        return QByteArray();
+    }
+    const uchar *pos = reinterpret_cast<const uchar*>(m_data.constData()) + m_blobHeap.fileOffset + index;
+    quint32 length = 0;
+    quint32 prefix = 0;
+    if (!readCompressedLength(pos, m_blobHeap.size - index, length, prefix)) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(pos + prefix), static_cast<qsizetype>(length));
+}
+
+PEClrMetadata::TypeDefRow PEClrMetadata::typeDef(quint32 row) const
+{
+    TypeDefRow result;
+    result.flags = value(TypeDef, row, 0);
+    result.name = string(value(TypeDef, row, 1));
+    result.typeNamespace = string(value(TypeDef, row, 2));
+    result.extends = value(TypeDef, row, 3);
+    result.fieldList = value(TypeDef, row, 4);
+    result.methodList = value(TypeDef, row, 5);
+    return result;
+}
+
+PEClrMetadata::MethodDefRow PEClrMetadata::methodDef(quint32 row) const
+{
+    MethodDefRow result;
+    result.rva = value(MethodDef, row, 0);
+    result.implFlags = static_cast<quint16>(value(MethodDef, row, 1));
+    result.flags = static_cast<quint16>(value(MethodDef, row, 2));
+    result.name = string(value(MethodDef, row, 3));
+    result.signature = value(MethodDef, row, 4);
+    result.paramList = value(MethodDef, row, 5);
+    return result;
+}
+
+PEClrMetadata::MemberRefRow PEClrMetadata::memberRef(quint32 row) const
+{
+    MemberRefRow result;
+    result.parent = value(MemberRef, row, 0);
+    result.name = string(value(MemberRef, row, 1));
+    result.signature = value(MemberRef, row, 2);
+    return result;
+}
+
+PEClrMetadata::AssemblyRefRow PEClrMetadata::assemblyRef(quint32 row) const
+{
+    AssemblyRefRow result;
+    result.majorVersion = static_cast<quint16>(value(AssemblyRef, row, 0));
+    result.minorVersion = static_cast<quint16>(value(AssemblyRef, row, 1));
+    result.buildNumber = static_cast<quint16>(value(AssemblyRef, row, 2));
+    result.revisionNumber = static_cast<quint16>(value(AssemblyRef, row, 3));
+    result.flags = value(AssemblyRef, row, 4);
+    result.publicKeyOrToken = blob(value(AssemblyRef, row, 5));
+    result.name = string(value(AssemblyRef, row, 6));
+    result.culture = string(value(AssemblyRef, row, 7));
+    return result;
+}
+
+PEClrMetadata::ManifestResourceRow PEClrMetadata::manifestResource(quint32 row) const
+{
+    ManifestResourceRow result;
+    result.offset = value(ManifestResource, row, 0);
+    result.flags = value(ManifestResource, row, 1);
+    result.name = string(value(ManifestResource, row, 2));
+    result.implementation = value(ManifestResource, row, 3);
+    return result;
+}
+
+QString PEClrMetadata::assemblyName() const
+{
+    return rowCount(Assembly) > 0 ? string(value(Assembly, 1, 7)) : QString();
+}
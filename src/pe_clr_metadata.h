@@ -0,0 +1,167 @@
+/**
+ * @file pe_clr_metadata.h
+ * @brief Lazy reader for .NET (ECMA-335) metadata
+ *
+ * The COR20 header points at the metadata root ("BSJB"), which lists the
+ * streams: #~ (or the uncompressed #-) with the tables, and the #Strings,
+ * #US, #GUID and #Blob heaps they index into.
+ *
+ * open() only reads the root, the stream headers and the table stream
+ * header. From the row counts and heap sizes it derives the byte layout of
+ * every table, so any cell can later be located with a multiply and an add.
+ * Rows are decoded when asked for; nothing is materialized up front, which
+ * keeps obfuscated assemblies with millions of rows cheap to open.
+ *
+ * The reader keeps a shallow (implicitly shared) copy of the file buffer.
+ * Heap strings are decoded on request, and blob() returns a view into that
+ * buffer without copying it.
+ */
+
+#ifndef PE_CLR_METADATA_H
+#define PE_CLR_METADATA_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QUuid>
+#include <QtGlobal>
+
+class PEClrMetadata
+{
+public:
+    // Table IDs from ECMA-335 II.22; only the ones with typed accessors are named
+    enum Table : quint8 {
+        Module = 0x00,
+        TypeRef = 0x01,
+        TypeDef = 0x02,
+        Field = 0x04,
+        MethodDef = 0x06,
+        Param = 0x08,
+        MemberRef = 0x0A,
+        CustomAttribute = 0x0C,
+        StandAloneSig = 0x11,
+        ModuleRef = 0x1A,
+        TypeSpec = 0x1B,
+        Assembly = 0x20,
+        AssemblyRef = 0x23,
+        ManifestResource = 0x28,
+        GenericParam = 0x2A,
+        MethodSpec = 0x2B
+    };
+    static const int TABLE_COUNT = 0x2D;    ///< Tables with a layout defined by ECMA-335
+    static const int MAX_COLUMNS = 9;
+
+    struct Stream {
+        QString name;
+        quint32 fileOffset = 0;
+        quint32 size = 0;
+    };
+
+    struct TypeDefRow {
+        quint32 flags = 0;
+        QString name;
+        QString typeNamespace;
+        quint32 extends = 0;            ///< TypeDefOrRef coded index
+        quint32 fieldList = 0;          ///< First row in Field
+        quint32 methodList = 0;         ///< First row in MethodDef
+    };
+
+    struct MethodDefRow {
+        quint32 rva = 0;                ///< 0 for abstract, runtime and P/Invoke methods
+        quint16 implFlags = 0;
+        quint16 flags = 0;
+        QString name;
+        quint32 signature = 0;          ///< #Blob index
+        quint32 paramList = 0;          ///< First row in Param
+    };
+
+    struct MemberRefRow {
+        quint32 parent = 0;             ///< MemberRefParent coded index
+        QString name;
+        quint32 signature = 0;          ///< #Blob index
+    };
+
+    struct AssemblyRefRow {
+        quint16 majorVersion = 0;
+        quint16 minorVersion = 0;
+        quint16 buildNumber = 0;
+        quint16 revisionNumber = 0;
+        quint32 flags = 0;
+        QByteArray publicKeyOrToken;
+        QString name;
+        QString culture;
+    };
+
+    struct ManifestResourceRow {
+        quint32 offset = 0;             ///< Into the COR20 Resources directory when embedded
+        quint32 flags = 0;
+        QString name;
+        quint32 implementation = 0;     ///< Implementation coded index; 0 for embedded resources
+    };
+
+    PEClrMetadata() = default;
+
+    /**
+     * @brief Reads the metadata root and table layout
+     * @param fileData File contents; shared, not copied
+     * @param fileOffset File offset of the metadata root
+     * @param size Size from the COR20 MetaData directory
+     * @return A reader with isValid() == false if the root is malformed
+     */
+    static PEClrMetadata open(const QByteArray &fileData, quint32 fileOffset, quint32 size);
+
+    bool isValid() const { return m_valid; }
+    QString version() const { return m_version; }
+    const QList<Stream>& streams() const { return m_streams; }
+    bool isUncompressed() const { return m_uncompressed; }   ///< Tables come from a #- stream
+    bool isTruncated() const { return m_truncated; }         ///< Some rows lie past the stream end
+
+    quint32 rowCount(int table) const;
+
+    /**
+     * @brief Raw value of one cell
+     * @param row 1-based, as in metadata tokens
+     * @return 0 for a row or column that does not exist
+     */
+    quint32 value(int table, quint32 row, int column) const;
+
+    QString string(quint32 index) const;        ///< #Strings, UTF-8
+    QString userString(quint32 index) const;    ///< #US, UTF-16 literals from ldstr
+    QUuid guid(quint32 index) const;            ///< #GUID, 1-based
+    QByteArray blob(quint32 index) const;       ///< #Blob, a view into the file buffer
+
+    TypeDefRow typeDef(quint32 row) const;
+    MethodDefRow methodDef(quint32 row) const;
+    MemberRefRow memberRef(quint32 row) const;
+    AssemblyRefRow assemblyRef(quint32 row) const;
+    ManifestResourceRow manifestResource(quint32 row) const;
+
+    /**
+     * @brief Name of the assembly from the Assembly table, empty for a netmodule
+     */
+    QString assemblyName() const;
+
+private:
+    bool parseTableStream(quint32 fileOffset, quint32 size);
+    quint32 readUInt(quint64 fileOffset, int size) const;
+
+    QByteArray m_data;
+    bool m_valid = false;
+    bool m_uncompressed = false;
+    bool m_truncated = false;
+    QString m_version;
+    QList<Stream> m_streams;
+
+    Stream m_stringHeap;
+    Stream m_userStringHeap;
+    Stream m_guidHeap;
+    Stream m_blobHeap;
+
+    quint32 m_rowCounts[TABLE_COUNT] = {};
+    quint64 m_tableOffsets[TABLE_COUNT] = {};
+    quint32 m_rowSizes[TABLE_COUNT] = {};
+    quint8 m_columnOffsets[TABLE_COUNT][MAX_COLUMNS] = {};
+    quint8 m_columnSizes[TABLE_COUNT][MAX_COLUMNS] = {};
+};
+
+#endif // PE_CLR_METADATA_H
@@ -0,0 +1,263 @@
+/**
+ * @file pe_command_line.cpp
+ * @brief Headless command-line mode implementation
+ */
+
+#include "pe_command_line.h"
+#include "pe_parser_new.h"
+#include "pe_hash_index.h"
+#include "pe_export_index.h"
+#include "language_manager.h"
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <cstring>
+#include <cstdio>
+
+// "-" names standard input, so images can be piped in from other tools
+static bool loadInput(PEParserNew &peParser, const QString &path)
+{
+    if (path != QLatin1String("-")) {
+        return peParser.loadFile(path);
+    }
+    QFile input;
+    if (!input.open(stdin, QIODevice::ReadOnly)) {
+        return false;
+    }
+    return peParser.loadFromDevice(&input, path);
+}
+
+bool PECommandLine::isCommandLineInvocation(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--hash") == 0 ||
+            std::strcmp(argv[i], "--find-imphash") == 0 ||
+            std::strcmp(argv[i], "--find-exphash") == 0 ||
+            std::strcmp(argv[i], "--find-richhash") == 0 ||
+            std::strcmp(argv[i], "--find-pdb") == 0 ||
+            std::strcmp(argv[i], "--find-similar") == 0 ||
+            std::strcmp(argv[i], "--build-export-index") == 0 ||
+            std::strcmp(argv[i], "--json") == 0 ||
+            std::strcmp(argv[i], "--trace") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int PECommandLine::run(const QStringList &arguments)
+{
+    LanguageManager::getInstance().initialize();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(LANG("UI/cli_description"));
+    parser.addHelpOption();
+
+    QCommandLineOption hashOption("hash", LANG("UI/cli_option_hash"));
+    QCommandLineOption findImportOption("find-imphash", LANG("UI/cli_option_find_imphash"), "hash");
+    QCommandLineOption findExportOption("find-exphash", LANG("UI/cli_option_find_exphash"), "hash");
+    QCommandLineOption findRichOption("find-richhash", LANG("UI/cli_option_find_richhash"), "hash");
+    QCommandLineOption findPdbOption("find-pdb", LANG("UI/cli_option_find_pdb"), "key");
+    QCommandLineOption findSimilarOption("find-similar", LANG("UI/cli_option_find_similar"), "file");
+    QCommandLineOption maxDistanceOption("max-distance", LANG("UI/cli_option_max_distance"), "distance", "100");
+    QCommandLineOption indexOption("index", LANG("UI/cli_option_index"), "directory", PEHashIndex::defaultPath());
+    QCommandLineOption buildExportIndexOption("build-export-index", LANG("UI/cli_option_build_export_index"), "directory");
+    QCommandLineOption exportIndexOption("export-index", LANG("UI/cli_option_export_index"), "file", PEExportIndex::defaultPath());
+    QCommandLineOption jsonOption("json", LANG("UI/cli_option_json"));
+    QCommandLineOption traceOption("trace", LANG("UI/cli_option_trace"), "file");
+    QCommandLineOption memoryLimitOption("memory-limit", LANG("UI/cli_option_memory_limit"), "MB");
+    parser.addOption(hashOption);
+    parser.addOption(findImportOption);
+    parser.addOption(findExportOption);
+    parser.addOption(findRichOption);
+    parser.addOption(findPdbOption);
+    parser.addOption(findSimilarOption);
+    parser.addOption(maxDistanceOption);
+    parser.addOption(indexOption);
+    parser.addOption(buildExportIndexOption);
+    parser.addOption(exportIndexOption);
+    parser.addOption(jsonOption);
+    parser.addOption(traceOption);
+    parser.addOption(memoryLimitOption);
+    parser.addPositionalArgument("files", LANG("UI/cli_argument_files"), "[files...]");
+    parser.process(arguments);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    PEHashIndex index(parser.value(indexOption));
+
+    if (parser.isSet(buildExportIndexOption)) {
+        QString dllDirectory = parser.value(buildExportIndexOption);
+        int moduleCount = 0;
+        if (!PEExportIndex::build(dllDirectory, parser.value(exportIndexOption), &moduleCount)) {
+            err << LANG_PARAM("UI/cli_error_export_index_build", "directory", dllDirectory) << '\n';
+            return 1;
+        }
+        QMap<QString, QString> params;
+        params["modules"] = QString::number(moduleCount);
+        params["path"] = parser.value(exportIndexOption);
+        out << LANG_PARAMS("UI/cli_export_index_built", params) << '\n';
+        return 0;
+    }
+
+    // Mapped once and shared by every parser below
+    QSharedPointer<const PEExportIndex> exportIndex = PEExportIndex::load(parser.value(exportIndexOption));
+
+    // Files above the limit are parsed from a mapping in bounded memory
+    qint64 memoryLimit = 0;
+    if (parser.isSet(memoryLimitOption)) {
+        bool limitOk = false;
+        memoryLimit = parser.value(memoryLimitOption).toLongLong(&limitOk) * 1024 * 1024;
+        if (!limitOk || memoryLimit <= 0) {
+            parser.showHelp(1);
+        }
+    }
+
+    // Lookups only read one bucket file each
+    const QList<QPair<const QCommandLineOption*, PEHashIndex::HashKind>> lookups = {
+        {&findImportOption, PEHashIndex::HashKind::ImportHash},
+        {&findExportOption, PEHashIndex::HashKind::ExportHash},
+        {&findRichOption, PEHashIndex::HashKind::RichHash},
+        {&findPdbOption, PEHashIndex::HashKind::PdbKey}
+    };
+    for (const auto &lookup : lookups) {
+        if (parser.isSet(*lookup.first)) {
+            for (const QString &sample : index.findSamples(lookup.second, parser.value(*lookup.first))) {
+                out << sample << '\n';
+            }
+            return 0;
+        }
+    }
+
+    // Similarity search parses the probe file, then scans the digest list once
+    if (parser.isSet(findSimilarOption)) {
+        QString probePath = parser.value(findSimilarOption);
+        PEParserNew peParser;
+        peParser.setExportIndex(exportIndex);
+        if (memoryLimit > 0) {
+            peParser.setMemoryLimit(memoryLimit);
+        }
+        if (!loadInput(peParser, probePath)) {
+            err << LANG_PARAM("UI/cli_error_parse_failed", "file", probePath) << '\n';
+            return 1;
+        }
+        bool distanceOk = false;
+        int maxDistance = parser.value(maxDistanceOption).toInt(&distanceOk);
+        if (!distanceOk || maxDistance < 0) {
+            parser.showHelp(1);
+        }
+        QString digest = peParser.getFileContentDigest().similarityHash;
+        for (const auto &match : index.findSimilarSamples(digest, maxDistance)) {
+            out << match.first << ' ' << match.second << '\n';
+        }
+        return 0;
+    }
+
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    const bool json = parser.isSet(jsonOption);
+    const QString tracePath = parser.value(traceOption);
+    QJsonArray traceEvents;
+    int traceLane = 0;
+    QElapsedTimer runClock;
+    runClock.start();
+
+    int failures = 0;
+    for (const QString &filePath : files) {
+        PEParserNew peParser;
+        peParser.setExportIndex(exportIndex);
+        if (memoryLimit > 0) {
+            peParser.setMemoryLimit(memoryLimit);
+        }
+        const qint64 startUs = runClock.nsecsElapsed() / 1000;
+        const bool parsed = loadInput(peParser, filePath);
+        if (!tracePath.isEmpty()) {
+            // One lane per file, laid out on a shared time axis
+            peParser.getParseProfile().appendTraceEvents(traceEvents, ++traceLane, startUs, filePath);
+        }
+        if (!parsed) {
+            err << LANG_PARAM("UI/cli_error_parse_failed", "file", filePath) << '\n';
+            if (json) {
+                QJsonObject record;
+                record["path"] = filePath;
+                record["parsed"] = false;
+                record["profile"] = peParser.getParseProfile().toJson();
+                out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+            }
+            ++failures;
+            continue;
+        }
+
+        const QList<QPair<PEHashIndex::HashKind, QString>> hashes = {
+            {PEHashIndex::HashKind::ImportHash, peParser.getImportHash()},
+            {PEHashIndex::HashKind::ExportHash, peParser.getExportHash()},
+            {PEHashIndex::HashKind::RichHash, peParser.getRichHeaderHash()},
+            {PEHashIndex::HashKind::PdbKey, peParser.getPdbKey()}
+        };
+        if (json) {
+            // One object per line, so large batches can be streamed and grepped
+            QJsonObject record;
+            record["path"] = filePath;
+            record["parsed"] = true;
+            record["imphash"] = peParser.getImportHash();
+            record["exphash"] = peParser.getExportHash();
+            record["richhash"] = peParser.getRichHeaderHash();
+            record["pdbkey"] = peParser.getPdbKey();
+            record["overlay_offset"] = peParser.getOverlay().offset;
+            record["overlay_size"] = peParser.getOverlay().size;
+            QJsonArray embedded;
+            for (const PEDataModel::EmbeddedImage &image : peParser.getEmbeddedImages()) {
+                QJsonObject entry;
+                entry["offset"] = image.fileOffset;
+                entry["size"] = image.size;
+                entry["container"] = image.container;
+                entry["depth"] = image.depth;
+                entry["parsed"] = image.parsed;
+                entry["sha256"] = image.sha256;
+                entry["imphash"] = image.importHash;
+                embedded.append(entry);
+            }
+            record["embedded"] = embedded;
+            record["profile"] = peParser.getParseProfile().toJson();
+            out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+        } else {
+            for (const auto &hash : hashes) {
+                out << (hash.second.isEmpty() ? QStringLiteral("-") : hash.second) << ' ';
+            }
+            out << filePath << '\n';
+        }
+
+        // Piped input has no path to find it by again
+        if (filePath == QLatin1String("-")) {
+            continue;
+        }
+        for (const auto &hash : hashes) {
+            if (!hash.second.isEmpty() && !index.addSample(hash.first, hash.second, filePath)) {
+                err << LANG_PARAM("UI/cli_error_index_write", "directory", index.rootPath()) << '\n';
+            }
+        }
+        QString similarityHash = peParser.getFileContentDigest().similarityHash;
+        if (!similarityHash.isEmpty() && !index.addSimilarityDigest(similarityHash, filePath)) {
+            err << LANG_PARAM("UI/cli_error_index_write", "directory", index.rootPath()) << '\n';
+        }
+    }
+
+    if (!tracePath.isEmpty()) {
+        QFile traceFile(tracePath);
+        if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            traceFile.write(QJsonDocument(PEParseProfile::traceDocument(traceEvents)).toJson(QJsonDocument::Compact)) < 0) {
+            err << LANG_PARAM("UI/cli_error_trace_write", "file", tracePath) << '\n';
+            return 1;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
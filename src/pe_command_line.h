@@ -0,0 +1,64 @@
+/**
+ * @file pe_command_line.h
+ * @brief Headless command-line mode for batch processing
+ *
+ * Usage:
+ *   PEHint --hash [--index <dir>] <file>...
+ *       Prints "<imphash> <exphash> <richhash> <pdbkey> <path>" per file ("-"
+ *       when a hash does not apply) and records the hashes and the file's
+ *       similarity digest in the on-disk index.
+ *   PEHint --hash --json <file>...
+ *       Prints one JSON object per file instead: the hashes, the overlay
+ *       range, the PE images carved from the overlay and resources, and the
+ *       parse profile, i.e. duration, input bytes and peak memory growth of
+ *       every stage and data directory (see PEParseProfile).
+ *   PEHint --hash --trace <trace.json> <file>...
+ *       Also writes the stages of all files as a Chrome trace, one lane per
+ *       file, for chrome://tracing or ui.perfetto.dev.
+ *   PEHint --find-imphash <hash> [--index <dir>]
+ *   PEHint --find-exphash <hash> [--index <dir>]
+ *   PEHint --find-richhash <hash> [--index <dir>]
+ *       Prints every indexed sample that shares the hash.
+ *   PEHint --find-pdb <key> [--index <dir>]
+ *       Prints every indexed sample built with the same PDB. The key is the
+ *       symbol server key: GUID hex digits without separators followed by
+ *       the age in hex, e.g. 3844DBB920174967BE7AA4A2C20430FA2.
+ *   PEHint --find-similar <file> [--max-distance <n>] [--index <dir>]
+ *       Prints "<distance> <path>" for every indexed sample whose similarity
+ *       digest is within n (default 100) of the file's digest, closest first.
+ *
+ * --memory-limit <MB> parses files larger than this from a mapping in
+ * bounded memory instead of reading them whole (see PEParserNew).
+ *
+ * A file argument of "-" reads the image from standard input, e.g.
+ * "curl -s <url> | PEHint --hash -". Input beyond the memory limit is
+ * spilled to a temporary file (see PEByteSource). Piped samples are
+ * printed but not added to the index, since they have no path.
+ *
+ * Any invocation without one of these options starts the GUI as before.
+ */
+
+#ifndef PE_COMMAND_LINE_H
+#define PE_COMMAND_LINE_H
+
+#include <QStringList>
+
+class PECommandLine
+{
+public:
+    /**
+     * @brief Returns true if argv selects the headless mode
+     *
+     * Checked before any QApplication exists so batch runs never need a display.
+     */
+    static bool isCommandLineInvocation(int argc, char *argv[]);
+
+    /**
+     * @brief Runs the selected command
+     * @param arguments Full argument list including the program name
+     * @return Process exit code
+     */
+    static int run(const QStringList &arguments);
+};
+
+#endif // PE_COMMAND_LINE_H
@@ -0,0 +1,148 @@
+/**
+ * @file pe_content_statistics.cpp
+ * @brief Single-pass byte statistics implementation
+ */
+
+#include "pe_content_statistics.h"
+#include <array>
+
+namespace {
+
+// Printable ASCII plus tab, LF and CR
+constexpr std::array<bool, 256> makePrintableTable()
+{
+    std::array<bool, 256> table{};
+    for (int i = 0x20; i <= 0x7E; ++i) {
+        table[i] = true;
+    }
+    table['\t'] = true;
+    table['\n'] = true;
+    table['\r'] = true;
+    return table;
+}
+
+constexpr std::array<bool, 256> PRINTABLE = makePrintableTable();
+
+} // namespace
+
+PEContentStatistics::PEContentStatistics(Mode mode)
+    : m_mode(mode)
+    , m_md5(QCryptographicHash::Md5)
+    , m_sha256(QCryptographicHash::Sha256)
+    , m_zeroRunBytes(0)
+    , m_currentZeroRun(0)
+    , m_leadingZeroRun(0)
+    , m_seenNonZero(false)
+    , m_printableBytes(0)
+{
+}
+
+void PEContentStatistics::update(const char *data, qint64 size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    if (m_mode != Mode::Mergeable) {
+        m_md5.addData(QByteArrayView(data, size));
+        m_sha256.addData(QByteArrayView(data, size));
+    }
+    if (m_mode == Mode::OrderedHashes) {
+        m_fuzzyHash.updateChecksum(data, size);
+        return;
+    }
+    m_fuzzyHash.update(data, size);
+
+    const quint8 *bytes = reinterpret_cast<const quint8*>(data);
+    qint64 printable = 0;
+    for (qint64 i = 0; i < size; ++i) {
+        const quint8 byte = bytes[i];
+        printable += PRINTABLE[byte];
+        if (byte == 0) {
+            ++m_currentZeroRun;
+        } else {
+            if (!m_seenNonZero) {
+                m_leadingZeroRun = m_currentZeroRun;
+                m_seenNonZero = true;
+            }
+            if (m_currentZeroRun >= ZERO_RUN_MIN_LENGTH) {
+                m_zeroRunBytes += m_currentZeroRun;
+            }
+            m_currentZeroRun = 0;
+        }
+    }
+    m_printableBytes += printable;
+}
+
+void PEContentStatistics::append(const PEContentStatistics &next)
+{
+    m_fuzzyHash.append(next.m_fuzzyHash);
+    m_printableBytes += next.m_printableBytes;
+
+    if (!next.m_seenNonZero) {
+        m_currentZeroRun += next.m_currentZeroRun;
+        return;
+    }
+
+    // next closed its leading run on its own; count the run joined across the boundary instead
+    const qint64 joined = m_currentZeroRun + next.m_leadingZeroRun;
+    m_zeroRunBytes += next.m_zeroRunBytes;
+    if (next.m_leadingZeroRun >= ZERO_RUN_MIN_LENGTH) {
+        m_zeroRunBytes -= next.m_leadingZeroRun;
+    }
+    if (joined >= ZERO_RUN_MIN_LENGTH) {
+        m_zeroRunBytes += joined;
+    }
+    if (!m_seenNonZero) {
+        m_leadingZeroRun = joined;
+        m_seenNonZero = true;
+    }
+    m_currentZeroRun = next.m_currentZeroRun;
+}
+
+PEDataModel::ContentDigest PEContentStatistics::result() const
+{
+    return digest(m_fuzzyHash, m_md5, m_sha256);
+}
+
+PEDataModel::ContentDigest PEContentStatistics::result(const PEContentStatistics &orderedHashes) const
+{
+    PEFuzzyHash fuzzyHash = m_fuzzyHash;
+    fuzzyHash.adoptChecksum(orderedHashes.m_fuzzyHash);
+    return digest(fuzzyHash, orderedHashes.m_md5, orderedHashes.m_sha256);
+}
+
+PEDataModel::ContentDigest PEContentStatistics::digest(const PEFuzzyHash &fuzzyHash, const QCryptographicHash &md5,
+                                                       const QCryptographicHash &sha256) const
+{
+    PEDataModel::ContentDigest digest;
+    digest.size = fuzzyHash.size();
+
+    const std::array<quint64, 256> &histogram = fuzzyHash.histogram();
+    digest.histogram = QVector<quint64>(histogram.begin(), histogram.end());
+    if (digest.size == 0) {
+        return digest;
+    }
+
+    digest.md5 = QString::fromLatin1(md5.result().toHex());
+    digest.sha256 = QString::fromLatin1(sha256.result().toHex());
+    digest.similarityHash = fuzzyHash.digest().toString();
+    digest.entropy = fuzzyHash.entropy();
+
+    // A run that reaches the end of the range has not been closed by update() yet
+    qint64 zeroRunBytes = m_zeroRunBytes;
+    if (m_currentZeroRun >= ZERO_RUN_MIN_LENGTH) {
+        zeroRunBytes += m_currentZeroRun;
+    }
+    const double totalBytes = static_cast<double>(digest.size);
+    digest.zeroRunCoverage = zeroRunBytes / totalBytes;
+    digest.printableRatio = m_printableBytes / totalBytes;
+    return digest;
+}
+
+PEDataModel::ContentDigest PEContentStatistics::analyzeData(const QByteArray &data)
+{
+    PEContentStatistics statistics;
+    statistics.update(data.constData(), data.size());
+    return statistics.result();
+}
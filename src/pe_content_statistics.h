@@ -0,0 +1,86 @@
+/**
+ * @file pe_content_statistics.h
+ * @brief Single-pass byte statistics for a file or section range
+ *
+ * One accumulator produces everything PEHint reports about a byte range:
+ * MD5 and SHA-256, the similarity digest and entropy from PEFuzzyHash, the
+ * byte histogram, how much of the range lies in long runs of zero bytes and
+ * the share of printable ASCII. Each byte is visited once, so ranges can be
+ * fed in chunks straight from disk.
+ *
+ * Instances are independent; the parser runs one per section on the
+ * global thread pool. Everything except the two hashes and the similarity
+ * digest's checksum also combines exactly across consecutive pieces (see
+ * append()), so the whole-file statistics are merged from the pieces, and
+ * only an OrderedHashes accumulator walks the file from front to back.
+ */
+
+#ifndef PE_CONTENT_STATISTICS_H
+#define PE_CONTENT_STATISTICS_H
+
+#include "pe_data_model.h"
+#include "pe_fuzzy_hash.h"
+#include <QByteArray>
+#include <QCryptographicHash>
+
+class PEContentStatistics
+{
+public:
+    /// Zero runs shorter than this (alignment, small gaps) do not count as padding
+    static constexpr qint64 ZERO_RUN_MIN_LENGTH = 16;
+
+    enum class Mode {
+        Full,               ///< Everything
+        Mergeable,          ///< Everything but MD5 and SHA-256, for pieces only ever appended
+        OrderedHashes       ///< Only MD5, SHA-256 and the digest checksum, fed in order
+    };
+
+    explicit PEContentStatistics(Mode mode = Mode::Full);
+
+    /**
+     * @brief Feeds the next chunk of the range
+     */
+    void update(const char *data, qint64 size);
+
+    /**
+     * @brief Adds the statistics of the range that directly follows this one
+     *
+     * Histogram, similarity buckets, printable share and zero runs (also
+     * those crossing the boundary) combine exactly; the hashes do not and
+     * come from result(const PEContentStatistics &).
+     */
+    void append(const PEContentStatistics &next);
+
+    /**
+     * @brief Statistics of the bytes seen so far
+     *
+     * Hashes are left empty for an empty range.
+     */
+    PEDataModel::ContentDigest result() const;
+
+    /**
+     * @brief Statistics of appended pieces, with the hashes of an OrderedHashes accumulator
+     */
+    PEDataModel::ContentDigest result(const PEContentStatistics &orderedHashes) const;
+
+    /**
+     * @brief Convenience wrapper for a complete in-memory buffer
+     */
+    static PEDataModel::ContentDigest analyzeData(const QByteArray &data);
+
+private:
+    PEDataModel::ContentDigest digest(const PEFuzzyHash &fuzzyHash, const QCryptographicHash &md5,
+                                      const QCryptographicHash &sha256) const;
+
+    Mode m_mode;
+    PEFuzzyHash m_fuzzyHash;          ///< Also owns the byte histogram
+    QCryptographicHash m_md5;
+    QCryptographicHash m_sha256;
+    qint64 m_zeroRunBytes;            ///< Bytes inside finished runs of at least ZERO_RUN_MIN_LENGTH
+    qint64 m_currentZeroRun;
+    qint64 m_leadingZeroRun;          ///< Zero bytes before the first non-zero one, once one was seen
+    bool m_seenNonZero;
+    qint64 m_printableBytes;
+};
+
+#endif // PE_CONTENT_STATISTICS_H
@@ -1,13 +1,27 @@
 #include "pe_data_directory_parser.h"
 #include "pe_utils.h"
+#include "pe_fingerprint.h"
+#include "pe_export_index.h"
+#include "pe_parse_profile.h"
 #include "language_manager.h"
 #include <QDebug>
 #include <QtGlobal>
 #include <QHash>
+#include <QSet>
+#include <cstddef>
 #include <cstring>
+#include <algorithm>
 
 namespace {
 constexpr int MAX_EXPORT_FUNCTIONS_LIMIT = 10000;
+
+// Stage names for the parse profile, by data directory index
+const char *const DIRECTORY_STAGE_NAMES[16] = {
+    "directory/export", "directory/import", "directory/resource", "directory/exception",
+    "directory/security", "directory/basereloc", "directory/debug", "directory/architecture",
+    "directory/globalptr", "directory/tls", "directory/load_config", "directory/bound_import",
+    "directory/iat", "directory/delay_import", "directory/clr", "directory/reserved"
+};
 }
 
 #ifndef IMAGE_ORDINAL_FLAG32
@@ -34,7 +48,8 @@ bool PEDataDirectoryParser::parseDataDirectories(const IMAGE_OPTIONAL_HEADER *op
     // Data directories start immediately after the optional header
     // According to Microsoft: "The data directory is the last part of the optional header"
     if (dataDirectoryOffset + 16 * sizeof(IMAGE_DATA_DIRECTORY) > static_cast<quint32>(m_fileData.size())) {
-        qWarning() << "Data directory table extends beyond file size";
+        dataModel.reportDiagnostic(PEErrorType::TableTruncated, dataDirectoryOffset,
+                                   "Data directory table extends beyond file size");
         return false;
     }
 
@@ -47,71 +62,81 @@ bool PEDataDirectoryParser::parseDataDirectories(const IMAGE_OPTIONAL_HEADER *op
         const IMAGE_DATA_DIRECTORY &dir = dataDirectories[i];
         
         if (dir.VirtualAddress != 0 && dir.Size != 0) {
+            PEParseProfile::Scope stage(m_profile, QLatin1String(DIRECTORY_STAGE_NAMES[i]), dir.Size,
+                                        QStringLiteral("directory"));
+            bool parsed = true;
             switch (i) {
                 case 0: // Export Directory
-                    parseExportDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseExportDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 1: // Import Directory
-                    parseImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 2: // Resource Directory
-                    parseResourceDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseResourceDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 3: // Exception Directory
-                    parseExceptionDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseExceptionDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 4: // Certificate Directory
-                    parseCertificateDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseCertificateDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 5: // Base Relocation Directory
-                    parseBaseRelocationDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseBaseRelocationDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 6: // Debug Directory
-                    parseDebugDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseDebugDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 7: // Architecture Directory
-                    parseArchitectureDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseArchitectureDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 8: // Global Pointer Directory
-                    parseGlobalPointerDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseGlobalPointerDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 9: // TLS Directory
-                    parseTLSDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseTLSDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 10: // Load Configuration Directory
-                    parseLoadConfigDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseLoadConfigDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 11: // Bound Import Directory
-                    parseBoundImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseBoundImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 12: // Import Address Table Directory
-                    parseImportAddressTableDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseImportAddressTableDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 13: // Delay Import Directory
-                    parseDelayImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseDelayImportDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 14: // COM+ Runtime Header Directory
-                    parseCOMRuntimeDirectory(dir.VirtualAddress, dir.Size, dataModel);
+                    parsed = parseCOMRuntimeDirectory(dir.VirtualAddress, dir.Size, dataModel);
                     break;
                     
                 case 15: // Reserved Directory
                     // Reserved for future use
                     break;
             }
+            
+            if (!parsed) {
+                dataModel.reportDiagnostic(PEErrorType::DataDirectoryCorrupted,
+                                           dataDirectoryOffset + i * sizeof(IMAGE_DATA_DIRECTORY),
+                                           QString("Data directory %1 (RVA 0x%2, size %3) could not be parsed")
+                                               .arg(i).arg(dir.VirtualAddress, 8, 16, QChar('0')).arg(dir.Size));
+            }
         }
     }
     
@@ -123,7 +148,7 @@ bool PEDataDirectoryParser::parseExportDirectory(quint32 rva, quint32 size, PEDa
     if (rva == 0 || size == 0) return true;
     
     quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
-    if (fileOffset == 0) return false;
+    if (fileOffset == 0 || static_cast<quint64>(fileOffset) + sizeof(IMAGE_EXPORT_DIRECTORY) > static_cast<quint64>(m_fileData.size())) return false;
     
     const IMAGE_EXPORT_DIRECTORY *exportDir = reinterpret_cast<const IMAGE_EXPORT_DIRECTORY*>(
         m_fileData.data() + fileOffset
@@ -135,8 +160,12 @@ bool PEDataDirectoryParser::parseExportDirectory(quint32 rva, quint32 size, PEDa
         return true;
     }
 
+    // Only the entries that will be read are checked; a forged NumberOfFunctions
+    // would otherwise overflow the 32-bit end offset and pass the check
+    quint32 maxFunctions = qMin(exportDir->NumberOfFunctions, static_cast<quint32>(MAX_EXPORT_FUNCTIONS_LIMIT));
     quint32 functionsOffset = rvaToFileOffset(exportDir->AddressOfFunctions, dataModel.getSections());
-    if (functionsOffset == 0 || functionsOffset + exportDir->NumberOfFunctions * sizeof(quint32) > static_cast<quint32>(m_fileData.size())) {
+    if (functionsOffset == 0 ||
+        static_cast<quint64>(functionsOffset) + maxFunctions * sizeof(quint32) > static_cast<quint64>(m_fileData.size())) {
         dataModel.setExportFunctions(exportFunctions);
         return true;
     }
@@ -147,11 +176,13 @@ bool PEDataDirectoryParser::parseExportDirectory(quint32 rva, quint32 size, PEDa
     if (exportDir->AddressOfNames != 0 && exportDir->AddressOfNameOrdinals != 0) {
         quint32 namesOffset = rvaToFileOffset(exportDir->AddressOfNames, dataModel.getSections());
         quint32 ordinalsOffset = rvaToFileOffset(exportDir->AddressOfNameOrdinals, dataModel.getSections());
-        if (namesOffset != 0 && ordinalsOffset != 0) {
+        quint32 nameCount = qMin(exportDir->NumberOfNames, static_cast<quint32>(MAX_EXPORT_FUNCTIONS_LIMIT));
+        if (namesOffset != 0 && ordinalsOffset != 0 &&
+            static_cast<quint64>(namesOffset) + nameCount * sizeof(quint32) <= static_cast<quint64>(m_fileData.size()) &&
+            static_cast<quint64>(ordinalsOffset) + nameCount * sizeof(quint16) <= static_cast<quint64>(m_fileData.size())) {
             const quint32 *nameRVAs = reinterpret_cast<const quint32*>(m_fileData.constData() + namesOffset);
             const quint16 *nameOrdinals = reinterpret_cast<const quint16*>(m_fileData.constData() + ordinalsOffset);
-            quint32 maxNames = qMin(exportDir->NumberOfNames, static_cast<quint32>(MAX_EXPORT_FUNCTIONS_LIMIT));
-            for (quint32 i = 0; i < maxNames; ++i) {
+            for (quint32 i = 0; i < nameCount; ++i) {
                 quint16 funcIndex = nameOrdinals[i];
                 if (funcIndex >= exportDir->NumberOfFunctions) {
                     continue;
@@ -164,7 +195,6 @@ bool PEDataDirectoryParser::parseExportDirectory(quint32 rva, quint32 size, PEDa
         }
     }
 
-    quint32 maxFunctions = qMin(exportDir->NumberOfFunctions, static_cast<quint32>(MAX_EXPORT_FUNCTIONS_LIMIT));
     for (quint32 i = 0; i < maxFunctions; ++i) {
         PEDataModel::ExportFunctionEntry entry;
         entry.ordinal = static_cast<quint16>(exportDir->OrdinalBase + i);
@@ -174,10 +204,15 @@ bool PEDataDirectoryParser::parseExportDirectory(quint32 rva, quint32 size, PEDa
         if (entry.name.isEmpty()) {
             entry.name = QStringLiteral("[ - ]");
         }
+        // An address inside the export directory is a "DLL.Function" string, not code
+        if (entry.rva >= rva && entry.rva - rva < size) {
+            entry.forwarder = readStringFromRVA(entry.rva, dataModel.getSections());
+        }
         exportFunctions.append(entry);
     }
 
     dataModel.setExportFunctions(exportFunctions);
+    dataModel.setExportHash(PEFingerprint::calculateExportHash(exportFunctions));
     
     return true;
 }
@@ -191,85 +226,140 @@ bool PEDataDirectoryParser::parseImportDirectory(quint32 rva, quint32 size, PEDa
     
     QStringList imports;
     QMap<QString, QList<PEDataModel::ImportFunctionEntry>> importDetails;
+    QStringList importHashEntries; // Kept in descriptor order; the map above is sorted
 
     const IMAGE_OPTIONAL_HEADER *optionalHeader = dataModel.getOptionalHeader();
     bool isPE64 = optionalHeader && optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC;
 
-    const IMAGE_IMPORT_DESCRIPTOR *importDesc = reinterpret_cast<const IMAGE_IMPORT_DESCRIPTOR*>(
-        m_fileData.data() + fileOffset
-    );
+    // The table has no count; it ends at a null descriptor, which a truncated
+    // or forged file may not have before the end of the data
+    const quint64 fileSize = static_cast<quint64>(m_fileData.size());
+    quint64 descriptorPos = fileOffset;
+    IMAGE_IMPORT_DESCRIPTOR importDesc = {};
     
     int descriptorCount = 0;
-    while (importDesc->Name != 0 && descriptorCount < 1000) { // Safety limit
+    while (descriptorCount < MAX_IMPORT_DESCRIPTORS) { // Safety limit
+        if (descriptorPos + sizeof(IMAGE_IMPORT_DESCRIPTOR) > fileSize) {
+            break;
+        }
+        std::memcpy(&importDesc, m_fileData.constData() + descriptorPos, sizeof(importDesc));
+        if (importDesc.Name == 0) {
+            break;
+        }
+        
         // Read DLL name from RVA
-        QString dllName = readStringFromRVA(importDesc->Name, dataModel.getSections());
+        QString dllName = readStringFromRVA(importDesc.Name, dataModel.getSections());
         if (!dllName.isEmpty()) {
             imports.append(dllName);
             
-            QList<PEDataModel::ImportFunctionEntry> functions;
-
-            quint32 nameTableRVA = (importDesc->OriginalFirstThunk != 0) ? importDesc->OriginalFirstThunk : importDesc->FirstThunk;
-            quint32 thunkTableRVA = (importDesc->FirstThunk != 0) ? importDesc->FirstThunk : nameTableRVA;
-
-            quint32 nameTableOffset = (nameTableRVA != 0) ? rvaToFileOffset(nameTableRVA, dataModel.getSections()) : 0;
-            quint32 thunkTableOffset = (thunkTableRVA != 0) ? rvaToFileOffset(thunkTableRVA, dataModel.getSections()) : 0;
-
-            if (nameTableOffset != 0 && nameTableOffset < static_cast<quint32>(m_fileData.size())) {
-                const char *tablePtr = m_fileData.constData() + nameTableOffset;
-                int entrySize = isPE64 ? static_cast<int>(sizeof(quint64)) : static_cast<int>(sizeof(quint32));
-
-                for (int index = 0; ; ++index) {
-                    qsizetype nameEntryOffset = index * entrySize;
-                    qsizetype remaining = m_fileData.size() - static_cast<qsizetype>(nameTableOffset);
-                    if (nameEntryOffset + entrySize > remaining) {
-                        break;
-                    }
-
-                    quint64 rawValue = 0;
-                    std::memcpy(&rawValue, tablePtr + nameEntryOffset, entrySize);
-                    if (rawValue == 0) {
-                        break;
-                    }
-
-                    quint32 thunkEntryRVA = thunkTableRVA + static_cast<quint32>(index * entrySize);
-                    quint32 thunkEntryOffset = rvaToFileOffset(thunkEntryRVA, dataModel.getSections());
-
-                    PEDataModel::ImportFunctionEntry entry;
-                    entry.thunkRVA = thunkEntryRVA;
-                    entry.thunkOffset = thunkEntryOffset;
-
-                    bool importByOrdinal = (isPE64 && (rawValue & IMAGE_ORDINAL_FLAG64)) || (!isPE64 && (rawValue & IMAGE_ORDINAL_FLAG32));
-                    if (importByOrdinal) {
-                        quint16 ordinal = static_cast<quint16>(rawValue & 0xFFFF);
-                        entry.importedByOrdinal = true;
-                        entry.ordinal = ordinal;
-                        entry.name = QStringLiteral("[ - ]");
-                    } else {
-                        quint32 importByNameRVA = static_cast<quint32>(rawValue & 0xFFFFFFFF);
-                        QString functionName = readStringFromRVA(importByNameRVA + 2, dataModel.getSections());
-                        if (functionName.isEmpty()) {
-                            functionName = QStringLiteral("0x%1").arg(importByNameRVA, 0, 16).toUpper();
-                        }
-                        entry.name = functionName;
-                    }
-
-                    functions.append(entry);
+            quint32 nameTableRVA = (importDesc.OriginalFirstThunk != 0) ? importDesc.OriginalFirstThunk : importDesc.FirstThunk;
+            quint32 thunkTableRVA = (importDesc.FirstThunk != 0) ? importDesc.FirstThunk : nameTableRVA;
+            QList<PEDataModel::ImportFunctionEntry> functions =
+                readImportThunks(dllName, nameTableRVA, thunkTableRVA, isPE64, 0, dataModel.getSections());
+
+            for (const PEDataModel::ImportFunctionEntry &entry : functions) {
+                QString hashEntry = PEFingerprint::importHashEntry(dllName, entry);
+                if (!hashEntry.isEmpty()) {
+                    importHashEntries.append(hashEntry);
                 }
             }
 
             importDetails[dllName] = functions;
         }
         
-        importDesc++;
+        descriptorPos += sizeof(IMAGE_IMPORT_DESCRIPTOR);
         descriptorCount++;
     }
+    if (descriptorCount >= MAX_IMPORT_DESCRIPTORS) {
+        dataModel.reportDiagnostic(PEErrorType::LimitExceeded, fileOffset,
+                                   QString("Import directory truncated at %1 descriptors").arg(MAX_IMPORT_DESCRIPTORS));
+    }
     
     dataModel.setImports(imports);
     dataModel.setImportFunctions(importDetails);
+    dataModel.setImportHash(PEFingerprint::calculateImportHash(importHashEntries));
     
     return true;
 }
 
+QList<PEDataModel::ImportFunctionEntry> PEDataDirectoryParser::readImportThunks(const QString &dllName, quint32 nameTableRVA, quint32 thunkTableRVA,
+                                                                          bool isPE64, quint64 addressBase,
+                                                                          const QList<const IMAGE_SECTION_HEADER*> &sections) const
+{
+    QList<PEDataModel::ImportFunctionEntry> functions;
+
+    quint32 nameTableOffset = (nameTableRVA != 0) ? rvaToFileOffset(nameTableRVA, sections) : 0;
+    if (nameTableOffset == 0 || nameTableOffset >= static_cast<quint32>(m_fileData.size())) {
+        return functions;
+    }
+
+    const char *tablePtr = m_fileData.constData() + nameTableOffset;
+    int entrySize = isPE64 ? static_cast<int>(sizeof(quint64)) : static_cast<int>(sizeof(quint32));
+
+    for (int index = 0; ; ++index) {
+        qsizetype nameEntryOffset = index * entrySize;
+        qsizetype remaining = m_fileData.size() - static_cast<qsizetype>(nameTableOffset);
+        if (nameEntryOffset + entrySize > remaining) {
+            break;
+        }
+
+        quint64 rawValue = 0;
+        std::memcpy(&rawValue, tablePtr + nameEntryOffset, entrySize);
+        if (rawValue == 0) {
+            break;
+        }
+
+        quint32 thunkEntryRVA = thunkTableRVA + static_cast<quint32>(index * entrySize);
+
+        PEDataModel::ImportFunctionEntry entry;
+        entry.thunkRVA = thunkEntryRVA;
+        entry.thunkOffset = rvaToFileOffset(thunkEntryRVA, sections);
+
+        bool importByOrdinal = (isPE64 && (rawValue & IMAGE_ORDINAL_FLAG64)) || (!isPE64 && (rawValue & IMAGE_ORDINAL_FLAG32));
+        if (importByOrdinal) {
+            entry.importedByOrdinal = true;
+            entry.ordinal = static_cast<quint16>(rawValue & 0xFFFF);
+            entry.name = QStringLiteral("[ - ]");
+        } else {
+            // VA-based delay import descriptors point at IMAGE_IMPORT_BY_NAME with VAs
+            quint32 importByNameRVA = static_cast<quint32>((rawValue - addressBase) & 0xFFFFFFFF);
+            QString functionName = rawValue > addressBase ? readStringFromRVA(importByNameRVA + 2, sections) : QString();
+            if (functionName.isEmpty()) {
+                functionName = QStringLiteral("0x%1").arg(importByNameRVA, 0, 16).toUpper();
+            }
+            entry.name = functionName;
+        }
+
+        if (m_exportIndex) {
+            QString forwarder;
+            if (entry.importedByOrdinal) {
+                QString exportName = m_exportIndex->nameForOrdinal(dllName, entry.ordinal);
+                if (!exportName.isEmpty()) {
+                    entry.name = exportName;
+                }
+                forwarder = m_exportIndex->forwarderForOrdinal(dllName, entry.ordinal);
+            } else {
+                forwarder = m_exportIndex->forwarderForName(dllName, entry.name);
+            }
+            if (!forwarder.isEmpty()) {
+                entry.forwardedTo = m_exportIndex->resolveForwarderChain(forwarder);
+            }
+        }
+
+        functions.append(entry);
+    }
+
+    return functions;
+}
+
+struct PEDataDirectoryParser::ResourceWalkContext {
+    quint32 resourceBase = 0;
+    const QList<const IMAGE_SECTION_HEADER*> *sections = nullptr;
+    QSet<quint32> visitedDirectories;
+    QHash<quint32, QString> nameCache;
+    QList<PEDataModel::ResourceEntry> entries;
+};
+
 bool PEDataDirectoryParser::parseResourceDirectory(quint32 rva, quint32 size, PEDataModel &dataModel)
 {
     if (rva == 0 || size == 0) return true;
@@ -277,57 +367,160 @@ bool PEDataDirectoryParser::parseResourceDirectory(quint32 rva, quint32 size, PE
     quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
     if (fileOffset == 0) return false;
     
+    // Walk the full Type -> Name -> Language tree. Only the leaf locations are
+    // recorded so large resource sections stay cheap to parse.
+    ResourceWalkContext context;
+    context.resourceBase = fileOffset;
+    context.sections = &dataModel.getSections();
+    walkResourceDirectory(0, 0, PEDataModel::ResourceEntry(), context);
+    if (context.entries.size() >= MAX_RESOURCE_ENTRIES) {
+        dataModel.reportDiagnostic(PEErrorType::LimitExceeded, fileOffset,
+                                   QString("Resource tree truncated at %1 entries").arg(MAX_RESOURCE_ENTRIES));
+    }
+    
+    // Keep the summary maps used by the rest of the application populated
     QStringList resourceTypes;
     QMap<QString, QMap<QString, QString>> resources;
+    QHash<quint32, QString> typeLabels;
+    const QString namedLabel = LANG("UI/resource_named");
+    const QString idLabel = LANG("UI/resource_id");
+    
+    for (const PEDataModel::ResourceEntry &entry : context.entries) {
+        QString resourceType = entry.typeName;
+        if (resourceType.isEmpty()) {
+            auto it = typeLabels.constFind(entry.typeId);
+            if (it == typeLabels.constEnd()) {
+                it = typeLabels.insert(entry.typeId, PEUtils::getResourceTypeName(entry.typeId));
+            }
+            resourceType = it.value();
+        }
+        if (!resources.contains(resourceType)) {
+            resourceTypes.append(resourceType);
+        }
+        
+        if (!entry.name.isEmpty()) {
+            resources[resourceType][entry.name] = namedLabel;
+        } else {
+            resources[resourceType][QString::number(entry.nameId)] = idLabel;
+        }
+    }
     
-    const IMAGE_RESOURCE_DIRECTORY *resourceDir = reinterpret_cast<const IMAGE_RESOURCE_DIRECTORY*>(
-        m_fileData.data() + fileOffset
-    );
+    dataModel.setResourceTypes(resourceTypes);
+    dataModel.setResources(resources);
+    dataModel.setResourceEntries(context.entries);
     
-    quint32 totalEntries = resourceDir->NumberOfNamedEntries + resourceDir->NumberOfIdEntries;
-    quint32 entryOffset = fileOffset + sizeof(IMAGE_RESOURCE_DIRECTORY);
+    return true;
+}
+
+void PEDataDirectoryParser::walkResourceDirectory(quint32 directoryOffset, 
+                                                  int depth, 
+                                                  const PEDataModel::ResourceEntry &path, 
+                                                  ResourceWalkContext &context)
+{
+    if (depth >= MAX_RESOURCE_DEPTH || context.entries.size() >= MAX_RESOURCE_ENTRIES) {
+        return;
+    }
     
-    for (quint32 i = 0; i < totalEntries && i < MAX_RESOURCE_ENTRIES; ++i) {
-        const IMAGE_RESOURCE_DIRECTORY_ENTRY *entry = reinterpret_cast<const IMAGE_RESOURCE_DIRECTORY_ENTRY*>(
-            m_fileData.data() + entryOffset
-        );
-        
-        QString resourceType = PEUtils::getResourceTypeName(entry->getName());
-        resourceTypes.append(resourceType);
+    // A directory reached twice means the tree loops back on itself
+    if (context.visitedDirectories.contains(directoryOffset)) {
+        return;
+    }
+    context.visitedDirectories.insert(directoryOffset);
+    
+    const quint64 fileSize = static_cast<quint64>(m_fileData.size());
+    const quint64 directoryPos = static_cast<quint64>(context.resourceBase) + directoryOffset;
+    if (directoryPos + sizeof(IMAGE_RESOURCE_DIRECTORY) > fileSize) {
+        return;
+    }
+    
+    IMAGE_RESOURCE_DIRECTORY directory;
+    std::memcpy(&directory, m_fileData.constData() + directoryPos, sizeof(directory));
+    
+    quint64 entryPos = directoryPos + sizeof(IMAGE_RESOURCE_DIRECTORY);
+    quint64 totalEntries = static_cast<quint64>(directory.NumberOfNamedEntries) + directory.NumberOfIdEntries;
+    totalEntries = qMin(totalEntries, (fileSize - entryPos) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+    
+    for (quint64 i = 0; i < totalEntries && context.entries.size() < MAX_RESOURCE_ENTRIES; ++i) {
+        IMAGE_RESOURCE_DIRECTORY_ENTRY entry;
+        std::memcpy(&entry, m_fileData.constData() + entryPos + i * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), sizeof(entry));
         
-        // Check if this is a directory or data entry
-        if (entry->getOffsetToData() & 0x80000000) {
-            // Directory entry
-            if (entry->getName() != 0) {
-                quint32 nameOffset = fileOffset + (entry->getName() & 0x7FFFFFFF);
-                if (nameOffset + 2 <= m_fileData.size()) {
-                    quint16 nameLength = *reinterpret_cast<const quint16*>(m_fileData.data() + nameOffset);
-                    if (nameOffset + 2 + nameLength * 2 <= m_fileData.size()) {
-                        const wchar_t* namePtr = reinterpret_cast<const wchar_t*>(m_fileData.data() + nameOffset + 2);
-                        QString resourceName = QString::fromWCharArray(namePtr, nameLength);
-                        resources[resourceType][resourceName] = LANG("UI/resource_named");
-                    } else {
-                        resources[resourceType][QString("Invalid Name")] = LANG("UI/resource_named");
-                    }
-                } else {
-                    resources[resourceType][QString("Invalid Name")] = LANG("UI/resource_named");
-                }
-            } else {
-                resources[resourceType][QString("Empty Name")] = LANG("UI/resource_named");
-            }
+        PEDataModel::ResourceEntry node = path;
+        quint32 id = 0;
+        QString name;
+        if (entry.isNameString()) {
+            name = readResourceName(entry.getName() & 0x7FFFFFFF, context);
         } else {
-            // Data entry
-            QString resourceId = QString::number(entry->getName());
-            resources[resourceType][resourceId] = LANG("UI/resource_id");
+            id = entry.getName() & 0xFFFF;
         }
         
-        entryOffset += sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+        switch (depth) {
+            case 0:
+                node.typeId = id;
+                node.typeName = name;
+                break;
+            case 1:
+                node.nameId = id;
+                node.name = name;
+                break;
+            default:
+                node.languageId = static_cast<quint16>(id);
+                break;
+        }
+        
+        quint32 childOffset = entry.getOffsetToData() & 0x7FFFFFFF;
+        if (entry.isDataDirectory()) {
+            walkResourceDirectory(childOffset, depth + 1, node, context);
+            continue;
+        }
+        
+        const quint64 dataEntryPos = static_cast<quint64>(context.resourceBase) + childOffset;
+        if (dataEntryPos + sizeof(IMAGE_RESOURCE_DATA_ENTRY) > fileSize) {
+            continue;
+        }
+        
+        IMAGE_RESOURCE_DATA_ENTRY dataEntry;
+        std::memcpy(&dataEntry, m_fileData.constData() + dataEntryPos, sizeof(dataEntry));
+        
+        node.dataRVA = dataEntry.OffsetToData;
+        node.size = dataEntry.Size;
+        node.codePage = dataEntry.CodePage;
+        node.fileOffset = rvaToFileOffset(dataEntry.OffsetToData, *context.sections);
+        context.entries.append(node);
+    }
+}
+
+QString PEDataDirectoryParser::readResourceName(quint32 nameOffset, ResourceWalkContext &context) const
+{
+    // The same name string is frequently shared by many entries
+    auto cached = context.nameCache.constFind(nameOffset);
+    if (cached != context.nameCache.constEnd()) {
+        return cached.value();
     }
     
-    dataModel.setResourceTypes(resourceTypes);
-    dataModel.setResources(resources);
+    const quint64 fileSize = static_cast<quint64>(m_fileData.size());
+    const quint64 namePos = static_cast<quint64>(context.resourceBase) + nameOffset;
+    QString name;
+    if (namePos + sizeof(quint16) <= fileSize) {
+        quint16 nameLength = 0;
+        std::memcpy(&nameLength, m_fileData.constData() + namePos, sizeof(nameLength));
+        if (namePos + sizeof(quint16) + nameLength * sizeof(char16_t) <= fileSize) {
+            name = QString::fromUtf16(reinterpret_cast<const char16_t*>(m_fileData.constData() + namePos + sizeof(quint16)),
+                                      nameLength);
+        }
+    }
     
-    return true;
+    context.nameCache.insert(nameOffset, name);
+    return name;
+}
+
+QByteArray PEDataDirectoryParser::readResourceData(const PEDataModel::ResourceEntry &entry) const
+{
+    if (entry.fileOffset == 0 || entry.fileOffset >= static_cast<quint64>(m_fileData.size())) {
+        return QByteArray();
+    }
+    
+    quint64 available = static_cast<quint64>(m_fileData.size()) - entry.fileOffset;
+    return m_fileData.mid(entry.fileOffset, static_cast<qsizetype>(qMin<quint64>(entry.size, available)));
 }
 
 bool PEDataDirectoryParser::parseDebugDirectory(quint32 rva, quint32 size, PEDataModel &dataModel)
@@ -339,52 +532,229 @@ bool PEDataDirectoryParser::parseDebugDirectory(quint32 rva, quint32 size, PEDat
     
     QStringList debugInfo;
     QMap<QString, QString> debugDetails;
+    QList<PEDataModel::DebugEntry> debugEntries;
     
     // Parse debug directory entries
     int entryCount = size / sizeof(IMAGE_DEBUG_DIRECTORY);
     for (int i = 0; i < entryCount && i < MAX_DEBUG_ENTRIES; i++) {
         quint32 entryOffset = fileOffset + (i * sizeof(IMAGE_DEBUG_DIRECTORY));
         if (entryOffset + sizeof(IMAGE_DEBUG_DIRECTORY) <= m_fileData.size()) {
-            const IMAGE_DEBUG_DIRECTORY *debugDir = reinterpret_cast<const IMAGE_DEBUG_DIRECTORY*>(
-                m_fileData.data() + entryOffset
-            );
+            IMAGE_DEBUG_DIRECTORY debugDir;
+            std::memcpy(&debugDir, m_fileData.constData() + entryOffset, sizeof(debugDir));
             
-            QString debugType = PEUtils::getDebugTypeName(debugDir->Type);
+            QString debugType = PEUtils::getDebugTypeName(debugDir.Type);
             QMap<QString, QString> debugParams;
-            debugParams["size"] = QString::number(debugDir->SizeOfData);
-            debugParams["rva"] = PEUtils::formatHex(debugDir->AddressOfRawData);
-            debugParams["raw"] = PEUtils::formatHex(debugDir->PointerToRawData);
+            debugParams["size"] = QString::number(debugDir.SizeOfData);
+            debugParams["rva"] = PEUtils::formatHex(debugDir.AddressOfRawData);
+            debugParams["raw"] = PEUtils::formatHex(debugDir.PointerToRawData);
             QString debugDetailsStr = LANG_PARAMS("UI/debug_details_format", debugParams);
             
             debugInfo.append(debugType);
             debugDetails[debugType] = debugDetailsStr;
+            PEDataModel::DebugEntry entry = decodeDebugEntry(debugDir);
+            entry.fileOffset = entryOffset;
+            debugEntries.append(entry);
         }
     }
     
     dataModel.setDebugInfo(debugInfo);
     dataModel.setDebugDetails(debugDetails);
+    dataModel.setDebugEntries(debugEntries);
     
     return true;
 }
 
+PEDataModel::DebugEntry PEDataDirectoryParser::decodeDebugEntry(const IMAGE_DEBUG_DIRECTORY &debugDir) const
+{
+    PEDataModel::DebugEntry entry;
+    entry.type = debugDir.Type;
+    entry.timeDateStamp = debugDir.TimeDateStamp;
+    entry.majorVersion = debugDir.MajorVersion;
+    entry.minorVersion = debugDir.MinorVersion;
+    entry.sizeOfData = debugDir.SizeOfData;
+    entry.addressOfRawData = debugDir.AddressOfRawData;
+    entry.pointerToRawData = debugDir.PointerToRawData;
+    
+    // Clamp the payload to the file; every read below stays inside it
+    const quint64 fileSize = static_cast<quint64>(m_fileData.size());
+    if (debugDir.PointerToRawData == 0 || debugDir.PointerToRawData >= fileSize) {
+        return entry;
+    }
+    const char *payload = m_fileData.constData() + debugDir.PointerToRawData;
+    const quint32 payloadSize = static_cast<quint32>(qMin<quint64>(debugDir.SizeOfData, fileSize - debugDir.PointerToRawData));
+    auto readDword = [payload, payloadSize](quint32 offset, quint32 &value) {
+        if (static_cast<quint64>(offset) + sizeof(quint32) > payloadSize) {
+            return false;
+        }
+        std::memcpy(&value, payload + offset, sizeof(value));
+        return true;
+    };
+    auto readString = [payload, payloadSize](quint32 offset) {
+        if (offset >= payloadSize) {
+            return QString();
+        }
+        return QString::fromUtf8(payload + offset, static_cast<qsizetype>(qstrnlen(payload + offset, payloadSize - offset)));
+    };
+    
+    switch (debugDir.Type) {
+    case IMAGE_DEBUG_TYPE_CODEVIEW: {
+        quint32 signature = 0;
+        if (!readDword(0, signature)) {
+            break;
+        }
+        if (signature == CV_SIGNATURE_RSDS && payloadSize >= offsetof(CV_INFO_PDB70, PdbFileName)) {
+            // GUID fields are little-endian dwords/words followed by 8 plain bytes
+            quint32 data1 = 0;
+            quint16 data2 = 0;
+            quint16 data3 = 0;
+            const uchar *guid = reinterpret_cast<const uchar*>(payload + offsetof(CV_INFO_PDB70, Signature));
+            std::memcpy(&data1, guid, sizeof(data1));
+            std::memcpy(&data2, guid + 4, sizeof(data2));
+            std::memcpy(&data3, guid + 6, sizeof(data3));
+            QString tail = QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(guid + 8), 8).toHex().toUpper());
+            QString data1Hex = QString("%1").arg(data1, 8, 16, QChar('0')).toUpper();
+            QString data2Hex = QString("%1").arg(data2, 4, 16, QChar('0')).toUpper();
+            QString data3Hex = QString("%1").arg(data3, 4, 16, QChar('0')).toUpper();
+            readDword(offsetof(CV_INFO_PDB70, Age), entry.pdbAge);
+            entry.codeViewFormat = "RSDS";
+            entry.pdbGuid = QString("{%1-%2-%3-%4-%5}").arg(data1Hex, data2Hex, data3Hex, tail.left(4), tail.mid(4));
+            entry.pdbPath = readString(offsetof(CV_INFO_PDB70, PdbFileName));
+            entry.pdbKey = data1Hex + data2Hex + data3Hex + tail + QString::number(entry.pdbAge, 16).toUpper();
+        } else if (signature == CV_SIGNATURE_NB10 && payloadSize >= offsetof(CV_INFO_PDB20, PdbFileName)) {
+            quint32 pdbSignature = 0;
+            readDword(offsetof(CV_INFO_PDB20, Signature), pdbSignature);
+            readDword(offsetof(CV_INFO_PDB20, Age), entry.pdbAge);
+            entry.codeViewFormat = "NB10";
+            entry.pdbGuid = QString("%1").arg(pdbSignature, 8, 16, QChar('0')).toUpper();
+            entry.pdbPath = readString(offsetof(CV_INFO_PDB20, PdbFileName));
+            entry.pdbKey = entry.pdbGuid + QString::number(entry.pdbAge, 16).toUpper();
+        }
+        break;
+    }
+    case IMAGE_DEBUG_TYPE_POGO: {
+        // A signature dword, then (RVA, size, NUL-terminated name) records aligned to 4 bytes
+        quint32 signature = 0;
+        if (!readDword(0, signature)) {
+            break;
+        }
+        switch (signature) {
+        case POGO_SIGNATURE_LTCG: entry.pogoFormat = "LTCG"; break;
+        case POGO_SIGNATURE_PGU: entry.pogoFormat = "PGU"; break;
+        case POGO_SIGNATURE_PGI: entry.pogoFormat = "PGI"; break;
+        case POGO_SIGNATURE_PGO: entry.pogoFormat = "PGO"; break;
+        default: entry.pogoFormat = PEUtils::formatHex(signature); break;
+        }
+        quint32 offset = sizeof(quint32);
+        while (entry.pogoEntries.size() < MAX_POGO_ENTRIES) {
+            PEDataModel::PogoEntry pogo;
+            if (!readDword(offset, pogo.rva) || !readDword(offset + 4, pogo.size) || offset + 8 >= payloadSize) {
+                break;
+            }
+            quint32 nameLength = static_cast<quint32>(qstrnlen(payload + offset + 8, payloadSize - offset - 8));
+            pogo.name = QString::fromLatin1(payload + offset + 8, static_cast<qsizetype>(nameLength));
+            entry.pogoEntries.append(pogo);
+            offset = (offset + 8 + nameLength + 1 + 3) & ~3u;
+        }
+        break;
+    }
+    case IMAGE_DEBUG_TYPE_VC_FEATURE:
+        readDword(0, entry.preVC11Count);
+        readDword(4, entry.cAndCppCount);
+        readDword(8, entry.gsCount);
+        readDword(12, entry.sdlCount);
+        readDword(16, entry.guardNCount);
+        break;
+    case IMAGE_DEBUG_TYPE_REPRO: {
+        // Older linkers write no payload and put the hash in TimeDateStamp
+        quint32 hashLength = 0;
+        if (readDword(0, hashLength) && hashLength <= payloadSize - sizeof(quint32)) {
+            entry.reproHash = QByteArray(payload + sizeof(quint32), static_cast<qsizetype>(hashLength));
+        }
+        break;
+    }
+    case IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS:
+        readDword(0, entry.exDllCharacteristics);
+        break;
+    default:
+        break;
+    }
+    
+    return entry;
+}
+
 bool PEDataDirectoryParser::parseTLSDirectory(quint32 rva, quint32 size, PEDataModel &dataModel)
 {
     if (rva == 0 || size == 0) return true;
     
-    quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    quint32 fileOffset = rvaToFileOffset(rva, sections);
     if (fileOffset == 0) return false;
     
-    const IMAGE_TLS_DIRECTORY *tlsDir = reinterpret_cast<const IMAGE_TLS_DIRECTORY*>(
-        m_fileData.data() + fileOffset
-    );
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = dataModel.getOptionalHeader();
+    if (!optionalHeader) return false;
+    bool isPE64 = optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    quint32 directorySize = isPE64 ? sizeof(IMAGE_TLS_DIRECTORY64) : sizeof(IMAGE_TLS_DIRECTORY32);
+    if (static_cast<quint64>(fileOffset) + directorySize > static_cast<quint64>(m_fileData.size())) return false;
+    
+    quint64 imageBase = 0;
+    quint64 callbackArrayVA = 0;
+    quint32 zeroFill = 0;
+    if (isPE64) {
+        IMAGE_TLS_DIRECTORY64 tlsDir;
+        std::memcpy(&tlsDir, m_fileData.constData() + fileOffset, sizeof(tlsDir));
+        imageBase = reinterpret_cast<const IMAGE_OPTIONAL_HEADER64*>(optionalHeader)->ImageBase;
+        callbackArrayVA = tlsDir.AddressOfCallBacks;
+        zeroFill = tlsDir.SizeOfZeroFill;
+    } else {
+        IMAGE_TLS_DIRECTORY32 tlsDir;
+        std::memcpy(&tlsDir, m_fileData.constData() + fileOffset, sizeof(tlsDir));
+        imageBase = reinterpret_cast<const IMAGE_OPTIONAL_HEADER32*>(optionalHeader)->ImageBase;
+        callbackArrayVA = tlsDir.AddressOfCallBacks;
+        zeroFill = tlsDir.SizeOfZeroFill;
+    }
+    
+    // The array holds pointer-sized VAs up to a null entry. Only the raw data
+    // of the section that holds the array is read, and never past its end.
+    QList<PEDataModel::TLSCallbackEntry> callbacks;
+    int arraySection = -1;
+    if (callbackArrayVA > imageBase && callbackArrayVA - imageBase <= 0xFFFFFFFFULL) {
+        arraySection = findSectionIndex(static_cast<quint32>(callbackArrayVA - imageBase), sections);
+    }
+    if (arraySection >= 0) {
+        const IMAGE_SECTION_HEADER *section = sections[arraySection];
+        quint64 arrayOffset = static_cast<quint64>(section->PointerToRawData) +
+                              (static_cast<quint32>(callbackArrayVA - imageBase) - section->VirtualAddress);
+        quint64 arrayEnd = qMin<quint64>(static_cast<quint64>(section->PointerToRawData) + section->SizeOfRawData,
+                                         static_cast<quint64>(m_fileData.size()));
+        quint32 pointerSize = isPE64 ? sizeof(quint64) : sizeof(quint32);
+        
+        for (quint64 pos = arrayOffset; pos + pointerSize <= arrayEnd && callbacks.size() < MAX_TLS_CALLBACKS; pos += pointerSize) {
+            quint64 va = 0;
+            std::memcpy(&va, m_fileData.constData() + pos, pointerSize);
+            if (va == 0) {
+                break;
+            }
+            
+            PEDataModel::TLSCallbackEntry callback;
+            callback.fileOffset = static_cast<quint32>(pos);
+            callback.va = va;
+            if (va > imageBase && va - imageBase <= 0xFFFFFFFFULL) {
+                callback.rva = static_cast<quint32>(va - imageBase);
+                callback.sectionIndex = findSectionIndex(callback.rva, sections);
+                callback.executable = callback.sectionIndex >= 0 &&
+                                      (sections[callback.sectionIndex]->Characteristics & IMAGE_SCN_MEM_EXECUTE);
+            }
+            callbacks.append(callback);
+        }
+    }
     
     QStringList tlsInfo;
     QMap<QString, QString> tlsDetails;
     
-    // Parse TLS directory structure
     QMap<QString, QString> tlsParams;
-    tlsParams["rva"] = PEUtils::formatHex(tlsDir->AddressOfCallBacks);
-    tlsParams["size"] = QString::number(tlsDir->SizeOfZeroFill);
+    tlsParams["rva"] = PEUtils::formatHex(callbackArrayVA);
+    tlsParams["count"] = QString::number(callbacks.size());
+    tlsParams["size"] = QString::number(zeroFill);
     QString tlsData = LANG_PARAMS("UI/tls_details_format", tlsParams);
     
     tlsInfo.append(LANG("UI/data_dir_tls"));
@@ -392,6 +762,7 @@ bool PEDataDirectoryParser::parseTLSDirectory(quint32 rva, quint32 size, PEDataM
     
     dataModel.setTLSInfo(tlsInfo);
     dataModel.setTLSDetails(tlsDetails);
+    dataModel.setTLSCallbacks(callbacks);
     
     return true;
 }
@@ -400,21 +771,94 @@ bool PEDataDirectoryParser::parseLoadConfigDirectory(quint32 rva, quint32 size,
 {
     if (rva == 0 || size == 0) return true;
     
-    quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    quint32 fileOffset = rvaToFileOffset(rva, sections);
     if (fileOffset == 0) return false;
+    if (static_cast<quint64>(fileOffset) + sizeof(quint32) > static_cast<quint64>(m_fileData.size())) return false;
     
-    const IMAGE_LOAD_CONFIG_DIRECTORY *loadConfigDir = reinterpret_cast<const IMAGE_LOAD_CONFIG_DIRECTORY*>(
-        m_fileData.data() + fileOffset
-    );
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = dataModel.getOptionalHeader();
+    if (!optionalHeader) return false;
+    bool isPE64 = optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    
+    // The structure grew with every Windows release; Size says how much of it
+    // this linker wrote. Fields beyond that stay zero.
+    quint32 declaredSize = 0;
+    std::memcpy(&declaredSize, m_fileData.constData() + fileOffset, sizeof(declaredSize));
+    quint64 available = static_cast<quint64>(m_fileData.size()) - fileOffset;
+    
+    PEDataModel::LoadConfigDirectory loadConfig;
+    loadConfig.present = true;
+    loadConfig.fileOffset = fileOffset;
+    loadConfig.size = declaredSize;
+    
+    quint64 imageBase = 0;
+    quint64 majorVersion = 0;
+    quint64 guardCFTable = 0, addressTakenIatTable = 0, longJumpTable = 0, ehContinuationTable = 0, seHandlerTable = 0;
+    auto readFields = [&](const auto &dir) {
+        majorVersion = dir.MajorVersion;
+        loadConfig.timeDateStamp = dir.TimeDateStamp;
+        loadConfig.securityCookie = dir.SecurityCookie;
+        loadConfig.guardFlags = dir.GuardFlags;
+        loadConfig.guardCFCheckFunctionPointer = dir.GuardCFCheckFunctionPointer;
+        loadConfig.guardCFDispatchFunctionPointer = dir.GuardCFDispatchFunctionPointer;
+        loadConfig.guardCFFunctionCount = dir.GuardCFFunctionCount;
+        loadConfig.guardAddressTakenIatEntryCount = dir.GuardAddressTakenIatEntryCount;
+        loadConfig.guardLongJumpTargetCount = dir.GuardLongJumpTargetCount;
+        loadConfig.guardEHContinuationCount = dir.GuardEHContinuationCount;
+        loadConfig.seHandlerCount = dir.SEHandlerCount;
+        guardCFTable = dir.GuardCFFunctionTable;
+        addressTakenIatTable = dir.GuardAddressTakenIatEntryTable;
+        longJumpTable = dir.GuardLongJumpTargetTable;
+        ehContinuationTable = dir.GuardEHContinuationTable;
+        seHandlerTable = dir.SEHandlerTable;
+    };
+    if (isPE64) {
+        IMAGE_LOAD_CONFIG_DIRECTORY64 dir = {};
+        std::memcpy(&dir, m_fileData.constData() + fileOffset, qMin<quint64>(qMin<quint64>(declaredSize, sizeof(dir)), available));
+        imageBase = reinterpret_cast<const IMAGE_OPTIONAL_HEADER64*>(optionalHeader)->ImageBase;
+        readFields(dir);
+    } else {
+        IMAGE_LOAD_CONFIG_DIRECTORY32 dir = {};
+        std::memcpy(&dir, m_fileData.constData() + fileOffset, qMin<quint64>(qMin<quint64>(declaredSize, sizeof(dir)), available));
+        imageBase = reinterpret_cast<const IMAGE_OPTIONAL_HEADER32*>(optionalHeader)->ImageBase;
+        readFields(dir);
+    }
+    
+    // Guard tables hold RVAs followed by GuardFlags-defined metadata bytes;
+    // the SafeSEH table holds plain RVAs and only exists in 32-bit images.
+    loadConfig.guardTableStride = (loadConfig.guardFlags & IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK) >>
+                                  IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT;
+    auto tableRVA = [imageBase](quint64 va) -> quint32 {
+        return (va > imageBase && va - imageBase <= 0xFFFFFFFFULL) ? static_cast<quint32>(va - imageBase) : 0;
+    };
+    bool complete = true;
+    complete &= readGuardTable(tableRVA(guardCFTable), loadConfig.guardCFFunctionCount, loadConfig.guardTableStride,
+                               sections, loadConfig.guardCFFunctions, &loadConfig.suppressedFunctions);
+    complete &= readGuardTable(tableRVA(addressTakenIatTable), loadConfig.guardAddressTakenIatEntryCount,
+                               loadConfig.guardTableStride, sections, loadConfig.addressTakenIatEntries, nullptr);
+    complete &= readGuardTable(tableRVA(longJumpTable), loadConfig.guardLongJumpTargetCount,
+                               loadConfig.guardTableStride, sections, loadConfig.longJumpTargets, nullptr);
+    complete &= readGuardTable(tableRVA(ehContinuationTable), loadConfig.guardEHContinuationCount,
+                               loadConfig.guardTableStride, sections, loadConfig.ehContinuationTargets, nullptr);
+    if (!isPE64) {
+        complete &= readGuardTable(tableRVA(seHandlerTable), loadConfig.seHandlerCount, 0,
+                                   sections, loadConfig.seHandlers, nullptr);
+    }
+    loadConfig.truncated = !complete;
+    if (loadConfig.truncated) {
+        dataModel.reportDiagnostic(PEErrorType::TableTruncated, fileOffset,
+                                   "Load config guard tables extend beyond the file");
+    }
     
     QStringList loadConfigInfo;
     QMap<QString, QString> loadConfigDetails;
     
-    // Parse Load Configuration directory structure
     QMap<QString, QString> configParams;
-    configParams["size"] = QString::number(loadConfigDir->Size);
-    configParams["time"] = PEUtils::formatHex(loadConfigDir->TimeDateStamp);
-    configParams["version"] = QString::number(loadConfigDir->MajorVersion);
+    configParams["size"] = QString::number(declaredSize);
+    configParams["time"] = PEUtils::formatHex(loadConfig.timeDateStamp);
+    configParams["version"] = QString::number(majorVersion);
+    configParams["flags"] = PEUtils::formatHex(loadConfig.guardFlags);
+    configParams["functions"] = QString::number(loadConfig.guardCFFunctions.size());
     QString configData = LANG_PARAMS("UI/load_config_details_format", configParams);
     
     loadConfigInfo.append(LANG("UI/data_dir_load_config"));
@@ -422,11 +866,48 @@ bool PEDataDirectoryParser::parseLoadConfigDirectory(quint32 rva, quint32 size,
     
     dataModel.setLoadConfigInfo(loadConfigInfo);
     dataModel.setLoadConfigDetails(loadConfigDetails);
+    dataModel.setLoadConfigDirectory(loadConfig);
     
     return true;
 }
 
-quint32 PEDataDirectoryParser::rvaToFileOffset(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections)
+bool PEDataDirectoryParser::readGuardTable(quint32 tableRVA, quint64 count, quint32 metadataSize,
+                                           const QList<const IMAGE_SECTION_HEADER*> &sections,
+                                           PERvaSet &targets, PERvaSet *suppressed) const
+{
+    if (tableRVA == 0 || count == 0) return true;
+    
+    quint32 fileOffset = rvaToFileOffset(tableRVA, sections);
+    if (fileOffset == 0 || fileOffset >= static_cast<quint64>(m_fileData.size())) return false;
+    
+    // Never trust the declared count beyond what the file can hold
+    quint32 entrySize = sizeof(quint32) + metadataSize;
+    quint64 readable = (static_cast<quint64>(m_fileData.size()) - fileOffset) / entrySize;
+    quint64 readCount = qMin<quint64>(qMin<quint64>(count, readable), MAX_GUARD_TABLE_ENTRIES);
+    
+    QVector<quint32> rvas;
+    QVector<quint32> suppressedRvas;
+    rvas.reserve(static_cast<int>(readCount));
+    const char *entry = m_fileData.constData() + fileOffset;
+    for (quint64 i = 0; i < readCount; ++i, entry += entrySize) {
+        quint32 rva = 0;
+        std::memcpy(&rva, entry, sizeof(rva));
+        rvas.append(rva);
+        if (suppressed && metadataSize > 0 &&
+            (static_cast<quint8>(entry[sizeof(quint32)]) &
+             (IMAGE_GUARD_FLAG_FID_SUPPRESSED | IMAGE_GUARD_FLAG_EXPORT_SUPPRESSED))) {
+            suppressedRvas.append(rva);
+        }
+    }
+    
+    targets = PERvaSet::fromValues(rvas);
+    if (suppressed) {
+        *suppressed = PERvaSet::fromValues(suppressedRvas);
+    }
+    return readCount == count;
+}
+
+quint32 PEDataDirectoryParser::rvaToFileOffset(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const
 {
     if (sections.isEmpty()) return 0;
     
@@ -446,12 +927,32 @@ quint32 PEDataDirectoryParser::rvaToFileOffset(quint32 rva, const QList<const IM
     return 0;
 }
 
-QString PEDataDirectoryParser::readStringFromRVA(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections)
+int PEDataDirectoryParser::findSectionIndex(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const
+{
+    for (int i = 0; i < sections.size(); ++i) {
+        const IMAGE_SECTION_HEADER *section = sections[i];
+        quint32 sectionSize = qMax(section->getVirtualSize(), section->SizeOfRawData);
+        if (rva >= section->VirtualAddress && rva - section->VirtualAddress < sectionSize) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString PEDataDirectoryParser::readStringFromRVA(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const
 {
     if (rva == 0) return QString();
     
     quint32 fileOffset = rvaToFileOffset(rva, sections);
-    if (fileOffset == 0 || fileOffset >= static_cast<quint32>(m_fileData.size())) {
+    if (fileOffset == 0) {
+        return QString();
+    }
+    return readStringAtOffset(fileOffset);
+}
+
+QString PEDataDirectoryParser::readStringAtOffset(quint32 fileOffset) const
+{
+    if (fileOffset >= static_cast<quint32>(m_fileData.size())) {
         return QString();
     }
 
@@ -496,48 +997,217 @@ bool PEDataDirectoryParser::parseExceptionDirectory(quint32 rva, quint32 size, P
     QStringList exceptionInfo;
     QMap<QString, QString> exceptionDetails;
     
-    // Parse exception directory (typically contains exception handling information)
-    // For x64, this contains RUNTIME_FUNCTION structures
+    quint16 machine = dataModel.getFileHeader() ? dataModel.getFileHeader()->Machine : 0;
+    bool isArm64 = machine == IMAGE_FILE_MACHINE_ARM64;
+    bool isArm = machine == IMAGE_FILE_MACHINE_ARM || machine == IMAGE_FILE_MACHINE_ARMNT || machine == IMAGE_FILE_MACHINE_THUMB;
+    
+    // x64/IA64 use 12-byte entries; ARM and ARM64 use 8-byte entries with
+    // either packed unwind data or an .xdata RVA in the second word
+    const quint32 entrySize = (isArm || isArm64) ? sizeof(IMAGE_ARM64_RUNTIME_FUNCTION_ENTRY)
+                                                 : sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY);
+    const quint64 tableEnd = qMin<quint64>(static_cast<quint64>(fileOffset) + size, m_fileData.size());
+    const quint32 entryCount = tableEnd > fileOffset ? static_cast<quint32>((tableEnd - fileOffset) / entrySize) : 0;
+    const char *table = m_fileData.constData() + fileOffset;
+    const quint32 lengthScale = isArm64 ? 4 : 2;
+    
+    QList<PEDataModel::RuntimeFunctionEntry> functions;
+    functions.reserve(static_cast<qsizetype>(entryCount));
+    bool sorted = true;
+    
+    for (quint32 i = 0; i < entryCount; ++i) {
+        PEDataModel::RuntimeFunctionEntry function;
+        if (isArm || isArm64) {
+            IMAGE_ARM64_RUNTIME_FUNCTION_ENTRY entry;
+            std::memcpy(&entry, table + static_cast<quint64>(i) * entrySize, sizeof(entry));
+            function.beginAddress = entry.BeginAddress;
+            function.unwindData = entry.UnwindData.UnwindData;
+            
+            quint32 functionLength = 0;
+            if ((function.unwindData & 0x3) != 0) {
+                functionLength = (function.unwindData >> 2) & 0x7FF;
+            } else {
+                // Unpacked: the first .xdata word holds the length in bits 0-17
+                quint32 xdataOffset = rvaToFileOffset(function.unwindData, dataModel.getSections());
+                if (xdataOffset != 0 && static_cast<quint64>(xdataOffset) + sizeof(quint32) <= static_cast<quint64>(m_fileData.size())) {
+                    quint32 header;
+                    std::memcpy(&header, m_fileData.constData() + xdataOffset, sizeof(header));
+                    functionLength = header & 0x3FFFF;
+                }
+            }
+            function.endAddress = function.beginAddress + functionLength * lengthScale;
+        } else {
+            IMAGE_RUNTIME_FUNCTION_ENTRY entry;
+            std::memcpy(&entry, table + static_cast<quint64>(i) * entrySize, sizeof(entry));
+            if (entry.BeginAddress == 0 && entry.EndAddress == 0) {
+                continue; // Zero padding at the end of the table
+            }
+            function.beginAddress = entry.BeginAddress;
+            function.endAddress = entry.EndAddress;
+            function.unwindData = entry.UnwindInfoAddress;
+        }
+        
+        if (!functions.isEmpty() && function.beginAddress < functions.last().beginAddress) {
+            sorted = false;
+        }
+        functions.append(function);
+    }
+    
+    // The loader requires a sorted table, but malformed files may not comply
+    if (!sorted) {
+        std::sort(functions.begin(), functions.end(),
+                  [](const PEDataModel::RuntimeFunctionEntry &a, const PEDataModel::RuntimeFunctionEntry &b) {
+                      return a.beginAddress < b.beginAddress;
+                  });
+    }
+    
+    // Coverage statistics against the executable sections
+    quint64 coveredBytes = 0;
+    quint32 largestFunction = 0;
+    int overlapping = 0;
+    for (int i = 0; i < functions.size(); ++i) {
+        const PEDataModel::RuntimeFunctionEntry &function = functions.at(i);
+        quint32 length = function.endAddress > function.beginAddress ? function.endAddress - function.beginAddress : 0;
+        coveredBytes += length;
+        largestFunction = qMax(largestFunction, length);
+        if (i > 0 && function.beginAddress < functions.at(i - 1).endAddress) {
+            ++overlapping;
+        }
+    }
+    
+    quint64 executableBytes = 0;
+    for (const IMAGE_SECTION_HEADER *section : dataModel.getSections()) {
+        if (section->Characteristics & IMAGE_SCN_MEM_EXECUTE) {
+            executableBytes += qMax(section->getVirtualSize(), section->SizeOfRawData);
+        }
+    }
+    double coverage = executableBytes > 0 ? (100.0 * coveredBytes) / executableBytes : 0.0;
+    
     QMap<QString, QString> exceptionParams;
-    exceptionParams["rva"] = PEUtils::formatHex(rva);
-    exceptionParams["size"] = QString::number(size);
-    QString exceptionData = LANG_PARAMS("UI/exception_details_format", exceptionParams);
+    exceptionParams["count"] = QString::number(functions.size());
+    exceptionParams["covered"] = QString::number(coveredBytes);
+    exceptionParams["coverage"] = QString::number(qMin(coverage, 100.0), 'f', 1);
     
     exceptionInfo.append(LANG("UI/data_dir_exception"));
-    exceptionDetails[LANG("UI/data_dir_exception")] = exceptionData;
+    exceptionDetails[LANG("UI/data_dir_exception")] = LANG_PARAMS("UI/exception_details_format", exceptionParams);
+    if (!functions.isEmpty()) {
+        exceptionDetails[LANG("UI/exception_average_size")] = QString::number(coveredBytes / functions.size());
+        exceptionDetails[LANG("UI/exception_largest_size")] = QString::number(largestFunction);
+    }
+    if (overlapping > 0) {
+        exceptionDetails[LANG("UI/exception_overlapping")] = QString::number(overlapping);
+    }
     
     dataModel.setExceptionInfo(exceptionInfo);
     dataModel.setExceptionDetails(exceptionDetails);
+    dataModel.setRuntimeFunctions(functions);
     
     return true;
 }
 
+PEDataModel::UnwindInfoEntry PEDataDirectoryParser::readUnwindInfo(const PEDataModel::RuntimeFunctionEntry &function,
+                                                                   const QList<const IMAGE_SECTION_HEADER*> &sections) const
+{
+    PEDataModel::UnwindInfoEntry info;
+    
+    const quint64 fileSize = static_cast<quint64>(m_fileData.size());
+    
+    // Bit 0 set means the entry points at another RUNTIME_FUNCTION instead
+    if (function.unwindData & 1u) {
+        quint32 chainOffset = rvaToFileOffset(function.unwindData & ~1u, sections);
+        if (chainOffset != 0 && static_cast<quint64>(chainOffset) + sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) <= fileSize) {
+            IMAGE_RUNTIME_FUNCTION_ENTRY chained;
+            std::memcpy(&chained, m_fileData.constData() + chainOffset, sizeof(chained));
+            info.flags = UNW_FLAG_CHAININFO;
+            info.chainedFunction.beginAddress = chained.BeginAddress;
+            info.chainedFunction.endAddress = chained.EndAddress;
+            info.chainedFunction.unwindData = chained.UnwindInfoAddress;
+            info.valid = true;
+        }
+        return info;
+    }
+    
+    quint32 offset = rvaToFileOffset(function.unwindData, sections);
+    if (offset == 0 || static_cast<quint64>(offset) + sizeof(UNWIND_INFO) > fileSize) {
+        return info;
+    }
+    
+    UNWIND_INFO header;
+    std::memcpy(&header, m_fileData.constData() + offset, sizeof(header));
+    info.version = header.VersionAndFlags & 0x7;
+    info.flags = header.VersionAndFlags >> 3;
+    info.sizeOfProlog = header.SizeOfProlog;
+    info.frameRegister = header.FrameRegisterAndOffset & 0xF;
+    info.frameOffset = header.FrameRegisterAndOffset >> 4;
+    
+    // Codes are padded to an even count before the trailing handler/chain data
+    quint64 codesPos = static_cast<quint64>(offset) + sizeof(UNWIND_INFO);
+    quint64 codesSize = static_cast<quint64>(header.CountOfCodes) * sizeof(quint16);
+    if (codesPos + codesSize > fileSize) {
+        return info;
+    }
+    info.unwindCodes.resize(header.CountOfCodes);
+    if (header.CountOfCodes > 0) {
+        std::memcpy(info.unwindCodes.data(), m_fileData.constData() + codesPos, codesSize);
+    }
+    
+    quint64 trailerPos = codesPos + ((header.CountOfCodes + 1) & ~1u) * sizeof(quint16);
+    if (info.flags & UNW_FLAG_CHAININFO) {
+        if (trailerPos + sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) <= fileSize) {
+            IMAGE_RUNTIME_FUNCTION_ENTRY chained;
+            std::memcpy(&chained, m_fileData.constData() + trailerPos, sizeof(chained));
+            info.chainedFunction.beginAddress = chained.BeginAddress;
+            info.chainedFunction.endAddress = chained.EndAddress;
+            info.chainedFunction.unwindData = chained.UnwindInfoAddress;
+        }
+    } else if (info.flags & (UNW_FLAG_EHANDLER | UNW_FLAG_UHANDLER)) {
+        if (trailerPos + sizeof(quint32) <= fileSize) {
+            std::memcpy(&info.exceptionHandlerRVA, m_fileData.constData() + trailerPos, sizeof(quint32));
+        }
+    }
+    
+    info.valid = true;
+    return info;
+}
+
 bool PEDataDirectoryParser::parseCertificateDirectory(quint32 rva, quint32 size, PEDataModel &dataModel)
 {
     if (rva == 0 || size == 0) return true;
     
-    quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
-    if (fileOffset == 0) return false;
+    // The security directory is the one entry that holds a file offset, not an RVA
+    quint32 fileOffset = rva;
+    if (fileOffset >= static_cast<quint32>(m_fileData.size())) return false;
     
     QStringList certificateInfo;
     QMap<QString, QString> certificateDetails;
     
-    // Parse certificate directory (Authenticode signatures)
-    if (fileOffset + sizeof(WIN_CERTIFICATE) <= m_fileData.size()) {
-        const WIN_CERTIFICATE *cert = reinterpret_cast<const WIN_CERTIFICATE*>(
-            m_fileData.data() + fileOffset
-        );
+    const quint64 tableEnd = qMin<quint64>(static_cast<quint64>(fileOffset) + size, m_fileData.size());
+    const quint32 headerSize = offsetof(WIN_CERTIFICATE, bCertificate);
+    quint64 entryPos = fileOffset;
+    int index = 0;
+    
+    // WIN_CERTIFICATE entries follow each other, each aligned to 8 bytes
+    while (entryPos + headerSize <= tableEnd) {
+        WIN_CERTIFICATE cert;
+        std::memcpy(&cert, m_fileData.constData() + entryPos, headerSize);
+        if (cert.dwLength < headerSize || entryPos + cert.dwLength > tableEnd) {
+            break;
+        }
         
-        QString certData = QString("Type: %1, Version: %2, Size: %3 bytes")
-                          .arg(PEUtils::formatHex(static_cast<quint32>(cert->wRevision)))
-                          .arg(PEUtils::formatHex(static_cast<quint32>(cert->wCertificateType)))
-                          .arg(cert->dwLength);
+        QMap<QString, QString> certParams;
+        certParams["type"] = PEUtils::formatHex(static_cast<quint32>(cert.wCertificateType));
+        certParams["revision"] = PEUtils::formatHex(static_cast<quint32>(cert.wRevision));
+        certParams["size"] = QString::number(cert.dwLength);
+        QString certData = LANG_PARAMS("UI/certificate_details_format", certParams);
         
-        certificateInfo.append(LANG("UI/data_dir_certificate"));
-        certificateDetails[LANG("UI/data_dir_certificate")] = certData;
-    } else {
-        certificateInfo.append(LANG("UI/data_dir_certificate"));
-        certificateDetails[LANG("UI/data_dir_certificate")] = QString("RVA: 0x%1, Size: %2 bytes").arg(PEUtils::formatHex(rva)).arg(size);
+        QString entryName = LANG("UI/data_dir_certificate");
+        if (index > 0) {
+            entryName += QString(" #%1").arg(index + 1);
+        }
+        certificateInfo.append(entryName);
+        certificateDetails[entryName] = certData;
+        
+        entryPos += (static_cast<quint64>(cert.dwLength) + 7) & ~static_cast<quint64>(7);
+        ++index;
     }
     
     dataModel.setCertificateInfo(certificateInfo);
@@ -556,25 +1226,75 @@ bool PEDataDirectoryParser::parseBaseRelocationDirectory(quint32 rva, quint32 si
     QStringList relocationInfo;
     QMap<QString, QString> relocationDetails;
     
-    // Parse base relocation directory
-    const IMAGE_BASE_RELOCATION *relocDir = reinterpret_cast<const IMAGE_BASE_RELOCATION*>(
-        m_fileData.data() + fileOffset
-    );
+    const quint64 directoryEnd = qMin<quint64>(static_cast<quint64>(fileOffset) + size, m_fileData.size());
+    const char *data = m_fileData.constData();
     
-    if (fileOffset + sizeof(IMAGE_BASE_RELOCATION) <= m_fileData.size()) {
-        QString relocData = QString("Virtual Address: 0x%1, Size: %2 bytes")
-                           .arg(PEUtils::formatHex(relocDir->VirtualAddress))
-                           .arg(relocDir->SizeOfBlock);
+    // Each entry is two bytes, which bounds the output before we start
+    QList<quint64> relocations;
+    relocations.reserve(static_cast<qsizetype>((directoryEnd > fileOffset ? directoryEnd - fileOffset : 0) / sizeof(quint16)));
+    
+    int typeCounts[16] = {};
+    int blockCount = 0;
+    bool sorted = true;
+    quint64 previous = 0;
+    quint64 blockPos = fileOffset;
+    
+    // Walk every IMAGE_BASE_RELOCATION block; each covers one 4 KB page
+    while (blockPos + sizeof(IMAGE_BASE_RELOCATION) <= directoryEnd) {
+        IMAGE_BASE_RELOCATION block;
+        std::memcpy(&block, data + blockPos, sizeof(block));
+        if (block.SizeOfBlock < sizeof(IMAGE_BASE_RELOCATION) || blockPos + block.SizeOfBlock > directoryEnd) {
+            break;
+        }
         
-        relocationInfo.append(LANG("UI/data_dir_base_relocation"));
-        relocationDetails[LANG("UI/data_dir_base_relocation")] = relocData;
-    } else {
-        relocationInfo.append(LANG("UI/data_dir_base_relocation"));
-        relocationDetails[LANG("UI/data_dir_base_relocation")] = QString("RVA: 0x%1, Size: %2 bytes").arg(PEUtils::formatHex(rva)).arg(size);
+        const char *entries = data + blockPos + sizeof(IMAGE_BASE_RELOCATION);
+        const quint32 entryCount = (block.SizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(quint16);
+        for (quint32 i = 0; i < entryCount; ++i) {
+            quint16 value;
+            std::memcpy(&value, entries + i * sizeof(quint16), sizeof(value));
+            
+            quint8 type = static_cast<quint8>(value >> 12);
+            if (type == IMAGE_REL_BASED_ABSOLUTE) {
+                continue; // Padding to keep blocks 32-bit aligned
+            }
+            
+            quint64 packed = (static_cast<quint64>(block.VirtualAddress + (value & 0x0FFF)) << 8) | type;
+            sorted = sorted && packed >= previous;
+            previous = packed;
+            relocations.append(packed);
+            ++typeCounts[type];
+            
+            if (type == IMAGE_REL_BASED_HIGHADJ) {
+                ++i; // The following slot holds the low 16 bits of the adjustment
+            }
+        }
+        
+        ++blockCount;
+        blockPos += block.SizeOfBlock;
+    }
+    
+    // Linkers emit blocks in ascending page order, so this is rarely needed
+    if (!sorted) {
+        std::sort(relocations.begin(), relocations.end());
+    }
+    
+    QMap<QString, QString> relocParams;
+    relocParams["blocks"] = QString::number(blockCount);
+    relocParams["entries"] = QString::number(relocations.size());
+    
+    relocationInfo.append(LANG("UI/data_dir_base_relocation"));
+    relocationDetails[LANG("UI/data_dir_base_relocation")] = LANG_PARAMS("UI/relocation_details_format", relocParams);
+    
+    quint16 machine = dataModel.getFileHeader() ? dataModel.getFileHeader()->Machine : 0;
+    for (int type = 0; type < 16; ++type) {
+        if (typeCounts[type] > 0) {
+            relocationDetails[PEUtils::getRelocationTypeName(static_cast<quint8>(type), machine)] = QString::number(typeCounts[type]);
+        }
     }
     
     dataModel.setRelocationInfo(relocationInfo);
     dataModel.setRelocationDetails(relocationDetails);
+    dataModel.setRelocations(relocations);
     
     return true;
 }
@@ -631,22 +1351,73 @@ bool PEDataDirectoryParser::parseBoundImportDirectory(quint32 rva, quint32 size,
 {
     if (rva == 0 || size == 0) return true;
     
+    // The linker places this directory right after the section table, in the
+    // headers, where no section maps it and RVA equals file offset
     quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = dataModel.getOptionalHeader();
+    if (fileOffset == 0 && optionalHeader && rva < optionalHeader->SizeOfHeaders) {
+        fileOffset = rva;
+    }
     if (fileOffset == 0) return false;
     
+    quint64 directoryEnd = qMin<quint64>(static_cast<quint64>(fileOffset) + size, static_cast<quint64>(m_fileData.size()));
+    
+    // Module names are offsets from the start of the directory
+    auto readModuleName = [&](quint16 offsetModuleName) {
+        return readStringAtOffset(fileOffset + offsetModuleName);
+    };
+    
+    QList<PEDataModel::BoundImportEntry> boundImports;
+    quint64 position = fileOffset;
+    while (position + sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR) <= directoryEnd && boundImports.size() < MAX_IMPORT_DESCRIPTORS) {
+        IMAGE_BOUND_IMPORT_DESCRIPTOR descriptor;
+        std::memcpy(&descriptor, m_fileData.constData() + position, sizeof(descriptor));
+        if (descriptor.TimeDateStamp == 0 && descriptor.OffsetModuleName == 0) {
+            break;
+        }
+        
+        PEDataModel::BoundImportEntry entry;
+        entry.moduleName = readModuleName(descriptor.OffsetModuleName);
+        entry.timeDateStamp = descriptor.TimeDateStamp;
+        entry.fileOffset = static_cast<quint32>(position);
+        position += sizeof(descriptor);
+        
+        // Forwarder references follow their descriptor and share its size
+        for (int i = 0; i < descriptor.NumberOfModuleForwarderRefs; ++i) {
+            if (position + sizeof(IMAGE_BOUND_FORWARDER_REF) > directoryEnd) {
+                break;
+            }
+            IMAGE_BOUND_FORWARDER_REF forwarderRef;
+            std::memcpy(&forwarderRef, m_fileData.constData() + position, sizeof(forwarderRef));
+            position += sizeof(forwarderRef);
+            
+            PEDataModel::BoundForwarderRef forwarder;
+            forwarder.moduleName = readModuleName(forwarderRef.OffsetModuleName);
+            forwarder.timeDateStamp = forwarderRef.TimeDateStamp;
+            entry.forwarders.append(forwarder);
+        }
+        
+        boundImports.append(entry);
+    }
+    
     QStringList boundImportInfo;
     QMap<QString, QString> boundImportDetails;
     
-    // Parse bound import directory
-    QString boundData = QString("RVA: 0x%1, Size: %2 bytes")
-                       .arg(PEUtils::formatHex(rva))
-                       .arg(size);
+    int forwarderCount = 0;
+    for (const PEDataModel::BoundImportEntry &entry : boundImports) {
+        forwarderCount += entry.forwarders.size();
+    }
+    QMap<QString, QString> boundParams;
+    boundParams["modules"] = QString::number(boundImports.size());
+    boundParams["forwarders"] = QString::number(forwarderCount);
+    QString boundData = LANG_PARAMS("UI/bound_import_details_format", boundParams);
     
     boundImportInfo.append(LANG("UI/data_dir_bound_import"));
     boundImportDetails[LANG("UI/data_dir_bound_import")] = boundData;
     
     dataModel.setBoundImportInfo(boundImportInfo);
     dataModel.setBoundImportDetails(boundImportDetails);
+    dataModel.setBoundImports(boundImports);
     
     return true;
 }
@@ -679,22 +1450,75 @@ bool PEDataDirectoryParser::parseDelayImportDirectory(quint32 rva, quint32 size,
 {
     if (rva == 0 || size == 0) return true;
     
-    quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    quint32 fileOffset = rvaToFileOffset(rva, sections);
     if (fileOffset == 0) return false;
     
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = dataModel.getOptionalHeader();
+    if (!optionalHeader) return false;
+    bool isPE64 = optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    quint64 imageBase = isPE64 ? reinterpret_cast<const IMAGE_OPTIONAL_HEADER64*>(optionalHeader)->ImageBase
+                               : reinterpret_cast<const IMAGE_OPTIONAL_HEADER32*>(optionalHeader)->ImageBase;
+    
+    QList<PEDataModel::DelayImportModule> modules;
+    QMap<QString, QList<PEDataModel::ImportFunctionEntry>> delayImportFunctions;
+    int functionCount = 0;
+    
+    quint64 position = fileOffset;
+    while (position + sizeof(IMAGE_DELAYLOAD_DESCRIPTOR) <= static_cast<quint64>(m_fileData.size()) &&
+           modules.size() < MAX_IMPORT_DESCRIPTORS) {
+        IMAGE_DELAYLOAD_DESCRIPTOR descriptor;
+        std::memcpy(&descriptor, m_fileData.constData() + position, sizeof(descriptor));
+        if (descriptor.DllNameRVA == 0) {
+            break;
+        }
+        
+        // Descriptors from before the RvaBased attribute (VC6 delayimp.h) hold
+        // VAs in every address field, including the name table entries
+        PEDataModel::DelayImportModule module;
+        module.descriptorOffset = static_cast<quint32>(position);
+        module.rvaBased = (descriptor.Attributes.AllAttributes & 1) != 0;
+        auto toRVA = [&](quint32 address) -> quint32 {
+            if (address == 0 || module.rvaBased) return address;
+            return address > imageBase ? static_cast<quint32>(address - imageBase) : 0;
+        };
+        module.moduleHandleRVA = toRVA(descriptor.ModuleHandleRVA);
+        module.importAddressTableRVA = toRVA(descriptor.ImportAddressTableRVA);
+        module.importNameTableRVA = toRVA(descriptor.ImportNameTableRVA);
+        module.boundImportAddressTableRVA = toRVA(descriptor.BoundImportAddressTableRVA);
+        module.unloadInformationTableRVA = toRVA(descriptor.UnloadInformationTableRVA);
+        module.timeDateStamp = descriptor.TimeDateStamp;
+        module.dllName = readStringFromRVA(toRVA(descriptor.DllNameRVA), sections);
+        position += sizeof(descriptor);
+        
+        if (module.dllName.isEmpty()) {
+            continue;
+        }
+        
+        // The delay IAT initially points at loader thunks, so names come only from the INT
+        QList<PEDataModel::ImportFunctionEntry> functions =
+            readImportThunks(module.dllName, module.importNameTableRVA, module.importAddressTableRVA, isPE64,
+                             module.rvaBased ? 0 : imageBase, sections);
+        functionCount += functions.size();
+        delayImportFunctions[module.dllName].append(functions);
+        modules.append(module);
+    }
+    
     QStringList delayImportInfo;
     QMap<QString, QString> delayImportDetails;
     
-    // Parse delay import directory
-    QString delayData = QString("RVA: 0x%1, Size: %2 bytes")
-                       .arg(PEUtils::formatHex(rva))
-                       .arg(size);
+    QMap<QString, QString> delayParams;
+    delayParams["modules"] = QString::number(modules.size());
+    delayParams["functions"] = QString::number(functionCount);
+    QString delayData = LANG_PARAMS("UI/delay_import_details_format", delayParams);
     
     delayImportInfo.append(LANG("UI/data_dir_delay_import"));
     delayImportDetails[LANG("UI/data_dir_delay_import")] = delayData;
     
     dataModel.setDelayImportInfo(delayImportInfo);
     dataModel.setDelayImportDetails(delayImportDetails);
+    dataModel.setDelayImportModules(modules);
+    dataModel.setDelayImportFunctions(delayImportFunctions);
     
     return true;
 }
@@ -703,22 +1527,44 @@ bool PEDataDirectoryParser::parseCOMRuntimeDirectory(quint32 rva, quint32 size,
 {
     if (rva == 0 || size == 0) return true;
     
-    quint32 fileOffset = rvaToFileOffset(rva, dataModel.getSections());
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    quint32 fileOffset = rvaToFileOffset(rva, sections);
     if (fileOffset == 0) return false;
+    if (static_cast<quint64>(fileOffset) + sizeof(IMAGE_COR20_HEADER) > static_cast<quint64>(m_fileData.size())) return false;
+    
+    PEDataModel::ClrRuntimeHeader clrHeader;
+    clrHeader.present = true;
+    clrHeader.fileOffset = fileOffset;
+    std::memcpy(&clrHeader.header, m_fileData.constData() + fileOffset, sizeof(clrHeader.header));
+    
+    // Only the metadata root and table layout are read here; rows are decoded on demand
+    PEClrMetadata metadata;
+    quint32 metadataOffset = rvaToFileOffset(clrHeader.header.MetaData.VirtualAddress, sections);
+    if (clrHeader.header.MetaData.VirtualAddress != 0 && metadataOffset != 0) {
+        metadata = PEClrMetadata::open(m_fileData, metadataOffset, clrHeader.header.MetaData.Size);
+        if (metadata.isTruncated()) {
+            dataModel.reportDiagnostic(PEErrorType::TableTruncated, metadataOffset,
+                                       "CLR metadata tables extend beyond the table stream");
+        }
+    }
     
     QStringList comRuntimeInfo;
     QMap<QString, QString> comRuntimeDetails;
     
-    // Parse COM+ Runtime Header directory
-    QString comData = QString("RVA: 0x%1, Size: %2 bytes")
-                     .arg(PEUtils::formatHex(rva))
-                     .arg(size);
+    QMap<QString, QString> clrParams;
+    clrParams["runtime"] = QString("%1.%2").arg(clrHeader.header.MajorRuntimeVersion).arg(clrHeader.header.MinorRuntimeVersion);
+    clrParams["version"] = metadata.isValid() ? metadata.version() : LANG("UI/clr_metadata_invalid");
+    clrParams["types"] = QString::number(metadata.rowCount(PEClrMetadata::TypeDef));
+    clrParams["methods"] = QString::number(metadata.rowCount(PEClrMetadata::MethodDef));
+    QString comData = LANG_PARAMS("UI/com_runtime_details_format", clrParams);
     
     comRuntimeInfo.append(LANG("UI/data_dir_com_runtime"));
     comRuntimeDetails[LANG("UI/data_dir_com_runtime")] = comData;
     
     dataModel.setCOMRuntimeInfo(comRuntimeInfo);
     dataModel.setCOMRuntimeDetails(comRuntimeDetails);
+    dataModel.setClrRuntimeHeader(clrHeader);
+    dataModel.setClrMetadata(metadata);
     
     return true;
 }
@@ -6,11 +6,20 @@
 #include <QByteArray>
 #include <QString>
 
+class PEExportIndex;
+class PEParseProfile;
+
 class PEDataDirectoryParser
 {
 public:
     PEDataDirectoryParser(const QByteArray &fileData);
     
+    // Names ordinal imports and follows forwarded exports while parsing; may be null
+    void setExportIndex(const PEExportIndex *exportIndex) { m_exportIndex = exportIndex; }
+    
+    // Records one "directory/<name>" stage per parsed directory; may be null
+    void setProfile(PEParseProfile *profile) { m_profile = profile; }
+    
     // Main parsing function (Microsoft PE Format compliant)
     bool parseDataDirectories(const IMAGE_OPTIONAL_HEADER *optionalHeader, 
                             quint32 dataDirectoryOffset, 
@@ -34,25 +43,56 @@ public:
     bool parseCOMRuntimeDirectory(quint32 rva, quint32 size, PEDataModel &dataModel);
     
     // Helper methods
-    quint32 rvaToFileOffset(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections);
-    QString readStringFromRVA(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections);
+    quint32 rvaToFileOffset(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const;
+    int findSectionIndex(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const;
+    QString readStringFromRVA(quint32 rva, const QList<const IMAGE_SECTION_HEADER*> &sections) const;
+    QString readStringAtOffset(quint32 fileOffset) const;
+    
+    // Resource payloads are only referenced by the model; this reads one on demand
+    QByteArray readResourceData(const PEDataModel::ResourceEntry &entry) const;
+    
+    // Decodes the payload of one debug directory entry, found via PointerToRawData
+    PEDataModel::DebugEntry decodeDebugEntry(const IMAGE_DEBUG_DIRECTORY &debugDir) const;
+    
+    // x64 unwind data is decoded per function instead of for the whole table
+    PEDataModel::UnwindInfoEntry readUnwindInfo(const PEDataModel::RuntimeFunctionEntry &function,
+                                                const QList<const IMAGE_SECTION_HEADER*> &sections) const;
     
 private:
     // Resource parsing helpers
-    bool parseResourceDirectoryEntry(const IMAGE_RESOURCE_DIRECTORY_ENTRY *entry, 
-                                   quint32 resourceOffset, 
-                                   PEDataModel &dataModel);
+    struct ResourceWalkContext;
+    void walkResourceDirectory(quint32 directoryOffset, 
+                               int depth, 
+                               const PEDataModel::ResourceEntry &path, 
+                               ResourceWalkContext &context);
+    QString readResourceName(quint32 nameOffset, ResourceWalkContext &context) const;
+    
+    // Walks a name table (INT) and pairs each entry with its IAT slot. addressBase
+    // is subtracted from hint/name pointers, for tables that hold VAs. With an
+    // export index set, ordinal imports are named and forwarders followed.
+    QList<PEDataModel::ImportFunctionEntry> readImportThunks(const QString &dllName, quint32 nameTableRVA, quint32 thunkTableRVA,
+                                                             bool isPE64, quint64 addressBase,
+                                                             const QList<const IMAGE_SECTION_HEADER*> &sections) const;
     
-    // Debug parsing helpers
-    bool parseDebugDirectoryEntry(const IMAGE_DEBUG_DIRECTORY *debugDir, 
-                                 PEDataModel &dataModel);
+    // Reads a guard table of RVAs, each followed by metadataSize bytes.
+    // Returns false if the table is shorter than count.
+    bool readGuardTable(quint32 tableRVA, quint64 count, quint32 metadataSize,
+                        const QList<const IMAGE_SECTION_HEADER*> &sections,
+                        PERvaSet &targets, PERvaSet *suppressed) const;
     
     // Data
     const QByteArray &m_fileData;
+    const PEExportIndex *m_exportIndex = nullptr;
+    PEParseProfile *m_profile = nullptr;
     
     // Constants
-    static const int MAX_RESOURCE_ENTRIES = 1000;
+    static const int MAX_RESOURCE_ENTRIES = 100000;
+    static const int MAX_RESOURCE_DEPTH = 3; // Type / Name / Language
     static const int MAX_DEBUG_ENTRIES = 100;
+    static const int MAX_IMPORT_DESCRIPTORS = 1000;
+    static const int MAX_POGO_ENTRIES = 10000;
+    static const int MAX_TLS_CALLBACKS = 1024;
+    static const int MAX_GUARD_TABLE_ENTRIES = 4000000;
 };
 
 #endif // PE_DATA_DIRECTORY_PARSER_H
@@ -1,4 +1,5 @@
 #include "pe_data_model.h"
+#include <algorithm>
 
 PEDataModel::PEDataModel()
     : m_filePath("")
@@ -13,32 +14,51 @@ PEDataModel::PEDataModel()
     m_imports.clear();
     m_importFunctionDetails.clear();
     m_exportFunctions.clear();
+    m_importHash.clear();
+    m_exportHash.clear();
+    m_richHeader = PERichHeader::Info();
+    m_fileContentDigest = ContentDigest();
+    m_sectionContentDigests.clear();
+    m_overlay = Overlay();
+    m_embeddedImages.clear();
     m_resourceTypes.clear();
     m_resources.clear();
+    m_resourceEntries.clear();
     m_debugInfo.clear();
     m_debugDetails.clear();
+    m_debugEntries.clear();
     m_tlsInfo.clear();
     m_tlsDetails.clear();
+    m_tlsCallbacks.clear();
     m_loadConfigInfo.clear();
     m_loadConfigDetails.clear();
+    m_loadConfigDirectory = LoadConfigDirectory();
     m_exceptionInfo.clear();
     m_exceptionDetails.clear();
+    m_runtimeFunctions.clear();
     m_certificateInfo.clear();
     m_certificateDetails.clear();
     m_relocationInfo.clear();
     m_relocationDetails.clear();
+    m_relocations.clear();
     m_architectureInfo.clear();
     m_architectureDetails.clear();
     m_globalPointerInfo.clear();
     m_globalPointerDetails.clear();
     m_boundImportInfo.clear();
     m_boundImportDetails.clear();
+    m_boundImports.clear();
     m_iatInfo.clear();
     m_iatDetails.clear();
     m_delayImportInfo.clear();
     m_delayImportDetails.clear();
+    m_delayImportModules.clear();
+    m_delayImportFunctions.clear();
     m_comRuntimeInfo.clear();
     m_comRuntimeDetails.clear();
+    m_clrRuntimeHeader = ClrRuntimeHeader();
+    m_clrMetadata = PEClrMetadata();
+    m_diagnostics.clear();
 }
 
 PEDataModel::~PEDataModel()
@@ -140,6 +160,77 @@ const QList<PEDataModel::ExportFunctionEntry>& PEDataModel::getExportFunctions()
     return m_exportFunctions;
 }
 
+void PEDataModel::setImportHash(const QString &hash)
+{
+    m_importHash = hash;
+}
+
+QString PEDataModel::getImportHash() const
+{
+    return m_importHash;
+}
+
+void PEDataModel::setExportHash(const QString &hash)
+{
+    m_exportHash = hash;
+}
+
+QString PEDataModel::getExportHash() const
+{
+    return m_exportHash;
+}
+
+void PEDataModel::setRichHeader(const PERichHeader::Info &richHeader)
+{
+    m_richHeader = richHeader;
+}
+
+const PERichHeader::Info& PEDataModel::getRichHeader() const
+{
+    return m_richHeader;
+}
+
+void PEDataModel::setFileContentDigest(const ContentDigest &digest)
+{
+    m_fileContentDigest = digest;
+}
+
+const PEDataModel::ContentDigest& PEDataModel::getFileContentDigest() const
+{
+    return m_fileContentDigest;
+}
+
+void PEDataModel::setSectionContentDigests(const QList<ContentDigest> &digests)
+{
+    m_sectionContentDigests = digests;
+}
+
+const QList<PEDataModel::ContentDigest>& PEDataModel::getSectionContentDigests() const
+{
+    return m_sectionContentDigests;
+}
+
+// Overlay and embedded images
+void PEDataModel::setOverlay(const Overlay &overlay)
+{
+    m_overlay = overlay;
+}
+
+const PEDataModel::Overlay& PEDataModel::getOverlay() const
+{
+    return m_overlay;
+}
+
+void PEDataModel::setEmbeddedImages(const QList<EmbeddedImage> &images)
+{
+    m_embeddedImages = images;
+}
+
+const QList<PEDataModel::EmbeddedImage>& PEDataModel::getEmbeddedImages() const
+{
+    return m_embeddedImages;
+}
+
 // Resources
 void PEDataModel::setResourceTypes(const QStringList &types)
 {
@@ -161,6 +252,16 @@ QMap<QString, QMap<QString, QString>> PEDataModel::getResources() const
     return m_resources;
 }
 
+void PEDataModel::setResourceEntries(const QList<ResourceEntry> &entries)
+{
+    m_resourceEntries = entries;
+}
+
+const QList<PEDataModel::ResourceEntry>& PEDataModel::getResourceEntries() const
+{
+    return m_resourceEntries;
+}
+
 // Debug info
 void PEDataModel::setDebugInfo(const QStringList &info)
 {
@@ -182,6 +283,26 @@ QMap<QString, QString> PEDataModel::getDebugDetails() const
     return m_debugDetails;
 }
 
+void PEDataModel::setDebugEntries(const QList<DebugEntry> &entries)
+{
+    m_debugEntries = entries;
+}
+
+const QList<PEDataModel::DebugEntry>& PEDataModel::getDebugEntries() const
+{
+    return m_debugEntries;
+}
+
+QString PEDataModel::getPdbKey() const
+{
+    for (const DebugEntry &entry : m_debugEntries) {
+        if (!entry.pdbKey.isEmpty()) {
+            return entry.pdbKey;
+        }
+    }
+    return QString();
+}
+
 // TLS info
 void PEDataModel::setTLSInfo(const QStringList &info)
 {
@@ -203,6 +324,16 @@ QMap<QString, QString> PEDataModel::getTLSDetails() const
     return m_tlsDetails;
 }
 
+void PEDataModel::setTLSCallbacks(const QList<TLSCallbackEntry> &callbacks)
+{
+    m_tlsCallbacks = callbacks;
+}
+
+const QList<PEDataModel::TLSCallbackEntry>& PEDataModel::getTLSCallbacks() const
+{
+    return m_tlsCallbacks;
+}
+
 // Load Configuration info
 void PEDataModel::setLoadConfigInfo(const QStringList &info)
 {
@@ -224,6 +355,16 @@ QMap<QString, QString> PEDataModel::getLoadConfigDetails() const
     return m_loadConfigDetails;
 }
 
+void PEDataModel::setLoadConfigDirectory(const LoadConfigDirectory &directory)
+{
+    m_loadConfigDirectory = directory;
+}
+
+const PEDataModel::LoadConfigDirectory& PEDataModel::getLoadConfigDirectory() const
+{
+    return m_loadConfigDirectory;
+}
+
 // Exception info
 void PEDataModel::setExceptionInfo(const QStringList &info)
 {
@@ -245,6 +386,33 @@ QMap<QString, QString> PEDataModel::getExceptionDetails() const
     return m_exceptionDetails;
 }
 
+void PEDataModel::setRuntimeFunctions(const QList<RuntimeFunctionEntry> &functions)
+{
+    m_runtimeFunctions = functions;
+}
+
+const QList<PEDataModel::RuntimeFunctionEntry>& PEDataModel::getRuntimeFunctions() const
+{
+    return m_runtimeFunctions;
+}
+
+int PEDataModel::findRuntimeFunction(quint32 rva) const
+{
+    // Last function starting at or before the RVA, if its range contains it
+    auto it = std::upper_bound(m_runtimeFunctions.cbegin(), m_runtimeFunctions.cend(), rva,
+                               [](quint32 value, const RuntimeFunctionEntry &entry) {
+                                   return value < entry.beginAddress;
+                               });
+    if (it == m_runtimeFunctions.cbegin()) {
+        return -1;
+    }
+    --it;
+    if (rva >= it->endAddress) {
+        return -1;
+    }
+    return static_cast<int>(it - m_runtimeFunctions.cbegin());
+}
+
 // Certificate info
 void PEDataModel::setCertificateInfo(const QStringList &info)
 {
@@ -287,6 +455,28 @@ QMap<QString, QString> PEDataModel::getRelocationDetails() const
     return m_relocationDetails;
 }
 
+void PEDataModel::setRelocations(const QList<quint64> &relocations)
+{
+    m_relocations = relocations;
+}
+
+const QList<quint64>& PEDataModel::getRelocations() const
+{
+    return m_relocations;
+}
+
+QList<quint64> PEDataModel::getRelocationsInRange(quint32 startRVA, quint32 endRVA) const
+{
+    if (startRVA >= endRVA) {
+        return QList<quint64>();
+    }
+
+    // Packed values sort by RVA first, so the type bits never affect the bounds
+    auto first = std::lower_bound(m_relocations.cbegin(), m_relocations.cend(), static_cast<quint64>(startRVA) << 8);
+    auto last = std::lower_bound(first, m_relocations.cend(), static_cast<quint64>(endRVA) << 8);
+    return QList<quint64>(first, last);
+}
+
 // Architecture info
 void PEDataModel::setArchitectureInfo(const QStringList &info)
 {
@@ -350,6 +540,16 @@ QMap<QString, QString> PEDataModel::getBoundImportDetails() const
     return m_boundImportDetails;
 }
 
+void PEDataModel::setBoundImports(const QList<BoundImportEntry> &entries)
+{
+    m_boundImports = entries;
+}
+
+const QList<PEDataModel::BoundImportEntry>& PEDataModel::getBoundImports() const
+{
+    return m_boundImports;
+}
+
 // IAT info
 void PEDataModel::setIATInfo(const QStringList &info)
 {
@@ -392,6 +592,26 @@ QMap<QString, QString> PEDataModel::getDelayImportDetails() const
     return m_delayImportDetails;
 }
 
+void PEDataModel::setDelayImportModules(const QList<DelayImportModule> &modules)
+{
+    m_delayImportModules = modules;
+}
+
+const QList<PEDataModel::DelayImportModule>& PEDataModel::getDelayImportModules() const
+{
+    return m_delayImportModules;
+}
+
+void PEDataModel::setDelayImportFunctions(const QMap<QString, QList<ImportFunctionEntry>> &details)
+{
+    m_delayImportFunctions = details;
+}
+
+const QMap<QString, QList<PEDataModel::ImportFunctionEntry>>& PEDataModel::getDelayImportFunctions() const
+{
+    return m_delayImportFunctions;
+}
+
 // COM+ Runtime info
 void PEDataModel::setCOMRuntimeInfo(const QStringList &info)
 {
@@ -413,6 +633,36 @@ QMap<QString, QString> PEDataModel::getCOMRuntimeDetails() const
     return m_comRuntimeDetails;
 }
 
+void PEDataModel::setClrRuntimeHeader(const ClrRuntimeHeader &header)
+{
+    m_clrRuntimeHeader = header;
+}
+
+const PEDataModel::ClrRuntimeHeader& PEDataModel::getClrRuntimeHeader() const
+{
+    return m_clrRuntimeHeader;
+}
+
+void PEDataModel::setClrMetadata(const PEClrMetadata &metadata)
+{
+    m_clrMetadata = metadata;
+}
+
+const PEClrMetadata& PEDataModel::getClrMetadata() const
+{
+    return m_clrMetadata;
+}
+
+void PEDataModel::reportDiagnostic(PEErrorType type, quint64 fileOffset, const QString &detail)
+{
+    m_diagnostics.report(type, fileOffset, detail);
+}
+
+const PEDiagnostics& PEDataModel::getDiagnostics() const
+{
+    return m_diagnostics;
+}
+
 // Validation
 bool PEDataModel::isValid() const
 {
@@ -437,32 +687,49 @@ void PEDataModel::clear()
     m_imports.clear();
     m_importFunctionDetails.clear();
     m_exportFunctions.clear();
+    m_importHash.clear();
+    m_exportHash.clear();
+    m_richHeader = PERichHeader::Info();
+    m_fileContentDigest = ContentDigest();
+    m_sectionContentDigests.clear();
     m_resourceTypes.clear();
     m_resources.clear();
+    m_resourceEntries.clear();
     m_debugInfo.clear();
     m_debugDetails.clear();
+    m_debugEntries.clear();
     
     // Clear new data fields
     m_tlsInfo.clear();
     m_tlsDetails.clear();
+    m_tlsCallbacks.clear();
     m_loadConfigInfo.clear();
     m_loadConfigDetails.clear();
+    m_loadConfigDirectory = LoadConfigDirectory();
     m_exceptionInfo.clear();
     m_exceptionDetails.clear();
+    m_runtimeFunctions.clear();
     m_certificateInfo.clear();
     m_certificateDetails.clear();
     m_relocationInfo.clear();
     m_relocationDetails.clear();
+    m_relocations.clear();
     m_architectureInfo.clear();
     m_architectureDetails.clear();
     m_globalPointerInfo.clear();
     m_globalPointerDetails.clear();
     m_boundImportInfo.clear();
     m_boundImportDetails.clear();
+    m_boundImports.clear();
     m_iatInfo.clear();
     m_iatDetails.clear();
     m_delayImportInfo.clear();
     m_delayImportDetails.clear();
+    m_delayImportModules.clear();
+    m_delayImportFunctions.clear();
     m_comRuntimeInfo.clear();
     m_comRuntimeDetails.clear();
+    m_clrRuntimeHeader = ClrRuntimeHeader();
+    m_clrMetadata = PEClrMetadata();
+    m_diagnostics.clear();
 }
@@ -2,9 +2,16 @@
 #define PE_DATA_MODEL_H
 
 #include "pe_structures.h"
+#include "pe_rich_header.h"
+#include "pe_rva_set.h"
+#include "pe_clr_metadata.h"
+#include "pe_error_handler.h"
+#include <QByteArray>
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QPair>
+#include <QVector>
 
 class PEDataModel
 {
@@ -15,6 +22,33 @@ public:
         quint16 ordinal = 0;
         quint32 thunkRVA = 0;
         quint32 thunkOffset = 0;
+        QString forwardedTo;        // End of the forwarder chain, from the export index
+    };
+
+    // One IMAGE_DELAYLOAD_DESCRIPTOR; its functions live in the delay import map keyed by dllName
+    struct DelayImportModule {
+        QString dllName;
+        quint32 descriptorOffset = 0;
+        bool rvaBased = true;           // Attributes bit 0; VC6-era descriptors hold VAs instead
+        quint32 moduleHandleRVA = 0;    // All RVAs below are normalized even when the descriptor holds VAs
+        quint32 importAddressTableRVA = 0;
+        quint32 importNameTableRVA = 0;
+        quint32 boundImportAddressTableRVA = 0;
+        quint32 unloadInformationTableRVA = 0;
+        quint32 timeDateStamp = 0;
+    };
+
+    // One IMAGE_BOUND_IMPORT_DESCRIPTOR with the forwarder references that follow it
+    struct BoundForwarderRef {
+        QString moduleName;
+        quint32 timeDateStamp = 0;
+    };
+
+    struct BoundImportEntry {
+        QString moduleName;
+        quint32 timeDateStamp = 0;
+        quint32 fileOffset = 0;
+        QList<BoundForwarderRef> forwarders;
     };
 
     struct ExportFunctionEntry {
@@ -22,6 +56,163 @@ public:
         quint16 ordinal = 0;
         quint32 rva = 0;
         quint32 fileOffset = 0;
+        QString forwarder;          // "DLL.Function" or "DLL.#ordinal" when rva points into the export directory
+    };
+
+    // One leaf of the Type/Name/Language resource tree. The payload itself is
+    // not copied; it is referenced by file offset and size and read on demand.
+    struct ResourceEntry {
+        quint32 typeId = 0;
+        QString typeName;
+        quint32 nameId = 0;
+        QString name;
+        quint16 languageId = 0;
+        quint32 dataRVA = 0;
+        quint32 fileOffset = 0;
+        quint32 size = 0;
+        quint32 codePage = 0;
+    };
+
+    // One .pdata entry. For ARM/ARM64 the end address is derived from the
+    // packed unwind data or the .xdata header.
+    struct RuntimeFunctionEntry {
+        quint32 beginAddress = 0;
+        quint32 endAddress = 0;
+        quint32 unwindData = 0;
+    };
+
+    // Decoded x64 UNWIND_INFO, produced on demand for a single function
+    struct UnwindInfoEntry {
+        bool valid = false;
+        quint8 version = 0;
+        quint8 flags = 0;
+        quint8 sizeOfProlog = 0;
+        quint8 frameRegister = 0;
+        quint8 frameOffset = 0;
+        QList<quint16> unwindCodes;
+        quint32 exceptionHandlerRVA = 0;
+        RuntimeFunctionEntry chainedFunction;
+    };
+
+    // One record of a POGO debug entry: a section contribution laid out by the linker
+    struct PogoEntry {
+        quint32 rva = 0;
+        quint32 size = 0;
+        QString name;
+    };
+
+    // One IMAGE_DEBUG_DIRECTORY entry. The payload is decoded by type; fields
+    // that do not belong to the entry's type keep their defaults.
+    struct DebugEntry {
+        quint32 fileOffset = 0;         // Offset of the IMAGE_DEBUG_DIRECTORY itself
+        quint32 type = 0;
+        quint32 timeDateStamp = 0;
+        quint16 majorVersion = 0;
+        quint16 minorVersion = 0;
+        quint32 sizeOfData = 0;
+        quint32 addressOfRawData = 0;
+        quint32 pointerToRawData = 0;
+
+        // CODEVIEW
+        QString codeViewFormat;         // "RSDS" or "NB10"
+        QString pdbGuid;                // {GUID} for RSDS, 8 hex digit signature for NB10
+        quint32 pdbAge = 0;
+        QString pdbPath;
+        QString pdbKey;                 // Symbol server key: GUID/signature hex followed by age hex
+
+        // POGO
+        QString pogoFormat;             // "PGU", "PGI", "PGO" or "LTCG"
+        QList<PogoEntry> pogoEntries;
+
+        // VC_FEATURE: number of objects built with each feature
+        quint32 preVC11Count = 0;
+        quint32 cAndCppCount = 0;
+        quint32 gsCount = 0;
+        quint32 sdlCount = 0;
+        quint32 guardNCount = 0;
+
+        // REPRO: hash of the build inputs; empty when the timestamp field is the hash
+        QByteArray reproHash;
+
+        // EX_DLLCHARACTERISTICS
+        quint32 exDllCharacteristics = 0;
+    };
+
+    // One entry of the TLS callback array
+    struct TLSCallbackEntry {
+        quint32 fileOffset = 0;         // Offset of the array slot holding the VA
+        quint64 va = 0;
+        quint32 rva = 0;                // 0 when the VA lies below ImageBase
+        int sectionIndex = -1;          // -1 when no section maps the RVA
+        bool executable = false;        // Target section has IMAGE_SCN_MEM_EXECUTE
+    };
+
+    // Load configuration directory and the control flow guard tables it references.
+    // Table targets are RVAs; counts are as declared, the sets hold what the file provides.
+    struct LoadConfigDirectory {
+        bool present = false;
+        quint32 fileOffset = 0;
+        quint32 size = 0;               // Size field, i.e. how much of the structure the linker wrote
+        quint32 timeDateStamp = 0;
+        quint64 securityCookie = 0;
+        quint32 guardFlags = 0;
+        quint32 guardTableStride = 0;   // Metadata bytes after each guard table RVA
+        quint64 guardCFCheckFunctionPointer = 0;
+        quint64 guardCFDispatchFunctionPointer = 0;
+        quint64 guardCFFunctionCount = 0;
+        quint64 guardAddressTakenIatEntryCount = 0;
+        quint64 guardLongJumpTargetCount = 0;
+        quint64 guardEHContinuationCount = 0;
+        quint64 seHandlerCount = 0;
+        PERvaSet guardCFFunctions;
+        PERvaSet suppressedFunctions;   // FID_SUPPRESSED or EXPORT_SUPPRESSED in the metadata
+        PERvaSet addressTakenIatEntries;
+        PERvaSet longJumpTargets;
+        PERvaSet ehContinuationTargets;
+        PERvaSet seHandlers;            // SafeSEH, 32-bit images only
+        bool truncated = false;         // A table ran past the end of the file
+    };
+
+    // CLR runtime header of a .NET image; the metadata itself is read lazily through PEClrMetadata
+    struct ClrRuntimeHeader {
+        bool present = false;
+        quint32 fileOffset = 0;
+        IMAGE_COR20_HEADER header = {};
+    };
+
+    // Statistics of one byte range (whole file or section raw data), gathered in a single pass
+    struct ContentDigest {
+        QString md5;                    // Lower-case hex; empty for an empty range
+        QString sha256;
+        QString similarityHash;         // Empty when the range is too short or too uniform
+        double entropy = 0.0;
+        double zeroRunCoverage = 0.0;   // Share of bytes in runs of 16 or more zero bytes
+        double printableRatio = 0.0;    // Share of printable ASCII, tab, CR and LF
+        QVector<quint64> histogram;     // Occurrences of each byte value
+        qint64 size = 0;
+    };
+
+    // Bytes past the end of the image, i.e. past the headers and the raw data of
+    // every section. The certificate table is not overlay even where signing
+    // appended it there, so the overlay can be split in two around it.
+    struct Overlay {
+        qint64 offset = 0;              // End of the image
+        qint64 size = 0;                // Overlay bytes, certificate table excluded
+        QVector<QPair<qint64, qint64>> ranges; // [start, end) file ranges holding them
+    };
+
+    // A PE image carved from the overlay or a resource payload and parsed on its own.
+    // Images found inside embedded images follow their container with a greater depth.
+    struct EmbeddedImage {
+        qint64 fileOffset = 0;          // Offset of its MZ header in this file
+        qint64 size = 0;                // Headers, section raw data and certificate table, clamped to the container
+        QString container;              // "overlay" or "resource"
+        int depth = 0;                  // 0 for images directly inside this file
+        bool parsed = false;            // Headers were valid but a later stage may still have failed
+        quint16 machine = 0;
+        quint16 characteristics = 0;
+        QString sha256;
+        QString importHash;
     };
 
     PEDataModel();
@@ -54,30 +245,61 @@ public:
 
     void setExportFunctions(const QList<ExportFunctionEntry> &functions);
     const QList<ExportFunctionEntry>& getExportFunctions() const;
+
+    // Import/export fingerprints (lower-case hex MD5, empty when not applicable)
+    void setImportHash(const QString &hash);
+    QString getImportHash() const;
+    void setExportHash(const QString &hash);
+    QString getExportHash() const;
+
+    // Decoded Rich header (found == false when the file has none)
+    void setRichHeader(const PERichHeader::Info &richHeader);
+    const PERichHeader::Info& getRichHeader() const;
+
+    // Content digests of the whole file and of each section (index-aligned with getSections())
+    void setFileContentDigest(const ContentDigest &digest);
+    const ContentDigest& getFileContentDigest() const;
+    void setSectionContentDigests(const QList<ContentDigest> &digests);
+    const QList<ContentDigest>& getSectionContentDigests() const;
+    
+    // Overlay and embedded images
+    void setOverlay(const Overlay &overlay);
+    const Overlay& getOverlay() const;
+    void setEmbeddedImages(const QList<EmbeddedImage> &images);
+    const QList<EmbeddedImage>& getEmbeddedImages() const;
     
     // Resources
     void setResourceTypes(const QStringList &types);
     void setResources(const QMap<QString, QMap<QString, QString>> &resources);
     QStringList getResourceTypes() const;
     QMap<QString, QMap<QString, QString>> getResources() const;
+    void setResourceEntries(const QList<ResourceEntry> &entries);
+    const QList<ResourceEntry>& getResourceEntries() const;
     
     // Debug info
     void setDebugInfo(const QStringList &info);
     void setDebugDetails(const QMap<QString, QString> &details);
     QStringList getDebugInfo() const;
     QMap<QString, QString> getDebugDetails() const;
+    void setDebugEntries(const QList<DebugEntry> &entries);
+    const QList<DebugEntry>& getDebugEntries() const;
+    QString getPdbKey() const;      // Key of the first CodeView entry, empty if none
     
     // TLS info
     void setTLSInfo(const QStringList &info);
     void setTLSDetails(const QMap<QString, QString> &details);
     QStringList getTLSInfo() const;
     QMap<QString, QString> getTLSDetails() const;
+    void setTLSCallbacks(const QList<TLSCallbackEntry> &callbacks);
+    const QList<TLSCallbackEntry>& getTLSCallbacks() const;
     
     // Load Configuration info
     void setLoadConfigInfo(const QStringList &info);
     void setLoadConfigDetails(const QMap<QString, QString> &details);
     QStringList getLoadConfigInfo() const;
     QMap<QString, QString> getLoadConfigDetails() const;
+    void setLoadConfigDirectory(const LoadConfigDirectory &directory);
+    const LoadConfigDirectory& getLoadConfigDirectory() const;
     
     // Exception info
     void setExceptionInfo(const QStringList &info);
@@ -85,6 +307,11 @@ public:
     QStringList getExceptionInfo() const;
     QMap<QString, QString> getExceptionDetails() const;
     
+    // Runtime functions, sorted by begin address
+    void setRuntimeFunctions(const QList<RuntimeFunctionEntry> &functions);
+    const QList<RuntimeFunctionEntry>& getRuntimeFunctions() const;
+    int findRuntimeFunction(quint32 rva) const;
+    
     // Certificate info
     void setCertificateInfo(const QStringList &info);
     void setCertificateDetails(const QMap<QString, QString> &details);
@@ -97,6 +324,13 @@ public:
     QStringList getRelocationInfo() const;
     QMap<QString, QString> getRelocationDetails() const;
     
+    // Base relocations, packed as (RVA << 8) | type and sorted by RVA
+    void setRelocations(const QList<quint64> &relocations);
+    const QList<quint64>& getRelocations() const;
+    QList<quint64> getRelocationsInRange(quint32 startRVA, quint32 endRVA) const;
+    static quint32 relocationRVA(quint64 packed) { return static_cast<quint32>(packed >> 8); }
+    static quint8 relocationType(quint64 packed) { return static_cast<quint8>(packed & 0xFF); }
+    
     // Architecture info
     void setArchitectureInfo(const QStringList &info);
     void setArchitectureDetails(const QMap<QString, QString> &details);
@@ -114,6 +348,8 @@ public:
     void setBoundImportDetails(const QMap<QString, QString> &details);
     QStringList getBoundImportInfo() const;
     QMap<QString, QString> getBoundImportDetails() const;
+    void setBoundImports(const QList<BoundImportEntry> &entries);
+    const QList<BoundImportEntry>& getBoundImports() const;
     
     // IAT info
     void setIATInfo(const QStringList &info);
@@ -126,12 +362,24 @@ public:
     void setDelayImportDetails(const QMap<QString, QString> &details);
     QStringList getDelayImportInfo() const;
     QMap<QString, QString> getDelayImportDetails() const;
+    void setDelayImportModules(const QList<DelayImportModule> &modules);
+    const QList<DelayImportModule>& getDelayImportModules() const;
+    void setDelayImportFunctions(const QMap<QString, QList<ImportFunctionEntry>> &details);
+    const QMap<QString, QList<ImportFunctionEntry>>& getDelayImportFunctions() const;
     
     // COM+ Runtime info
     void setCOMRuntimeInfo(const QStringList &info);
     void setCOMRuntimeDetails(const QMap<QString, QString> &details);
     QStringList getCOMRuntimeInfo() const;
     QMap<QString, QString> getCOMRuntimeDetails() const;
+    void setClrRuntimeHeader(const ClrRuntimeHeader &header);
+    const ClrRuntimeHeader& getClrRuntimeHeader() const;
+    void setClrMetadata(const PEClrMetadata &metadata);
+    const PEClrMetadata& getClrMetadata() const;
+    
+    // Malformations found while parsing this file
+    void reportDiagnostic(PEErrorType type, quint64 fileOffset, const QString &detail = QString());
+    const PEDiagnostics& getDiagnostics() const;
     
     // Validation
     bool isValid() const;
@@ -158,26 +406,42 @@ private:
     QStringList m_imports;
     QMap<QString, QList<ImportFunctionEntry>> m_importFunctionDetails;
     QList<ExportFunctionEntry> m_exportFunctions;
+    QString m_importHash;
+    QString m_exportHash;
+    PERichHeader::Info m_richHeader;
+    
+    // Content digests
+    ContentDigest m_fileContentDigest;
+    QList<ContentDigest> m_sectionContentDigests;
+    
+    // Overlay and embedded images
+    Overlay m_overlay;
+    QList<EmbeddedImage> m_embeddedImages;
     
     // Resources
     QStringList m_resourceTypes;
     QMap<QString, QMap<QString, QString>> m_resources;
+    QList<ResourceEntry> m_resourceEntries;
     
     // Debug info
     QStringList m_debugInfo;
     QMap<QString, QString> m_debugDetails;
+    QList<DebugEntry> m_debugEntries;
     
     // TLS info
     QStringList m_tlsInfo;
     QMap<QString, QString> m_tlsDetails;
+    QList<TLSCallbackEntry> m_tlsCallbacks;
     
     // Load Configuration info
     QStringList m_loadConfigInfo;
     QMap<QString, QString> m_loadConfigDetails;
+    LoadConfigDirectory m_loadConfigDirectory;
     
     // Exception info
     QStringList m_exceptionInfo;
     QMap<QString, QString> m_exceptionDetails;
+    QList<RuntimeFunctionEntry> m_runtimeFunctions;
     
     // Certificate info
     QStringList m_certificateInfo;
@@ -186,6 +450,7 @@ private:
     // Relocation info
     QStringList m_relocationInfo;
     QMap<QString, QString> m_relocationDetails;
+    QList<quint64> m_relocations;
     
     // Architecture info
     QStringList m_architectureInfo;
@@ -198,6 +463,7 @@ private:
     // Bound Import info
     QStringList m_boundImportInfo;
     QMap<QString, QString> m_boundImportDetails;
+    QList<BoundImportEntry> m_boundImports;
     
     // IAT info
     QStringList m_iatInfo;
@@ -206,10 +472,16 @@ private:
     // Delay Import info
     QStringList m_delayImportInfo;
     QMap<QString, QString> m_delayImportDetails;
+    QList<DelayImportModule> m_delayImportModules;
+    QMap<QString, QList<ImportFunctionEntry>> m_delayImportFunctions;
     
     // COM+ Runtime info
     QStringList m_comRuntimeInfo;
     QMap<QString, QString> m_comRuntimeDetails;
+    ClrRuntimeHeader m_clrRuntimeHeader;
+    PEClrMetadata m_clrMetadata;        // Shares the file buffer until cleared
+    
+    PEDiagnostics m_diagnostics;
 };
 
 #endif // PE_DATA_MODEL_H
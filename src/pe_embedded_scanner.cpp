@@ -0,0 +1,157 @@
+#include "pe_embedded_scanner.h"
+#include "pe_structures.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+struct Chunk {
+    qint64 start = 0;               // Candidates must start in [start, end)
+    qint64 end = 0;
+    qint64 rangeEnd = 0;            // ... and fit before rangeEnd
+    int range = -1;
+};
+
+template <typename T>
+bool readAt(const char *image, qint64 available, qint64 offset, T *value)
+{
+    if (offset < 0 || offset + static_cast<qint64>(sizeof(T)) > available) {
+        return false;
+    }
+    std::memcpy(value, image + offset, sizeof(T));
+    return true;
+}
+
+} // namespace
+
+qint64 PEEmbeddedScanner::carvedImageSize(const char *image, qint64 available)
+{
+    IMAGE_DOS_HEADER dosHeader;
+    if (!readAt(image, available, 0, &dosHeader) || dosHeader.e_magic != IMAGE_DOS_SIGNATURE ||
+        dosHeader.e_lfanew < static_cast<qint32>(sizeof(IMAGE_DOS_HEADER)) || dosHeader.e_lfanew > MAX_PE_HEADER_OFFSET) {
+        return 0;
+    }
+
+    quint32 signature = 0;
+    IMAGE_FILE_HEADER fileHeader;
+    quint16 magic = 0;
+    const qint64 fileHeaderOffset = static_cast<qint64>(dosHeader.e_lfanew) + sizeof(quint32);
+    const qint64 optionalHeaderOffset = fileHeaderOffset + sizeof(IMAGE_FILE_HEADER);
+    if (!readAt(image, available, dosHeader.e_lfanew, &signature) || signature != IMAGE_NT_SIGNATURE ||
+        !readAt(image, available, fileHeaderOffset, &fileHeader) ||
+        !readAt(image, available, optionalHeaderOffset, &magic)) {
+        return 0;
+    }
+
+    qint64 dataDirectoryOffset = 0;
+    if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+        dataDirectoryOffset = optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory);
+    } else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+        dataDirectoryOffset = optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory);
+    } else {
+        return 0;
+    }
+
+    const qint64 sectionTableOffset = optionalHeaderOffset + fileHeader.SizeOfOptionalHeader;
+    const qint64 sectionTableEnd = sectionTableOffset + fileHeader.NumberOfSections * static_cast<qint64>(sizeof(IMAGE_SECTION_HEADER));
+    if (fileHeader.NumberOfSections == 0 || fileHeader.NumberOfSections > MAX_SECTIONS || sectionTableEnd > available) {
+        return 0;
+    }
+
+    // SizeOfHeaders sits at the same offset in both layouts
+    qint64 end = sectionTableEnd;
+    quint32 sizeOfHeaders = 0;
+    if (readAt(image, available, optionalHeaderOffset + offsetof(IMAGE_OPTIONAL_HEADER32, SizeOfHeaders), &sizeOfHeaders)) {
+        end = qMax<qint64>(end, sizeOfHeaders);
+    }
+
+    for (quint16 i = 0; i < fileHeader.NumberOfSections; ++i) {
+        IMAGE_SECTION_HEADER section;
+        std::memcpy(&section, image + sectionTableOffset + i * static_cast<qint64>(sizeof(IMAGE_SECTION_HEADER)), sizeof(section));
+        if (section.PointerToRawData != 0 && section.SizeOfRawData != 0) {
+            end = qMax<qint64>(end, static_cast<qint64>(section.PointerToRawData) + section.SizeOfRawData);
+        }
+    }
+
+    // A signed payload keeps its certificate table, which follows the sections
+    quint32 numberOfRvaAndSizes = 0;
+    IMAGE_DATA_DIRECTORY securityDirectory = {};
+    const qint64 securityDirectoryOffset = dataDirectoryOffset + IMAGE_DIRECTORY_ENTRY_SECURITY * sizeof(IMAGE_DATA_DIRECTORY);
+    if (readAt(image, available, dataDirectoryOffset - sizeof(quint32), &numberOfRvaAndSizes) &&
+        numberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_SECURITY &&
+        securityDirectoryOffset + static_cast<qint64>(sizeof(IMAGE_DATA_DIRECTORY)) <= sectionTableOffset &&
+        readAt(image, available, securityDirectoryOffset, &securityDirectory) &&
+        securityDirectory.VirtualAddress != 0 && securityDirectory.Size != 0) {
+        end = qMax<qint64>(end, static_cast<qint64>(securityDirectory.VirtualAddress) + securityDirectory.Size);
+    }
+
+    return qMin(end, available);
+}
+
+QVector<PEEmbeddedScanner::Hit> PEEmbeddedScanner::scan(const QByteArray &data, const QVector<QPair<qint64, qint64>> &ranges,
+                                                       int maxHits)
+{
+    QVector<Chunk> chunks;
+    for (int i = 0; i < ranges.size(); ++i) {
+        const qint64 rangeStart = qBound<qint64>(0, ranges[i].first, data.size());
+        const qint64 rangeEnd = qBound<qint64>(rangeStart, ranges[i].second, data.size());
+        for (qint64 start = rangeStart; start < rangeEnd; start += SCAN_CHUNK_SIZE) {
+            Chunk chunk;
+            chunk.start = start;
+            chunk.end = qMin(start + SCAN_CHUNK_SIZE, rangeEnd);
+            chunk.rangeEnd = rangeEnd;
+            chunk.range = i;
+            chunks.append(chunk);
+        }
+    }
+
+    auto scanChunk = [data](const Chunk &chunk) {
+        QVector<Hit> hits;
+        const char *base = data.constData();
+        const char *cursor = base + chunk.start;
+        const char *end = base + chunk.end;
+        while (cursor < end) {
+            const char *found = static_cast<const char*>(std::memchr(cursor, 'M', static_cast<size_t>(end - cursor)));
+            if (!found) {
+                break;
+            }
+            const qint64 offset = found - base;
+            if (offset + 1 < chunk.rangeEnd && found[1] == 'Z') {
+                const qint64 size = carvedImageSize(found, chunk.rangeEnd - offset);
+                if (size > 0) {
+                    Hit hit;
+                    hit.offset = offset;
+                    hit.size = size;
+                    hit.range = chunk.range;
+                    hits.append(hit);
+                }
+            }
+            cursor = found + 1;
+        }
+        return hits;
+    };
+
+    const QList<QVector<Hit>> chunkHits = QtConcurrent::blockingMapped<QList<QVector<Hit>>>(chunks, scanChunk);
+
+    QVector<Hit> candidates;
+    for (const QVector<Hit> &hits : chunkHits) {
+        candidates += hits;
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Hit &a, const Hit &b) { return a.offset < b.offset; });
+
+    QVector<Hit> hits;
+    qint64 coveredEnd = -1;
+    for (const Hit &hit : candidates) {
+        if (hits.size() >= maxHits) {
+            break;
+        }
+        if (hit.offset < coveredEnd) {
+            continue;
+        }
+        hits.append(hit);
+        coveredEnd = hit.offset + hit.size;
+    }
+    return hits;
+}
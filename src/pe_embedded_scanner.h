@@ -0,0 +1,66 @@
+/**
+ * @file pe_embedded_scanner.h
+ * @brief Finds and carves PE images embedded in byte ranges of a file
+ *
+ * Installers, droppers and packers store payload executables in the
+ * overlay or in resources. A candidate is any "MZ" whose e_lfanew leads,
+ * within the containing range, to a "PE\0\0" signature, a known optional
+ * header magic and a section table that fits:
+ *
+ *   MZ ... e_lfanew --> "PE\0\0", IMAGE_FILE_HEADER, Magic 0x10b/0x20b,
+ *                       NumberOfSections (1..96) section headers
+ *
+ * The carved size is what the embedded headers describe: the headers, the
+ * raw data of every section and a trailing certificate table, clamped to
+ * the containing range. Random data passes all of these checks practically
+ * never, so the scan has next to no false positives.
+ *
+ * Ranges are split into chunks scanned in parallel on the global thread
+ * pool. Each chunk is searched with memchr(), which every mainstream C
+ * library implements with SIMD, so the scan runs at memory bandwidth and
+ * only the rare 'M' bytes followed by 'Z' are validated.
+ */
+
+#ifndef PE_EMBEDDED_SCANNER_H
+#define PE_EMBEDDED_SCANNER_H
+
+#include <QByteArray>
+#include <QPair>
+#include <QVector>
+#include <QtGlobal>
+
+class PEEmbeddedScanner
+{
+public:
+    struct Hit {
+        qint64 offset = 0;          // Offset of the MZ header in the scanned data
+        qint64 size = 0;            // Carved size
+        int range = -1;             // Index of the range it was found in
+    };
+
+    /**
+     * @brief Finds the PE images that start in the given ranges
+     * @param data Scanned bytes, e.g. a parser's view of the whole file
+     * @param ranges [start, end) ranges of data; an image must fit its range
+     * @param maxHits Stop after this many images
+     * @return Images ordered by offset
+     *
+     * Candidates that lie inside an image found earlier are dropped; they
+     * belong to that image and turn up when it is scanned in turn.
+     */
+    static QVector<Hit> scan(const QByteArray &data, const QVector<QPair<qint64, qint64>> &ranges, int maxHits);
+
+    /**
+     * @brief Validates the headers of a PE image and returns its carved size
+     * @param image Points at the "MZ" of the candidate
+     * @param available Bytes readable from image on
+     * @return Size in bytes, at most available, or 0 if the headers are not a PE image
+     */
+    static qint64 carvedImageSize(const char *image, qint64 available);
+
+    static constexpr qint64 SCAN_CHUNK_SIZE = 16 * 1024 * 1024;
+    static constexpr qint32 MAX_PE_HEADER_OFFSET = 0x10000;    ///< Larger e_lfanew values are treated as noise
+    static constexpr quint16 MAX_SECTIONS = 96;                 ///< Loader limit on NumberOfSections
+};
+
+#endif // PE_EMBEDDED_SCANNER_H
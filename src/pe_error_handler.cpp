@@ -4,138 +4,107 @@
  */
 
 #include "pe_error_handler.h"
-#include "language_manager.h"
-#include <QDebug>
-#include <QFileInfo>
 
-PEErrorHandler& PEErrorHandler::getInstance()
+void PEDiagnostics::report(PEErrorType type, quint64 fileOffset, const QString &detail)
 {
-    static PEErrorHandler instance;
-    return instance;
+    report(type, PEError::defaultSeverity(type), fileOffset, detail);
 }
 
-PEError PEErrorHandler::createError(PEErrorType type, const QString &message,
-                                   const QString &context,
-                                   quint32 offset,
-                                   const QString &expected,
-                                   const QString &actual)
+void PEDiagnostics::report(PEErrorType type, PEErrorSeverity severity, quint64 fileOffset, const QString &detail)
 {
-    PEError error;
-    error.type = type;
-    error.message = message;
-    error.context = context.isEmpty() ? m_currentOperation : context;
-    error.fileOffset = offset;
-    error.expectedValue = expected;
-    error.actualValue = actual;
-    
-    // Determine severity based on error type
-    switch (type) {
-        case PEErrorType::FileNotFound:
-        case PEErrorType::FileAccessDenied:
-        case PEErrorType::InvalidDOSHeader:
-        case PEErrorType::InvalidPESignature:
-        case PEErrorType::MemoryAllocationFailed:
-            error.severity = PEErrorSeverity::Critical;
-            break;
-        case PEErrorType::FileTooSmall:
-        case PEErrorType::InvalidFileHeader:
-        case PEErrorType::InvalidOptionalHeader:
-        case PEErrorType::SectionTableCorrupted:
-            error.severity = PEErrorSeverity::Error;
-            break;
-        case PEErrorType::DataDirectoryCorrupted:
-        case PEErrorType::InvalidRVA:
-        case PEErrorType::InvalidOffset:
-            error.severity = PEErrorSeverity::Warning;
-            break;
-        default:
-            error.severity = PEErrorSeverity::Info;
-            break;
-    }
-    
-    // Generate recovery suggestions
-    error.recoverySuggestions = generateRecoverySuggestions(type);
-    
-    return error;
+    m_records.append({fileOffset, m_details.size(), detail.size(), type, severity});
+    m_details.append(detail);
 }
 
-void PEErrorHandler::reportError(const PEError &error)
+void PEDiagnostics::merge(const PEDiagnostics &other, const QString &context)
 {
-    m_errors.append(error);
-    
-    QString errorMsg = QString("[%1] %2")
-        .arg(getSeverityString(error.severity))
-        .arg(error.toString());
+    if (context.isEmpty()) {
+        qsizetype base = m_details.size();
+        m_records.reserve(m_records.size() + other.m_records.size());
+        for (const Record &record : other.m_records) {
+            m_records.append({record.fileOffset, base + record.detailStart, record.detailLength, record.type, record.severity});
+        }
+        m_details.append(other.m_details);
+        return;
+    }
     
-    if (error.severity == PEErrorSeverity::Critical) {
-        qCritical() << errorMsg;
-    } else if (error.severity == PEErrorSeverity::Error) {
-        qWarning() << errorMsg;
-    } else {
-        qDebug() << errorMsg;
+    for (int i = 0; i < other.size(); ++i) {
+        QString detail = other.detail(i);
+        report(other.type(i), other.severity(i), other.fileOffset(i), detail.isEmpty() ? context : context + ": " + detail);
     }
 }
 
-void PEErrorHandler::reportWarning(const QString &message, const QString &context)
+void PEDiagnostics::clear()
 {
-    PEError error = createError(PEErrorType::UnknownError, message, context);
-    error.severity = PEErrorSeverity::Warning;
-    reportError(error);
+    m_records.clear();
+    m_details.clear();
 }
 
-void PEErrorHandler::reportInfo(const QString &message, const QString &context)
+QString PEDiagnostics::detail(int index) const
 {
-    PEError error = createError(PEErrorType::None, message, context);
-    error.severity = PEErrorSeverity::Info;
-    reportError(error);
+    const Record &record = m_records[index];
+    return m_details.mid(record.detailStart, record.detailLength);
 }
 
-void PEErrorHandler::clearErrors()
+PEError PEDiagnostics::error(int index) const
 {
-    m_errors.clear();
+    const Record &record = m_records[index];
+    PEError error;
+    error.type = record.type;
+    error.severity = record.severity;
+    error.message = detail(index);
+    error.fileOffset = static_cast<quint32>(qMin<quint64>(record.fileOffset, 0xFFFFFFFF));
+    error.recoverySuggestions = PEError::recoverySuggestions(record.type);
+    return error;
 }
 
-QList<PEError> PEErrorHandler::getCriticalErrors() const
+QList<PEError> PEDiagnostics::errors() const
 {
-    QList<PEError> critical;
-    for (const PEError &error : m_errors) {
-        if (error.isCritical()) {
-            critical.append(error);
-        }
+    QList<PEError> result;
+    result.reserve(m_records.size());
+    for (int i = 0; i < size(); ++i) {
+        result.append(error(i));
     }
-    return critical;
+    return result;
 }
 
-bool PEErrorHandler::hasCriticalErrors() const
+int PEDiagnostics::count(PEErrorSeverity minimum) const
 {
-    for (const PEError &error : m_errors) {
-        if (error.isCritical()) {
-            return true;
+    int matches = 0;
+    for (const Record &record : m_records) {
+        if (record.severity >= minimum) {
+            ++matches;
         }
     }
-    return false;
-}
-
-void PEErrorHandler::setCurrentFile(const QString &filePath)
-{
-    m_currentFile = filePath;
-}
-
-void PEErrorHandler::setCurrentOperation(const QString &operation)
-{
-    m_currentOperation = operation;
+    return matches;
 }
 
-QStringList PEErrorHandler::getRecoverySuggestions() const
+PEErrorSeverity PEError::defaultSeverity(PEErrorType type)
 {
-    QStringList suggestions;
-    for (const PEError &error : m_errors) {
-        suggestions.append(error.recoverySuggestions);
+    switch (type) {
+        case PEErrorType::FileNotFound:
+        case PEErrorType::FileAccessDenied:
+        case PEErrorType::InvalidDOSHeader:
+        case PEErrorType::InvalidPESignature:
+        case PEErrorType::MemoryAllocationFailed:
+            return PEErrorSeverity::Critical;
+        case PEErrorType::FileTooSmall:
+        case PEErrorType::InvalidFileHeader:
+        case PEErrorType::InvalidOptionalHeader:
+        case PEErrorType::SectionTableCorrupted:
+            return PEErrorSeverity::Error;
+        case PEErrorType::DataDirectoryCorrupted:
+        case PEErrorType::InvalidRVA:
+        case PEErrorType::InvalidOffset:
+        case PEErrorType::TableTruncated:
+        case PEErrorType::LimitExceeded:
+            return PEErrorSeverity::Warning;
+        default:
+            return PEErrorSeverity::Info;
     }
-    return suggestions;
 }
 
-QStringList PEErrorHandler::generateRecoverySuggestions(PEErrorType type) const
+QStringList PEError::recoverySuggestions(PEErrorType type)
 {
     QStringList suggestions;
     
@@ -180,6 +149,14 @@ QStringList PEErrorHandler::generateRecoverySuggestions(PEErrorType type) const
                         << "Check section alignment"
                         << "Verify PE structure integrity";
             break;
+        case PEErrorType::TableTruncated:
+            suggestions << "Entries past the end of the file were skipped"
+                        << "File may be truncated or packed";
+            break;
+        case PEErrorType::LimitExceeded:
+            suggestions << "Only the first entries were parsed"
+                        << "Very large counts are typical of malformed or hostile files";
+            break;
         case PEErrorType::MemoryAllocationFailed:
             suggestions << "File may be too large"
                         << "Try using streaming mode"
@@ -192,27 +169,7 @@ QStringList PEErrorHandler::generateRecoverySuggestions(PEErrorType type) const
     return suggestions;
 }
 
-QString PEErrorHandler::getErrorTypeString(PEErrorType type) const
-{
-    switch (type) {
-        case PEErrorType::FileNotFound: return "File Not Found";
-        case PEErrorType::FileAccessDenied: return "File Access Denied";
-        case PEErrorType::FileTooSmall: return "File Too Small";
-        case PEErrorType::InvalidDOSHeader: return "Invalid DOS Header";
-        case PEErrorType::InvalidPESignature: return "Invalid PE Signature";
-        case PEErrorType::InvalidFileHeader: return "Invalid File Header";
-        case PEErrorType::InvalidOptionalHeader: return "Invalid Optional Header";
-        case PEErrorType::SectionTableCorrupted: return "Section Table Corrupted";
-        case PEErrorType::DataDirectoryCorrupted: return "Data Directory Corrupted";
-        case PEErrorType::InvalidRVA: return "Invalid RVA";
-        case PEErrorType::InvalidOffset: return "Invalid Offset";
-        case PEErrorType::MemoryAllocationFailed: return "Memory Allocation Failed";
-        case PEErrorType::ParsingFailed: return "Parsing Failed";
-        default: return "Unknown Error";
-    }
-}
-
-QString PEErrorHandler::getSeverityString(PEErrorSeverity severity) const
+QString PEError::getSeverityString(PEErrorSeverity severity)
 {
     switch (severity) {
         case PEErrorSeverity::Info: return "INFO";
@@ -257,7 +214,7 @@ bool PEError::isRecoverable() const
     }
 }
 
-QString PEError::getErrorTypeString(PEErrorType type) const
+QString PEError::getErrorTypeString(PEErrorType type)
 {
     switch (type) {
         case PEErrorType::FileNotFound: return "File Not Found";
@@ -273,6 +230,8 @@ QString PEError::getErrorTypeString(PEErrorType type) const
         case PEErrorType::InvalidOffset: return "Invalid Offset";
         case PEErrorType::MemoryAllocationFailed: return "Memory Allocation Failed";
         case PEErrorType::ParsingFailed: return "Parsing Failed";
+        case PEErrorType::TableTruncated: return "Table Truncated";
+        case PEErrorType::LimitExceeded: return "Limit Exceeded";
         default: return "Unknown Error";
     }
 }
@@ -4,6 +4,9 @@
  * 
  * This file provides comprehensive error handling with context,
  * recovery suggestions, and detailed error reporting.
+ * 
+ * Malformations are collected per parse in a PEDiagnostics owned by the
+ * file's PEDataModel, so files parsed concurrently never share state.
  */
 
 #ifndef PE_ERROR_HANDLER_H
@@ -12,6 +15,7 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QVector>
 #include <QException>
 
 /**
@@ -32,6 +36,8 @@ enum class PEErrorType {
     InvalidOffset,
     MemoryAllocationFailed,
     ParsingFailed,
+    TableTruncated,         ///< A table is shorter than its header declares
+    LimitExceeded,          ///< Parsing stopped at a safety limit
     UnknownError
 };
 
@@ -65,65 +71,66 @@ struct PEError {
     bool isCritical() const { return severity == PEErrorSeverity::Critical; }
     bool isRecoverable() const;
     
-private:
-    QString getErrorTypeString(PEErrorType type) const;
+    static PEErrorSeverity defaultSeverity(PEErrorType type);
+    static QStringList recoverySuggestions(PEErrorType type);
+    static QString getErrorTypeString(PEErrorType type);
+    static QString getSeverityString(PEErrorSeverity severity);
 };
 
 /**
- * @brief Enhanced error handler for PE parsing operations
+ * @brief Append-only log of the problems found while parsing one file
  * 
- * This class provides:
- * - Detailed error context
- * - Recovery suggestions
- * - Error aggregation
- * - Error reporting
+ * Each parse owns its own instance (see PEDataModel::reportDiagnostic), so
+ * there is no shared state to lock. Records are fixed-size and all detail
+ * text lives in one arena string, so reporting is an append to two
+ * contiguous buffers and merging the logs of many files is two bulk copies.
+ * PEError values, with recovery suggestions, are only built when read.
  */
-class PEErrorHandler
+class PEDiagnostics
 {
 public:
-    static PEErrorHandler& getInstance();
+    /**
+     * @brief Records a problem with the severity implied by its type
+     * @param fileOffset Where the malformed structure starts, 0 if unknown
+     */
+    void report(PEErrorType type, quint64 fileOffset, const QString &detail = QString());
+    void report(PEErrorType type, PEErrorSeverity severity, quint64 fileOffset, const QString &detail);
     
-    // Error creation
-    PEError createError(PEErrorType type, const QString &message, 
-                       const QString &context = QString(),
-                       quint32 offset = 0,
-                       const QString &expected = QString(),
-                       const QString &actual = QString());
+    /**
+     * @brief Appends another log, e.g. to combine per-file results of a batch
+     * @param context Prepended to every merged detail when not empty, such as the file path
+     */
+    void merge(const PEDiagnostics &other, const QString &context = QString());
     
-    // Error reporting
-    void reportError(const PEError &error);
-    void reportWarning(const QString &message, const QString &context = QString());
-    void reportInfo(const QString &message, const QString &context = QString());
+    void clear();
+    int size() const { return static_cast<int>(m_records.size()); }
+    bool isEmpty() const { return m_records.isEmpty(); }
     
-    // Error management
-    void clearErrors();
-    QList<PEError> getErrors() const { return m_errors; }
-    QList<PEError> getCriticalErrors() const;
-    bool hasErrors() const { return !m_errors.isEmpty(); }
-    bool hasCriticalErrors() const;
+    PEErrorType type(int index) const { return m_records[index].type; }
+    PEErrorSeverity severity(int index) const { return m_records[index].severity; }
+    quint64 fileOffset(int index) const { return m_records[index].fileOffset; }
+    QString detail(int index) const;
     
-    // Error context
-    void setCurrentFile(const QString &filePath);
-    void setCurrentOperation(const QString &operation);
-    QString getCurrentFile() const { return m_currentFile; }
-    QString getCurrentOperation() const { return m_currentOperation; }
+    /**
+     * @brief Full error for one record, including recovery suggestions
+     */
+    PEError error(int index) const;
+    QList<PEError> errors() const;
     
-    // Recovery suggestions
-    QStringList getRecoverySuggestions() const;
+    int count(PEErrorSeverity minimum) const;
+    bool hasCriticalErrors() const { return count(PEErrorSeverity::Critical) > 0; }
     
 private:
-    PEErrorHandler() = default;
-    ~PEErrorHandler() = default;
-    PEErrorHandler(const PEErrorHandler&) = delete;
-    PEErrorHandler& operator=(const PEErrorHandler&) = delete;
-    
-    QList<PEError> m_errors;
-    QString m_currentFile;
-    QString m_currentOperation;
+    struct Record {
+        quint64 fileOffset;
+        qsizetype detailStart;      // Into m_details
+        qsizetype detailLength;
+        PEErrorType type;
+        PEErrorSeverity severity;
+    };
     
-    QStringList generateRecoverySuggestions(PEErrorType type) const;
-    QString getErrorTypeString(PEErrorType type) const;
-    QString getSeverityString(PEErrorSeverity severity) const;
+    QVector<Record> m_records;
+    QString m_details;
 };
 
 /**
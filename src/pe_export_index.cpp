@@ -0,0 +1,411 @@
+/**
+ * @file pe_export_index.cpp
+ * @brief Memory-mapped export index implementation
+ */
+
+#include "pe_export_index.h"
+#include "pe_data_directory_parser.h"
+#include "pe_utils.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+struct PEExportIndex::Header {
+    char magic[4];
+    quint32 version;
+    quint32 moduleCount;
+    quint32 exportCount;
+    quint32 stringsSize;
+};
+
+struct PEExportIndex::Module {
+    quint32 name;           // String offset of the module key
+    quint32 firstExport;    // Into Export[] and NameRef[]
+    quint32 exportCount;
+};
+
+struct PEExportIndex::Export {
+    quint32 name;           // 0 when exported by ordinal only
+    quint32 forwarder;      // 0 when the export has code in the module itself
+    quint16 ordinal;
+    quint16 reserved;
+};
+
+namespace {
+
+const char INDEX_MAGIC[4] = {'P', 'E', 'X', 'I'};
+const quint32 INDEX_VERSION = 1;
+
+struct ModuleExports {
+    QString fileName;
+    QList<PEDataModel::ExportFunctionEntry> exports;
+};
+
+// Only the headers, the section table and the export directory are read;
+// the file is mapped so that the rest of the DLL is never paged in
+ModuleExports readModuleExports(const QString &filePath)
+{
+    ModuleExports result;
+    result.fileName = QFileInfo(filePath).fileName();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(sizeof(IMAGE_DOS_HEADER))) {
+        return result;
+    }
+    const uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        return result;
+    }
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(file.size()));
+    const quint64 fileSize = static_cast<quint64>(data.size());
+
+    IMAGE_DOS_HEADER dosHeader;
+    std::memcpy(&dosHeader, data.constData(), sizeof(dosHeader));
+    quint64 peOffset = static_cast<quint32>(dosHeader.e_lfanew);
+    quint64 optionalHeaderOffset = peOffset + sizeof(quint32) + sizeof(IMAGE_FILE_HEADER);
+    if (!PEUtils::isValidDOSMagic(dosHeader.e_magic) || optionalHeaderOffset + sizeof(quint16) > fileSize) {
+        return result;
+    }
+
+    quint32 signature;
+    IMAGE_FILE_HEADER fileHeader;
+    quint16 magic;
+    std::memcpy(&signature, data.constData() + peOffset, sizeof(signature));
+    std::memcpy(&fileHeader, data.constData() + peOffset + sizeof(quint32), sizeof(fileHeader));
+    std::memcpy(&magic, data.constData() + optionalHeaderOffset, sizeof(magic));
+    if (!PEUtils::isValidPESignature(signature) || !PEUtils::isValidOptionalHeaderMagic(magic)) {
+        return result;
+    }
+
+    // The first data directory follows NumberOfRvaAndSizes
+    quint32 rvaCountOffset = (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC) ? 92 : 108;
+    quint64 sectionTableOffset = optionalHeaderOffset + fileHeader.SizeOfOptionalHeader;
+    if (fileHeader.SizeOfOptionalHeader < rvaCountOffset + sizeof(quint32) + sizeof(IMAGE_DATA_DIRECTORY) ||
+        sectionTableOffset + fileHeader.NumberOfSections * sizeof(IMAGE_SECTION_HEADER) > fileSize) {
+        return result;
+    }
+    quint32 rvaCount;
+    IMAGE_DATA_DIRECTORY exportDirectory;
+    std::memcpy(&rvaCount, data.constData() + optionalHeaderOffset + rvaCountOffset, sizeof(rvaCount));
+    std::memcpy(&exportDirectory, data.constData() + optionalHeaderOffset + rvaCountOffset + sizeof(quint32), sizeof(exportDirectory));
+    if (rvaCount == 0 || exportDirectory.VirtualAddress == 0) {
+        return result;
+    }
+
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(data.constData() + optionalHeaderOffset));
+    for (quint16 i = 0; i < fileHeader.NumberOfSections; ++i) {
+        model.addSection(reinterpret_cast<const IMAGE_SECTION_HEADER*>(
+            data.constData() + sectionTableOffset + i * sizeof(IMAGE_SECTION_HEADER)));
+    }
+
+    PEDataDirectoryParser parser(data);
+    if (parser.parseExportDirectory(exportDirectory.VirtualAddress, exportDirectory.Size, model)) {
+        result.exports = model.getExportFunctions();
+    }
+    return result;
+}
+
+class StringPool
+{
+public:
+    StringPool() : m_data(1, '\0') {}
+
+    quint32 add(const QString &value)
+    {
+        if (value.isEmpty()) {
+            return 0;
+        }
+        QByteArray utf8 = value.toUtf8();
+        auto it = m_offsets.constFind(utf8);
+        if (it != m_offsets.constEnd()) {
+            return it.value();
+        }
+        quint32 offset = static_cast<quint32>(m_data.size());
+        m_data.append(utf8).append('\0');
+        m_offsets.insert(utf8, offset);
+        return offset;
+    }
+
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QHash<QByteArray, quint32> m_offsets;
+};
+
+} // namespace
+
+PEExportIndex::~PEExportIndex()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+QString PEExportIndex::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/export_index.bin";
+}
+
+QString PEExportIndex::moduleKey(const QString &moduleName)
+{
+    QString key = moduleName.toLower();
+    if (key.endsWith(QLatin1String(".dll"))) {
+        key.chop(4);
+    }
+    return key;
+}
+
+bool PEExportIndex::build(const QString &dllDirectory, const QString &indexPath, int *moduleCount)
+{
+    QStringList files;
+    const QFileInfoList entries = QDir(dllDirectory).entryInfoList(
+        {"*.dll", "*.drv", "*.ocx", "*.cpl", "*.exe"}, QDir::Files | QDir::Readable);
+    for (const QFileInfo &entry : entries) {
+        files.append(entry.absoluteFilePath());
+    }
+
+    const QList<ModuleExports> parsed = QtConcurrent::blockingMapped<QList<ModuleExports>>(files, readModuleExports);
+
+    QMap<QString, QList<PEDataModel::ExportFunctionEntry>> exportsByModule;
+    for (const ModuleExports &module : parsed) {
+        if (!module.exports.isEmpty()) {
+            exportsByModule.insert(module.fileName, module.exports);
+        }
+    }
+    if (moduleCount) {
+        *moduleCount = static_cast<int>(exportsByModule.size());
+    }
+    return !exportsByModule.isEmpty() && write(exportsByModule, indexPath);
+}
+
+bool PEExportIndex::write(const QMap<QString, QList<PEDataModel::ExportFunctionEntry>> &exportsByModule,
+                          const QString &indexPath)
+{
+    // Sorted by the UTF-8 bytes of the key, which is the order lookups compare in.
+    // File names that differ only in case or in a ".dll" suffix keep the first one.
+    std::vector<std::pair<QByteArray, const QList<PEDataModel::ExportFunctionEntry>*>> modules;
+    QSet<QByteArray> seenKeys;
+    for (auto it = exportsByModule.constBegin(); it != exportsByModule.constEnd(); ++it) {
+        QByteArray key = moduleKey(it.key()).toUtf8();
+        if (!key.isEmpty() && !seenKeys.contains(key)) {
+            seenKeys.insert(key);
+            modules.emplace_back(key, &it.value());
+        }
+    }
+    std::sort(modules.begin(), modules.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    StringPool strings;
+    QList<Module> moduleTable;
+    QList<Export> exportTable;
+    QList<quint32> nameRefs;
+    for (const auto &module : modules) {
+        Module record = {};
+        record.name = strings.add(QString::fromUtf8(module.first));
+        record.firstExport = static_cast<quint32>(exportTable.size());
+
+        QList<Export> moduleExports;
+        QList<QByteArray> names;
+        for (const PEDataModel::ExportFunctionEntry &entry : *module.second) {
+            if (entry.rva == 0) {
+                continue;   // Gap in the function table
+            }
+            bool named = !entry.name.isEmpty() && entry.name != "[ - ]";
+            Export exportRecord = {};
+            exportRecord.name = named ? strings.add(entry.name) : 0;
+            exportRecord.forwarder = strings.add(entry.forwarder);
+            exportRecord.ordinal = entry.ordinal;
+            moduleExports.append(exportRecord);
+        }
+        std::stable_sort(moduleExports.begin(), moduleExports.end(),
+                         [](const Export &a, const Export &b) { return a.ordinal < b.ordinal; });
+
+        QList<quint32> order(moduleExports.size());
+        for (int i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<quint32>(i);
+        }
+        const QByteArray &pool = strings.data();
+        std::stable_sort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+            return qstrcmp(pool.constData() + moduleExports[a].name, pool.constData() + moduleExports[b].name) < 0;
+        });
+        for (quint32 index : order) {
+            nameRefs.append(record.firstExport + index);
+        }
+
+        exportTable.append(moduleExports);
+        record.exportCount = static_cast<quint32>(moduleExports.size());
+        moduleTable.append(record);
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.moduleCount = static_cast<quint32>(moduleTable.size());
+    header.exportCount = static_cast<quint32>(exportTable.size());
+    header.stringsSize = static_cast<quint32>(strings.data().size());
+
+    if (!QDir().mkpath(QFileInfo(indexPath).absolutePath())) {
+        return false;
+    }
+    // Readers map the file, so it is replaced atomically rather than rewritten in place
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(moduleTable.constData()), moduleTable.size() * static_cast<qsizetype>(sizeof(Module)));
+    file.write(reinterpret_cast<const char*>(exportTable.constData()), exportTable.size() * static_cast<qsizetype>(sizeof(Export)));
+    file.write(reinterpret_cast<const char*>(nameRefs.constData()), nameRefs.size() * static_cast<qsizetype>(sizeof(quint32)));
+    file.write(strings.data());
+    return file.commit();
+}
+
+QSharedPointer<const PEExportIndex> PEExportIndex::load(const QString &indexPath)
+{
+    QSharedPointer<PEExportIndex> index(new PEExportIndex);
+    index->m_file.setFileName(indexPath);
+    if (!index->m_file.open(QIODevice::ReadOnly) || index->m_file.size() < static_cast<qint64>(sizeof(Header))) {
+        return nullptr;
+    }
+    index->m_data = index->m_file.map(0, index->m_file.size());
+    if (!index->m_data) {
+        return nullptr;
+    }
+
+    // Only the header is validated here; offsets read from the tables are
+    // bounds-checked when a lookup uses them
+    const Header *header = reinterpret_cast<const Header*>(index->m_data);
+    quint64 modulesSize = static_cast<quint64>(header->moduleCount) * sizeof(Module);
+    quint64 exportsSize = static_cast<quint64>(header->exportCount) * sizeof(Export);
+    quint64 nameRefsSize = static_cast<quint64>(header->exportCount) * sizeof(quint32);
+    quint64 expectedSize = sizeof(Header) + modulesSize + exportsSize + nameRefsSize + header->stringsSize;
+    if (std::memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 || header->version != INDEX_VERSION ||
+        header->stringsSize == 0 || expectedSize != static_cast<quint64>(index->m_file.size())) {
+        return nullptr;
+    }
+
+    index->m_header = header;
+    index->m_modules = reinterpret_cast<const Module*>(index->m_data + sizeof(Header));
+    index->m_exports = reinterpret_cast<const Export*>(index->m_data + sizeof(Header) + modulesSize);
+    index->m_nameRefs = reinterpret_cast<const quint32*>(index->m_data + sizeof(Header) + modulesSize + exportsSize);
+    index->m_strings = reinterpret_cast<const char*>(index->m_data + sizeof(Header) + modulesSize + exportsSize + nameRefsSize);
+    if (index->m_strings[header->stringsSize - 1] != '\0') {
+        return nullptr;
+    }
+    return index;
+}
+
+int PEExportIndex::moduleCount() const
+{
+    return static_cast<int>(m_header->moduleCount);
+}
+
+int PEExportIndex::exportCount() const
+{
+    return static_cast<int>(m_header->exportCount);
+}
+
+QString PEExportIndex::nameForOrdinal(const QString &moduleName, quint16 ordinal) const
+{
+    const Export *entry = findOrdinal(findModule(moduleName), ordinal);
+    return entry ? QString::fromUtf8(string(entry->name)) : QString();
+}
+
+QString PEExportIndex::forwarderForOrdinal(const QString &moduleName, quint16 ordinal) const
+{
+    const Export *entry = findOrdinal(findModule(moduleName), ordinal);
+    return entry ? QString::fromUtf8(string(entry->forwarder)) : QString();
+}
+
+QString PEExportIndex::forwarderForName(const QString &moduleName, const QString &functionName) const
+{
+    const Export *entry = findName(findModule(moduleName), functionName.toUtf8());
+    return entry ? QString::fromUtf8(string(entry->forwarder)) : QString();
+}
+
+QString PEExportIndex::resolveForwarderChain(const QString &forwarder) const
+{
+    // The depth limit also ends forwarder cycles
+    QString current = forwarder;
+    for (int depth = 0; depth < MAX_FORWARDER_DEPTH; ++depth) {
+        qsizetype dot = current.lastIndexOf('.');
+        if (dot <= 0) {
+            break;
+        }
+        QString moduleName = current.left(dot);
+        QString function = current.mid(dot + 1);
+
+        QString next;
+        if (function.startsWith('#')) {
+            bool ok = false;
+            quint16 ordinal = function.mid(1).toUShort(&ok);
+            if (ok) {
+                next = forwarderForOrdinal(moduleName, ordinal);
+            }
+        } else {
+            next = forwarderForName(moduleName, function);
+        }
+        if (next.isEmpty()) {
+            break;
+        }
+        current = next;
+    }
+    return current;
+}
+
+const PEExportIndex::Module *PEExportIndex::findModule(const QString &moduleName) const
+{
+    const QByteArray key = moduleKey(moduleName).toUtf8();
+    const Module *end = m_modules + m_header->moduleCount;
+    const Module *module = std::lower_bound(m_modules, end, key, [this](const Module &candidate, const QByteArray &value) {
+        return qstrcmp(string(candidate.name), value.constData()) < 0;
+    });
+    if (module == end || qstrcmp(string(module->name), key.constData()) != 0 ||
+        static_cast<quint64>(module->firstExport) + module->exportCount > m_header->exportCount) {
+        return nullptr;
+    }
+    return module;
+}
+
+const PEExportIndex::Export *PEExportIndex::findOrdinal(const Module *module, quint16 ordinal) const
+{
+    if (!module) {
+        return nullptr;
+    }
+    const Export *begin = m_exports + module->firstExport;
+    const Export *end = begin + module->exportCount;
+    const Export *entry = std::lower_bound(begin, end, ordinal, [](const Export &candidate, quint16 value) {
+        return candidate.ordinal < value;
+    });
+    return (entry != end && entry->ordinal == ordinal) ? entry : nullptr;
+}
+
+const PEExportIndex::Export *PEExportIndex::findName(const Module *module, const QByteArray &name) const
+{
+    if (!module || name.isEmpty()) {
+        return nullptr;
+    }
+    const quint32 *begin = m_nameRefs + module->firstExport;
+    const quint32 *end = begin + module->exportCount;
+    auto nameOf = [this](quint32 ref) {
+        return ref < m_header->exportCount ? string(m_exports[ref].name) : "";
+    };
+    const quint32 *ref = std::lower_bound(begin, end, name, [&](quint32 candidate, const QByteArray &value) {
+        return qstrcmp(nameOf(candidate), value.constData()) < 0;
+    });
+    return (ref != end && qstrcmp(nameOf(*ref), name.constData()) == 0) ? &m_exports[*ref] : nullptr;
+}
+
+const char *PEExportIndex::string(quint32 offset) const
+{
+    return offset < m_header->stringsSize ? m_strings + offset : "";
+}
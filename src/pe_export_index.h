@@ -0,0 +1,119 @@
+/**
+ * @file pe_export_index.h
+ * @brief Memory-mapped index of the exports of reference DLLs
+ *
+ * Imports by ordinal carry no name, and forwarded exports only name another
+ * DLL's export. Both can be resolved offline against the export tables of a
+ * known set of system DLLs. build() parses every DLL in a directory once and
+ * writes the result to a single file:
+ *
+ *   Header     magic, version and the counts below
+ *   Module[]   sorted by module key; each owns a run of Export[] and NameRef[]
+ *   Export[]   per module, sorted by ordinal
+ *   NameRef[]  per module, export indices sorted by name
+ *   strings    NUL-terminated UTF-8; offset 0 is the empty string
+ *
+ * load() maps the file instead of reading it and only checks the header, so
+ * opening the index costs the same for ten DLLs as for ten thousand. Lookups
+ * are binary searches directly over the mapping.
+ *
+ * Modules are keyed by lower-case file name without a ".dll" suffix, which
+ * is how both import descriptors ("KERNEL32.dll") and forwarder strings
+ * ("NTDLL.RtlAllocateHeap") name them once normalized.
+ */
+
+#ifndef PE_EXPORT_INDEX_H
+#define PE_EXPORT_INDEX_H
+
+#include "pe_data_model.h"
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+#include <QSharedPointer>
+#include <QString>
+#include <QtGlobal>
+
+class PEExportIndex
+{
+public:
+    ~PEExportIndex();
+
+    /**
+     * @brief Per-user index location used when no path is given
+     */
+    static QString defaultPath();
+
+    /**
+     * @brief Normalizes a DLL or forwarder module name to the index key
+     */
+    static QString moduleKey(const QString &moduleName);
+
+    /**
+     * @brief Parses the exports of every DLL in a directory and writes an index
+     * @param moduleCount Receives the number of DLLs with an export table
+     * @return false if no DLL could be parsed or the index cannot be written
+     *
+     * DLLs are parsed in parallel; the directory is not searched recursively.
+     */
+    static bool build(const QString &dllDirectory, const QString &indexPath, int *moduleCount = nullptr);
+
+    /**
+     * @brief Writes an index for already parsed export tables
+     * @param exportsByModule Export tables keyed by DLL file name
+     */
+    static bool write(const QMap<QString, QList<PEDataModel::ExportFunctionEntry>> &exportsByModule,
+                      const QString &indexPath);
+
+    /**
+     * @brief Maps an index file
+     * @return nullptr if the file is missing or not an index
+     */
+    static QSharedPointer<const PEExportIndex> load(const QString &indexPath);
+
+    int moduleCount() const;
+    int exportCount() const;
+
+    /**
+     * @brief Name exported at an ordinal, empty if unknown or exported by ordinal only
+     */
+    QString nameForOrdinal(const QString &moduleName, quint16 ordinal) const;
+
+    /**
+     * @brief Forwarder string ("DLL.Function" or "DLL.#ordinal") of an export,
+     *        empty if the export is not forwarded or unknown
+     */
+    QString forwarderForOrdinal(const QString &moduleName, quint16 ordinal) const;
+    QString forwarderForName(const QString &moduleName, const QString &functionName) const;
+
+    /**
+     * @brief Follows a forwarder through further forwarded exports
+     * @return The last forwarder string of the chain. Chains that leave the
+     *         index (API sets, missing DLLs) stop at the last known hop.
+     */
+    QString resolveForwarderChain(const QString &forwarder) const;
+
+private:
+    struct Header;
+    struct Module;
+    struct Export;
+
+    PEExportIndex() = default;
+    Q_DISABLE_COPY(PEExportIndex)
+
+    const Module *findModule(const QString &moduleName) const;
+    const Export *findOrdinal(const Module *module, quint16 ordinal) const;
+    const Export *findName(const Module *module, const QByteArray &name) const;
+    const char *string(quint32 offset) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    const Header *m_header = nullptr;
+    const Module *m_modules = nullptr;
+    const Export *m_exports = nullptr;
+    const quint32 *m_nameRefs = nullptr;
+    const char *m_strings = nullptr;
+
+    static const int MAX_FORWARDER_DEPTH = 16;
+};
+
+#endif // PE_EXPORT_INDEX_H
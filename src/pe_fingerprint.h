@@ -0,0 +1,56 @@
+/**
+ * @file pe_fingerprint.h
+ * @brief Sample fingerprints computed from parsed PE structures
+ *
+ * Fingerprints are short hashes that stay stable across rebuilds of the
+ * same code and are used to cluster related samples.
+ *
+ * IMPORT HASH (imphash):
+ * Matches the pefile convention: every imported function becomes
+ * "module.function" (lower case, .dll/.ocx/.sys stripped from the module,
+ * ordinals resolved through the ws2_32/wsock32/oleaut32 tables or written as
+ * "ordN"), the terms are joined with "," in import table order and hashed
+ * with MD5.
+ *
+ * EXPORT HASH:
+ * MD5 of the lower-case named exports, sorted and joined with ",". Exports
+ * that only have an ordinal do not contribute.
+ */
+
+#ifndef PE_FINGERPRINT_H
+#define PE_FINGERPRINT_H
+
+#include "pe_data_model.h"
+#include <QString>
+#include <QStringList>
+
+class PEFingerprint
+{
+public:
+    /**
+     * @brief Builds the imphash term for one imported function
+     * @return "module.function", or an empty string if the entry has no name
+     */
+    static QString importHashEntry(const QString &moduleName,
+                                   const PEDataModel::ImportFunctionEntry &function);
+
+    /**
+     * @brief Hashes the terms produced by importHashEntry()
+     * @return Lower-case hex MD5, or an empty string when there are no imports
+     */
+    static QString calculateImportHash(const QStringList &entries);
+
+    /**
+     * @brief Hashes the named exports of a module
+     * @return Lower-case hex MD5, or an empty string when nothing is exported by name
+     */
+    static QString calculateExportHash(const QList<PEDataModel::ExportFunctionEntry> &exports);
+
+    /**
+     * @brief Resolves a well-known import ordinal to its function name
+     * @return The name, or an empty string if the module or ordinal is unknown
+     */
+    static QString ordinalName(const QString &moduleName, quint16 ordinal);
+};
+
+#endif // PE_FINGERPRINT_H
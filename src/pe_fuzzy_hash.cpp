@@ -0,0 +1,350 @@
+/**
+ * @file pe_fuzzy_hash.cpp
+ * @brief TLSH-style similarity digest implementation
+ */
+
+#include "pe_fuzzy_hash.h"
+#include <QByteArray>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+// Fixed pseudo-random permutation of 0..255 (xorshift-driven Fisher-Yates)
+constexpr std::array<quint8, 256> makePearsonTable()
+{
+    std::array<quint8, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = static_cast<quint8>(i);
+    }
+    quint32 state = 0x9E3779B9u;
+    for (int i = 255; i > 0; --i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int j = static_cast<int>(state % static_cast<quint32>(i + 1));
+        quint8 swap = table[i];
+        table[i] = table[j];
+        table[j] = swap;
+    }
+    return table;
+}
+
+constexpr std::array<quint8, 256> PEARSON = makePearsonTable();
+
+inline quint8 pearson(quint8 salt, quint8 a, quint8 b, quint8 c)
+{
+    return PEARSON[PEARSON[PEARSON[PEARSON[salt] ^ a] ^ b] ^ c];
+}
+
+quint8 lengthCode(qint64 length)
+{
+    // Piecewise logarithm so small inputs still get distinct codes
+    double value = static_cast<double>(length);
+    double code;
+    if (length <= 656) {
+        code = std::log(value) / std::log(1.5);
+    } else if (length <= 3199) {
+        code = std::log(value) / std::log(1.3) - 8.72777;
+    } else {
+        code = std::log(value) / std::log(1.1) - 62.5472;
+    }
+    return static_cast<quint8>(static_cast<quint64>(std::floor(code)) & 0xFF);
+}
+
+int modularDifference(int first, int second, int range)
+{
+    int difference = std::abs(first - second);
+    return std::min(difference, range - difference);
+}
+
+bool isHexDigit(QChar c)
+{
+    return c.isDigit() || (c.toLower() >= 'a' && c.toLower() <= 'f');
+}
+
+} // namespace
+
+PEFuzzyHash::PEFuzzyHash()
+    : m_window{0, 0, 0, 0}
+    , m_head{0, 0, 0, 0}
+    , m_checksum(0)
+    , m_size(0)
+{
+    m_buckets.fill(0);
+    m_histogram.fill(0);
+}
+
+void PEFuzzyHash::update(const char *data, qint64 size)
+{
+    const quint8 *bytes = reinterpret_cast<const quint8*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        const quint8 b0 = bytes[i];
+        ++m_histogram[b0];
+
+        // Buckets are only fed once a full 5-byte window is available
+        if (m_size + i >= 4) {
+            m_checksum = pearson(0, b0, m_window[0], m_checksum);
+            addWindow(b0, m_window[0], m_window[1], m_window[2], m_window[3]);
+        } else {
+            m_head[m_size + i] = b0;
+        }
+
+        m_window[3] = m_window[2];
+        m_window[2] = m_window[1];
+        m_window[1] = m_window[0];
+        m_window[0] = b0;
+    }
+    m_size += size;
+}
+
+void PEFuzzyHash::updateChecksum(const char *data, qint64 size)
+{
+    const quint8 *bytes = reinterpret_cast<const quint8*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        const quint8 b0 = bytes[i];
+        if (m_size + i >= 4) {
+            m_checksum = pearson(0, b0, m_window[0], m_checksum);
+        }
+        m_window[3] = m_window[2];
+        m_window[2] = m_window[1];
+        m_window[1] = m_window[0];
+        m_window[0] = b0;
+    }
+    m_size += size;
+}
+
+void PEFuzzyHash::append(const PEFuzzyHash &next)
+{
+    // Bytes around the boundary, oldest first: up to four from here, up to four from next
+    quint8 bytes[8];
+    int count = 0;
+    const int tail = static_cast<int>(qMin<qint64>(m_size, 4));
+    for (int i = tail - 1; i >= 0; --i) {
+        bytes[count++] = m_window[i];
+    }
+    const int head = static_cast<int>(qMin<qint64>(next.m_size, 4));
+    for (int i = 0; i < head; ++i) {
+        bytes[count++] = next.m_head[i];
+    }
+
+    // next skipped the windows ending in its first four bytes; those that
+    // start in this input are complete now. bytes[i] is input byte m_size - tail + i.
+    for (int i = tail; i < count; ++i) {
+        if (m_size - tail + i >= 4) {
+            addWindow(bytes[i], bytes[i - 1], bytes[i - 2], bytes[i - 3], bytes[i - 4]);
+        }
+    }
+
+    for (int i = 0; i < 128; ++i) {
+        m_buckets[i] += next.m_buckets[i];
+    }
+    for (int i = 0; i < 256; ++i) {
+        m_histogram[i] += next.m_histogram[i];
+    }
+    for (qint64 i = m_size; i < 4 && i - m_size < head; ++i) {
+        m_head[i] = next.m_head[i - m_size];
+    }
+    for (int i = 0; i < 4 && i < count; ++i) {
+        m_window[i] = next.m_size >= 4 ? next.m_window[i] : bytes[count - 1 - i];
+    }
+    m_size += next.m_size;
+}
+
+void PEFuzzyHash::addWindow(quint8 b0, quint8 b1, quint8 b2, quint8 b3, quint8 b4)
+{
+    ++m_buckets[pearson(2, b0, b1, b2) & 0x7F];
+    ++m_buckets[pearson(3, b0, b1, b3) & 0x7F];
+    ++m_buckets[pearson(5, b0, b2, b3) & 0x7F];
+    ++m_buckets[pearson(7, b0, b2, b4) & 0x7F];
+    ++m_buckets[pearson(11, b0, b1, b4) & 0x7F];
+    ++m_buckets[pearson(13, b0, b3, b4) & 0x7F];
+}
+
+double PEFuzzyHash::entropy() const
+{
+    if (m_size <= 0) {
+        return 0.0;
+    }
+
+    double entropy = 0.0;
+    double totalBytes = static_cast<double>(m_size);
+    for (quint64 count : m_histogram) {
+        if (count > 0) {
+            double probability = count / totalBytes;
+            entropy -= probability * std::log2(probability);
+        }
+    }
+    return entropy;
+}
+
+PEFuzzyHash::Digest PEFuzzyHash::digest() const
+{
+    Digest result;
+    if (m_size < MIN_INPUT_SIZE) {
+        return result;
+    }
+
+    // Quartiles of the bucket counts; each nth_element narrows the range for the next
+    std::array<quint32, 128> sorted = m_buckets;
+    std::nth_element(sorted.begin(), sorted.begin() + 95, sorted.end());
+    const quint32 q3 = sorted[95];
+    std::nth_element(sorted.begin(), sorted.begin() + 63, sorted.begin() + 95);
+    const quint32 q2 = sorted[63];
+    std::nth_element(sorted.begin(), sorted.begin() + 31, sorted.begin() + 63);
+    const quint32 q1 = sorted[31];
+
+    int nonZeroBuckets = 0;
+    for (quint32 count : m_buckets) {
+        if (count > 0) {
+            ++nonZeroBuckets;
+        }
+    }
+    if (q3 == 0 || nonZeroBuckets <= 64) {
+        return result;
+    }
+
+    for (int i = 0; i < 128; ++i) {
+        const quint32 count = m_buckets[i];
+        quint64 code = (count <= q1) ? 0 : (count <= q2) ? 1 : (count <= q3) ? 2 : 3;
+        result.body[i / 32] |= code << ((i % 32) * 2);
+    }
+
+    result.checksum = m_checksum;
+    result.lengthCode = lengthCode(m_size);
+    quint8 q1Ratio = static_cast<quint8>((static_cast<quint64>(q1) * 100 / q3) % 16);
+    quint8 q2Ratio = static_cast<quint8>((static_cast<quint64>(q2) * 100 / q3) % 16);
+    result.quartileRatios = static_cast<quint8>((q1Ratio << 4) | q2Ratio);
+    result.valid = true;
+    return result;
+}
+
+QString PEFuzzyHash::hashData(const QByteArray &data)
+{
+    PEFuzzyHash hasher;
+    hasher.update(data.constData(), data.size());
+    return hasher.digest().toString();
+}
+
+QString PEFuzzyHash::Digest::toString() const
+{
+    if (!valid) {
+        return QString();
+    }
+
+    QByteArray raw;
+    raw.reserve(35);
+    raw.append(static_cast<char>(checksum));
+    raw.append(static_cast<char>(lengthCode));
+    raw.append(static_cast<char>(quartileRatios));
+    for (quint64 word : body) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            raw.append(static_cast<char>((word >> shift) & 0xFF));
+        }
+    }
+    return QString::fromLatin1(raw.toHex());
+}
+
+PEFuzzyHash::Digest PEFuzzyHash::Digest::fromString(const QString &text)
+{
+    Digest result;
+    if (text.size() != 70) {
+        return result;
+    }
+    for (QChar c : text) {
+        if (!isHexDigit(c)) {
+            return result;
+        }
+    }
+
+    QByteArray raw = QByteArray::fromHex(text.toLatin1());
+    const quint8 *bytes = reinterpret_cast<const quint8*>(raw.constData());
+    result.checksum = bytes[0];
+    result.lengthCode = bytes[1];
+    result.quartileRatios = bytes[2];
+    for (int word = 0; word < 4; ++word) {
+        quint64 value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<quint64>(bytes[3 + word * 8 + i]) << (i * 8);
+        }
+        result.body[word] = value;
+    }
+    result.valid = true;
+    return result;
+}
+
+int PEFuzzyHash::headerDistance(const Digest &first, const Digest &second)
+{
+    int distance = 0;
+
+    int lengthDiff = modularDifference(first.lengthCode, second.lengthCode, 256);
+    distance += (lengthDiff <= 1) ? lengthDiff : lengthDiff * 12;
+
+    int q1Diff = modularDifference(first.quartileRatios >> 4, second.quartileRatios >> 4, 16);
+    distance += (q1Diff <= 1) ? q1Diff : (q1Diff - 1) * 12;
+
+    int q2Diff = modularDifference(first.quartileRatios & 0x0F, second.quartileRatios & 0x0F, 16);
+    distance += (q2Diff <= 1) ? q2Diff : (q2Diff - 1) * 12;
+
+    if (first.checksum != second.checksum) {
+        distance += 1;
+    }
+    return distance;
+}
+
+int PEFuzzyHash::bodyDistance(const Digest &first, const Digest &second)
+{
+    // Per 2-bit field the score is |a - b|, except that the extreme pair
+    // (0 vs 3) counts 6. Evaluated 32 fields at a time with bit masks.
+    constexpr quint64 LOW_BITS = 0x5555555555555555ULL;
+    int distance = 0;
+    for (int word = 0; word < 4; ++word) {
+        const quint64 a = first.body[word];
+        const quint64 diff = a ^ second.body[word];
+        const quint64 low = diff & LOW_BITS;
+        const quint64 high = (diff >> 1) & LOW_BITS;
+        const quint64 both = low & high;
+        const quint64 extreme = both & ~(a ^ (a >> 1)) & LOW_BITS; // a is 00 or 11
+        distance += qPopulationCount(low) + 2 * qPopulationCount(high)
+                    - 2 * qPopulationCount(both & ~extreme) + 3 * qPopulationCount(extreme);
+    }
+    return distance;
+}
+
+int PEFuzzyHash::distance(const Digest &first, const Digest &second)
+{
+    if (!first.valid || !second.valid) {
+        return -1;
+    }
+    return headerDistance(first, second) + bodyDistance(first, second);
+}
+
+QList<QPair<int, int>> PEFuzzyHash::findSimilar(const Digest &probe, const QVector<Digest> &corpus,
+                                                int maxDistance)
+{
+    QList<QPair<int, int>> matches;
+    if (!probe.valid) {
+        return matches;
+    }
+
+    for (int i = 0; i < corpus.size(); ++i) {
+        const Digest &candidate = corpus[i];
+        if (!candidate.valid) {
+            continue;
+        }
+        int score = headerDistance(probe, candidate);
+        if (score > maxDistance) {
+            continue;
+        }
+        score += bodyDistance(probe, candidate);
+        if (score <= maxDistance) {
+            matches.append(qMakePair(i, score));
+        }
+    }
+
+    std::stable_sort(matches.begin(), matches.end(),
+                     [](const QPair<int, int> &a, const QPair<int, int> &b) { return a.second < b.second; });
+    return matches;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file pe_fuzzy_hash.h
+ * @brief Locality-sensitive similarity digests for clustering related samples
+ *
+ * The digest follows the TLSH construction: every 5-byte window feeds six
+ * byte triplets into 128 buckets, the buckets are quantised against their
+ * quartiles into 2 bits each, and a small header records a checksum, the
+ * log-scaled input length and the quartile ratios. Two digests are compared
+ * with a distance score where 0 means "same content" and larger values mean
+ * less related; variants of the same build typically score below 100.
+ *
+ * The bucket mapping uses PEHint's own Pearson table, so digests are only
+ * comparable with other PEHint digests, not with the reference tlsh tool.
+ *
+ * The accumulator also keeps a byte histogram, so one streaming pass over
+ * the data yields both the digest and the Shannon entropy.
+ */
+
+#ifndef PE_FUZZY_HASH_H
+#define PE_FUZZY_HASH_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <array>
+
+class PEFuzzyHash
+{
+public:
+    /**
+     * @brief Packed similarity digest (35 bytes of information)
+     */
+    struct Digest {
+        quint8 checksum = 0;
+        quint8 lengthCode = 0;          ///< Log-scaled input length
+        quint8 quartileRatios = 0;      ///< q1/q3 ratio in the high nibble, q2/q3 in the low nibble
+        quint64 body[4] = {0, 0, 0, 0}; ///< 128 buckets, 2 bits each
+        bool valid = false;
+
+        /**
+         * @brief Hex form: 70 characters, or an empty string for an invalid digest
+         */
+        QString toString() const;
+
+        /**
+         * @brief Parses the form produced by toString()
+         * @return Digest with valid == false if the text is malformed
+         */
+        static Digest fromString(const QString &text);
+    };
+
+    /// Inputs shorter than this do not carry enough structure for a digest
+    static constexpr qint64 MIN_INPUT_SIZE = 50;
+
+    PEFuzzyHash();
+
+    /**
+     * @brief Feeds the next chunk of the input
+     *
+     * Chunks may have any size; the result only depends on the concatenated bytes.
+     */
+    void update(const char *data, qint64 size);
+
+    /**
+     * @brief Advances only the checksum over the next chunk of the input
+     *
+     * The checksum chains through every byte in order, so it is the one part
+     * of the digest that cannot be combined from pieces. An accumulator fed
+     * through this method tracks it for pieces gathered with update() and
+     * append(); see adoptChecksum().
+     */
+    void updateChecksum(const char *data, qint64 size);
+
+    /**
+     * @brief Adds the state of the input that directly follows this one
+     * @param next Accumulator fed with the following bytes only
+     *
+     * Buckets, histogram and length combine exactly, including the windows
+     * that span the boundary. The checksum is left as it is.
+     */
+    void append(const PEFuzzyHash &next);
+
+    /**
+     * @brief Takes the checksum of an accumulator that saw the whole input in order
+     */
+    void adoptChecksum(const PEFuzzyHash &ordered) { m_checksum = ordered.m_checksum; }
+
+    qint64 size() const { return m_size; }
+
+    /**
+     * @brief Occurrences of each byte value seen so far
+     */
+    const std::array<quint64, 256>& histogram() const { return m_histogram; }
+
+    /**
+     * @brief Shannon entropy of the bytes seen so far (0.0 to 8.0)
+     */
+    double entropy() const;
+
+    /**
+     * @brief Builds the digest of the bytes seen so far
+     *
+     * Returns an invalid digest for inputs that are too short or too uniform
+     * (for example zero padding) to be meaningfully compared.
+     */
+    Digest digest() const;
+
+    /**
+     * @brief Convenience wrapper for hashing a complete buffer
+     */
+    static QString hashData(const QByteArray &data);
+
+    /**
+     * @brief Distance between two digests
+     * @return 0 for identical content, growing with dissimilarity; -1 if either digest is invalid
+     */
+    static int distance(const Digest &first, const Digest &second);
+
+    /**
+     * @brief Compares one digest against a corpus of precomputed digests
+     * @param probe Digest of the sample under investigation
+     * @param corpus Precomputed digests
+     * @param maxDistance Only matches at or below this distance are returned
+     * @return (corpus index, distance) pairs sorted by ascending distance
+     *
+     * The header terms are scored first and candidates that already exceed
+     * maxDistance skip the body comparison, so a scan over a million digests
+     * spends most of its time in a few integer operations per entry.
+     */
+    static QList<QPair<int, int>> findSimilar(const Digest &probe, const QVector<Digest> &corpus,
+                                             int maxDistance);
+
+private:
+    static int headerDistance(const Digest &first, const Digest &second);
+    static int bodyDistance(const Digest &first, const Digest &second);
+    void addWindow(quint8 b0, quint8 b1, quint8 b2, quint8 b3, quint8 b4);
+
+    std::array<quint32, 128> m_buckets;
+    std::array<quint64, 256> m_histogram;
+    quint8 m_window[4];       ///< Previous four bytes, most recent first
+    quint8 m_head[4];         ///< First four bytes, whose windows reach into a preceding piece
+    quint8 m_checksum;
+    qint64 m_size;
+};
+
+#endif // PE_FUZZY_HASH_H
@@ -0,0 +1,157 @@
+/**
+ * @file pe_hash_index.cpp
+ * @brief On-disk fingerprint index implementation
+ */
+
+#include "pe_hash_index.h"
+#include "pe_fuzzy_hash.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QSet>
+#include <QTextStream>
+
+PEHashIndex::PEHashIndex(const QString &rootPath)
+    : m_rootPath(rootPath)
+{
+}
+
+QString PEHashIndex::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/hash_index";
+}
+
+bool PEHashIndex::addSample(HashKind kind, const QString &hash, const QString &filePath)
+{
+    if (!isValidHash(hash) || filePath.isEmpty()) {
+        return false;
+    }
+
+    // Appending keeps indexing O(1); repeated entries are collapsed by findSamples()
+    return appendLine(bucketPath(kind, hash), QFileInfo(filePath).absoluteFilePath());
+}
+
+QStringList PEHashIndex::findSamples(HashKind kind, const QString &hash) const
+{
+    QStringList samples;
+    if (!isValidHash(hash)) {
+        return samples;
+    }
+
+    QFile file(bucketPath(kind, hash));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return samples;
+    }
+
+    QSet<QString> seen;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        QString line = stream.readLine();
+        if (!line.isEmpty() && !seen.contains(line)) {
+            seen.insert(line);
+            samples.append(line);
+        }
+    }
+    return samples;
+}
+
+bool PEHashIndex::addSimilarityDigest(const QString &digest, const QString &filePath)
+{
+    if (!PEFuzzyHash::Digest::fromString(digest).valid || filePath.isEmpty()) {
+        return false;
+    }
+
+    // Appending keeps indexing O(1); repeated entries are collapsed by findSimilarSamples()
+    return appendLine(similarityListPath(), digest.toLower() + ' ' + QFileInfo(filePath).absoluteFilePath());
+}
+
+QList<QPair<int, QString>> PEHashIndex::findSimilarSamples(const QString &digest, int maxDistance) const
+{
+    QList<QPair<int, QString>> samples;
+    PEFuzzyHash::Digest probe = PEFuzzyHash::Digest::fromString(digest);
+    if (!probe.valid) {
+        return samples;
+    }
+
+    QFile file(similarityListPath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return samples;
+    }
+
+    QVector<PEFuzzyHash::Digest> corpus;
+    QStringList paths;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        QString line = stream.readLine();
+        int separator = line.indexOf(' ');
+        if (separator <= 0) {
+            continue;
+        }
+        corpus.append(PEFuzzyHash::Digest::fromString(line.left(separator)));
+        paths.append(line.mid(separator + 1));
+    }
+
+    QSet<QString> seen;
+    for (const QPair<int, int> &match : PEFuzzyHash::findSimilar(probe, corpus, maxDistance)) {
+        const QString &path = paths.at(match.first);
+        if (!seen.contains(path)) {
+            seen.insert(path);
+            samples.append(qMakePair(match.second, path));
+        }
+    }
+    return samples;
+}
+
+bool PEHashIndex::appendLine(const QString &path, const QString &line)
+{
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return false;
+    }
+
+    // Several indexing processes may share a bucket; the lock keeps their lines whole
+    QLockFile lock(path + ".lock");
+    if (!lock.lock()) {
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+    const QByteArray bytes = (line + '\n').toUtf8();
+    return file.write(bytes) == bytes.size() && file.flush();
+}
+
+QString PEHashIndex::bucketPath(HashKind kind, const QString &hash) const
+{
+    QString normalized = hash.toLower();
+    QString kindName;
+    switch (kind) {
+    case HashKind::ImportHash: kindName = "imphash"; break;
+    case HashKind::ExportHash: kindName = "exphash"; break;
+    case HashKind::RichHash: kindName = "richhash"; break;
+    case HashKind::PdbKey: kindName = "pdb"; break;
+    }
+    return QString("%1/%2/%3/%4.txt").arg(m_rootPath, kindName, normalized.left(2), normalized);
+}
+
+QString PEHashIndex::similarityListPath() const
+{
+    return m_rootPath + "/similarity/digests.txt";
+}
+
+bool PEHashIndex::isValidHash(const QString &hash)
+{
+    // Hashes become file names, so only accept plain hex digests
+    if (hash.size() < 2 || hash.size() > 128) {
+        return false;
+    }
+    for (QChar c : hash) {
+        if (!c.isDigit() && !(c.toLower() >= 'a' && c.toLower() <= 'f')) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file pe_hash_index.h
+ * @brief On-disk index from sample fingerprints to file paths
+ *
+ * Every hash owns one small bucket file at
+ *   <root>/<kind>/<first two hex digits>/<hash>.txt
+ * holding one sample path per line. Looking up all samples that share a
+ * hash is a single file read whose path is derived from the hash itself,
+ * so the cost does not grow with the number of indexed samples. Writers
+ * only append, holding a lock file next to the bucket, and readers drop
+ * repeated lines, so indexing never reads a bucket.
+ *
+ * Similarity digests cannot be bucketed by value, so they are appended to
+ * <root>/similarity/digests.txt as "<digest> <path>" lines and compared
+ * with a linear scan (see PEFuzzyHash::findSimilar).
+ */
+
+#ifndef PE_HASH_INDEX_H
+#define PE_HASH_INDEX_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+class PEHashIndex
+{
+public:
+    enum class HashKind {
+        ImportHash,
+        ExportHash,
+        RichHash,
+        PdbKey          ///< CodeView GUID (or NB10 signature) followed by age
+    };
+
+    /**
+     * @brief Opens (and lazily creates) an index rooted at the given directory
+     */
+    explicit PEHashIndex(const QString &rootPath = defaultPath());
+
+    /**
+     * @brief Per-user index location used when no path is given
+     */
+    static QString defaultPath();
+
+    QString rootPath() const { return m_rootPath; }
+
+    /**
+     * @brief Records that a sample has the given hash
+     * @return false if the hash is malformed or the bucket cannot be written.
+     *         Adding a sample again is harmless; findSamples() lists it once.
+     */
+    bool addSample(HashKind kind, const QString &hash, const QString &filePath);
+
+    /**
+     * @brief Returns every indexed sample path that has the given hash, each once
+     */
+    QStringList findSamples(HashKind kind, const QString &hash) const;
+
+    /**
+     * @brief Records the similarity digest of a sample
+     * @return false if the digest is malformed or the list cannot be written
+     */
+    bool addSimilarityDigest(const QString &digest, const QString &filePath);
+
+    /**
+     * @brief Returns indexed samples whose digest is within maxDistance
+     * @return (distance, path) pairs, closest first, one entry per path
+     */
+    QList<QPair<int, QString>> findSimilarSamples(const QString &digest, int maxDistance) const;
+
+private:
+    QString bucketPath(HashKind kind, const QString &hash) const;
+    QString similarityListPath() const;
+    static bool appendLine(const QString &path, const QString &line);
+    static bool isValidHash(const QString &hash);
+
+    QString m_rootPath;
+};
+
+#endif // PE_HASH_INDEX_H
@@ -0,0 +1,163 @@
+#include "pe_parse_profile.h"
+
+#ifdef Q_OS_WIN
+#ifndef _WINDOWS_
+#include <windows.h>
+#endif
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+PEParseProfile::Scope::Scope(PEParseProfile *profile, const QString &name, qint64 bytes, const QString &category)
+    : m_profile(profile)
+    , m_index(profile ? profile->begin(name, bytes, category) : -1)
+{
+}
+
+PEParseProfile::Scope::~Scope()
+{
+    if (m_profile) {
+        m_profile->end(m_index);
+    }
+}
+
+void PEParseProfile::Scope::setBytes(qint64 bytes)
+{
+    if (m_profile && m_index >= 0) {
+        m_profile->m_stages[m_index].bytes = bytes;
+    }
+}
+
+PEParseProfile::PEParseProfile()
+{
+    m_clock.start();
+}
+
+void PEParseProfile::reset()
+{
+    m_stages.clear();
+    m_open.clear();
+    m_clock.restart();
+}
+
+int PEParseProfile::begin(const QString &name, qint64 bytes, const QString &category)
+{
+    Stage stage;
+    stage.name = name;
+    stage.category = category;
+    stage.depth = m_open.size();
+    stage.bytes = bytes;
+    stage.startNs = m_clock.nsecsElapsed();
+    // Holds the peak at the start until end() turns it into the growth
+    stage.peakGrowth = peakResidentBytes();
+    m_stages.append(stage);
+    m_open.append(m_stages.size() - 1);
+    return m_stages.size() - 1;
+}
+
+void PEParseProfile::end(int index)
+{
+    if (index < 0 || index >= m_stages.size() || !m_open.contains(index)) {
+        return;
+    }
+
+    Stage &stage = m_stages[index];
+    stage.durationNs = m_clock.nsecsElapsed() - stage.startNs;
+    stage.peakGrowth = qMax<qint64>(0, peakResidentBytes() - stage.peakGrowth);
+    m_open.removeOne(index);
+}
+
+qint64 PEParseProfile::totalNs() const
+{
+    qint64 total = 0;
+    for (const Stage &stage : m_stages) {
+        if (stage.depth == 0) {
+            total += stage.durationNs;
+        }
+    }
+    return total;
+}
+
+QJsonObject PEParseProfile::toJson() const
+{
+    QJsonArray stages;
+    for (const Stage &stage : m_stages) {
+        QJsonObject entry;
+        entry["name"] = stage.name;
+        entry["category"] = stage.category;
+        entry["depth"] = stage.depth;
+        entry["start_ns"] = stage.startNs;
+        entry["duration_ns"] = stage.durationNs;
+        entry["bytes"] = stage.bytes;
+        entry["peak_growth"] = stage.peakGrowth;
+        stages.append(entry);
+    }
+
+    QJsonObject profile;
+    profile["total_ns"] = totalNs();
+    profile["stages"] = stages;
+    return profile;
+}
+
+void PEParseProfile::appendTraceEvents(QJsonArray &events, int threadId, qint64 offsetUs, const QString &label) const
+{
+    // Names the lane after the file in the viewer
+    QJsonObject laneName;
+    laneName["name"] = label;
+    QJsonObject lane;
+    lane["name"] = "thread_name";
+    lane["ph"] = "M";
+    lane["pid"] = 1;
+    lane["tid"] = threadId;
+    lane["args"] = laneName;
+    events.append(lane);
+
+    // Trace timestamps are microseconds; fractions keep sub-microsecond stages visible
+    for (const Stage &stage : m_stages) {
+        QJsonObject args;
+        args["file"] = label;
+        args["bytes"] = stage.bytes;
+        args["peak_growth"] = stage.peakGrowth;
+
+        QJsonObject event;
+        event["name"] = stage.name;
+        event["cat"] = stage.category;
+        event["ph"] = "X";
+        event["ts"] = offsetUs + stage.startNs / 1000.0;
+        event["dur"] = stage.durationNs / 1000.0;
+        event["pid"] = 1;
+        event["tid"] = threadId;
+        event["args"] = args;
+        events.append(event);
+    }
+}
+
+QJsonObject PEParseProfile::traceDocument(const QJsonArray &events)
+{
+    QJsonObject document;
+    document["traceEvents"] = events;
+    document["displayTimeUnit"] = "ns";
+    return document;
+}
+
+qint64 PEParseProfile::peakResidentBytes()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef Q_OS_MACOS
+    return static_cast<qint64>(usage.ru_maxrss);           // Bytes on macOS
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;    // Kilobytes elsewhere
+#endif
+#endif
+}
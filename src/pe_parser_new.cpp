@@ -1,5 +1,9 @@
 #include "pe_parser_new.h"
 #include "pe_utils.h"
+#include "pe_content_statistics.h"
+#include "pe_rich_header.h"
+#include "pe_parse_profile.h"
+#include "pe_embedded_scanner.h"
 #include "language_manager.h"
 #include <QDebug>
 #include <QFileInfo>
@@ -11,6 +15,87 @@
 #include <QDir>
 #include <QDateTime>
 #include <QtGlobal>
+#include <QThreadPool>
+#include <QMap>
+#include <QMetaMethod>
+#include <QSharedPointer>
+#include <QWaitCondition>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+// Feeds chunks that arrive from parallel tasks, in any order, into the
+// accumulator of the hashes that must see the file from front to back.
+// Whichever task delivers the next expected offset hashes it, plus any
+// chunks already waiting behind it. Tasks that run ahead block once the
+// waiting chunks would exceed the budget.
+class OrderedDigestFeed
+{
+public:
+    explicit OrderedDigestFeed(qint64 budget)
+        : m_hashes(PEContentStatistics::Mode::OrderedHashes)
+        , m_budget(budget)
+    {
+    }
+
+    void push(qint64 offset, const QByteArray &chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_failed && offset != m_next && m_pendingBytes > 0 && m_pendingBytes + chunk.size() > m_budget) {
+            m_drained.wait(&m_mutex);
+        }
+        if (m_failed) {
+            return;
+        }
+        m_pending.insert(offset, chunk);
+        m_pendingBytes += chunk.size();
+        if (m_busy) {
+            return;
+        }
+
+        m_busy = true;
+        while (!m_failed && !m_pending.isEmpty() && m_pending.firstKey() == m_next) {
+            const QByteArray next = m_pending.first();
+            m_pending.erase(m_pending.begin());
+            locker.unlock();
+            m_hashes.update(next.constData(), next.size());
+            locker.relock();
+            m_next += next.size();
+            m_pendingBytes -= next.size();
+            m_drained.wakeAll();
+        }
+        m_busy = false;
+    }
+
+    // A range could not be read; its bytes never arrive
+    void fail()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_failed = true;
+        m_pending.clear();
+        m_pendingBytes = 0;
+        m_drained.wakeAll();
+    }
+
+    bool failed() const { return m_failed; }
+    const PEContentStatistics &hashes() const { return m_hashes; }
+
+private:
+    PEContentStatistics m_hashes;
+    const qint64 m_budget;
+    QMutex m_mutex;
+    QWaitCondition m_drained;
+    QMap<qint64, QByteArray> m_pending;
+    qint64 m_pendingBytes = 0;
+    qint64 m_next = 0;
+    bool m_busy = false;
+    bool m_failed = false;
+};
+
+} // namespace
 
 PEParserNew::PEParserNew(QObject *parent)
     : QObject(parent)
@@ -18,6 +103,7 @@ PEParserNew::PEParserNew(QObject *parent)
     , m_isParsing(false)
     , m_dataDirectoryParser(m_fileData)
 {
+    m_dataDirectoryParser.setProfile(&m_profile);
 }
 
 PEParserNew::~PEParserNew()
@@ -29,65 +115,121 @@ bool PEParserNew::loadFile(const QString &filePath)
 {
     clear();
     
-    m_file.setFileName(filePath);
-    if (!m_file.open(QIODevice::ReadOnly)) {
+    // Files above the memory limit are mapped rather than read (see PEByteSource)
+    bool opened = false;
+    {
+        PEParseProfile::Scope stage(&m_profile, QStringLiteral("read"));
+        opened = m_source.openFile(filePath, m_memoryLimit);
+        stage.setBytes(m_source.size());
+    }
+    if (!opened) {
         emit errorOccurred(LANG_PARAM("UI/error_file_open_generic", "filepath", filePath));
         return false;
     }
     
     m_dataModel.setFilePath(filePath);
-    m_dataModel.setFileSize(m_file.size());
-    
-    // For large files, use streaming approach to avoid memory issues
-    if (m_file.size() > LARGE_FILE_THRESHOLD) {
-        emit parsingProgress(5, LANG("UI/progress_large_file_detected"));
-        bool success = loadLargeFileStreaming();
-        if (success) {
-            m_dataModel.setValid(true);
-            m_isValid = true;
-            emit parsingProgress(100, LANG("UI/progress_large_file_complete"));
-            emit parsingComplete(true);
-        }
-        return success;
+    return parseSource();
+}
+
+bool PEParserNew::loadFromBuffer(const QByteArray &data, const QString &sourceName)
+{
+    clear();
+    
+    m_source.setBuffer(data);
+    m_dataModel.setFilePath(sourceName);
+    return parseSource();
+}
+
+bool PEParserNew::loadFromDevice(QIODevice *device, const QString &sourceName)
+{
+    clear();
+    
+    bool opened = false;
+    {
+        PEParseProfile::Scope stage(&m_profile, QStringLiteral("read"));
+        opened = m_source.readDevice(device, m_memoryLimit);
+        stage.setBytes(m_source.size());
+    }
+    if (!opened) {
+        emit errorOccurred(LANG_PARAM("UI/error_file_open_generic", "filepath", sourceName));
+        return false;
     }
     
-    // For small files, load everything (current approach)
-    emit parsingProgress(5, LANG("UI/progress_file_loaded"));
-    m_fileData = m_file.readAll();
-    m_file.close();
+    m_dataModel.setFilePath(sourceName);
+    return parseSource();
+}
+
+bool PEParserNew::parseSource()
+{
+    m_dataModel.setFileSize(m_source.size());
+    m_fileData = m_source.data();
     
+    if (hasProgressReceivers()) {
+        emit parsingProgress(5, m_source.isMapped() ? LANG("UI/progress_large_file_detected")
+                                                    : LANG("UI/progress_file_loaded"));
+    }
+    return parseFileData();
+}
+
+bool PEParserNew::hasProgressReceivers() const
+{
+    return isSignalConnected(QMetaMethod::fromSignal(&PEParserNew::parsingProgress));
+}
+
+bool PEParserNew::parseFileData()
+{
     // Parse DOS header
     if (!parseDOSHeader()) {
         return false;
     }
     
-    emit parsingProgress(15, LANG("UI/progress_dos_header"));
+    if (hasProgressReceivers()) {
+        emit parsingProgress(15, LANG("UI/progress_dos_header"));
+    }
     
     // Parse PE headers
     if (!parsePEHeaders()) {
         return false;
     }
     
-    emit parsingProgress(25, LANG("UI/progress_pe_headers"));
+    decodeRichHeader();
+    
+    if (hasProgressReceivers()) {
+        emit parsingProgress(25, LANG("UI/progress_pe_headers"));
+    }
     
     // Parse sections
     if (!parseSections()) {
         return false;
     }
     
-    emit parsingProgress(35, LANG("UI/progress_sections"));
+    if (hasProgressReceivers()) {
+        emit parsingProgress(35, LANG("UI/progress_sections"));
+    }
     
     // Parse data directories (NEW: Microsoft PE Format compliant)
     if (!parseDataDirectories()) {
         return false;
     }
     
-    emit parsingProgress(50, LANG("UI/progress_data_directories"));
+    if (hasProgressReceivers()) {
+        emit parsingProgress(50, LANG("UI/progress_data_directories"));
+    }
+    
+    // Directory tables are no longer needed resident; later reads fault them back in
+    m_source.releasePages();
+    
+    computeContentDigests();
+    
+    computeOverlay();
+    carveEmbeddedImages();
     
     m_dataModel.setValid(true);
     m_isValid = true;
     
-    emit parsingProgress(100, LANG("UI/progress_complete"));
+    if (hasProgressReceivers()) {
+        emit parsingProgress(100, LANG("UI/progress_complete"));
+    }
     emit parsingComplete(true);
     return true;
 }
@@ -99,21 +241,24 @@ void PEParserNew::loadFileAsync(const QString &filePath)
     }
     
     m_isParsing = true;
-    emit parsingProgress(0, LANG("UI/progress_async_start"));
+    if (hasProgressReceivers()) {
+        emit parsingProgress(0, LANG("UI/progress_async_start"));
+    }
     
     m_parsingFuture = QtConcurrent::run([this, filePath]() {
         QMutexLocker locker(&m_parsingMutex);
         
-        emit parsingProgress(1, LANG("UI/progress_async_loading"));
+        if (hasProgressReceivers()) {
+            emit parsingProgress(1, LANG("UI/progress_async_loading"));
+        }
         
         bool success = loadFile(filePath);
         m_isParsing = false;
         
         QMetaObject::invokeMethod(this, [this, success]() {
-            if (success) {
-                emit parsingProgress(100, LANG("UI/progress_async_complete"));
-            } else {
-                emit parsingProgress(100, LANG("UI/progress_async_failed"));
+            if (hasProgressReceivers()) {
+                emit parsingProgress(100, success ? LANG("UI/progress_async_complete")
+                                                  : LANG("UI/progress_async_failed"));
             }
             emit parsingComplete(success);
         }, Qt::QueuedConnection);
@@ -122,17 +267,23 @@ void PEParserNew::loadFileAsync(const QString &filePath)
 
 void PEParserNew::clear()
 {
-    m_file.close();
-    m_fileData.clear();
+    // The model and m_fileData may point into the mapping, which close() unmaps
     m_dataModel.clear();
-    m_optionalHeaderBuffer.clear();
-    m_cachedSections.clear();
+    m_fileData.clear();
+    m_source.close();
     m_cachedDosHeader = IMAGE_DOS_HEADER{};
     m_cachedFileHeader = IMAGE_FILE_HEADER{};
+    m_profile.reset();
     m_isValid = false;
     m_isParsing = false;
 }
 
+void PEParserNew::setExportIndex(const QSharedPointer<const PEExportIndex> &exportIndex)
+{
+    m_exportIndex = exportIndex;
+    m_dataDirectoryParser.setExportIndex(m_exportIndex.data());
+}
+
 bool PEParserNew::isValid() const
 {
     return m_isValid;
@@ -171,15 +322,18 @@ void PEParserNew::onAsyncParsingComplete()
 // Core parsing methods (Microsoft PE Format compliant)
 bool PEParserNew::parseDOSHeader()
 {
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("dos_header"), sizeof(IMAGE_DOS_HEADER));
     if (m_fileData.size() < sizeof(IMAGE_DOS_HEADER)) {
+        m_dataModel.reportDiagnostic(PEErrorType::FileTooSmall, 0);
         emit errorOccurred(LANG("UI/error_file_too_small"));
         return false;
     }
     
-    const IMAGE_DOS_HEADER *dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(m_fileData.data());
+    const IMAGE_DOS_HEADER *dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(m_fileData.constData());
     
     // Validate DOS magic number
     if (!PEUtils::isValidDOSMagic(dosHeader->e_magic)) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidDOSHeader, 0, "Missing MZ signature");
         emit errorOccurred(LANG("UI/error_invalid_dos"));
         return false;
     }
@@ -187,6 +341,8 @@ bool PEParserNew::parseDOSHeader()
     // Check if PE header exists
     if (dosHeader->e_lfanew >= m_fileData.size() || 
         dosHeader->e_lfanew < sizeof(IMAGE_DOS_HEADER)) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidDOSHeader, offsetof(IMAGE_DOS_HEADER, e_lfanew),
+                                     QString("e_lfanew 0x%1 is outside the file").arg(dosHeader->e_lfanew, 0, 16));
         emit errorOccurred(LANG("UI/error_invalid_pe_offset"));
         return false;
     }
@@ -198,6 +354,7 @@ bool PEParserNew::parseDOSHeader()
 
 bool PEParserNew::parsePEHeaders()
 {
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("pe_headers"));
     const IMAGE_DOS_HEADER *dosHeader = m_dataModel.getDOSHeader();
     if (!dosHeader) return false;
     
@@ -205,12 +362,14 @@ bool PEParserNew::parsePEHeaders()
     
     // Parse PE signature
     if (peOffset + sizeof(quint32) > m_fileData.size()) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidPESignature, peOffset, "PE signature extends beyond the file");
         emit errorOccurred(LANG("UI/error_pe_signature_beyond"));
         return false;
     }
     
-    quint32 peSignature = *reinterpret_cast<const quint32*>(m_fileData.data() + peOffset);
+    quint32 peSignature = *reinterpret_cast<const quint32*>(m_fileData.constData() + peOffset);
     if (!PEUtils::isValidPESignature(peSignature)) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidPESignature, peOffset);
         emit errorOccurred(LANG("UI/error_invalid_pe_signature"));
         return false;
     }
@@ -218,12 +377,13 @@ bool PEParserNew::parsePEHeaders()
     // Parse file header (immediately after the PE signature)
     quint32 fileHeaderOffset = peOffset + sizeof(quint32);
     if (fileHeaderOffset + sizeof(IMAGE_FILE_HEADER) > m_fileData.size()) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidFileHeader, fileHeaderOffset, "File header extends beyond the file");
         emit errorOccurred(LANG("UI/error_pe_header_beyond"));
         return false;
     }
     
     const IMAGE_FILE_HEADER *fileHeader = reinterpret_cast<const IMAGE_FILE_HEADER*>(
-        m_fileData.data() + fileHeaderOffset
+        m_fileData.constData() + fileHeaderOffset
     );
     m_cachedFileHeader = *fileHeader;
     m_dataModel.setFileHeader(&m_cachedFileHeader);
@@ -231,27 +391,33 @@ bool PEParserNew::parsePEHeaders()
     // Parse optional header
     quint32 optionalHeaderOffset = fileHeaderOffset + sizeof(IMAGE_FILE_HEADER);
     if (optionalHeaderOffset + fileHeader->SizeOfOptionalHeader > m_fileData.size()) {
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidOptionalHeader, optionalHeaderOffset,
+                                     "Optional header extends beyond the file");
         emit errorOccurred(LANG("UI/error_optional_header_beyond"));
         return false;
     }
     
     const IMAGE_OPTIONAL_HEADER *optionalHeader = reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(
-        m_fileData.data() + optionalHeaderOffset
+        m_fileData.constData() + optionalHeaderOffset
     );
     
     if (!PEUtils::isValidOptionalHeaderMagic(optionalHeader->Magic)) {
         qWarning() << "Unexpected optional header magic" << QString::number(optionalHeader->Magic, 16)
                    << "at offset" << QString("0x%1").arg(optionalHeaderOffset, 0, 16);
+        m_dataModel.reportDiagnostic(PEErrorType::InvalidOptionalHeader, optionalHeaderOffset,
+                                     QString("Unexpected magic 0x%1").arg(optionalHeader->Magic, 0, 16));
         emit errorOccurred(LANG("UI/error_invalid_optional_magic"));
         return false;
     }
     
     m_dataModel.setOptionalHeader(optionalHeader);
+    stage.setBytes(sizeof(quint32) + sizeof(IMAGE_FILE_HEADER) + fileHeader->SizeOfOptionalHeader);
     return true;
 }
 
 bool PEParserNew::parseSections()
 {
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("sections"));
     const IMAGE_DOS_HEADER *dosHeader = m_dataModel.getDOSHeader();
     const IMAGE_FILE_HEADER *fileHeader = m_dataModel.getFileHeader();
     const IMAGE_OPTIONAL_HEADER *optionalHeader = m_dataModel.getOptionalHeader();
@@ -267,10 +433,14 @@ bool PEParserNew::parseSections()
                                + fileHeader->SizeOfOptionalHeader;
     
     if (sectionTableOffset + (fileHeader->NumberOfSections * sizeof(IMAGE_SECTION_HEADER)) > m_fileData.size()) {
+        m_dataModel.reportDiagnostic(PEErrorType::SectionTableCorrupted, sectionTableOffset,
+                                     QString("%1 section headers extend beyond the file").arg(fileHeader->NumberOfSections));
         emit errorOccurred(LANG("UI/error_section_table_beyond"));
         return false;
     }
     
+    stage.setBytes(fileHeader->NumberOfSections * sizeof(IMAGE_SECTION_HEADER));
+    
     // Parse each section header from the in-memory buffer
     for (quint16 i = 0; i < fileHeader->NumberOfSections; ++i) {
         const IMAGE_SECTION_HEADER *section = reinterpret_cast<const IMAGE_SECTION_HEADER*>(
@@ -284,6 +454,7 @@ bool PEParserNew::parseSections()
 
 bool PEParserNew::parseDataDirectories()
 {
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("data_directories"));
     const IMAGE_DOS_HEADER *dosHeader = m_dataModel.getDOSHeader();
     const IMAGE_FILE_HEADER *fileHeader = m_dataModel.getFileHeader();
     const IMAGE_OPTIONAL_HEADER *optionalHeader = m_dataModel.getOptionalHeader();
@@ -305,6 +476,284 @@ bool PEParserNew::parseDataDirectories()
     return m_dataDirectoryParser.parseDataDirectories(optionalHeader, dataDirectoryOffset, m_dataModel);
 }
 
+void PEParserNew::decodeRichHeader()
+{
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("rich_header"));
+    const IMAGE_DOS_HEADER *dosHeader = m_dataModel.getDOSHeader();
+    if (dosHeader) {
+        m_dataModel.setRichHeader(PERichHeader::decode(m_fileData, dosHeader->e_lfanew));
+    }
+}
+
+void PEParserNew::computeContentDigests()
+{
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("content_digests"), m_dataModel.getFileSize());
+    const QList<const IMAGE_SECTION_HEADER*> &sections = m_dataModel.getSections();
+    const qint64 fileSize = m_dataModel.getFileSize();
+    
+    struct Piece {
+        qint64 start = 0;
+        qint64 end = 0;
+        int section = -1;           // -1 for a gap between sections
+        bool covers = true;         // Part of the file-order cover of [0, fileSize)
+    };
+    
+    // The raw data of each section, clamped to the file
+    QVector<Piece> sectionPieces;
+    sectionPieces.reserve(sections.size());
+    for (int i = 0; i < sections.size(); ++i) {
+        Piece piece;
+        piece.start = qMin<qint64>(sections[i]->PointerToRawData, fileSize);
+        piece.end = qMin<qint64>(piece.start + sections[i]->SizeOfRawData, fileSize);
+        piece.section = i;
+        sectionPieces.append(piece);
+    }
+    std::stable_sort(sectionPieces.begin(), sectionPieces.end(),
+                     [](const Piece &a, const Piece &b) { return a.start < b.start; });
+    
+    // Sections and the gaps between them cover the file once, in file order.
+    // The file digest is merged from these pieces, so no byte is read twice;
+    // only empty sections and those overlapping an earlier one are extra.
+    QVector<Piece> pieces;
+    QVector<Piece> extraPieces;
+    qint64 cursor = 0;
+    for (Piece piece : sectionPieces) {
+        if (piece.start < cursor || piece.start == piece.end) {
+            piece.covers = false;
+            extraPieces.append(piece);
+            continue;
+        }
+        if (piece.start > cursor) {
+            Piece gap;
+            gap.start = cursor;
+            gap.end = piece.start;
+            pieces.append(gap);
+        }
+        pieces.append(piece);
+        cursor = piece.end;
+    }
+    if (cursor < fileSize) {
+        Piece gap;
+        gap.start = cursor;
+        gap.end = fileSize;
+        pieces.append(gap);
+    }
+    const int coverCount = pieces.size();
+    pieces += extraPieces;
+    
+    // Every piece is an independent task, so the stage takes about as long as
+    // the largest piece. Files that were not loaded into memory are streamed,
+    // each task through its own file handle.
+    const QByteArray fileData = m_fileData;
+    const bool inMemory = !m_source.isMapped() && fileData.size() == fileSize;
+    const QString filePath = m_source.backingFilePath();
+    // Reading a mapping sequentially would leave the whole file resident, so
+    // mapped files are streamed too, with chunks sized to keep every task's
+    // buffer together within the memory limit
+    const qint64 chunkSize = qBound<qint64>(64 * 1024, m_memoryLimit / qMax(1, QThreadPool::globalInstance()->maxThreadCount()),
+                                            CONTENT_DIGEST_CHUNK_SIZE);
+    
+    // MD5, SHA-256 and the digest checksum cannot be combined from pieces;
+    // the tasks hand their chunks on to one ordered pass instead. In memory
+    // the chunks are views of fileData and cost nothing to hold.
+    OrderedDigestFeed feed(inMemory ? std::numeric_limits<qint64>::max() : m_memoryLimit);
+    OrderedDigestFeed *orderedFeed = &feed;
+    
+    auto analyzePiece = [fileData, inMemory, filePath, chunkSize, orderedFeed](const Piece &piece) {
+        QSharedPointer<PEContentStatistics> statistics = QSharedPointer<PEContentStatistics>::create(
+            piece.section < 0 ? PEContentStatistics::Mode::Mergeable : PEContentStatistics::Mode::Full);
+        if (inMemory) {
+            for (qint64 offset = piece.start; offset < piece.end; offset += chunkSize) {
+                const QByteArray chunk = QByteArray::fromRawData(fileData.constData() + offset, qMin(chunkSize, piece.end - offset));
+                statistics->update(chunk.constData(), chunk.size());
+                if (piece.covers) {
+                    orderedFeed->push(offset, chunk);
+                }
+            }
+            return statistics;
+        }
+        
+        QFile file(filePath);
+        qint64 offset = piece.start;
+        if (piece.start < piece.end && file.open(QIODevice::ReadOnly) && file.seek(piece.start)) {
+            while (offset < piece.end) {
+                const QByteArray chunk = file.read(qMin(piece.end - offset, chunkSize));
+                if (chunk.isEmpty()) {
+                    break;
+                }
+                statistics->update(chunk.constData(), chunk.size());
+                if (piece.covers) {
+                    orderedFeed->push(offset, chunk);
+                }
+                offset += chunk.size();
+            }
+        }
+        if (piece.covers && offset < piece.end) {
+            orderedFeed->fail();
+        }
+        return statistics;
+    };
+    
+    const QList<QSharedPointer<PEContentStatistics>> results =
+        QtConcurrent::blockingMapped<QList<QSharedPointer<PEContentStatistics>>>(pieces, analyzePiece);
+    
+    PEContentStatistics fileStatistics(PEContentStatistics::Mode::Mergeable);
+    QVector<PEDataModel::ContentDigest> sectionDigests(sections.size());
+    for (int i = 0; i < pieces.size(); ++i) {
+        if (i < coverCount) {
+            fileStatistics.append(*results[i]);
+        }
+        if (pieces[i].section >= 0) {
+            sectionDigests[pieces[i].section] = results[i]->result();
+        }
+    }
+    
+    PEDataModel::ContentDigest fileDigest = fileStatistics.result(feed.hashes());
+    if (feed.failed()) {
+        // Part of the file could not be read; the hashes would describe other bytes
+        fileDigest.md5.clear();
+        fileDigest.sha256.clear();
+        fileDigest.similarityHash.clear();
+    }
+    m_dataModel.setFileContentDigest(fileDigest);
+    m_dataModel.setSectionContentDigests(QList<PEDataModel::ContentDigest>(sectionDigests.begin(), sectionDigests.end()));
+}
+
+void PEParserNew::computeOverlay()
+{
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("overlay"));
+    const IMAGE_DOS_HEADER *dosHeader = m_dataModel.getDOSHeader();
+    const IMAGE_FILE_HEADER *fileHeader = m_dataModel.getFileHeader();
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = m_dataModel.getOptionalHeader();
+    const qint64 fileSize = m_fileData.size();
+    if (!dosHeader || !fileHeader || !optionalHeader) {
+        return;
+    }
+    
+    // The image ends where the headers or the raw data of the last section end
+    const qint64 optionalHeaderOffset = static_cast<qint64>(dosHeader->e_lfanew) + sizeof(quint32) + sizeof(IMAGE_FILE_HEADER);
+    qint64 imageEnd = qMax<qint64>(optionalHeader->SizeOfHeaders,
+                                   optionalHeaderOffset + fileHeader->SizeOfOptionalHeader +
+                                   fileHeader->NumberOfSections * static_cast<qint64>(sizeof(IMAGE_SECTION_HEADER)));
+    for (const IMAGE_SECTION_HEADER *section : m_dataModel.getSections()) {
+        if (section->PointerToRawData != 0 && section->SizeOfRawData != 0) {
+            imageEnd = qMax<qint64>(imageEnd, static_cast<qint64>(section->PointerToRawData) + section->SizeOfRawData);
+        }
+    }
+    imageEnd = qMin(imageEnd, fileSize);
+    
+    // The security directory holds a file offset, not an RVA
+    qint64 certificateStart = 0;
+    qint64 certificateEnd = 0;
+    const qint64 dataDirectoryOffset = optionalHeaderOffset + (optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC
+                                                               ? offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory)
+                                                               : offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory));
+    const qint64 securityDirectoryOffset = dataDirectoryOffset + IMAGE_DIRECTORY_ENTRY_SECURITY * sizeof(IMAGE_DATA_DIRECTORY);
+    if (securityDirectoryOffset + static_cast<qint64>(sizeof(IMAGE_DATA_DIRECTORY)) <= fileSize) {
+        IMAGE_DATA_DIRECTORY securityDirectory;
+        std::memcpy(&securityDirectory, m_fileData.constData() + securityDirectoryOffset, sizeof(securityDirectory));
+        if (securityDirectory.VirtualAddress != 0 && securityDirectory.Size != 0) {
+            certificateStart = qMin<qint64>(securityDirectory.VirtualAddress, fileSize);
+            certificateEnd = qMin<qint64>(certificateStart + securityDirectory.Size, fileSize);
+        }
+    }
+    
+    PEDataModel::Overlay overlay;
+    overlay.offset = imageEnd;
+    auto addRange = [&overlay](qint64 start, qint64 end) {
+        if (start < end) {
+            overlay.ranges.append(qMakePair(start, end));
+            overlay.size += end - start;
+        }
+    };
+    if (certificateStart < certificateEnd && certificateEnd > imageEnd) {
+        addRange(imageEnd, qMax(imageEnd, certificateStart));
+        addRange(qMax(imageEnd, certificateEnd), fileSize);
+    } else {
+        addRange(imageEnd, fileSize);
+    }
+    m_dataModel.setOverlay(overlay);
+    stage.setBytes(overlay.size);
+}
+
+void PEParserNew::carveEmbeddedImages()
+{
+    // Each level carves disjoint ranges of its container, so the total work
+    // stays within EMBEDDED_IMAGE_MAX_DEPTH passes over the file
+    if (m_embeddedDepth >= EMBEDDED_IMAGE_MAX_DEPTH) {
+        return;
+    }
+    
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("embedded_images"));
+    QVector<QPair<qint64, qint64>> ranges = m_dataModel.getOverlay().ranges;
+    const int overlayRanges = ranges.size();
+    const qint64 fileSize = m_fileData.size();
+    for (const PEDataModel::ResourceEntry &entry : m_dataModel.getResourceEntries()) {
+        // Offset 0 means the data maps to no section; scanning from there would carve the host itself
+        if (entry.fileOffset == 0 || entry.fileOffset >= static_cast<quint64>(fileSize)) {
+            continue;
+        }
+        ranges.append(qMakePair(qint64(entry.fileOffset), qMin(qint64(entry.fileOffset) + entry.size, fileSize)));
+    }
+    qint64 scannedBytes = 0;
+    for (const auto &range : ranges) {
+        scannedBytes += range.second - range.first;
+    }
+    stage.setBytes(scannedBytes);
+    
+    const QVector<PEEmbeddedScanner::Hit> hits = PEEmbeddedScanner::scan(m_fileData, ranges, EMBEDDED_IMAGE_MAX_COUNT);
+    
+    // Every image is parsed by its own parser on the global thread pool and
+    // carves its own overlay and resources in turn
+    const QByteArray fileData = m_fileData;
+    const QSharedPointer<const PEExportIndex> exportIndex = m_exportIndex;
+    const int depth = m_embeddedDepth + 1;
+    const QString filePath = m_dataModel.getFilePath();
+    const qint64 memoryLimit = m_memoryLimit;
+    auto parseImage = [fileData, exportIndex, depth, filePath, memoryLimit, overlayRanges](const PEEmbeddedScanner::Hit &hit) {
+        PEDataModel::EmbeddedImage image;
+        image.fileOffset = hit.offset;
+        image.size = hit.size;
+        image.container = hit.range < overlayRanges ? QStringLiteral("overlay") : QStringLiteral("resource");
+        image.depth = depth - 1;
+        
+        PEParserNew parser;
+        parser.setExportIndex(exportIndex);
+        parser.setMemoryLimit(memoryLimit);
+        parser.m_embeddedDepth = depth;
+        const QString name = QString("%1@0x%2").arg(filePath).arg(hit.offset, 0, 16);
+        image.parsed = parser.loadFromBuffer(QByteArray::fromRawData(fileData.constData() + hit.offset, hit.size), name);
+        
+        QList<PEDataModel::EmbeddedImage> images;
+        if (const IMAGE_FILE_HEADER *fileHeader = parser.m_dataModel.getFileHeader()) {
+            image.machine = fileHeader->Machine;
+            image.characteristics = fileHeader->Characteristics;
+        }
+        if (image.parsed) {
+            image.sha256 = parser.getFileContentDigest().sha256;
+            image.importHash = parser.getImportHash();
+        }
+        images.append(image);
+        
+        for (PEDataModel::EmbeddedImage nested : parser.getEmbeddedImages()) {
+            nested.fileOffset += hit.offset;
+            images.append(nested);
+        }
+        return images;
+    };
+    
+    const QList<QList<PEDataModel::EmbeddedImage>> carved =
+        QtConcurrent::blockingMapped<QList<QList<PEDataModel::EmbeddedImage>>>(hits, parseImage);
+    QList<PEDataModel::EmbeddedImage> images;
+    for (const QList<PEDataModel::EmbeddedImage> &imagesOfHit : carved) {
+        images += imagesOfHit;
+    }
+    m_dataModel.setEmbeddedImages(images);
+    
+    // The scan touched every overlay page of a mapped file
+    m_source.releasePages();
+}
+
 quint32 PEParserNew::rvaToFileOffset(quint32 rva)
 {
     const QList<const IMAGE_SECTION_HEADER*> &sections = m_dataModel.getSections();
@@ -327,7 +776,7 @@ quint32 PEParserNew::rvaToFileOffset(quint32 rva)
 
 bool PEParserNew::isLargeFile() const
 {
-    return m_dataModel.getFileSize() > LARGE_FILE_THRESHOLD;
+    return m_dataModel.getFileSize() > m_memoryLimit;
 }
 
 bool PEParserNew::isVeryLargeFile() const
@@ -335,148 +784,19 @@ bool PEParserNew::isVeryLargeFile() const
     return m_dataModel.getFileSize() > VERY_LARGE_FILE_THRESHOLD;
 }
 
-bool PEParserNew::loadLargeFileStreaming()
+void PEParserNew::setMemoryLimit(qint64 bytes)
 {
-    // For large files, we only read essential headers and structure information
-    // This avoids loading the entire file into memory
-    
-    emit parsingProgress(10, LANG("UI/progress_reading_dos_header"));
-    
-    // Read DOS header (64 bytes)
-    IMAGE_DOS_HEADER dosHeader;
-    if (m_file.read(reinterpret_cast<char*>(&dosHeader), sizeof(IMAGE_DOS_HEADER)) != sizeof(IMAGE_DOS_HEADER)) {
-        emit errorOccurred(LANG("UI/error_reading_dos_header"));
-        return false;
-    }
-    
-    // Validate DOS header
-    if (!PEUtils::isValidDOSHeader(dosHeader)) {
-        emit errorOccurred(LANG("UI/error_invalid_dos_header"));
-        return false;
-    }
-    
-    m_cachedDosHeader = dosHeader;
-    m_dataModel.setDOSHeader(&m_cachedDosHeader);
-    
-    emit parsingProgress(20, LANG("UI/progress_reading_pe_headers"));
-    
-    // Read PE signature and file header
-    if (!m_file.seek(dosHeader.e_lfanew)) {
-        emit errorOccurred(LANG("UI/error_seeking_pe_header"));
-        return false;
-    }
-    
-    // Read PE signature
-    quint32 peSignature;
-    if (m_file.read(reinterpret_cast<char*>(&peSignature), sizeof(quint32)) != sizeof(quint32)) {
-        emit errorOccurred(LANG("UI/error_reading_pe_signature"));
-        return false;
-    }
-    
-    if (!PEUtils::isValidPESignature(peSignature)) {
-        emit errorOccurred(LANG("UI/error_invalid_pe_signature"));
-        return false;
-    }
-    
-    // Read file header
-    IMAGE_FILE_HEADER fileHeader;
-    if (m_file.read(reinterpret_cast<char*>(&fileHeader), sizeof(IMAGE_FILE_HEADER)) != sizeof(IMAGE_FILE_HEADER)) {
-        emit errorOccurred(LANG("UI/error_reading_file_header"));
-        return false;
-    }
-    
-    m_cachedFileHeader = fileHeader;
-    m_dataModel.setFileHeader(&m_cachedFileHeader);
-    
-    emit parsingProgress(30, LANG("UI/progress_reading_optional_header"));
-    
-    // Read optional header - must read exactly SizeOfOptionalHeader bytes
-    // Allocate buffer for the optional header (max size is 224 bytes for PE32+)
-    QByteArray optionalHeaderBuffer(fileHeader.SizeOfOptionalHeader, 0);
-    if (m_file.read(optionalHeaderBuffer.data(), fileHeader.SizeOfOptionalHeader) != fileHeader.SizeOfOptionalHeader) {
-        emit errorOccurred(LANG("UI/error_reading_optional_header"));
-        return false;
-    }
-    
-    // Check magic number to determine if it's PE32 or PE32+
-    quint16 magic = *reinterpret_cast<const quint16*>(optionalHeaderBuffer.data());
-    if (!PEUtils::isValidOptionalHeaderMagic(magic)) {
-        emit errorOccurred(LANG("UI/error_invalid_optional_magic"));
-        return false;
-    }
-    
-    // Store the optional header buffer in the data model
-    // We need to keep the buffer alive, so we'll store it in m_fileData
-    // For now, we'll create a properly sized structure
-    if (magic == 0x10b) {
-        // PE32 (32-bit)
-        if (optionalHeaderBuffer.size() < static_cast<int>(sizeof(IMAGE_OPTIONAL_HEADER32))) {
-            emit errorOccurred(LANG("UI/error_optional_header_too_small"));
-            return false;
-        }
-        const IMAGE_OPTIONAL_HEADER32 *optHeader = reinterpret_cast<const IMAGE_OPTIONAL_HEADER32*>(optionalHeaderBuffer.data());
-        m_dataModel.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(optHeader));
-    } else if (magic == 0x20b) {
-        // PE32+ (64-bit)
-        if (optionalHeaderBuffer.size() < static_cast<int>(sizeof(IMAGE_OPTIONAL_HEADER64))) {
-            emit errorOccurred(LANG("UI/error_optional_header_too_small"));
-            return false;
-        }
-        // For 64-bit, we need to handle it differently, but for now use the same structure
-        // The DataDirectory array is at the same relative offset in both
-        const IMAGE_OPTIONAL_HEADER64 *optHeader64 = reinterpret_cast<const IMAGE_OPTIONAL_HEADER64*>(optionalHeaderBuffer.data());
-        // Store as 32-bit structure but we'll need to adjust access
-        m_dataModel.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(optHeader64));
-    }
-    
-    // Store the buffer so it doesn't go out of scope
-    m_optionalHeaderBuffer = optionalHeaderBuffer;
-    
-    // Load at least the headers into m_fileData so we can access Data Directories
-    // Calculate the size needed: DOS header + PE headers + Optional header + Section headers
-    quint32 headersSize = dosHeader.e_lfanew + sizeof(IMAGE_FILE_HEADER) + fileHeader.SizeOfOptionalHeader + 
-                          (fileHeader.NumberOfSections * sizeof(IMAGE_SECTION_HEADER));
-    if (!m_file.seek(0)) {
-        emit errorOccurred(LANG("UI/error_seeking_file_start"));
-        return false;
-    }
-    m_fileData = m_file.read(headersSize); // Read only headers, not entire file
-    
-    emit parsingProgress(40, LANG("UI/progress_reading_sections"));
-    
-    // Read section table (typically < 1KB even for large files)
-    quint32 sectionTableOffset = dosHeader.e_lfanew + sizeof(IMAGE_FILE_HEADER) + fileHeader.SizeOfOptionalHeader;
-    if (!m_file.seek(sectionTableOffset)) {
-        emit errorOccurred(LANG("UI/error_seeking_section_table"));
-        return false;
-    }
-    
-    // Read each section header
-    m_cachedSections.clear();
-    m_cachedSections.reserve(fileHeader.NumberOfSections);
-    
-    for (quint16 i = 0; i < fileHeader.NumberOfSections; ++i) {
-        IMAGE_SECTION_HEADER sectionHeader;
-        if (m_file.read(reinterpret_cast<char*>(&sectionHeader), sizeof(IMAGE_SECTION_HEADER)) != sizeof(IMAGE_SECTION_HEADER)) {
-            emit errorOccurred(LANG("UI/error_reading_section_header"));
-            return false;
-        }
-        m_cachedSections.append(sectionHeader);
-        m_dataModel.addSection(&m_cachedSections.last());
-    }
-    
-    emit parsingProgress(60, LANG("UI/progress_analyzing_structure"));
-    
-    // For large files, we skip detailed data directory parsing
-    // as it would require reading large portions of the file
-    emit parsingProgress(80, LANG("UI/progress_large_file_optimization"));
-    
-    // Don't close the file yet - we might need it for specific field access
-    // m_file.close(); // Keep file open for streaming access
-    
-    emit parsingProgress(90, LANG("UI/progress_large_file_complete"));
-    
-    return true;
+    m_memoryLimit = bytes > 0 ? bytes : std::numeric_limits<qint64>::max();
+}
+
+qint64 PEParserNew::getMemoryLimit() const
+{
+    return m_memoryLimit;
+}
+
+bool PEParserNew::isStreaming() const
+{
+    return m_source.isMapped();
 }
 
 // Field explanation and offset methods (for UI compatibility)
@@ -781,6 +1101,7 @@ void PEParserNew::setLanguage(const QString &language)
 
 QList<QTreeWidgetItem*> PEParserNew::getPEStructureTree()
 {
+    PEParseProfile::Scope stage(&m_profile, QStringLiteral("structure_tree"));
     QList<QTreeWidgetItem*> treeItems;
     
     // Create DOS Header section
@@ -797,21 +1118,17 @@ QList<QTreeWidgetItem*> PEParserNew::getPEStructureTree()
     treeItems.append(dosHeaderItem);
     
     // Create Rich Header section (if present)
-    if (dosHeader) {
-        quint32 richOffset;
-        if (PEUtils::findRichHeaderOffset(m_fileData, *dosHeader, richOffset)) {
-            quint32 richSize = PEUtils::calculateRichHeaderSize(m_fileData, richOffset);
-            
-            QTreeWidgetItem *richHeaderItem = new QTreeWidgetItem();
-            richHeaderItem->setText(0, "Rich Header");
-            richHeaderItem->setText(1, "");
-            richHeaderItem->setText(2, PEUtils::formatHexWidth(richOffset, 8));
-            richHeaderItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(richSize, 0)));
-            richHeaderItem->setText(4, ""); // No meaning for section header
-            
-            addRichHeaderFields(richHeaderItem, richOffset);
-            treeItems.append(richHeaderItem);
-        }
+    const PERichHeader::Info &richHeader = m_dataModel.getRichHeader();
+    if (richHeader.found) {
+        QTreeWidgetItem *richHeaderItem = new QTreeWidgetItem();
+        richHeaderItem->setText(0, "Rich Header");
+        richHeaderItem->setText(1, "");
+        richHeaderItem->setText(2, PEUtils::formatHexWidth(richHeader.offset, 8));
+        richHeaderItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(richHeader.size, 0)));
+        richHeaderItem->setText(4, ""); // No meaning for section header
+        
+        addRichHeaderFields(richHeaderItem);
+        treeItems.append(richHeaderItem);
     }
     
     // Create NT Headers section (parent container for File Header, Optional Header, and Section Headers)
@@ -829,7 +1146,7 @@ QList<QTreeWidgetItem*> PEParserNew::getPEStructureTree()
     
     // Add PE Signature as first field of NT Headers
     if (ntHeadersOffset + 4 <= m_fileData.size()) {
-        quint32 peSignature = *reinterpret_cast<const quint32*>(m_fileData.data() + ntHeadersOffset);
+        quint32 peSignature = *reinterpret_cast<const quint32*>(m_fileData.constData() + ntHeadersOffset);
         addTreeField(ntHeadersItem, "Signature", PEUtils::formatHexWidth(peSignature, 8), 0, sizeof(quint32));
     }
     
@@ -897,6 +1214,121 @@ QList<QTreeWidgetItem*> PEParserNew::getPEStructureTree()
     
     treeItems.append(ntHeadersItem);
     
+    // Create Debug Directory section (if present)
+    const QList<PEDataModel::DebugEntry> &debugEntries = m_dataModel.getDebugEntries();
+    if (!debugEntries.isEmpty()) {
+        QTreeWidgetItem *debugItem = new QTreeWidgetItem();
+        debugItem->setText(0, LANG("UI/data_dir_debug"));
+        debugItem->setText(1, "");
+        debugItem->setText(2, PEUtils::formatHexWidth(debugEntries.first().fileOffset, 8));
+        debugItem->setText(3, LANG_PARAM("UI/pe_structure_entries_format", "count", PEUtils::formatHexWidth(static_cast<quint64>(debugEntries.size()), 0)));
+        debugItem->setText(4, ""); // No meaning for container
+        
+        addDebugDirectoryFields(debugItem);
+        treeItems.append(debugItem);
+    }
+    
+    // Create TLS Callbacks section (if present)
+    const QList<PEDataModel::TLSCallbackEntry> &tlsCallbacks = m_dataModel.getTLSCallbacks();
+    if (!tlsCallbacks.isEmpty()) {
+        const QList<const IMAGE_SECTION_HEADER*> &sections = m_dataModel.getSections();
+        quint32 pointerSize = (optionalHeader && optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC) ? 8 : 4;
+        QTreeWidgetItem *tlsItem = new QTreeWidgetItem();
+        tlsItem->setText(0, "TLS Callbacks");
+        tlsItem->setText(1, "");
+        tlsItem->setText(2, PEUtils::formatHexWidth(tlsCallbacks.first().fileOffset, 8));
+        tlsItem->setText(3, LANG_PARAM("UI/pe_structure_entries_format", "count", PEUtils::formatHexWidth(static_cast<quint64>(tlsCallbacks.size()), 0)));
+        tlsItem->setText(4, ""); // No meaning for container
+        
+        for (int i = 0; i < tlsCallbacks.size(); ++i) {
+            const PEDataModel::TLSCallbackEntry &callback = tlsCallbacks[i];
+            QTreeWidgetItem *callbackItem = new QTreeWidgetItem(tlsItem);
+            callbackItem->setText(0, QString("Callback %1").arg(i + 1));
+            callbackItem->setText(1, PEUtils::formatHex(callback.va));
+            callbackItem->setText(2, PEUtils::formatHexWidth(callback.fileOffset, 8));
+            callbackItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(pointerSize, 0)));
+            QString sectionName = LANG("UI/security_tls_no_section");
+            if (callback.sectionIndex >= 0 && callback.sectionIndex < sections.size()) {
+                const char *name = reinterpret_cast<const char*>(sections[callback.sectionIndex]->Name);
+                sectionName = QString::fromLatin1(name, static_cast<int>(qstrnlen(name, 8)));
+            }
+            callbackItem->setText(4, callback.executable ? sectionName
+                                                         : LANG_PARAM("UI/tls_callback_not_executable", "section", sectionName));
+        }
+        treeItems.append(tlsItem);
+    }
+    
+    // Create Load Configuration section (if present)
+    const PEDataModel::LoadConfigDirectory &loadConfig = m_dataModel.getLoadConfigDirectory();
+    if (loadConfig.present) {
+        QTreeWidgetItem *loadConfigItem = new QTreeWidgetItem();
+        loadConfigItem->setText(0, LANG("UI/data_dir_load_config"));
+        loadConfigItem->setText(1, "");
+        loadConfigItem->setText(2, PEUtils::formatHexWidth(loadConfig.fileOffset, 8));
+        loadConfigItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(loadConfig.size, 0)));
+        loadConfigItem->setText(4, ""); // No meaning for container
+        
+        addLoadConfigFields(loadConfigItem, optionalHeader && optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC);
+        treeItems.append(loadConfigItem);
+    }
+    
+    // Create Delay Import Descriptors section (if present)
+    const QList<PEDataModel::DelayImportModule> &delayModules = m_dataModel.getDelayImportModules();
+    if (!delayModules.isEmpty()) {
+        QTreeWidgetItem *delayItem = new QTreeWidgetItem();
+        delayItem->setText(0, LANG("UI/data_dir_delay_import"));
+        delayItem->setText(1, "");
+        delayItem->setText(2, PEUtils::formatHexWidth(delayModules.first().descriptorOffset, 8));
+        delayItem->setText(3, LANG_PARAM("UI/pe_structure_entries_format", "count", PEUtils::formatHexWidth(static_cast<quint64>(delayModules.size()), 0)));
+        delayItem->setText(4, ""); // No meaning for container
+        
+        addDelayImportFields(delayItem);
+        treeItems.append(delayItem);
+    }
+    
+    // Create Bound Import Descriptors section (if present)
+    const QList<PEDataModel::BoundImportEntry> &boundImports = m_dataModel.getBoundImports();
+    if (!boundImports.isEmpty()) {
+        QTreeWidgetItem *boundItem = new QTreeWidgetItem();
+        boundItem->setText(0, LANG("UI/data_dir_bound_import"));
+        boundItem->setText(1, "");
+        boundItem->setText(2, PEUtils::formatHexWidth(boundImports.first().fileOffset, 8));
+        boundItem->setText(3, LANG_PARAM("UI/pe_structure_entries_format", "count", PEUtils::formatHexWidth(static_cast<quint64>(boundImports.size()), 0)));
+        boundItem->setText(4, ""); // No meaning for container
+        
+        for (const PEDataModel::BoundImportEntry &entry : boundImports) {
+            QTreeWidgetItem *moduleItem = new QTreeWidgetItem(boundItem);
+            moduleItem->setText(0, entry.moduleName);
+            moduleItem->setText(1, "");
+            moduleItem->setText(2, PEUtils::formatHexWidth(entry.fileOffset, 8));
+            moduleItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR), 0)));
+            moduleItem->setText(4, "");
+            
+            addTreeField(moduleItem, "TimeDateStamp", PEUtils::formatHexWidth(entry.timeDateStamp, 8), 0, sizeof(quint32));
+            addTreeField(moduleItem, "NumberOfModuleForwarderRefs", QString::number(entry.forwarders.size()), 6, sizeof(quint16));
+            for (int i = 0; i < entry.forwarders.size(); ++i) {
+                // Forwarder references directly follow their descriptor
+                addTreeField(moduleItem, entry.forwarders[i].moduleName, PEUtils::formatHexWidth(entry.forwarders[i].timeDateStamp, 8),
+                             (i + 1) * sizeof(IMAGE_BOUND_FORWARDER_REF), sizeof(IMAGE_BOUND_FORWARDER_REF));
+            }
+        }
+        treeItems.append(boundItem);
+    }
+    
+    // Create CLR Runtime Header section (if present)
+    const PEDataModel::ClrRuntimeHeader &clrHeader = m_dataModel.getClrRuntimeHeader();
+    if (clrHeader.present) {
+        QTreeWidgetItem *clrItem = new QTreeWidgetItem();
+        clrItem->setText(0, LANG("UI/data_dir_com_runtime"));
+        clrItem->setText(1, "");
+        clrItem->setText(2, PEUtils::formatHexWidth(clrHeader.fileOffset, 8));
+        clrItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(sizeof(IMAGE_COR20_HEADER), 0)));
+        clrItem->setText(4, ""); // No meaning for container
+        
+        addClrFields(clrItem);
+        treeItems.append(clrItem);
+    }
+    
     return treeItems;
 }
 
@@ -1047,48 +1479,251 @@ void PEParserNew::addSectionFields(QTreeWidgetItem *parent)
     }
 }
 
-void PEParserNew::addRichHeaderFields(QTreeWidgetItem *parent, quint32 richOffset)
+void PEParserNew::addRichHeaderFields(QTreeWidgetItem *parent)
 {
-    if (richOffset + 16 > m_fileData.size()) {
-        return;
+    const PERichHeader::Info &richHeader = m_dataModel.getRichHeader();
+    
+    // Offsets are relative to the "DanS" dword (parent's offset)
+    quint32 richMarkerOffset = richHeader.size - 8;
+    addTreeField(parent, "DanSSignature", PEUtils::formatHexWidth(0x536E6144 ^ richHeader.xorKey, 8), 0, sizeof(quint32));
+    addTreeField(parent, "RichSignature", "Rich", richMarkerOffset, sizeof(quint32));
+    addTreeField(parent, "XorKey", PEUtils::formatHexWidth(richHeader.xorKey, 8), richMarkerOffset + 4, sizeof(quint32));
+    addTreeField(parent, "RichChecksum", richHeader.checksumValid ? LANG("UI/rich_checksum_valid") : LANG("UI/rich_checksum_invalid"),
+                 richMarkerOffset + 4, sizeof(quint32));
+    addTreeField(parent, "RichHash", richHeader.hash, 0, richMarkerOffset);
+    addTreeField(parent, "RichCount", QString::number(richHeader.entries.size()), 16, richMarkerOffset - 16);
+    
+    for (int i = 0; i < richHeader.entries.size(); ++i) {
+        const PERichHeader::Entry &entry = richHeader.entries[i];
+        QString entryName = QString("Entry %1: %2").arg(i + 1).arg(PERichHeader::productName(entry.productId));
+        QString toolchain = PERichHeader::toolchainName(entry.productId, entry.buildNumber);
+        
+        QTreeWidgetItem *entryItem = new QTreeWidgetItem(parent);
+        entryItem->setText(0, entryName);
+        QString summary = QString("Build %1, Count: %2").arg(entry.buildNumber).arg(entry.count);
+        if (!toolchain.isEmpty()) {
+            summary += QString(" (%1)").arg(toolchain);
+        }
+        entryItem->setText(1, summary);
+        entryItem->setText(2, PEUtils::formatHexWidth(entry.fileOffset, 8));
+        entryItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(8, 0)));
+        entryItem->setText(4, ""); // No meaning for entry header
+        
+        // compId is build number (low word) then product ID (high word); offsets relative to the entry
+        addTreeField(entryItem, "BuildNumber", QString::number(entry.buildNumber), 0, sizeof(quint16));
+        addTreeField(entryItem, "ProductId", PEUtils::formatHexWidth(entry.productId, 4), 2, sizeof(quint16));
+        addTreeField(entryItem, "Count", QString::number(entry.count), 4, sizeof(quint32));
     }
-    
-    IMAGE_RICH_HEADER richHeader;
-    if (!PEUtils::parseRichHeader(m_fileData, richOffset, richHeader)) {
+}
+
+void PEParserNew::addDebugDirectoryFields(QTreeWidgetItem *parent)
+{
+    const QList<PEDataModel::DebugEntry> &debugEntries = m_dataModel.getDebugEntries();
+    for (int i = 0; i < debugEntries.size(); ++i) {
+        const PEDataModel::DebugEntry &entry = debugEntries[i];
+        
+        QTreeWidgetItem *entryItem = new QTreeWidgetItem(parent);
+        entryItem->setText(0, QString("Entry %1: %2").arg(i + 1).arg(PEUtils::getDebugTypeName(entry.type)));
+        entryItem->setText(1, "");
+        entryItem->setText(2, PEUtils::formatHexWidth(entry.fileOffset, 8));
+        entryItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(sizeof(IMAGE_DEBUG_DIRECTORY), 0)));
+        entryItem->setText(4, ""); // No meaning for entry header
+        
+        // IMAGE_DEBUG_DIRECTORY fields - offsets relative to the entry
+        addTreeField(entryItem, "TimeDateStamp", PEUtils::formatHexWidth(entry.timeDateStamp, 8), 4, sizeof(quint32));
+        addTreeField(entryItem, "MajorVersion", PEUtils::formatHexWidth(entry.majorVersion, 4), 8, sizeof(quint16));
+        addTreeField(entryItem, "MinorVersion", PEUtils::formatHexWidth(entry.minorVersion, 4), 10, sizeof(quint16));
+        addTreeField(entryItem, "Type", PEUtils::formatHexWidth(entry.type, 8), 12, sizeof(quint32));
+        addTreeField(entryItem, "SizeOfData", PEUtils::formatHexWidth(entry.sizeOfData, 8), 16, sizeof(quint32));
+        addTreeField(entryItem, "AddressOfRawData", PEUtils::formatHexWidth(entry.addressOfRawData, 8), 20, sizeof(quint32));
+        addTreeField(entryItem, "PointerToRawData", PEUtils::formatHexWidth(entry.pointerToRawData, 8), 24, sizeof(quint32));
+        
+        // Decoded payload - offsets relative to PointerToRawData
+        QTreeWidgetItem *dataItem = new QTreeWidgetItem(entryItem);
+        dataItem->setText(0, "Data");
+        dataItem->setText(1, "");
+        dataItem->setText(2, PEUtils::formatHexWidth(entry.pointerToRawData, 8));
+        dataItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(entry.sizeOfData, 0)));
+        dataItem->setText(4, "");
+        
+        if (entry.codeViewFormat == "RSDS") {
+            addTreeField(dataItem, "CvSignature", entry.codeViewFormat, 0, sizeof(quint32));
+            addTreeField(dataItem, "PdbGuid", entry.pdbGuid, 4, 16);
+            addTreeField(dataItem, "PdbAge", QString::number(entry.pdbAge), 20, sizeof(quint32));
+            addTreeField(dataItem, "PdbFileName", entry.pdbPath, 24, entry.pdbPath.toUtf8().size() + 1);
+        } else if (entry.codeViewFormat == "NB10") {
+            addTreeField(dataItem, "CvSignature", entry.codeViewFormat, 0, sizeof(quint32));
+            addTreeField(dataItem, "PdbSignature", entry.pdbGuid, 8, sizeof(quint32));
+            addTreeField(dataItem, "PdbAge", QString::number(entry.pdbAge), 12, sizeof(quint32));
+            addTreeField(dataItem, "PdbFileName", entry.pdbPath, 16, entry.pdbPath.toUtf8().size() + 1);
+        } else if (entry.type == IMAGE_DEBUG_TYPE_POGO && !entry.pogoFormat.isEmpty()) {
+            addTreeField(dataItem, "PogoSignature", entry.pogoFormat, 0, sizeof(quint32));
+            quint32 offset = sizeof(quint32);
+            for (const PEDataModel::PogoEntry &pogo : entry.pogoEntries) {
+                quint32 recordSize = 8 + pogo.name.size() + 1;
+                addTreeField(dataItem, pogo.name, QString("RVA %1, Size %2").arg(PEUtils::formatHexWidth(pogo.rva, 8), PEUtils::formatHexWidth(pogo.size, 0)),
+                             offset, recordSize);
+                offset = (offset + recordSize + 3) & ~3u;
+            }
+        } else if (entry.type == IMAGE_DEBUG_TYPE_VC_FEATURE) {
+            addTreeField(dataItem, "PreVC11", QString::number(entry.preVC11Count), 0, sizeof(quint32));
+            addTreeField(dataItem, "C/C++", QString::number(entry.cAndCppCount), 4, sizeof(quint32));
+            addTreeField(dataItem, "/GS", QString::number(entry.gsCount), 8, sizeof(quint32));
+            addTreeField(dataItem, "/sdl", QString::number(entry.sdlCount), 12, sizeof(quint32));
+            addTreeField(dataItem, "guardN", QString::number(entry.guardNCount), 16, sizeof(quint32));
+        } else if (entry.type == IMAGE_DEBUG_TYPE_REPRO && !entry.reproHash.isEmpty()) {
+            addTreeField(dataItem, "ReproHash", QString::fromLatin1(entry.reproHash.toHex()), 4, entry.reproHash.size());
+        } else if (entry.type == IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS) {
+            addTreeField(dataItem, "ExDllCharacteristics", PEUtils::formatHexWidth(entry.exDllCharacteristics, 8), 0, sizeof(quint32));
+        }
+        
+        if (dataItem->childCount() == 0) {
+            delete dataItem;
+        }
+    }
+}
+
+void PEParserNew::addDelayImportFields(QTreeWidgetItem *parent)
+{
+    const QList<PEDataModel::DelayImportModule> &modules = m_dataModel.getDelayImportModules();
+    const QMap<QString, QList<PEDataModel::ImportFunctionEntry>> &functionsByModule = m_dataModel.getDelayImportFunctions();
+    
+    for (const PEDataModel::DelayImportModule &module : modules) {
+        QTreeWidgetItem *moduleItem = new QTreeWidgetItem(parent);
+        moduleItem->setText(0, module.dllName);
+        moduleItem->setText(1, "");
+        moduleItem->setText(2, PEUtils::formatHexWidth(module.descriptorOffset, 8));
+        moduleItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(sizeof(IMAGE_DELAYLOAD_DESCRIPTOR), 0)));
+        moduleItem->setText(4, module.rvaBased ? "" : LANG("UI/delay_import_va_based"));
+        
+        // IMAGE_DELAYLOAD_DESCRIPTOR fields, shown as RVAs even when the descriptor stores VAs
+        addTreeField(moduleItem, "ModuleHandleRVA", PEUtils::formatHexWidth(module.moduleHandleRVA, 8), 8, sizeof(quint32));
+        addTreeField(moduleItem, "ImportAddressTableRVA", PEUtils::formatHexWidth(module.importAddressTableRVA, 8), 12, sizeof(quint32));
+        addTreeField(moduleItem, "ImportNameTableRVA", PEUtils::formatHexWidth(module.importNameTableRVA, 8), 16, sizeof(quint32));
+        addTreeField(moduleItem, "BoundImportAddressTableRVA", PEUtils::formatHexWidth(module.boundImportAddressTableRVA, 8), 20, sizeof(quint32));
+        addTreeField(moduleItem, "UnloadInformationTableRVA", PEUtils::formatHexWidth(module.unloadInformationTableRVA, 8), 24, sizeof(quint32));
+        addTreeField(moduleItem, "TimeDateStamp", PEUtils::formatHexWidth(module.timeDateStamp, 8), 28, sizeof(quint32));
+        
+        // Functions are listed at their IAT slots, not relative to the descriptor
+        for (const PEDataModel::ImportFunctionEntry &function : functionsByModule.value(module.dllName)) {
+            QTreeWidgetItem *functionItem = new QTreeWidgetItem(moduleItem);
+            bool unnamed = function.importedByOrdinal && function.name == "[ - ]";
+            functionItem->setText(0, unnamed ? QString("Ordinal %1").arg(function.ordinal) : function.name);
+            functionItem->setText(1, PEUtils::formatHexWidth(function.thunkRVA, 8));
+            functionItem->setText(2, PEUtils::formatHexWidth(function.thunkOffset, 8));
+            functionItem->setText(3, "");
+            functionItem->setText(4, function.forwardedTo.isEmpty() ? QString() : LANG_PARAM("UI/import_forwarded_to", "target", function.forwardedTo));
+        }
+    }
+}
+
+void PEParserNew::addClrFields(QTreeWidgetItem *parent)
+{
+    const IMAGE_COR20_HEADER &header = m_dataModel.getClrRuntimeHeader().header;
+    addTreeField(parent, "MajorRuntimeVersion", QString::number(header.MajorRuntimeVersion), 4, sizeof(quint16));
+    addTreeField(parent, "MinorRuntimeVersion", QString::number(header.MinorRuntimeVersion), 6, sizeof(quint16));
+    addTreeField(parent, "MetaData", QString("RVA %1, Size %2").arg(PEUtils::formatHexWidth(header.MetaData.VirtualAddress, 8), PEUtils::formatHexWidth(header.MetaData.Size, 0)), 8, sizeof(IMAGE_DATA_DIRECTORY));
+    addTreeField(parent, "ClrFlags", PEUtils::formatHexWidth(header.Flags, 8), 16, sizeof(quint32));
+    addTreeField(parent, "EntryPointToken", PEUtils::formatHexWidth(header.EntryPointToken, 8), 20, sizeof(quint32));
+    addTreeField(parent, "Resources", QString("RVA %1, Size %2").arg(PEUtils::formatHexWidth(header.Resources.VirtualAddress, 8), PEUtils::formatHexWidth(header.Resources.Size, 0)), 24, sizeof(IMAGE_DATA_DIRECTORY));
+    addTreeField(parent, "StrongNameSignature", QString("RVA %1, Size %2").arg(PEUtils::formatHexWidth(header.StrongNameSignature.VirtualAddress, 8), PEUtils::formatHexWidth(header.StrongNameSignature.Size, 0)), 32, sizeof(IMAGE_DATA_DIRECTORY));
+    
+    const PEClrMetadata &metadata = m_dataModel.getClrMetadata();
+    if (!metadata.isValid()) {
         return;
     }
     
-    // Add Rich Header fields - offsets are relative to richOffset (parent's offset)
-    addTreeField(parent, "XorKey", PEUtils::formatHexWidth(richHeader.XorKey, 8), 0, sizeof(quint32));
-    addTreeField(parent, "RichSignature", PEUtils::formatHexWidth(richHeader.RichSignature, 8), 4, sizeof(quint32));
-    addTreeField(parent, "RichVersion", PEUtils::formatHexWidth(richHeader.RichVersion, 8), 8, sizeof(quint32));
-    addTreeField(parent, "RichCount", PEUtils::formatHexWidth(richHeader.RichCount, 8), 12, sizeof(quint32));
-    
-    // Add Rich Entry fields
-    QList<IMAGE_RICH_ENTRY> entries = PEUtils::parseRichEntries(m_fileData, richOffset, richHeader.RichCount);
-    quint32 entryBaseOffset = 16; // 4 dwords = 16 bytes
-    
-    for (int i = 0; i < entries.size(); ++i) {
-        const IMAGE_RICH_ENTRY &entry = entries[i];
-        QString productName = PEUtils::getRichHeaderProductName(entry.ProductId);
-        QString entryName = QString("Entry %1: %2").arg(i + 1).arg(productName);
+    // Stream headers, then row counts; rows are only decoded for the small tables
+    for (const PEClrMetadata::Stream &stream : metadata.streams()) {
+        QTreeWidgetItem *streamItem = new QTreeWidgetItem(parent);
+        streamItem->setText(0, stream.name);
+        streamItem->setText(1, "");
+        streamItem->setText(2, PEUtils::formatHexWidth(stream.fileOffset, 8));
+        streamItem->setText(3, LANG_PARAM("UI/pe_structure_size_format", "size", PEUtils::formatHexWidth(stream.size, 0)));
+        streamItem->setText(4, (stream.name == "#~" || stream.name == "#-") ? metadata.version() : "");
         
-        QTreeWidgetItem *entryItem = new QTreeWidgetItem(parent);
-        entryItem->setText(0, entryName);
-        QString versionMajor = QString::number((entry.ProductVersion >> 8) & 0xFF, 16).toUpper().rightJustified(2, '0');
-        QString versionMinor = QString::number(entry.ProductVersion & 0xFF, 16).toUpper().rightJustified(2, '0');
-        QString countHex = PEUtils::formatHexWidth(entry.ProductCount, 8);
-        entryItem->setText(1, QString("v0x%1.0x%2, Count: %3").arg(versionMajor, versionMinor, countHex));
-        quint32 entryOffset = entryBaseOffset + (i * 12); // Each entry is 12 bytes
-        entryItem->setText(2, PEUtils::formatHexWidth(richOffset + entryOffset, 8));
-        entryItem->setText(3, PEUtils::formatHexWidth(12, 0) + " bytes");
-        entryItem->setText(4, ""); // No meaning for entry header
+        if (stream.name != "#~" && stream.name != "#-") {
+            continue;
+        }
+        const QList<QPair<int, QString>> tables = {
+            {PEClrMetadata::Module, "Module"}, {PEClrMetadata::TypeRef, "TypeRef"}, {PEClrMetadata::TypeDef, "TypeDef"},
+            {PEClrMetadata::Field, "Field"}, {PEClrMetadata::MethodDef, "MethodDef"}, {PEClrMetadata::MemberRef, "MemberRef"},
+            {PEClrMetadata::AssemblyRef, "AssemblyRef"}, {PEClrMetadata::ManifestResource, "ManifestResource"}
+        };
+        for (const QPair<int, QString> &table : tables) {
+            QTreeWidgetItem *tableItem = new QTreeWidgetItem(streamItem);
+            tableItem->setText(0, table.second);
+            tableItem->setText(1, QString::number(metadata.rowCount(table.first)));
+            tableItem->setText(2, "");
+            tableItem->setText(3, "");
+            tableItem->setText(4, "");
+            
+            if (table.first == PEClrMetadata::AssemblyRef) {
+                quint32 shownRows = qMin<quint32>(metadata.rowCount(table.first), MAX_CLR_TREE_ROWS);
+                for (quint32 row = 1; row <= shownRows; ++row) {
+                    PEClrMetadata::AssemblyRefRow assemblyRef = metadata.assemblyRef(row);
+                    QTreeWidgetItem *rowItem = new QTreeWidgetItem(tableItem);
+                    rowItem->setText(0, assemblyRef.name);
+                    rowItem->setText(1, QString("%1.%2.%3.%4").arg(assemblyRef.majorVersion).arg(assemblyRef.minorVersion)
+                                                                  .arg(assemblyRef.buildNumber).arg(assemblyRef.revisionNumber));
+                    rowItem->setText(4, QString::fromLatin1(assemblyRef.publicKeyOrToken.toHex()));
+                }
+            } else if (table.first == PEClrMetadata::ManifestResource) {
+                quint32 shownRows = qMin<quint32>(metadata.rowCount(table.first), MAX_CLR_TREE_ROWS);
+                for (quint32 row = 1; row <= shownRows; ++row) {
+                    PEClrMetadata::ManifestResourceRow resource = metadata.manifestResource(row);
+                    QTreeWidgetItem *rowItem = new QTreeWidgetItem(tableItem);
+                    rowItem->setText(0, resource.name);
+                    rowItem->setText(1, PEUtils::formatHexWidth(resource.offset, 8));
+                    rowItem->setText(4, resource.implementation == 0 ? LANG("UI/clr_resource_embedded") : LANG("UI/clr_resource_linked"));
+                }
+            }
+        }
+    }
+}
+
+void PEParserNew::addLoadConfigFields(QTreeWidgetItem *parent, bool isPE64)
+{
+    const PEDataModel::LoadConfigDirectory &loadConfig = m_dataModel.getLoadConfigDirectory();
+    
+    // Table fields show the entries actually read; a short count means the table was truncated
+    auto tableValue = [](const PERvaSet &set, quint64 declared) {
+        return set.size() == static_cast<int>(declared) ? QString::number(declared)
+                                                        : QString("%1 / %2").arg(set.size()).arg(declared);
+    };
+    auto addFields = [&](auto *dir) {
+        using Directory = std::remove_pointer_t<decltype(dir)>;
+        quint32 pointerSize = sizeof(dir->SecurityCookie);
+        auto fits = [&](size_t offset, size_t size) { return offset + size <= loadConfig.size; };
         
-        // Add individual entry fields - offsets relative to entry start (entryOffset)
-        addTreeField(entryItem, "ProductId", PEUtils::formatHexWidth(entry.ProductId, 4), entryOffset, sizeof(quint16));
-        addTreeField(entryItem, "ProductVersion", PEUtils::formatHexWidth(entry.ProductVersion, 4), entryOffset + 2, sizeof(quint16));
-        addTreeField(entryItem, "ProductCount", PEUtils::formatHexWidth(entry.ProductCount, 8), entryOffset + 4, sizeof(quint32));
-        addTreeField(entryItem, "ProductTimestamp", PEUtils::formatHexWidth(entry.ProductTimestamp, 8), entryOffset + 8, sizeof(quint32));
+        addTreeField(parent, "Size", PEUtils::formatHexWidth(loadConfig.size, 8), offsetof(Directory, Size), sizeof(quint32));
+        addTreeField(parent, "TimeDateStamp", PEUtils::formatHexWidth(loadConfig.timeDateStamp, 8), offsetof(Directory, TimeDateStamp), sizeof(quint32));
+        if (fits(offsetof(Directory, SecurityCookie), pointerSize)) {
+            addTreeField(parent, "SecurityCookie", PEUtils::formatHex(loadConfig.securityCookie), offsetof(Directory, SecurityCookie), pointerSize);
+        }
+        if (!isPE64 && fits(offsetof(Directory, SEHandlerCount), pointerSize)) {
+            addTreeField(parent, "SEHandlerCount", tableValue(loadConfig.seHandlers, loadConfig.seHandlerCount), offsetof(Directory, SEHandlerCount), pointerSize);
+        }
+        if (fits(offsetof(Directory, GuardFlags), sizeof(quint32))) {
+            addTreeField(parent, "GuardCFCheckFunctionPointer", PEUtils::formatHex(loadConfig.guardCFCheckFunctionPointer), offsetof(Directory, GuardCFCheckFunctionPointer), pointerSize);
+            addTreeField(parent, "GuardCFDispatchFunctionPointer", PEUtils::formatHex(loadConfig.guardCFDispatchFunctionPointer), offsetof(Directory, GuardCFDispatchFunctionPointer), pointerSize);
+            addTreeField(parent, "GuardCFFunctionCount", tableValue(loadConfig.guardCFFunctions, loadConfig.guardCFFunctionCount), offsetof(Directory, GuardCFFunctionCount), pointerSize);
+            addTreeField(parent, "GuardFlags", PEUtils::formatHexWidth(loadConfig.guardFlags, 8), offsetof(Directory, GuardFlags), sizeof(quint32));
+        }
+        if (fits(offsetof(Directory, GuardAddressTakenIatEntryCount), pointerSize)) {
+            addTreeField(parent, "GuardAddressTakenIatEntryCount", tableValue(loadConfig.addressTakenIatEntries, loadConfig.guardAddressTakenIatEntryCount), offsetof(Directory, GuardAddressTakenIatEntryCount), pointerSize);
+        }
+        if (fits(offsetof(Directory, GuardLongJumpTargetCount), pointerSize)) {
+            addTreeField(parent, "GuardLongJumpTargetCount", tableValue(loadConfig.longJumpTargets, loadConfig.guardLongJumpTargetCount), offsetof(Directory, GuardLongJumpTargetCount), pointerSize);
+        }
+        if (fits(offsetof(Directory, GuardEHContinuationCount), pointerSize)) {
+            addTreeField(parent, "GuardEHContinuationCount", tableValue(loadConfig.ehContinuationTargets, loadConfig.guardEHContinuationCount), offsetof(Directory, GuardEHContinuationCount), pointerSize);
+        }
+    };
+    if (isPE64) {
+        addFields(static_cast<const IMAGE_LOAD_CONFIG_DIRECTORY64*>(nullptr));
+    } else {
+        addFields(static_cast<const IMAGE_LOAD_CONFIG_DIRECTORY32*>(nullptr));
     }
 }
 
@@ -1190,14 +1825,14 @@ void PEParserNew::addDataDirectoryFields(QTreeWidgetItem *parent)
         quint32 fileAddress = 0;
         quint32 fileSize = 0;
         if (addressOffset + sizeof(quint32) <= static_cast<quint32>(m_fileData.size())) {
-            const quint8 *addrPtr = reinterpret_cast<const quint8*>(m_fileData.data() + addressOffset);
+            const quint8 *addrPtr = reinterpret_cast<const quint8*>(m_fileData.constData() + addressOffset);
             fileAddress = static_cast<quint32>(addrPtr[0]) |
                          (static_cast<quint32>(addrPtr[1]) << 8) |
                          (static_cast<quint32>(addrPtr[2]) << 16) |
                          (static_cast<quint32>(addrPtr[3]) << 24);
         }
         if (sizeOffset + sizeof(quint32) <= static_cast<quint32>(m_fileData.size())) {
-            const quint8 *sizePtr = reinterpret_cast<const quint8*>(m_fileData.data() + sizeOffset);
+            const quint8 *sizePtr = reinterpret_cast<const quint8*>(m_fileData.constData() + sizeOffset);
             fileSize = static_cast<quint32>(sizePtr[0]) |
                       (static_cast<quint32>(sizePtr[1]) << 8) |
                       (static_cast<quint32>(sizePtr[2]) << 16) |
@@ -1412,16 +2047,66 @@ QString PEParserNew::getFieldMeaning(const QString &fieldName, const QString &va
         }
     }
     
+    if (fieldName == "ClrFlags") {
+        bool ok;
+        quint32 flags = value.toULong(&ok, 16);
+        if (ok) {
+            QStringList names;
+            if (flags & COMIMAGE_FLAGS_ILONLY) names << "ILONLY";
+            if (flags & COMIMAGE_FLAGS_32BITREQUIRED) names << "32BITREQUIRED";
+            if (flags & COMIMAGE_FLAGS_IL_LIBRARY) names << "IL_LIBRARY";
+            if (flags & COMIMAGE_FLAGS_STRONGNAMESIGNED) names << "STRONGNAMESIGNED";
+            if (flags & COMIMAGE_FLAGS_NATIVE_ENTRYPOINT) names << "NATIVE_ENTRYPOINT";
+            if (flags & COMIMAGE_FLAGS_TRACKDEBUGDATA) names << "TRACKDEBUGDATA";
+            if (flags & COMIMAGE_FLAGS_32BITPREFERRED) names << "32BITPREFERRED";
+            return names.join(" | ");
+        }
+    }
+    
+    // Load configuration guard flags; the top nibble is the guard table stride
+    if (fieldName == "GuardFlags") {
+        bool ok;
+        quint32 flags = value.toULong(&ok, 16);
+        if (ok) {
+            QStringList names;
+            if (flags & IMAGE_GUARD_CF_INSTRUMENTED) names << "CF_INSTRUMENTED";
+            if (flags & IMAGE_GUARD_CFW_INSTRUMENTED) names << "CFW_INSTRUMENTED";
+            if (flags & IMAGE_GUARD_CF_FUNCTION_TABLE_PRESENT) names << "CF_FUNCTION_TABLE_PRESENT";
+            if (flags & IMAGE_GUARD_SECURITY_COOKIE_UNUSED) names << "SECURITY_COOKIE_UNUSED";
+            if (flags & IMAGE_GUARD_PROTECT_DELAYLOAD_IAT) names << "PROTECT_DELAYLOAD_IAT";
+            if (flags & IMAGE_GUARD_DELAYLOAD_IAT_IN_ITS_OWN_SECTION) names << "DELAYLOAD_IAT_IN_ITS_OWN_SECTION";
+            if (flags & IMAGE_GUARD_CF_EXPORT_SUPPRESSION_INFO_PRESENT) names << "CF_EXPORT_SUPPRESSION_INFO_PRESENT";
+            if (flags & IMAGE_GUARD_CF_ENABLE_EXPORT_SUPPRESSION) names << "CF_ENABLE_EXPORT_SUPPRESSION";
+            if (flags & IMAGE_GUARD_CF_LONGJUMP_TABLE_PRESENT) names << "CF_LONGJUMP_TABLE_PRESENT";
+            if (flags & IMAGE_GUARD_RF_INSTRUMENTED) names << "RF_INSTRUMENTED";
+            if (flags & IMAGE_GUARD_EH_CONTINUATION_TABLE_PRESENT) names << "EH_CONTINUATION_TABLE_PRESENT";
+            if (flags & IMAGE_GUARD_XFG_ENABLED) names << "XFG_ENABLED";
+            quint32 stride = (flags & IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK) >> IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT;
+            if (stride != 0) names << QString("STRIDE_%1").arg(stride);
+            return names.join(" | ");
+        }
+    }
+    
     // Rich Header fields
-    if (fieldName == "RichSignature") {
+    if (fieldName == "ExDllCharacteristics") {
         bool ok;
-        quint32 sig = value.toULong(&ok, 16);
+        quint32 flags = value.toULong(&ok, 16);
         if (ok) {
-            // Check if it's "DanS" when XORed (we'd need the XOR key, but for display we show it's the signature)
-            return "DanS signature (XORed)";
+            QStringList names;
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT) names << "CET_COMPAT";
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT_STRICT_MODE) names << "CET_COMPAT_STRICT_MODE";
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE) names << "CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE";
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_CET_DYNAMIC_APIS_ALLOW_IN_PROC) names << "CET_DYNAMIC_APIS_ALLOW_IN_PROC";
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_FORWARD_CFI_COMPAT) names << "FORWARD_CFI_COMPAT";
+            if (flags & IMAGE_DLLCHARACTERISTICS_EX_HOTPATCH_COMPATIBLE) names << "HOTPATCH_COMPATIBLE";
+            return names.join(", ");
         }
     }
     
+    if (fieldName == "DanSSignature") {
+        return "\"DanS\" XORed with the key";
+    }
+    
     if (fieldName == "RichCount") {
         bool ok;
         quint32 count = value.toULong(&ok, 10);
@@ -1430,6 +2115,14 @@ QString PEParserNew::getFieldMeaning(const QString &fieldName, const QString &va
         }
     }
     
+    if (fieldName == "ProductId") {
+        bool ok;
+        quint16 productId = static_cast<quint16>(value.toULong(&ok, 16));
+        if (ok) {
+            return PERichHeader::productName(productId);
+        }
+    }
+    
     // Default: return empty string if no specific meaning
     return "";
 }
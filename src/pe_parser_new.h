@@ -32,6 +32,9 @@
 #include "pe_data_model.h"
 #include "pe_structures.h"
 #include "pe_data_directory_parser.h"
+#include "pe_export_index.h"
+#include "pe_parse_profile.h"
+#include "pe_byte_source.h"
 #include "language_manager.h"
 #include <QObject>
 #include <QString>
@@ -118,6 +121,28 @@ public:
      */
     void loadFileAsync(const QString &filePath);
     
+    /**
+     * @brief Parses a PE image that is already in memory
+     * @param data Complete file contents; shared with the caller, not copied
+     * @param sourceName Reported as the file path, e.g. the name of an archive member
+     * @return true if parsing succeeded, false otherwise
+     * 
+     * Runs the same stages as loadFile() without touching the file system.
+     */
+    bool loadFromBuffer(const QByteArray &data, const QString &sourceName = QString());
+    
+    /**
+     * @brief Parses a PE image read from an open device
+     * @param device Readable device: a file, stdin, a pipe, a socket or a QProcess
+     * @param sourceName Reported as the file path, e.g. "-" for stdin
+     * @return true if parsing succeeded, false otherwise
+     * 
+     * Files are mapped above the memory limit just as in loadFile(). Streams
+     * are read to their end; a stream that outgrows the memory limit is
+     * spilled to a temporary file and parsed from a mapping of it.
+     */
+    bool loadFromDevice(QIODevice *device, const QString &sourceName = QString());
+    
     /**
      * @brief Clears all parsed data and resets the parser state
      * 
@@ -126,6 +151,16 @@ public:
      */
     void clear();
     
+    /**
+     * @brief Replaces the export index used to name ordinal imports
+     * @param exportIndex Index to use from the next load on; null disables resolution
+     * 
+     * A new parser has none, so library users, tests and fuzzers never
+     * depend on per-user state. Callers that want resolution load the index
+     * once and share the mapping between parsers through this setter.
+     */
+    void setExportIndex(const QSharedPointer<const PEExportIndex> &exportIndex);
+    
     // Status queries - Information about current parser state
     
     /**
@@ -172,7 +207,7 @@ public:
     
     /**
      * @brief Checks if the current file is considered "large"
-     * @return true if file exceeds the large file threshold
+     * @return true if the file exceeds the memory limit and was streamed
      * 
      * This method helps determine parsing strategy for large files,
      * allowing optimization of memory usage and parsing performance.
@@ -189,13 +224,30 @@ public:
     bool isVeryLargeFile() const;
     
     /**
-     * @brief Loads large files using streaming approach to avoid memory issues
-     * @return true if loading succeeded, false otherwise
+     * @brief Sets the size above which files are streamed rather than read
+     * @param bytes Limit in bytes; 0 or less reads every file into memory
+     * 
+     * Also bounds the read buffers of the content statistics stage in
+     * streaming mode. Takes effect from the next load.
+     */
+    void setMemoryLimit(qint64 bytes);
+    qint64 getMemoryLimit() const;
+    
+    /**
+     * @brief Checks if the current image was parsed from a mapping
      * 
-     * This method reads only essential headers and structure information
-     * without loading the entire file into memory.
+     * True for files above the memory limit and for spilled streams.
      */
-    bool loadLargeFileStreaming();
+    bool isStreaming() const;
+    
+    /**
+     * @brief Bytes of the current image
+     * 
+     * The caller's buffer, a view of the file mapping or the file read
+     * into memory. Every stage reads through constData(), so the view is
+     * never detached into a private copy.
+     */
+    const QByteArray &getFileData() const { return m_fileData; }
     
     // Data access - Access to parsed PE information
     
@@ -268,7 +320,29 @@ public:
     QList<QTreeWidgetItem*> getPEStructureTree();
     QStringList getImportModules() const { return m_dataModel.getImports(); }
     const QMap<QString, QList<PEDataModel::ImportFunctionEntry>>& getImportFunctionDetails() const { return m_dataModel.getImportFunctions(); }
+    const QList<PEDataModel::DelayImportModule>& getDelayImportModules() const { return m_dataModel.getDelayImportModules(); }
+    const QMap<QString, QList<PEDataModel::ImportFunctionEntry>>& getDelayImportFunctionDetails() const { return m_dataModel.getDelayImportFunctions(); }
+    const QList<PEDataModel::BoundImportEntry>& getBoundImports() const { return m_dataModel.getBoundImports(); }
+    const PEClrMetadata& getClrMetadata() const { return m_dataModel.getClrMetadata(); }
     const QList<PEDataModel::ExportFunctionEntry>& getExportFunctions() const { return m_dataModel.getExportFunctions(); }
+    QString getImportHash() const { return m_dataModel.getImportHash(); }
+    QString getExportHash() const { return m_dataModel.getExportHash(); }
+    QString getRichHeaderHash() const { return m_dataModel.getRichHeader().hash; }
+    QString getPdbKey() const { return m_dataModel.getPdbKey(); }
+    const QList<PEDataModel::DebugEntry>& getDebugEntries() const { return m_dataModel.getDebugEntries(); }
+    const PEDataModel::LoadConfigDirectory& getLoadConfigDirectory() const { return m_dataModel.getLoadConfigDirectory(); }
+    const PEDataModel::ContentDigest& getFileContentDigest() const { return m_dataModel.getFileContentDigest(); }
+    const QList<PEDataModel::ContentDigest>& getSectionContentDigests() const { return m_dataModel.getSectionContentDigests(); }
+    const QList<PEDataModel::ResourceEntry>& getResourceEntries() const { return m_dataModel.getResourceEntries(); }
+    const PEDataModel::Overlay& getOverlay() const { return m_dataModel.getOverlay(); }
+    const QList<PEDataModel::EmbeddedImage>& getEmbeddedImages() const { return m_dataModel.getEmbeddedImages(); }
+    const PEDiagnostics& getDiagnostics() const { return m_dataModel.getDiagnostics(); }
+    const PEParseProfile& getParseProfile() const { return m_profile; }
+    QByteArray getResourceData(const PEDataModel::ResourceEntry &entry) const { return m_dataDirectoryParser.readResourceData(entry); }
+    QList<quint64> getRelocationsInRange(quint32 startRVA, quint32 endRVA) const { return m_dataModel.getRelocationsInRange(startRVA, endRVA); }
+    const QList<PEDataModel::RuntimeFunctionEntry>& getRuntimeFunctions() const { return m_dataModel.getRuntimeFunctions(); }
+    int findRuntimeFunction(quint32 rva) const { return m_dataModel.findRuntimeFunction(rva); }
+    PEDataModel::UnwindInfoEntry getUnwindInfo(const PEDataModel::RuntimeFunctionEntry &function) const { return m_dataDirectoryParser.readUnwindInfo(function, m_dataModel.getSections()); }
     
     // Async parsing support - For handling large files without blocking UI
     
@@ -337,7 +411,31 @@ private:
     // Core parsing methods (Microsoft PE Format compliant)
     // These methods implement the actual PE parsing logic according to
     // the Microsoft PE Format specification
+
+    /**
+     * @brief Runs every parsing stage over m_fileData
+     * @return true if the image parsed, false if a header stage failed
+     *
+     * Called by parseSource() once the file path, file size and
+     * m_fileData are set.
+     */
+    bool parseFileData();
+    
+    /**
+     * @brief Points m_fileData at the loaded byte source and parses it
+     * 
+     * Shared by loadFile(), loadFromBuffer() and loadFromDevice().
+     */
+    bool parseSource();
     
+    /**
+     * @brief Tells whether anything listens to parsingProgress
+     * 
+     * Batch callers such as the command line and the fuzzer connect no
+     * receiver, so the progress messages are not worth building for them.
+     */
+    bool hasProgressReceivers() const;
+
     /**
      * @brief Parses the DOS header of the PE file
      * @return true if DOS header is valid, false otherwise
@@ -375,6 +473,43 @@ private:
      */
     bool parseDataDirectories(); // NEW: Proper data directory parsing
     
+    /**
+     * @brief Computes content statistics for the whole file and each section
+     * 
+     * Hashes, similarity digest, entropy, byte histogram, zero-run coverage
+     * and printable ratio are gathered per section in one pass. Sections and
+     * the gaps between them are processed in parallel on the global thread
+     * pool, and the file digest is merged from those pieces; only its MD5,
+     * SHA-256 and digest checksum are fed in file order from the chunks the
+     * pieces already read. Files that were not loaded into memory are
+     * streamed from disk in fixed-size chunks.
+     */
+    void computeContentDigests();
+    
+    /**
+     * @brief Records where the image ends and which bytes after it are overlay
+     * 
+     * The certificate table is left out of the overlay ranges wherever it lies.
+     */
+    void computeOverlay();
+    
+    /**
+     * @brief Finds PE images in the overlay and in resource payloads and parses them
+     * 
+     * Candidates come from PEEmbeddedScanner. Each is parsed by a nested
+     * parser on the global thread pool, which carves its own overlay and
+     * resources in turn, up to EMBEDDED_IMAGE_MAX_DEPTH levels.
+     */
+    void carveEmbeddedImages();
+
+    /**
+     * @brief Decodes the Rich header from the DOS stub into the data model
+     *
+     * Only the bytes before e_lfanew are read, which both load paths keep
+     * in m_fileData.
+     */
+    void decodeRichHeader();
+    
     // Helper methods - Utility functions for parsing operations
     
     /**
@@ -452,7 +587,11 @@ private:
      * @param parent Parent tree item
      */
     void addDataDirectoryFields(QTreeWidgetItem *parent);
-    void addRichHeaderFields(QTreeWidgetItem *parent, quint32 richOffset);
+    void addRichHeaderFields(QTreeWidgetItem *parent);
+    void addDebugDirectoryFields(QTreeWidgetItem *parent);
+    void addLoadConfigFields(QTreeWidgetItem *parent, bool isPE64);
+    void addDelayImportFields(QTreeWidgetItem *parent);
+    void addClrFields(QTreeWidgetItem *parent);
     
     /**
      * @brief Adds a field to a tree item
@@ -466,14 +605,16 @@ private:
     
     // File data - Storage for file content and parsed information
     
-    QFile m_file;                    ///< File handle for reading PE data
-    QByteArray m_fileData;          ///< Raw file data buffer
-    QByteArray m_optionalHeaderBuffer; ///< Buffer for optional header when reading from file
-    IMAGE_DOS_HEADER m_cachedDosHeader; ///< Persistent DOS header for streaming mode
-    IMAGE_FILE_HEADER m_cachedFileHeader; ///< Persistent File header for streaming mode
-    QVector<IMAGE_SECTION_HEADER> m_cachedSections; ///< Persistent section headers for streaming mode
+    PEByteSource m_source;           ///< File, buffer or stream backing m_fileData
+    QByteArray m_fileData;          ///< View of m_source's data, referenced by the directory parser; read only through constData()
+    qint64 m_memoryLimit = DEFAULT_MEMORY_LIMIT; ///< Files above this size are streamed
+    IMAGE_DOS_HEADER m_cachedDosHeader; ///< Persistent copy of the DOS header
+    IMAGE_FILE_HEADER m_cachedFileHeader; ///< Persistent copy of the File header
     PEDataModel m_dataModel;         ///< NEW: Organized storage for parsed data
     PEDataDirectoryParser m_dataDirectoryParser; ///< NEW: Specialized data directory parser
+    QSharedPointer<const PEExportIndex> m_exportIndex; ///< Reference DLL exports, may be null
+    PEParseProfile m_profile;        ///< Stage timings of the last load, reset by clear()
+    int m_embeddedDepth = 0;         ///< Nesting level of this parser inside carved images
     
     // Async parsing support - For non-blocking file processing
     
@@ -484,8 +625,12 @@ private:
     
     // Constants - Configuration values for parsing behavior
     
-    static const qint64 LARGE_FILE_THRESHOLD = std::numeric_limits<qint64>::max();
+    static constexpr qint64 DEFAULT_MEMORY_LIMIT = 256LL * 1024 * 1024;
     static const qint64 VERY_LARGE_FILE_THRESHOLD = std::numeric_limits<qint64>::max();
+    static constexpr qint64 CONTENT_DIGEST_CHUNK_SIZE = 1024 * 1024;
+    static constexpr int EMBEDDED_IMAGE_MAX_DEPTH = 3;    ///< Levels of images inside images that are carved
+    static constexpr int EMBEDDED_IMAGE_MAX_COUNT = 64;   ///< Images carved per file and level
+    static constexpr quint32 MAX_CLR_TREE_ROWS = 1000;    ///< Rows listed per metadata table in the tree
 };
 
 #endif // PE_PARSER_NEW_H
@@ -0,0 +1,525 @@
+/**
+ * @file pe_rich_header.cpp
+ * @brief Rich header decoding implementation
+ */
+
+#include "pe_rich_header.h"
+#include <QCryptographicHash>
+#include <QPair>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const quint32 DANS_SIGNATURE = 0x536E6144; // "DanS"
+const quint32 RICH_SIGNATURE = 0x68636952; // "Rich"
+
+enum Generation : quint8 {
+    None,
+    VS97,
+    VS6,
+    VS2002,
+    VS2003,
+    VS2005,
+    VS2008,
+    VS2010,
+    VS2012,
+    VS2013,
+    VS2015          // 14.x toolset: Visual Studio 2015 through 2022
+};
+
+const char *const GENERATION_NAMES[] = {
+    "",
+    "Visual Studio 97",
+    "Visual Studio 6.0",
+    "Visual Studio .NET 2002",
+    "Visual Studio .NET 2003",
+    "Visual Studio 2005",
+    "Visual Studio 2008",
+    "Visual Studio 2010",
+    "Visual Studio 2012",
+    "Visual Studio 2013",
+    "Visual Studio 2015 or later"
+};
+
+struct Product {
+    const char *name;
+    Generation generation;
+};
+
+// Indexed directly by product ID
+constexpr Product PRODUCTS[] = {
+    {"Unknown", None},                  // 0x0000
+    {"Import0", None},                  // 0x0001
+    {"Linker510", VS97},                // 0x0002
+    {"Cvtomf510", VS97},                // 0x0003
+    {"Linker600", VS6},                 // 0x0004
+    {"Cvtomf600", VS6},                 // 0x0005
+    {"Cvtres500", VS97},                // 0x0006
+    {"Utc11_Basic", VS97},              // 0x0007
+    {"Utc11_C", VS97},                  // 0x0008
+    {"Utc12_Basic", VS6},               // 0x0009
+    {"Utc12_C", VS6},                   // 0x000A
+    {"Utc12_CPP", VS6},                 // 0x000B
+    {"AliasObj60", VS6},                // 0x000C
+    {"VisualBasic60", VS6},             // 0x000D
+    {"Masm613", VS6},                   // 0x000E
+    {"Masm710", VS2003},                // 0x000F
+    {"Linker511", VS97},                // 0x0010
+    {"Cvtomf511", VS97},                // 0x0011
+    {"Masm614", VS6},                   // 0x0012
+    {"Linker512", VS97},                // 0x0013
+    {"Cvtomf512", VS97},                // 0x0014
+    {"Utc12_C_Std", VS6},               // 0x0015
+    {"Utc12_CPP_Std", VS6},             // 0x0016
+    {"Utc12_C_Book", VS6},              // 0x0017
+    {"Utc12_CPP_Book", VS6},            // 0x0018
+    {"Implib700", VS2002},              // 0x0019
+    {"Cvtomf700", VS2002},              // 0x001A
+    {"Utc13_Basic", VS2002},            // 0x001B
+    {"Utc13_C", VS2002},                // 0x001C
+    {"Utc13_CPP", VS2002},              // 0x001D
+    {"Linker610", VS6},                 // 0x001E
+    {"Cvtomf610", VS6},                 // 0x001F
+    {"Linker601", VS6},                 // 0x0020
+    {"Cvtomf601", VS6},                 // 0x0021
+    {"Utc12_1_Basic", VS6},             // 0x0022
+    {"Utc12_1_C", VS6},                 // 0x0023
+    {"Utc12_1_CPP", VS6},               // 0x0024
+    {"Linker620", VS6},                 // 0x0025
+    {"Cvtomf620", VS6},                 // 0x0026
+    {"AliasObj70", VS2002},             // 0x0027
+    {"Linker621", VS6},                 // 0x0028
+    {"Cvtomf621", VS6},                 // 0x0029
+    {"Masm615", VS6},                   // 0x002A
+    {"Utc13_LTCG_C", VS2002},           // 0x002B
+    {"Utc13_LTCG_CPP", VS2002},         // 0x002C
+    {"Masm620", VS6},                   // 0x002D
+    {"ILAsm100", VS2002},               // 0x002E
+    {"Utc12_2_Basic", VS6},             // 0x002F
+    {"Utc12_2_C", VS6},                 // 0x0030
+    {"Utc12_2_CPP", VS6},               // 0x0031
+    {"Utc12_2_C_Std", VS6},             // 0x0032
+    {"Utc12_2_CPP_Std", VS6},           // 0x0033
+    {"Utc12_2_C_Book", VS6},            // 0x0034
+    {"Utc12_2_CPP_Book", VS6},          // 0x0035
+    {"Implib622", VS6},                 // 0x0036
+    {"Cvtomf622", VS6},                 // 0x0037
+    {"Cvtres501", VS6},                 // 0x0038
+    {"Utc13_C_Std", VS2002},            // 0x0039
+    {"Utc13_CPP_Std", VS2002},          // 0x003A
+    {"Cvtpgd1300", VS2002},             // 0x003B
+    {"Linker622", VS6},                 // 0x003C
+    {"Linker700", VS2002},              // 0x003D
+    {"Export622", VS6},                 // 0x003E
+    {"Export700", VS2002},              // 0x003F
+    {"Masm700", VS2002},                // 0x0040
+    {"Utc13_POGO_I_C", VS2002},         // 0x0041
+    {"Utc13_POGO_I_CPP", VS2002},       // 0x0042
+    {"Utc13_POGO_O_C", VS2002},         // 0x0043
+    {"Utc13_POGO_O_CPP", VS2002},       // 0x0044
+    {"Cvtres700", VS2002},              // 0x0045
+    {"Cvtres710p", VS2003},             // 0x0046
+    {"Linker710p", VS2003},             // 0x0047
+    {"Cvtomf710p", VS2003},             // 0x0048
+    {"Export710p", VS2003},             // 0x0049
+    {"Implib710p", VS2003},             // 0x004A
+    {"Masm710p", VS2003},               // 0x004B
+    {"Utc1310p_C", VS2003},             // 0x004C
+    {"Utc1310p_CPP", VS2003},           // 0x004D
+    {"Utc1310p_C_Std", VS2003},         // 0x004E
+    {"Utc1310p_CPP_Std", VS2003},       // 0x004F
+    {"Utc1310p_LTCG_C", VS2003},        // 0x0050
+    {"Utc1310p_LTCG_CPP", VS2003},      // 0x0051
+    {"Utc1310p_POGO_I_C", VS2003},      // 0x0052
+    {"Utc1310p_POGO_I_CPP", VS2003},    // 0x0053
+    {"Utc1310p_POGO_O_C", VS2003},      // 0x0054
+    {"Utc1310p_POGO_O_CPP", VS2003},    // 0x0055
+    {"Linker624", VS6},                 // 0x0056
+    {"Cvtomf624", VS6},                 // 0x0057
+    {"Export624", VS6},                 // 0x0058
+    {"Implib624", VS6},                 // 0x0059
+    {"Linker710", VS2003},              // 0x005A
+    {"Cvtomf710", VS2003},              // 0x005B
+    {"Export710", VS2003},              // 0x005C
+    {"Implib710", VS2003},              // 0x005D
+    {"Cvtres710", VS2003},              // 0x005E
+    {"Utc1310_C", VS2003},              // 0x005F
+    {"Utc1310_CPP", VS2003},            // 0x0060
+    {"Utc1310_C_Std", VS2003},          // 0x0061
+    {"Utc1310_CPP_Std", VS2003},        // 0x0062
+    {"Utc1310_LTCG_C", VS2003},         // 0x0063
+    {"Utc1310_LTCG_CPP", VS2003},       // 0x0064
+    {"Utc1310_POGO_I_C", VS2003},       // 0x0065
+    {"Utc1310_POGO_I_CPP", VS2003},     // 0x0066
+    {"Utc1310_POGO_O_C", VS2003},       // 0x0067
+    {"Utc1310_POGO_O_CPP", VS2003},     // 0x0068
+    {"AliasObj710", VS2003},            // 0x0069
+    {"AliasObj710p", VS2003},           // 0x006A
+    {"Cvtpgd1310", VS2003},             // 0x006B
+    {"Cvtpgd1310p", VS2003},            // 0x006C
+    {"Utc1400_C", VS2005},              // 0x006D
+    {"Utc1400_CPP", VS2005},            // 0x006E
+    {"Utc1400_C_Std", VS2005},          // 0x006F
+    {"Utc1400_CPP_Std", VS2005},        // 0x0070
+    {"Utc1400_LTCG_C", VS2005},         // 0x0071
+    {"Utc1400_LTCG_CPP", VS2005},       // 0x0072
+    {"Utc1400_POGO_I_C", VS2005},       // 0x0073
+    {"Utc1400_POGO_I_CPP", VS2005},     // 0x0074
+    {"Utc1400_POGO_O_C", VS2005},       // 0x0075
+    {"Utc1400_POGO_O_CPP", VS2005},     // 0x0076
+    {"Cvtpgd1400", VS2005},             // 0x0077
+    {"Linker800", VS2005},              // 0x0078
+    {"Cvtomf800", VS2005},              // 0x0079
+    {"Export800", VS2005},              // 0x007A
+    {"Implib800", VS2005},              // 0x007B
+    {"Cvtres800", VS2005},              // 0x007C
+    {"Masm800", VS2005},                // 0x007D
+    {"AliasObj800", VS2005},            // 0x007E
+    {"PhoenixPrerelease", VS2005},      // 0x007F
+    {"Utc1400_CVTCIL_C", VS2005},       // 0x0080
+    {"Utc1400_CVTCIL_CPP", VS2005},     // 0x0081
+    {"Utc1400_LTCG_MSIL", VS2005},      // 0x0082
+    {"Utc1500_C", VS2008},              // 0x0083
+    {"Utc1500_CPP", VS2008},            // 0x0084
+    {"Utc1500_C_Std", VS2008},          // 0x0085
+    {"Utc1500_CPP_Std", VS2008},        // 0x0086
+    {"Utc1500_CVTCIL_C", VS2008},       // 0x0087
+    {"Utc1500_CVTCIL_CPP", VS2008},     // 0x0088
+    {"Utc1500_LTCG_C", VS2008},         // 0x0089
+    {"Utc1500_LTCG_CPP", VS2008},       // 0x008A
+    {"Utc1500_LTCG_MSIL", VS2008},      // 0x008B
+    {"Utc1500_POGO_I_C", VS2008},       // 0x008C
+    {"Utc1500_POGO_I_CPP", VS2008},     // 0x008D
+    {"Utc1500_POGO_O_C", VS2008},       // 0x008E
+    {"Utc1500_POGO_O_CPP", VS2008},     // 0x008F
+    {"Cvtpgd1500", VS2008},             // 0x0090
+    {"Linker900", VS2008},              // 0x0091
+    {"Export900", VS2008},              // 0x0092
+    {"Implib900", VS2008},              // 0x0093
+    {"Cvtres900", VS2008},              // 0x0094
+    {"Masm900", VS2008},                // 0x0095
+    {"AliasObj900", VS2008},            // 0x0096
+    {"Resource", None},                 // 0x0097
+    {"AliasObj1000", VS2010},           // 0x0098
+    {"Cvtpgd1600", VS2010},             // 0x0099
+    {"Cvtres1000", VS2010},             // 0x009A
+    {"Export1000", VS2010},             // 0x009B
+    {"Implib1000", VS2010},             // 0x009C
+    {"Linker1000", VS2010},             // 0x009D
+    {"Masm1000", VS2010},               // 0x009E
+    {"Phx1600_C", VS2010},              // 0x009F
+    {"Phx1600_CPP", VS2010},            // 0x00A0
+    {"Phx1600_CVTCIL_C", VS2010},       // 0x00A1
+    {"Phx1600_CVTCIL_CPP", VS2010},     // 0x00A2
+    {"Phx1600_LTCG_C", VS2010},         // 0x00A3
+    {"Phx1600_LTCG_CPP", VS2010},       // 0x00A4
+    {"Phx1600_LTCG_MSIL", VS2010},      // 0x00A5
+    {"Phx1600_POGO_I_C", VS2010},       // 0x00A6
+    {"Phx1600_POGO_I_CPP", VS2010},     // 0x00A7
+    {"Phx1600_POGO_O_C", VS2010},       // 0x00A8
+    {"Phx1600_POGO_O_CPP", VS2010},     // 0x00A9
+    {"Utc1600_C", VS2010},              // 0x00AA
+    {"Utc1600_CPP", VS2010},            // 0x00AB
+    {"Utc1600_CVTCIL_C", VS2010},       // 0x00AC
+    {"Utc1600_CVTCIL_CPP", VS2010},     // 0x00AD
+    {"Utc1600_LTCG_C", VS2010},         // 0x00AE
+    {"Utc1600_LTCG_CPP", VS2010},       // 0x00AF
+    {"Utc1600_LTCG_MSIL", VS2010},      // 0x00B0
+    {"Utc1600_POGO_I_C", VS2010},       // 0x00B1
+    {"Utc1600_POGO_I_CPP", VS2010},     // 0x00B2
+    {"Utc1600_POGO_O_C", VS2010},       // 0x00B3
+    {"Utc1600_POGO_O_CPP", VS2010},     // 0x00B4
+    {"AliasObj1010", VS2010},           // 0x00B5
+    {"Cvtpgd1610", VS2010},             // 0x00B6
+    {"Cvtres1010", VS2010},             // 0x00B7
+    {"Export1010", VS2010},             // 0x00B8
+    {"Implib1010", VS2010},             // 0x00B9
+    {"Linker1010", VS2010},             // 0x00BA
+    {"Masm1010", VS2010},               // 0x00BB
+    {"Utc1610_C", VS2010},              // 0x00BC
+    {"Utc1610_CPP", VS2010},            // 0x00BD
+    {"Utc1610_CVTCIL_C", VS2010},       // 0x00BE
+    {"Utc1610_CVTCIL_CPP", VS2010},     // 0x00BF
+    {"Utc1610_LTCG_C", VS2010},         // 0x00C0
+    {"Utc1610_LTCG_CPP", VS2010},       // 0x00C1
+    {"Utc1610_LTCG_MSIL", VS2010},      // 0x00C2
+    {"Utc1610_POGO_I_C", VS2010},       // 0x00C3
+    {"Utc1610_POGO_I_CPP", VS2010},     // 0x00C4
+    {"Utc1610_POGO_O_C", VS2010},       // 0x00C5
+    {"Utc1610_POGO_O_CPP", VS2010},     // 0x00C6
+    {"AliasObj1100", VS2012},           // 0x00C7
+    {"Cvtpgd1700", VS2012},             // 0x00C8
+    {"Cvtres1100", VS2012},             // 0x00C9
+    {"Export1100", VS2012},             // 0x00CA
+    {"Implib1100", VS2012},             // 0x00CB
+    {"Linker1100", VS2012},             // 0x00CC
+    {"Masm1100", VS2012},               // 0x00CD
+    {"Utc1700_C", VS2012},              // 0x00CE
+    {"Utc1700_CPP", VS2012},            // 0x00CF
+    {"Utc1700_CVTCIL_C", VS2012},       // 0x00D0
+    {"Utc1700_CVTCIL_CPP", VS2012},     // 0x00D1
+    {"Utc1700_LTCG_C", VS2012},         // 0x00D2
+    {"Utc1700_LTCG_CPP", VS2012},       // 0x00D3
+    {"Utc1700_LTCG_MSIL", VS2012},      // 0x00D4
+    {"Utc1700_POGO_I_C", VS2012},       // 0x00D5
+    {"Utc1700_POGO_I_CPP", VS2012},     // 0x00D6
+    {"Utc1700_POGO_O_C", VS2012},       // 0x00D7
+    {"Utc1700_POGO_O_CPP", VS2012},     // 0x00D8
+    {"AliasObj1200", VS2013},           // 0x00D9
+    {"Cvtpgd1800", VS2013},             // 0x00DA
+    {"Cvtres1200", VS2013},             // 0x00DB
+    {"Export1200", VS2013},             // 0x00DC
+    {"Implib1200", VS2013},             // 0x00DD
+    {"Linker1200", VS2013},             // 0x00DE
+    {"Masm1200", VS2013},               // 0x00DF
+    {"Utc1800_C", VS2013},              // 0x00E0
+    {"Utc1800_CPP", VS2013},            // 0x00E1
+    {"Utc1800_CVTCIL_C", VS2013},       // 0x00E2
+    {"Utc1800_CVTCIL_CPP", VS2013},     // 0x00E3
+    {"Utc1800_LTCG_C", VS2013},         // 0x00E4
+    {"Utc1800_LTCG_CPP", VS2013},       // 0x00E5
+    {"Utc1800_LTCG_MSIL", VS2013},      // 0x00E6
+    {"Utc1800_POGO_I_C", VS2013},       // 0x00E7
+    {"Utc1800_POGO_I_CPP", VS2013},     // 0x00E8
+    {"Utc1800_POGO_O_C", VS2013},       // 0x00E9
+    {"Utc1800_POGO_O_CPP", VS2013},     // 0x00EA
+    {"AliasObj1210", VS2013},           // 0x00EB
+    {"Cvtpgd1810", VS2013},             // 0x00EC
+    {"Cvtres1210", VS2013},             // 0x00ED
+    {"Export1210", VS2013},             // 0x00EE
+    {"Implib1210", VS2013},             // 0x00EF
+    {"Linker1210", VS2013},             // 0x00F0
+    {"Masm1210", VS2013},               // 0x00F1
+    {"Utc1810_C", VS2013},              // 0x00F2
+    {"Utc1810_CPP", VS2013},            // 0x00F3
+    {"Utc1810_CVTCIL_C", VS2013},       // 0x00F4
+    {"Utc1810_CVTCIL_CPP", VS2013},     // 0x00F5
+    {"Utc1810_LTCG_C", VS2013},         // 0x00F6
+    {"Utc1810_LTCG_CPP", VS2013},       // 0x00F7
+    {"Utc1810_LTCG_MSIL", VS2013},      // 0x00F8
+    {"Utc1810_POGO_I_C", VS2013},       // 0x00F9
+    {"Utc1810_POGO_I_CPP", VS2013},     // 0x00FA
+    {"Utc1810_POGO_O_C", VS2013},       // 0x00FB
+    {"Utc1810_POGO_O_CPP", VS2013},     // 0x00FC
+    {"AliasObj1400", VS2015},           // 0x00FD
+    {"Cvtpgd1900", VS2015},             // 0x00FE
+    {"Cvtres1400", VS2015},             // 0x00FF
+    {"Export1400", VS2015},             // 0x0100
+    {"Implib1400", VS2015},             // 0x0101
+    {"Linker1400", VS2015},             // 0x0102
+    {"Masm1400", VS2015},               // 0x0103
+    {"Utc1900_C", VS2015},              // 0x0104
+    {"Utc1900_CPP", VS2015},            // 0x0105
+    {"Utc1900_CVTCIL_C", VS2015},       // 0x0106
+    {"Utc1900_CVTCIL_CPP", VS2015},     // 0x0107
+    {"Utc1900_LTCG_C", VS2015},         // 0x0108
+    {"Utc1900_LTCG_CPP", VS2015},       // 0x0109
+    {"Utc1900_LTCG_MSIL", VS2015},      // 0x010A
+    {"Utc1900_POGO_I_C", VS2015},       // 0x010B
+    {"Utc1900_POGO_I_CPP", VS2015},     // 0x010C
+    {"Utc1900_POGO_O_C", VS2015},       // 0x010D
+    {"Utc1900_POGO_O_CPP", VS2015},     // 0x010E
+};
+
+constexpr int PRODUCT_COUNT = static_cast<int>(sizeof(PRODUCTS) / sizeof(PRODUCTS[0]));
+static_assert(PRODUCT_COUNT == 0x10F, "product table must cover IDs 0x0000-0x010E");
+
+// First tool build of each release; a build maps to the last row at or below it
+struct Release {
+    Generation generation;
+    quint16 firstBuild;
+    const char *name;
+};
+
+constexpr Release RELEASES[] = {
+    {VS6, 8168, "Visual Studio 6.0"},
+    {VS6, 8447, "Visual Studio 6.0 SP5"},
+    {VS6, 8804, "Visual Studio 6.0 SP6"},
+    {VS2002, 9466, "Visual Studio .NET 2002"},
+    {VS2003, 3077, "Visual Studio .NET 2003"},
+    {VS2003, 6030, "Visual Studio .NET 2003 SP1"},
+    {VS2005, 50727, "Visual Studio 2005"},
+    {VS2008, 21022, "Visual Studio 2008"},
+    {VS2008, 30729, "Visual Studio 2008 SP1"},
+    {VS2010, 30319, "Visual Studio 2010"},
+    {VS2010, 40219, "Visual Studio 2010 SP1"},
+    {VS2012, 50727, "Visual Studio 2012"},
+    {VS2012, 51106, "Visual Studio 2012 Update 1"},
+    {VS2012, 60315, "Visual Studio 2012 Update 2"},
+    {VS2012, 60610, "Visual Studio 2012 Update 3"},
+    {VS2012, 61030, "Visual Studio 2012 Update 4"},
+    {VS2013, 21005, "Visual Studio 2013"},
+    {VS2013, 30501, "Visual Studio 2013 Update 2"},
+    {VS2013, 30723, "Visual Studio 2013 Update 3"},
+    {VS2013, 31101, "Visual Studio 2013 Update 4"},
+    {VS2013, 40629, "Visual Studio 2013 Update 5"},
+    {VS2015, 23026, "Visual Studio 2015"},
+    {VS2015, 23506, "Visual Studio 2015 Update 1"},
+    {VS2015, 23918, "Visual Studio 2015 Update 2"},
+    {VS2015, 24210, "Visual Studio 2015 Update 3"},
+    {VS2015, 25017, "Visual Studio 2017 15.0"},
+    {VS2015, 25506, "Visual Studio 2017 15.3"},
+    {VS2015, 25547, "Visual Studio 2017 15.4"},
+    {VS2015, 25830, "Visual Studio 2017 15.5"},
+    {VS2015, 26128, "Visual Studio 2017 15.6"},
+    {VS2015, 26428, "Visual Studio 2017 15.7"},
+    {VS2015, 26726, "Visual Studio 2017 15.8"},
+    {VS2015, 27023, "Visual Studio 2017 15.9"},
+    {VS2015, 27508, "Visual Studio 2019 16.0"},
+    {VS2015, 27702, "Visual Studio 2019 16.1"},
+    {VS2015, 27905, "Visual Studio 2019 16.2"},
+    {VS2015, 28105, "Visual Studio 2019 16.3"},
+    {VS2015, 28314, "Visual Studio 2019 16.4"},
+    {VS2015, 28610, "Visual Studio 2019 16.5"},
+    {VS2015, 28805, "Visual Studio 2019 16.6"},
+    {VS2015, 29110, "Visual Studio 2019 16.7"},
+    {VS2015, 29333, "Visual Studio 2019 16.8"},
+    {VS2015, 29910, "Visual Studio 2019 16.9"},
+    {VS2015, 30037, "Visual Studio 2019 16.10"},
+    {VS2015, 30133, "Visual Studio 2019 16.11"},
+    {VS2015, 30705, "Visual Studio 2022 17.0"},
+    {VS2015, 31104, "Visual Studio 2022 17.1"},
+    {VS2015, 31326, "Visual Studio 2022 17.2"},
+    {VS2015, 31629, "Visual Studio 2022 17.3"},
+    {VS2015, 31933, "Visual Studio 2022 17.4"},
+    {VS2015, 32215, "Visual Studio 2022 17.5"},
+    {VS2015, 32532, "Visual Studio 2022 17.6"},
+    {VS2015, 32822, "Visual Studio 2022 17.7"},
+    {VS2015, 33130, "Visual Studio 2022 17.8"},
+    {VS2015, 33519, "Visual Studio 2022 17.9"},
+    {VS2015, 33808, "Visual Studio 2022 17.10"},
+    {VS2015, 34120, "Visual Studio 2022 17.11"},
+    {VS2015, 34433, "Visual Studio 2022 17.12"},
+    {VS2015, 34808, "Visual Studio 2022 17.13"},
+    {VS2015, 35207, "Visual Studio 2022 17.14"}
+};
+
+constexpr const Release *RELEASES_END = RELEASES + sizeof(RELEASES) / sizeof(RELEASES[0]);
+
+constexpr bool releasesSorted()
+{
+    for (const Release *release = RELEASES + 1; release != RELEASES_END; ++release) {
+        const Release &previous = *(release - 1);
+        if (previous.generation > release->generation ||
+            (previous.generation == release->generation && previous.firstBuild >= release->firstBuild)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(releasesSorted(), "release table must be sorted by generation and build");
+
+inline quint32 readDword(const QByteArray &data, quint32 offset)
+{
+    quint32 value;
+    memcpy(&value, data.constData() + offset, sizeof(value));
+    return value;
+}
+
+inline quint32 rotateLeft(quint32 value, quint32 shift)
+{
+    shift &= 31;
+    return shift == 0 ? value : (value << shift) | (value >> (32 - shift));
+}
+
+} // namespace
+
+PERichHeader::Info PERichHeader::decode(const QByteArray &fileData, quint32 peHeaderOffset)
+{
+    Info info;
+    const quint32 limit = qMin<quint32>(peHeaderOffset, static_cast<quint32>(fileData.size()));
+    const quint32 dosHeaderEnd = 0x40;
+
+    // "Rich" is stored in plain text; the key follows it
+    quint32 richOffset = 0;
+    for (quint32 offset = dosHeaderEnd; offset + 8 <= limit; offset += 4) {
+        if (readDword(fileData, offset) == RICH_SIGNATURE) {
+            richOffset = offset;
+            break;
+        }
+    }
+    if (richOffset == 0) {
+        return info;
+    }
+    const quint32 key = readDword(fileData, richOffset + 4);
+
+    // Walk back to the encrypted "DanS" marker
+    quint32 start = 0;
+    for (quint32 offset = richOffset; offset >= dosHeaderEnd + 4; ) {
+        offset -= 4;
+        if ((readDword(fileData, offset) ^ key) == DANS_SIGNATURE) {
+            start = offset;
+            break;
+        }
+    }
+    if (start == 0 || richOffset - start < 16 || (richOffset - start - 16) % 8 != 0) {
+        return info;
+    }
+
+    // Decrypt once; the hash and the entries are both read from the clear copy
+    QByteArray clearData(static_cast<int>(richOffset - start), Qt::Uninitialized);
+    for (quint32 offset = start; offset < richOffset; offset += 4) {
+        quint32 value = readDword(fileData, offset) ^ key;
+        memcpy(clearData.data() + (offset - start), &value, sizeof(value));
+    }
+
+    // The key doubles as a checksum over the DOS header and stub (skipping
+    // e_lfanew) and the entries
+    quint32 checksum = start;
+    const uchar *bytes = reinterpret_cast<const uchar*>(fileData.constData());
+    for (quint32 i = 0; i < start; ++i) {
+        if (i >= 0x3C && i < 0x40) {
+            continue;
+        }
+        checksum += rotateLeft(bytes[i], i);
+    }
+
+    for (quint32 offset = 16; offset < static_cast<quint32>(clearData.size()); offset += 8) {
+        quint32 compId = readDword(clearData, offset);
+        Entry entry;
+        entry.productId = static_cast<quint16>(compId >> 16);
+        entry.buildNumber = static_cast<quint16>(compId & 0xFFFF);
+        entry.count = readDword(clearData, offset + 4);
+        entry.fileOffset = start + offset;
+        info.entries.append(entry);
+        checksum += rotateLeft(compId, entry.count);
+    }
+
+    info.found = true;
+    info.offset = start;
+    info.size = richOffset + 8 - start;
+    info.xorKey = key;
+    info.checksumValid = checksum == key;
+    info.hash = QString::fromLatin1(QCryptographicHash::hash(clearData, QCryptographicHash::Md5).toHex());
+    return info;
+}
+
+QString PERichHeader::productName(quint16 productId)
+{
+    if (productId < PRODUCT_COUNT) {
+        return QString::fromLatin1(PRODUCTS[productId].name);
+    }
+    return QString("Unknown Product (0x%1)").arg(productId, 4, 16, QChar('0'));
+}
+
+QString PERichHeader::toolchainName(quint16 productId, quint16 buildNumber)
+{
+    // IDs are handed out in sequence and the table ends with the VS2015 tools,
+    // so any higher ID comes from a later 14.x toolset (VS2017 through 2022)
+    const Generation generation = productId < PRODUCT_COUNT ? PRODUCTS[productId].generation : VS2015;
+    if (generation == None) {
+        return QString();
+    }
+
+    const Release *next = std::upper_bound(RELEASES, RELEASES_END, qMakePair(generation, buildNumber),
+        [](const QPair<Generation, quint16> &key, const Release &release) {
+            return key.first < release.generation ||
+                   (key.first == release.generation && key.second < release.firstBuild);
+        });
+    if (next != RELEASES && (next - 1)->generation == generation) {
+        return QString::fromLatin1((next - 1)->name);
+    }
+    return QString::fromLatin1(GENERATION_NAMES[generation]);
+}
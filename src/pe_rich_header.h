@@ -0,0 +1,76 @@
+/**
+ * @file pe_rich_header.h
+ * @brief Rich header decoding, toolchain identification and hashing
+ *
+ * The Rich header sits between the DOS stub and the PE header:
+ *
+ *   "DanS" ^ key, key, key, key          (16 bytes, the padding is XORed zeros)
+ *   (compId ^ key, count ^ key) * N      (8 bytes per entry)
+ *   "Rich", key                          (plain text marker and the key itself)
+ *
+ * compId holds the product ID in the high word and the tool's build number in
+ * the low word. The key is a checksum over the DOS header/stub and the
+ * entries, so a header that was edited or copied without care fails it.
+ *
+ * RICH HEADER HASH:
+ * MD5 of the decrypted bytes from "DanS" up to (not including) "Rich". The
+ * same toolchain mix produces the same hash, which makes it useful for
+ * clustering samples built in the same environment.
+ *
+ * Product names and Visual Studio releases come from tables compiled into
+ * the binary: product IDs index an array directly, and build numbers are
+ * resolved with a binary search over a sorted constant table, so decoding
+ * allocates nothing beyond the result.
+ */
+
+#ifndef PE_RICH_HEADER_H
+#define PE_RICH_HEADER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+class PERichHeader
+{
+public:
+    struct Entry {
+        quint16 productId = 0;
+        quint16 buildNumber = 0;
+        quint32 count = 0;
+        quint32 fileOffset = 0;     ///< Offset of the encrypted compId dword
+    };
+
+    struct Info {
+        bool found = false;
+        quint32 offset = 0;         ///< File offset of the "DanS" dword
+        quint32 size = 0;           ///< From "DanS" through the key after "Rich"
+        quint32 xorKey = 0;
+        bool checksumValid = false;
+        QList<Entry> entries;
+        QString hash;               ///< Lower-case hex MD5 of the decrypted header
+    };
+
+    /**
+     * @brief Locates and decodes the Rich header
+     * @param fileData File contents; only the bytes before peHeaderOffset are read
+     * @param peHeaderOffset e_lfanew of the file
+     * @return Info with found == false if there is no well-formed Rich header
+     */
+    static Info decode(const QByteArray &fileData, quint32 peHeaderOffset);
+
+    /**
+     * @brief Internal tool name for a product ID, e.g. "Utc1900_CPP"
+     */
+    static QString productName(quint16 productId);
+
+    /**
+     * @brief Visual Studio release that shipped the given tool build
+     * @return e.g. "Visual Studio 2019 16.11", or an empty string if unknown
+     *
+     * Product IDs past the named table are resolved as 14.x toolset tools.
+     */
+    static QString toolchainName(quint16 productId, quint16 buildNumber);
+};
+
+#endif // PE_RICH_HEADER_H
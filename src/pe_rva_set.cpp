@@ -0,0 +1,103 @@
+/**
+ * @file pe_rva_set.cpp
+ * @brief Compact sorted RVA set implementation
+ */
+
+#include "pe_rva_set.h"
+#include <algorithm>
+
+namespace {
+
+inline void appendVarint(QByteArray &out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+inline quint32 readVarint(const uchar *&pos)
+{
+    quint32 value = 0;
+    int shift = 0;
+    uchar byte;
+    do {
+        byte = *pos++;
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+} // namespace
+
+PERvaSet PERvaSet::fromValues(QVector<quint32> values)
+{
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    PERvaSet set;
+    set.m_count = static_cast<int>(values.size());
+    set.m_blockStarts.reserve((values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    set.m_blockOffsets.reserve(set.m_blockStarts.capacity());
+    set.m_deltas.reserve(values.size());
+
+    for (int i = 0; i < values.size(); ++i) {
+        if (i % BLOCK_SIZE == 0) {
+            set.m_blockStarts.append(values[i]);
+            set.m_blockOffsets.append(static_cast<quint32>(set.m_deltas.size()));
+        } else {
+            appendVarint(set.m_deltas, values[i] - values[i - 1]);
+        }
+    }
+    set.m_deltas.squeeze();
+    return set;
+}
+
+bool PERvaSet::contains(quint32 rva) const
+{
+    // Last block that starts at or below rva
+    auto next = std::upper_bound(m_blockStarts.constBegin(), m_blockStarts.constEnd(), rva);
+    if (next == m_blockStarts.constBegin()) {
+        return false;
+    }
+    int block = static_cast<int>(next - m_blockStarts.constBegin()) - 1;
+    quint32 value = m_blockStarts[block];
+    if (value == rva) {
+        return true;
+    }
+
+    int remaining = qMin(BLOCK_SIZE, m_count - block * BLOCK_SIZE) - 1;
+    const uchar *pos = reinterpret_cast<const uchar*>(m_deltas.constData()) + m_blockOffsets[block];
+    while (remaining-- > 0) {
+        value += readVarint(pos);
+        if (value >= rva) {
+            return value == rva;
+        }
+    }
+    return false;
+}
+
+QVector<quint32> PERvaSet::toVector() const
+{
+    QVector<quint32> values;
+    values.reserve(m_count);
+    for (int block = 0; block < m_blockStarts.size(); ++block) {
+        quint32 value = m_blockStarts[block];
+        values.append(value);
+        int remaining = qMin(BLOCK_SIZE, m_count - block * BLOCK_SIZE) - 1;
+        const uchar *pos = reinterpret_cast<const uchar*>(m_deltas.constData()) + m_blockOffsets[block];
+        while (remaining-- > 0) {
+            value += readVarint(pos);
+            values.append(value);
+        }
+    }
+    return values;
+}
+
+qsizetype PERvaSet::memoryUsage() const
+{
+    return m_deltas.capacity() +
+           (m_blockStarts.capacity() + m_blockOffsets.capacity()) * static_cast<qsizetype>(sizeof(quint32));
+}
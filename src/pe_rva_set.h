@@ -0,0 +1,55 @@
+/**
+ * @file pe_rva_set.h
+ * @brief Compact sorted set of RVAs with fast membership tests
+ *
+ * Guard tables of system DLLs list tens of thousands of targets, mostly a
+ * few dozen bytes apart. Storing them as a plain QVector<quint32> costs four
+ * bytes per entry; here the sorted values are delta-encoded as LEB128
+ * varints, which brings typical tables down to one or two bytes per entry.
+ *
+ * Every BLOCK_SIZE-th value is kept uncompressed together with the byte
+ * offset of the deltas that follow it, so contains() is a binary search over
+ * the block starts followed by decoding at most BLOCK_SIZE - 1 varints.
+ */
+
+#ifndef PE_RVA_SET_H
+#define PE_RVA_SET_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+class PERvaSet
+{
+public:
+    PERvaSet() = default;
+
+    /**
+     * @brief Builds a set from values in any order; duplicates are dropped
+     */
+    static PERvaSet fromValues(QVector<quint32> values);
+
+    bool contains(quint32 rva) const;
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    /**
+     * @brief Decodes all values in ascending order
+     */
+    QVector<quint32> toVector() const;
+
+    /**
+     * @brief Heap bytes held by the encoded representation
+     */
+    qsizetype memoryUsage() const;
+
+private:
+    static const int BLOCK_SIZE = 64;
+
+    QVector<quint32> m_blockStarts;     // First value of each block
+    QVector<quint32> m_blockOffsets;    // Offset in m_deltas of the block's first delta
+    QByteArray m_deltas;                // LEB128 deltas of the remaining values of each block
+    int m_count = 0;
+};
+
+#endif // PE_RVA_SET_H
@@ -17,15 +17,19 @@
 
 #include "pe_security_analyzer.h"
 #include "pe_structures.h"
+#include "pe_data_model.h"
 #include "pe_utils.h"
+#include "pe_authenticode.h"
 #include "security_config_manager.h"
 #include "language_manager.h"
+#include <QBuffer>
 #include <QFileInfo>
 #include <QDebug>
 #include <QDir>
 #include <QProcess>
 #include <QRegularExpression>
 #include <cmath>
+#include <cstring>
 
 /**
  * @brief Constructor for PESecurityAnalyzer
@@ -74,7 +78,7 @@ PESecurityAnalyzer::~PESecurityAnalyzer()
  * for PE file security assessment, providing both technical details
  * and actionable recommendations.
  */
-SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
+SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath, const PEDataModel *dataModel)
 {
     SecurityAnalysisResult result;
     
@@ -136,6 +140,24 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
         }
     }
     
+    if (dataModel && m_configManager->getBool("General/enable_section_analysis", true)) {
+        QString sectionDetails = analyzeSectionStatistics(*dataModel, result.detectedIssues);
+        if (!sectionDetails.isEmpty()) {
+            result.detailedAnalysis["sections"] = sectionDetails;
+        }
+    }
+    
+    if (dataModel && m_configManager->getBool("General/enable_anti_debug_detection", true)) {
+        QString tlsDetails = analyzeTLSCallbacks(*dataModel, result.detectedIssues);
+        if (!tlsDetails.isEmpty()) {
+            result.detailedAnalysis["tls_callbacks"] = tlsDetails;
+        }
+    }
+    
+    if (dataModel && m_configManager->getBool("General/enable_import_analysis", true)) {
+        analyzeImportTables(*dataModel, result);
+    }
+    
     emit analysisProgress(40, "Analyzing PE structure...");
     
     // Basic PE structure validation
@@ -146,7 +168,7 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
         return result;
     }
     
-    const IMAGE_DOS_HEADER *dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(m_fileData.data());
+    const IMAGE_DOS_HEADER *dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(m_fileData.constData());
     
     // Validate DOS header
     if (dosHeader->e_magic != 0x5A4D) { // "MZ"
@@ -156,6 +178,26 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
         return result;
     }
     
+    // Recompute the image checksum and compare it with OptionalHeader.CheckSum
+    quint32 checkSumOffset = 0;
+    if (m_configManager->getBool("General/enable_checksum_validation", true) &&
+        PEUtils::findCheckSumOffset(m_fileData, checkSumOffset)) {
+        quint32 storedChecksum = 0;
+        memcpy(&storedChecksum, m_fileData.constData() + checkSumOffset, sizeof(storedChecksum));
+        quint32 computedChecksum = PEUtils::calculatePEChecksum(m_fileData, checkSumOffset);
+        
+        QMap<QString, QString> params;
+        params["stored"] = PEUtils::formatHexWidth(storedChecksum, 8);
+        params["computed"] = PEUtils::formatHexWidth(computedChecksum, 8);
+        result.detailedAnalysis["checksum"] = LANG_PARAMS("UI/security_checksum_details", params);
+        
+        // Linkers leave CheckSum at zero unless asked to set it, so only a
+        // non-zero value that disagrees points at post-link modification
+        if (storedChecksum != 0 && storedChecksum != computedChecksum) {
+            result.detectedIssues.append(LANG_PARAMS("UI/security_checksum_mismatch", params));
+        }
+    }
+    
     emit analysisProgress(60, "Checking for anti-analysis techniques...");
     
     // Detect anti-analysis techniques if enabled
@@ -180,10 +222,16 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
     emit analysisProgress(80, "Validating digital signatures...");
     
     // Validate digital signatures if enabled
+    bool signatureMismatch = false;
     if (m_configManager->getBool("General/enable_digital_signature_validation", true)) {
-        result.digitalSignatureStatus = validateDigitalSignature(filePath);
-        if (result.digitalSignatureStatus.contains("invalid", Qt::CaseInsensitive) ||
-            result.digitalSignatureStatus.contains("not found", Qt::CaseInsensitive)) {
+        PEAuthenticode::Result signature = PEAuthenticode::verifyFile(filePath);
+        result.digitalSignatureStatus = PEAuthenticode::describe(signature);
+        if (!signature.computedDigest.isEmpty()) {
+            result.detailedAnalysis["authenticode_hash"] = QString("%1: %2")
+                .arg(signature.algorithmName, QString::fromLatin1(signature.computedDigest.toHex()));
+        }
+        if (signature.hasSignature && !signature.digestMatches) {
+            signatureMismatch = true;
             result.detectedIssues.append(LANG("UI/security_digital_signature_failed"));
         }
     }
@@ -224,7 +272,7 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
         result.recommendations.append(LANG("UI/security_analyze_native"));
     }
     
-    if (result.digitalSignatureStatus.contains("invalid", Qt::CaseInsensitive)) {
+    if (signatureMismatch) {
         result.recommendations.append(LANG("UI/security_verify_authenticity"));
     }
     
@@ -248,7 +296,7 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeFile(const QString &filePath)
  * It's particularly useful for real-time analysis and integration
  * with other PE analysis tools.
  */
-SecurityAnalysisResult PESecurityAnalyzer::analyzeData(const QByteArray &peData)
+SecurityAnalysisResult PESecurityAnalyzer::analyzeData(const QByteArray &peData, const PEDataModel *dataModel)
 {
     // Store the provided data for analysis
     m_fileData = peData;
@@ -257,6 +305,10 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeData(const QByteArray &peData)
     SecurityAnalysisResult result;
     result.riskLevel = SecurityRiskLevel::SAFE;
     result.riskScore = 0;
+    result.isPacked = false;
+    result.isObfuscated = false;
+    result.hasAntiDebug = false;
+    result.hasAntiVM = false;
     
     // Perform basic validation
     if (peData.size() < sizeof(IMAGE_DOS_HEADER)) {
@@ -276,6 +328,29 @@ SecurityAnalysisResult PESecurityAnalyzer::analyzeData(const QByteArray &peData)
         result.detectedIssues.append(LANG("UI/security_high_entropy"));
     }
     
+    // The model-based checks of analyzeFile(), on the caller's parse of the same bytes
+    if (dataModel) {
+        QString sectionDetails = analyzeSectionStatistics(*dataModel, result.detectedIssues);
+        if (!sectionDetails.isEmpty()) {
+            result.detailedAnalysis["sections"] = sectionDetails;
+        }
+        QString tlsDetails = analyzeTLSCallbacks(*dataModel, result.detectedIssues);
+        if (!tlsDetails.isEmpty()) {
+            result.detailedAnalysis["tls_callbacks"] = tlsDetails;
+        }
+        analyzeImportTables(*dataModel, result);
+        
+        QBuffer buffer;
+        buffer.setData(peData);
+        if (buffer.open(QIODevice::ReadOnly)) {
+            PEAuthenticode::Result signature = PEAuthenticode::verifyDevice(&buffer);
+            result.digitalSignatureStatus = PEAuthenticode::describe(signature);
+            if (signature.hasSignature && !signature.digestMatches) {
+                result.detectedIssues.append(LANG("UI/security_digital_signature_failed"));
+            }
+        }
+    }
+    
     // Detect anti-analysis techniques
     QString antiAnalysisResults = detectAntiAnalysisTechniques(peData);
     if (!antiAnalysisResults.isEmpty()) {
@@ -502,32 +577,14 @@ bool PESecurityAnalyzer::isFilePacked(const QString &filePath)
  * @param filePath Path to the PE file to validate
  * @return Digital signature validation result
  * 
- * Digital signature validation helps establish file authenticity
- * and provides confidence in file origin and integrity. This method
- * attempts to validate signatures using Windows API calls and
- * provides detailed validation results.
+ * Recomputes the Authenticode image hash and compares it with the digest
+ * embedded in the PKCS#7 signature. This runs without platform trust APIs,
+ * so it confirms integrity of the signed content but does not validate the
+ * certificate chain.
  */
 QString PESecurityAnalyzer::validateDigitalSignature(const QString &filePath)
 {
-    // This is a simplified implementation
-    // In a production environment, you would use Windows API calls
-    // to perform actual digital signature validation
-    
-    QFileInfo fileInfo(filePath);
-    if (!fileInfo.exists()) {
-        return LANG("UI/file_status_not_found");
-    }
-    
-    // Check if file has .exe, .dll, .sys extension (common PE files)
-    QString extension = fileInfo.suffix().toLower();
-    if (extension != "exe" && extension != "dll" && extension != "sys") {
-        return "Not a standard PE file extension";
-    }
-    
-    // For now, return a placeholder result
-    // Note: Full digital signature validation would require Windows API integration
-    // This could be implemented using WinVerifyTrust, CryptQueryObject, etc.
-    return "Digital signature validation not implemented in this version";
+    return PEAuthenticode::describe(PEAuthenticode::verifyFile(filePath));
 }
 
 // Private analysis methods implementation
@@ -639,6 +696,123 @@ QString PESecurityAnalyzer::analyzeSectionSecurity(const QList<const IMAGE_SECTI
     return issues.join("; ");
 }
 
+/**
+ * @brief Assesses the per-section content statistics of a parsed file
+ * @param dataModel Parsed file with section statistics attached
+ * @param issues Receives one entry per suspicious section
+ * @return One summary line per section
+ * 
+ * High entropy inside a single section is a stronger packing signal than
+ * high whole-file entropy, which resources and overlays can dilute or inflate.
+ */
+QString PESecurityAnalyzer::analyzeSectionStatistics(const PEDataModel &dataModel, QStringList &issues)
+{
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    const QList<PEDataModel::ContentDigest> &statistics = dataModel.getSectionContentDigests();
+    bool checkEntropy = m_configManager->getBool("EntropyThresholds/enable_section_entropy_analysis", true);
+    double highThreshold = m_configManager->getDouble("EntropyThresholds/high_entropy_threshold", 7.5);
+    
+    QStringList lines;
+    for (int i = 0; i < sections.size() && i < statistics.size(); ++i) {
+        const PEDataModel::ContentDigest &digest = statistics[i];
+        if (digest.size == 0) {
+            continue;
+        }
+        
+        const char *name = reinterpret_cast<const char*>(sections[i]->Name);
+        QMap<QString, QString> params;
+        params["name"] = QString::fromLatin1(name, static_cast<int>(qstrnlen(name, 8)));
+        params["entropy"] = QString::number(digest.entropy, 'f', 2);
+        params["zero_runs"] = QString::number(digest.zeroRunCoverage * 100.0, 'f', 1);
+        params["printable"] = QString::number(digest.printableRatio * 100.0, 'f', 1);
+        params["sha256"] = digest.sha256;
+        lines.append(LANG_PARAMS("UI/security_section_statistics", params));
+        
+        if (checkEntropy && digest.entropy > highThreshold) {
+            params["threshold"] = QString::number(highThreshold, 'f', 1);
+            issues.append(LANG_PARAMS("UI/security_section_high_entropy", params));
+        }
+    }
+    
+    return lines.join("\n");
+}
+
+/**
+ * @brief Reports the TLS callbacks of a parsed file
+ * @param dataModel Parsed file with the TLS callback array resolved
+ * @param issues Receives one entry per callback outside executable sections
+ * @return One line per callback
+ * 
+ * Callbacks run before the entry point, where debuggers usually set their
+ * first breakpoint, so they are a common place for anti-debugging code.
+ */
+QString PESecurityAnalyzer::analyzeTLSCallbacks(const PEDataModel &dataModel, QStringList &issues)
+{
+    const QList<const IMAGE_SECTION_HEADER*> &sections = dataModel.getSections();
+    const QList<PEDataModel::TLSCallbackEntry> &callbacks = dataModel.getTLSCallbacks();
+    
+    QStringList lines;
+    for (int i = 0; i < callbacks.size(); ++i) {
+        const PEDataModel::TLSCallbackEntry &callback = callbacks[i];
+        QMap<QString, QString> params;
+        params["index"] = QString::number(i + 1);
+        params["va"] = PEUtils::formatHex(callback.va);
+        if (callback.sectionIndex >= 0 && callback.sectionIndex < sections.size()) {
+            const char *name = reinterpret_cast<const char*>(sections[callback.sectionIndex]->Name);
+            params["section"] = QString::fromLatin1(name, static_cast<int>(qstrnlen(name, 8)));
+        } else {
+            params["section"] = LANG("UI/security_tls_no_section");
+        }
+        lines.append(LANG_PARAMS("UI/security_tls_callback", params));
+        
+        if (!callback.executable) {
+            issues.append(LANG_PARAMS("UI/security_tls_callback_not_executable", params));
+        }
+    }
+    
+    return lines.join("\n");
+}
+
+/**
+ * @brief Runs the import checks over the regular and delay-load import tables
+ * @param dataModel Parsed file with both import tables resolved
+ * @param result Receives the "imports" and "delay_imports" details and issues
+ * 
+ * Delay-loaded functions are resolved on first call and do not show up in
+ * the regular import table, which makes delay loading a cheap way to keep
+ * sensitive APIs out of a quick look at the imports.
+ */
+void PESecurityAnalyzer::analyzeImportTables(const PEDataModel &dataModel, SecurityAnalysisResult &result)
+{
+    auto functionNames = [](const QMap<QString, QList<PEDataModel::ImportFunctionEntry>> &modules) {
+        QStringList names;
+        for (const QList<PEDataModel::ImportFunctionEntry> &functions : modules) {
+            for (const PEDataModel::ImportFunctionEntry &function : functions) {
+                // Ordinal imports have a name only when the export index knew it
+                if (!function.importedByOrdinal || function.name != "[ - ]") {
+                    names.append(function.name);
+                }
+            }
+        }
+        return names;
+    };
+    
+    QStringList imported = functionNames(dataModel.getImportFunctions());
+    if (!imported.isEmpty()) {
+        result.detailedAnalysis["imports"] = analyzeImportSecurity(imported);
+    }
+    
+    QStringList delayLoaded = functionNames(dataModel.getDelayImportFunctions());
+    if (!delayLoaded.isEmpty()) {
+        QStringList matches;
+        result.detailedAnalysis["delay_imports"] = analyzeImportSecurity(delayLoaded, &matches);
+        if (!matches.isEmpty()) {
+            matches.removeDuplicates();
+            result.detectedIssues.append(LANG_PARAM("UI/security_delay_loaded_suspicious_apis", "apis", matches.join(", ")));
+        }
+    }
+}
+
 /**
  * @brief Analyzes imports for suspicious or malicious functions
  * @param imports List of imported functions to analyze
@@ -649,7 +823,7 @@ QString PESecurityAnalyzer::analyzeSectionSecurity(const QList<const IMAGE_SECTI
  * functions related to process injection, anti-debugging,
  * network communication, and other suspicious activities.
  */
-QString PESecurityAnalyzer::analyzeImportSecurity(const QStringList &imports)
+QString PESecurityAnalyzer::analyzeImportSecurity(const QStringList &imports, QStringList *matches)
 {
     if (imports.isEmpty()) {
         return "No imports to analyze";
@@ -682,6 +856,17 @@ QString PESecurityAnalyzer::analyzeImportSecurity(const QStringList &imports)
         }
     }
     
+    if (matches) {
+        for (const QString &import : imports) {
+            if (antiDebugAPIs.contains(import, Qt::CaseInsensitive) ||
+                processInjectionAPIs.contains(import, Qt::CaseInsensitive) ||
+                networkAPIs.contains(import, Qt::CaseInsensitive) ||
+                registryAPIs.contains(import, Qt::CaseInsensitive)) {
+                matches->append(import);
+            }
+        }
+    }
+    
     if (issues.isEmpty()) {
         return "No suspicious imports detected";
     }
@@ -42,6 +42,7 @@
 
 // Forward declarations
 class SecurityConfigManager;
+class PEDataModel;
 
 // Forward declarations to avoid circular dependencies
 struct IMAGE_DOS_HEADER;
@@ -125,6 +126,8 @@ public:
     /**
      * @brief Performs comprehensive security analysis on a PE file
      * @param filePath Path to the PE file to analyze
+     * @param dataModel Parsed model of the same file; when given, the per-section
+     *                  content statistics it holds are assessed as well
      * @return SecurityAnalysisResult containing analysis findings
      * 
      * This method performs a complete security analysis including:
@@ -139,17 +142,19 @@ public:
      * The analysis is comprehensive and follows industry best practices
      * for PE file security assessment.
      */
-    SecurityAnalysisResult analyzeFile(const QString &filePath);
+    SecurityAnalysisResult analyzeFile(const QString &filePath, const PEDataModel *dataModel = nullptr);
     
     /**
      * @brief Performs security analysis on raw PE data
      * @param peData Raw PE file data as QByteArray
+     * @param dataModel Parsed model of the same bytes; when given, the section,
+     *                  TLS, import and signature checks run as in analyzeFile()
      * @return SecurityAnalysisResult containing analysis findings
      * 
      * This method is useful when you already have the PE data in memory
      * and want to perform security analysis without file I/O operations.
      */
-    SecurityAnalysisResult analyzeData(const QByteArray &peData);
+    SecurityAnalysisResult analyzeData(const QByteArray &peData, const PEDataModel *dataModel = nullptr);
     
     /**
      * @brief Performs quick security scan for basic threats
@@ -220,8 +225,8 @@ public:
      * @param filePath Path to the PE file to validate
      * @return Digital signature validation result
      * 
-     * Digital signature validation helps establish file authenticity
-     * and provides confidence in file origin and integrity.
+     * Compares the Authenticode image hash with the digest stored in the
+     * embedded signature. Certificate chains are not validated.
      */
     QString validateDigitalSignature(const QString &filePath);
     
@@ -280,15 +285,42 @@ private:
      */
     QString analyzeSectionSecurity(const QList<const IMAGE_SECTION_HEADER*> &sections);
     
+    /**
+     * @brief Assesses the per-section content statistics of a parsed file
+     * @param dataModel Parsed file with section statistics attached
+     * @param issues Receives one entry per suspicious section
+     * @return One summary line per section (entropy, zero-run coverage, printable ratio)
+     * 
+     * The byte-level pass already ran in the parser, so this stage only
+     * interprets the numbers and does not touch the file again.
+     */
+    QString analyzeSectionStatistics(const PEDataModel &dataModel, QStringList &issues);
+    
+    /**
+     * @brief Reports the TLS callbacks of a parsed file
+     * @param dataModel Parsed file with the TLS callback array resolved
+     * @param issues Receives one entry per callback outside executable sections
+     * @return One line per callback with its VA and section
+     */
+    QString analyzeTLSCallbacks(const PEDataModel &dataModel, QStringList &issues);
+    
     /**
      * @brief Analyzes imports for suspicious or malicious functions
      * @param imports List of imported functions to analyze
+     * @param matches Optionally receives the imports that matched a category
      * @return Import security analysis results
      * 
      * This method examines imported functions to identify
      * suspicious APIs commonly used in malware.
      */
-    QString analyzeImportSecurity(const QStringList &imports);
+    QString analyzeImportSecurity(const QStringList &imports, QStringList *matches = nullptr);
+    
+    /**
+     * @brief Runs the import checks over the regular and delay-load import tables
+     * @param dataModel Parsed file with both import tables resolved
+     * @param result Receives the "imports" and "delay_imports" details and issues
+     */
+    void analyzeImportTables(const PEDataModel &dataModel, SecurityAnalysisResult &result);
     
     /**
      * @brief Detects anti-debugging and anti-VM techniques
@@ -33,6 +33,9 @@
 #define IMAGE_FILE_MACHINE_POWERPC     0x01f0
 #define IMAGE_FILE_MACHINE_POWERPCFPU  0x01f1
 #define IMAGE_FILE_MACHINE_R4000       0x0166
+#define IMAGE_FILE_MACHINE_RISCV32     0x5032
+#define IMAGE_FILE_MACHINE_RISCV64     0x5064
+#define IMAGE_FILE_MACHINE_RISCV128    0x5128
 #define IMAGE_FILE_MACHINE_SH3         0x01a2
 #define IMAGE_FILE_MACHINE_SH3DSP      0x01a3
 #define IMAGE_FILE_MACHINE_SH4         0x01a6
@@ -116,6 +119,23 @@ struct IMAGE_DATA_DIRECTORY {
     quint32 Size;             // Size of the data
 };
 
+// Data directory indices
+#define IMAGE_DIRECTORY_ENTRY_EXPORT          0
+#define IMAGE_DIRECTORY_ENTRY_IMPORT          1
+#define IMAGE_DIRECTORY_ENTRY_RESOURCE        2
+#define IMAGE_DIRECTORY_ENTRY_EXCEPTION       3
+#define IMAGE_DIRECTORY_ENTRY_SECURITY        4   // File offset, not an RVA
+#define IMAGE_DIRECTORY_ENTRY_BASERELOC       5
+#define IMAGE_DIRECTORY_ENTRY_DEBUG           6
+#define IMAGE_DIRECTORY_ENTRY_ARCHITECTURE    7
+#define IMAGE_DIRECTORY_ENTRY_GLOBALPTR       8
+#define IMAGE_DIRECTORY_ENTRY_TLS             9
+#define IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG    10
+#define IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT   11
+#define IMAGE_DIRECTORY_ENTRY_IAT            12
+#define IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT   13
+#define IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR 14
+
 // ============================================================================
 // OPTIONAL HEADERS (32-bit and 64-bit)
 // ============================================================================
@@ -200,24 +220,6 @@ static_assert(sizeof(IMAGE_OPTIONAL_HEADER64) == 240, "IMAGE_OPTIONAL_HEADER64 m
 // Legacy compatibility - keep the old name for existing code
 typedef IMAGE_OPTIONAL_HEADER32 IMAGE_OPTIONAL_HEADER;
 
-// ============================================================================
-// RICH HEADER STRUCTURES (Compiler Identification)
-// ============================================================================
-
-struct IMAGE_RICH_HEADER {
-    quint32 XorKey;           // XOR key for decryption
-    quint32 RichSignature;     // Rich signature
-    quint32 RichVersion;       // Rich version
-    quint32 RichCount;         // Number of rich entries
-};
-
-struct IMAGE_RICH_ENTRY {
-    quint16 ProductId;         // Product ID
-    quint16 ProductVersion;    // Product version
-    quint32 ProductCount;      // Product count
-    quint32 ProductTimestamp;  // Product timestamp
-};
-
 // ============================================================================
 // IMPORT/EXPORT STRUCTURES
 // ============================================================================
@@ -293,6 +295,16 @@ struct IMAGE_SECTION_HEADER {
     quint32 getPhysicalAddress() const { return Misc.PhysicalAddress; }
 };
 
+// Section characteristics
+#define IMAGE_SCN_CNT_CODE                0x00000020
+#define IMAGE_SCN_CNT_INITIALIZED_DATA    0x00000040
+#define IMAGE_SCN_CNT_UNINITIALIZED_DATA  0x00000080
+#define IMAGE_SCN_MEM_DISCARDABLE         0x02000000
+#define IMAGE_SCN_MEM_SHARED              0x10000000
+#define IMAGE_SCN_MEM_EXECUTE             0x20000000
+#define IMAGE_SCN_MEM_READ                0x40000000
+#define IMAGE_SCN_MEM_WRITE               0x80000000
+
 // ============================================================================
 // RESOURCE STRUCTURES
 // ============================================================================
@@ -364,18 +376,26 @@ struct IMAGE_DEBUG_DIRECTORY {
 #define IMAGE_DEBUG_TYPE_BORLAND          9
 #define IMAGE_DEBUG_TYPE_RESERVED10       10
 #define IMAGE_DEBUG_TYPE_CLSID            11
-#define IMAGE_DEBUG_TYPE_MPX              12
-#define IMAGE_DEBUG_TYPE_REPRO            13
-#define IMAGE_DEBUG_TYPE_EMBEDDED_SOURCE  14
-#define IMAGE_DEBUG_TYPE_RESERVED15       15
-#define IMAGE_DEBUG_TYPE_POGO             16
-#define IMAGE_DEBUG_TYPE_ILTCG            17
-#define IMAGE_DEBUG_TYPE_MPX2             18
-#define IMAGE_DEBUG_TYPE_HOTPATCH         19
-#define IMAGE_DEBUG_TYPE_MPX3             20
-#define IMAGE_DEBUG_TYPE_PDB_CHECKSUM     21
+#define IMAGE_DEBUG_TYPE_VC_FEATURE       12
+#define IMAGE_DEBUG_TYPE_POGO             13
+#define IMAGE_DEBUG_TYPE_ILTCG            14
+#define IMAGE_DEBUG_TYPE_MPX              15
+#define IMAGE_DEBUG_TYPE_REPRO            16
+#define IMAGE_DEBUG_TYPE_EMBEDDED_PORTABLE_PDB 17
+#define IMAGE_DEBUG_TYPE_SPGO             18
+#define IMAGE_DEBUG_TYPE_PDBCHECKSUM      19
+#define IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS 20
 
 // CodeView debug information
+#define CV_SIGNATURE_RSDS                 0x53445352  // "RSDS", PDB 7.0
+#define CV_SIGNATURE_NB10                 0x3031424E  // "NB10", PDB 2.0
+
+// POGO debug entry signatures, read as a little-endian dword
+#define POGO_SIGNATURE_LTCG               0x4C544347  // Link-time code generation
+#define POGO_SIGNATURE_PGU                0x50475500  // Profile-guided update
+#define POGO_SIGNATURE_PGI                0x50474900  // Profile-guided instrumentation
+#define POGO_SIGNATURE_PGO                0x50474F00  // Profile-guided optimization
+
 struct CV_INFO_PDB70 {
     quint32 CvSignature;           // CodeView signature
     quint8  Signature[16];         // PDB signature
@@ -383,6 +403,22 @@ struct CV_INFO_PDB70 {
     char PdbFileName[1];           // PDB file name (variable length)
 };
 
+struct CV_INFO_PDB20 {
+    quint32 CvSignature;           // "NB10"
+    quint32 Offset;                // Always 0 for a separate PDB
+    quint32 Signature;             // Time-based PDB signature
+    quint32 Age;                   // PDB age
+    char PdbFileName[1];           // PDB file name (variable length)
+};
+
+// IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS flags
+#define IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT                         0x0001
+#define IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT_STRICT_MODE             0x0002
+#define IMAGE_DLLCHARACTERISTICS_EX_CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE 0x0004
+#define IMAGE_DLLCHARACTERISTICS_EX_CET_DYNAMIC_APIS_ALLOW_IN_PROC     0x0008
+#define IMAGE_DLLCHARACTERISTICS_EX_FORWARD_CFI_COMPAT                 0x0040
+#define IMAGE_DLLCHARACTERISTICS_EX_HOTPATCH_COMPATIBLE                0x0080
+
 // ============================================================================
 // TLS (Thread Local Storage) STRUCTURES
 // ============================================================================
@@ -412,6 +448,13 @@ typedef IMAGE_TLS_DIRECTORY32 IMAGE_TLS_DIRECTORY;
 // LOAD CONFIGURATION STRUCTURES
 // ============================================================================
 
+struct IMAGE_LOAD_CONFIG_CODE_INTEGRITY {
+    quint16 Flags;
+    quint16 Catalog;
+    quint32 CatalogOffset;
+    quint32 Reserved;
+};
+
 // 32-bit Load Configuration Directory
 struct IMAGE_LOAD_CONFIG_DIRECTORY32 {
     quint32 Size;
@@ -434,6 +477,36 @@ struct IMAGE_LOAD_CONFIG_DIRECTORY32 {
     quint32 SecurityCookie;
     quint32 SEHandlerTable;
     quint32 SEHandlerCount;
+    // Fields below are only present when Size covers them
+    quint32 GuardCFCheckFunctionPointer;
+    quint32 GuardCFDispatchFunctionPointer;
+    quint32 GuardCFFunctionTable;
+    quint32 GuardCFFunctionCount;
+    quint32 GuardFlags;
+    IMAGE_LOAD_CONFIG_CODE_INTEGRITY CodeIntegrity;
+    quint32 GuardAddressTakenIatEntryTable;
+    quint32 GuardAddressTakenIatEntryCount;
+    quint32 GuardLongJumpTargetTable;
+    quint32 GuardLongJumpTargetCount;
+    quint32 DynamicValueRelocTable;
+    quint32 CHPEMetadataPointer;
+    quint32 GuardRFFailureRoutine;
+    quint32 GuardRFFailureRoutineFunctionPointer;
+    quint32 DynamicValueRelocTableOffset;
+    quint16 DynamicValueRelocTableSection;
+    quint16 Reserved2;
+    quint32 GuardRFVerifyStackPointerFunctionPointer;
+    quint32 HotPatchTableOffset;
+    quint32 Reserved3;
+    quint32 EnclaveConfigurationPointer;
+    quint32 VolatileMetadataPointer;
+    quint32 GuardEHContinuationTable;
+    quint32 GuardEHContinuationCount;
+    quint32 GuardXFGCheckFunctionPointer;
+    quint32 GuardXFGDispatchFunctionPointer;
+    quint32 GuardXFGTableDispatchFunctionPointer;
+    quint32 CastGuardOsDeterminedFailureMode;
+    quint32 GuardMemcpyFunctionPointer;
 };
 
 // 64-bit Load Configuration Directory
@@ -457,8 +530,60 @@ struct IMAGE_LOAD_CONFIG_DIRECTORY64 {
     quint64 EditList;
     quint64 SecurityCookie;
     quint64 SEHandlerTable;
-    quint32 SEHandlerCount;
-};
+    quint64 SEHandlerCount;
+    // Fields below are only present when Size covers them
+    quint64 GuardCFCheckFunctionPointer;
+    quint64 GuardCFDispatchFunctionPointer;
+    quint64 GuardCFFunctionTable;
+    quint64 GuardCFFunctionCount;
+    quint32 GuardFlags;
+    IMAGE_LOAD_CONFIG_CODE_INTEGRITY CodeIntegrity;
+    quint64 GuardAddressTakenIatEntryTable;
+    quint64 GuardAddressTakenIatEntryCount;
+    quint64 GuardLongJumpTargetTable;
+    quint64 GuardLongJumpTargetCount;
+    quint64 DynamicValueRelocTable;
+    quint64 CHPEMetadataPointer;
+    quint64 GuardRFFailureRoutine;
+    quint64 GuardRFFailureRoutineFunctionPointer;
+    quint32 DynamicValueRelocTableOffset;
+    quint16 DynamicValueRelocTableSection;
+    quint16 Reserved2;
+    quint64 GuardRFVerifyStackPointerFunctionPointer;
+    quint32 HotPatchTableOffset;
+    quint32 Reserved3;
+    quint64 EnclaveConfigurationPointer;
+    quint64 VolatileMetadataPointer;
+    quint64 GuardEHContinuationTable;
+    quint64 GuardEHContinuationCount;
+    quint64 GuardXFGCheckFunctionPointer;
+    quint64 GuardXFGDispatchFunctionPointer;
+    quint64 GuardXFGTableDispatchFunctionPointer;
+    quint64 CastGuardOsDeterminedFailureMode;
+    quint64 GuardMemcpyFunctionPointer;
+};
+
+// GuardFlags
+#define IMAGE_GUARD_CF_INSTRUMENTED                    0x00000100
+#define IMAGE_GUARD_CFW_INSTRUMENTED                   0x00000200
+#define IMAGE_GUARD_CF_FUNCTION_TABLE_PRESENT          0x00000400
+#define IMAGE_GUARD_SECURITY_COOKIE_UNUSED             0x00000800
+#define IMAGE_GUARD_PROTECT_DELAYLOAD_IAT              0x00001000
+#define IMAGE_GUARD_DELAYLOAD_IAT_IN_ITS_OWN_SECTION   0x00002000
+#define IMAGE_GUARD_CF_EXPORT_SUPPRESSION_INFO_PRESENT 0x00004000
+#define IMAGE_GUARD_CF_ENABLE_EXPORT_SUPPRESSION       0x00008000
+#define IMAGE_GUARD_CF_LONGJUMP_TABLE_PRESENT          0x00010000
+#define IMAGE_GUARD_RF_INSTRUMENTED                    0x00020000
+#define IMAGE_GUARD_EH_CONTINUATION_TABLE_PRESENT      0x00400000
+#define IMAGE_GUARD_XFG_ENABLED                        0x00800000
+#define IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK        0xF0000000
+#define IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT       28
+
+// Metadata byte that follows each guard table RVA when the stride is non-zero
+#define IMAGE_GUARD_FLAG_FID_SUPPRESSED                0x01
+#define IMAGE_GUARD_FLAG_EXPORT_SUPPRESSED             0x02
+#define IMAGE_GUARD_FLAG_FID_LANGEXCPTHANDLER          0x04
+#define IMAGE_GUARD_FLAG_FID_XFG                       0x08
 
 // Legacy compatibility
 typedef IMAGE_LOAD_CONFIG_DIRECTORY32 IMAGE_LOAD_CONFIG_DIRECTORY;
@@ -479,6 +604,19 @@ struct IMAGE_RUNTIME_FUNCTION_ENTRY64 {
     quint32 UnwindInfoAddress;
 };
 
+// x64 UNWIND_INFO header; followed by CountOfCodes UNWIND_CODE slots
+struct UNWIND_INFO {
+    quint8 VersionAndFlags;       // Version : 3, Flags : 5
+    quint8 SizeOfProlog;
+    quint8 CountOfCodes;
+    quint8 FrameRegisterAndOffset; // FrameRegister : 4, FrameOffset : 4
+};
+
+#define UNW_FLAG_NHANDLER   0x0
+#define UNW_FLAG_EHANDLER   0x1
+#define UNW_FLAG_UHANDLER   0x2
+#define UNW_FLAG_CHAININFO  0x4
+
 // ============================================================================
 // BASE RELOCATION STRUCTURES
 // ============================================================================
@@ -507,6 +645,14 @@ struct IMAGE_RELOCATION {
 #define IMAGE_REL_BASED_DIR64           10
 #define IMAGE_REL_BASED_HIGH3ADJ        11
 
+// Machine-specific aliases of the types above
+#define IMAGE_REL_BASED_ARM_MOV32       5
+#define IMAGE_REL_BASED_RISCV_HIGH20    5
+#define IMAGE_REL_BASED_THUMB_MOV32     7
+#define IMAGE_REL_BASED_RISCV_LOW12I    7
+#define IMAGE_REL_BASED_RISCV_LOW12S    8
+#define IMAGE_REL_BASED_LOONGARCH_MARK_LA 8
+
 // ============================================================================
 // CERTIFICATE STRUCTURES (Authenticode)
 // ============================================================================
@@ -561,6 +707,37 @@ struct IMAGE_DELAYLOAD_DESCRIPTOR {
     quint32 TimeDateStamp;
 };
 
+// ============================================================================
+// CLR (.NET) STRUCTURES
+// ============================================================================
+
+struct IMAGE_COR20_HEADER {
+    quint32 cb;
+    quint16 MajorRuntimeVersion;
+    quint16 MinorRuntimeVersion;
+    IMAGE_DATA_DIRECTORY MetaData;
+    quint32 Flags;
+    quint32 EntryPointToken;          // Or EntryPointRVA with COMIMAGE_FLAGS_NATIVE_ENTRYPOINT
+    IMAGE_DATA_DIRECTORY Resources;
+    IMAGE_DATA_DIRECTORY StrongNameSignature;
+    IMAGE_DATA_DIRECTORY CodeManagerTable;
+    IMAGE_DATA_DIRECTORY VTableFixups;
+    IMAGE_DATA_DIRECTORY ExportAddressTableJumps;
+    IMAGE_DATA_DIRECTORY ManagedNativeHeader;
+};
+
+// IMAGE_COR20_HEADER Flags
+#define COMIMAGE_FLAGS_ILONLY               0x00000001
+#define COMIMAGE_FLAGS_32BITREQUIRED        0x00000002
+#define COMIMAGE_FLAGS_IL_LIBRARY           0x00000004
+#define COMIMAGE_FLAGS_STRONGNAMESIGNED     0x00000008
+#define COMIMAGE_FLAGS_NATIVE_ENTRYPOINT    0x00000010
+#define COMIMAGE_FLAGS_TRACKDEBUGDATA       0x00010000
+#define COMIMAGE_FLAGS_32BITPREFERRED       0x00020000
+
+// Metadata root signature "BSJB"
+#define CLR_METADATA_SIGNATURE 0x424A5342
+
 // ============================================================================
 // ARCHITECTURE SPECIFIC STRUCTURES
 // ============================================================================
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QDateTime>
 #include <QDebug>
+#include <cstddef>
+#include <cstring>
 
 QString PEUtils::formatHexInternal(quint64 value, int width)
 {
@@ -166,15 +168,56 @@ QString PEUtils::getDebugTypeName(quint32 typeId)
         case 9: return LANG("UI/debug_borland");
         case 10: return LANG("UI/debug_reserved");
         case 11: return LANG("UI/debug_clsid");
-        case 12: return LANG("UI/debug_pogo");
-        case 13: return LANG("UI/debug_iltcg");
-        case 14: return LANG("UI/debug_mpx");
-        case 15: return LANG("UI/debug_repro");
-        case 16: return LANG("UI/debug_exdll_characteristics");
+        case 12: return LANG("UI/debug_vc_feature");
+        case 13: return LANG("UI/debug_pogo");
+        case 14: return LANG("UI/debug_iltcg");
+        case 15: return LANG("UI/debug_mpx");
+        case 16: return LANG("UI/debug_repro");
+        case 17: return LANG("UI/debug_embedded_portable_pdb");
+        case 18: return LANG("UI/debug_spgo");
+        case 19: return LANG("UI/debug_pdb_checksum");
+        case 20: return LANG("UI/debug_exdll_characteristics");
         default: return LANG_PARAM("UI/debug_unknown", "value", QString::number(typeId));
     }
 }
 
+QString PEUtils::getRelocationTypeName(quint8 type, quint16 machine)
+{
+    // Types 5, 7, 8 and 9 mean different things per architecture, and nothing on the others
+    bool isArm = machine == IMAGE_FILE_MACHINE_ARM || machine == IMAGE_FILE_MACHINE_ARMNT || machine == IMAGE_FILE_MACHINE_THUMB;
+    bool isMips = machine == IMAGE_FILE_MACHINE_R4000 || machine == IMAGE_FILE_MACHINE_WCEMIPSV2 ||
+                  machine == IMAGE_FILE_MACHINE_MIPS16 || machine == IMAGE_FILE_MACHINE_MIPSFPU ||
+                  machine == IMAGE_FILE_MACHINE_MIPSFPU16;
+    bool isRiscv = machine == IMAGE_FILE_MACHINE_RISCV32 || machine == IMAGE_FILE_MACHINE_RISCV64 ||
+                   machine == IMAGE_FILE_MACHINE_RISCV128;
+    
+    switch (type) {
+        case IMAGE_REL_BASED_ABSOLUTE: return QStringLiteral("ABSOLUTE");
+        case IMAGE_REL_BASED_HIGH: return QStringLiteral("HIGH");
+        case IMAGE_REL_BASED_LOW: return QStringLiteral("LOW");
+        case IMAGE_REL_BASED_HIGHLOW: return QStringLiteral("HIGHLOW");
+        case IMAGE_REL_BASED_HIGHADJ: return QStringLiteral("HIGHADJ");
+        case 5:
+            if (isArm) return QStringLiteral("ARM_MOV32");
+            if (isMips) return QStringLiteral("MIPS_JMPADDR");
+            if (isRiscv) return QStringLiteral("RISCV_HIGH20");
+            break;
+        case 7:
+            if (isArm) return QStringLiteral("THUMB_MOV32");
+            if (isRiscv) return QStringLiteral("RISCV_LOW12I");
+            break;
+        case 8:
+            if (isRiscv) return QStringLiteral("RISCV_LOW12S");
+            break;
+        case 9:
+            if (isMips) return QStringLiteral("MIPS_JMPADDR16");
+            break;
+        case IMAGE_REL_BASED_DIR64: return QStringLiteral("DIR64");
+        default: break;
+    }
+    return QStringLiteral("TYPE_%1").arg(type);
+}
+
 QString PEUtils::getDLLCharacteristics(quint16 characteristics)
 {
     QStringList chars;
@@ -205,31 +248,6 @@ QString PEUtils::getDLLCharacteristics(quint16 characteristics)
     return chars.isEmpty() ? LANG("UI/dll_char_none") : chars.join(", ");
 }
 
-QString PEUtils::getRichHeaderProductName(quint16 productId)
-{
-    switch (productId) {
-        case 0x0001: return "Microsoft Visual C++";
-        case 0x0002: return "Microsoft Visual Basic";
-        case 0x0003: return "Microsoft Visual C++ (Debug)";
-        case 0x0004: return "Microsoft Visual Basic (Debug)";
-        case 0x0005: return "Microsoft Visual C++ (Release)";
-        case 0x0006: return "Microsoft Visual Basic (Release)";
-        case 0x0007: return "Microsoft Visual C++ (Debug Runtime)";
-        case 0x0008: return "Microsoft Visual Basic (Debug Runtime)";
-        case 0x0009: return "Microsoft Visual C++ (Release Runtime)";
-        case 0x000A: return "Microsoft Visual Basic (Release Runtime)";
-        case 0x000B: return "Microsoft Visual C++ (Debug DLL)";
-        case 0x000C: return "Microsoft Visual Basic (Debug DLL)";
-        case 0x000D: return "Microsoft Visual C++ (Release DLL)";
-        case 0x000E: return "Microsoft Visual Basic (Release DLL)";
-        case 0x000F: return "Microsoft Visual C++ (Debug Static)";
-        case 0x0010: return "Microsoft Visual Basic (Debug Static)";
-        case 0x0011: return "Microsoft Visual C++ (Release Static)";
-        case 0x0012: return "Microsoft Visual Basic (Release Static)";
-        default: return QString("Unknown Product (0x%1)").arg(productId, 4, 16, QChar('0'));
-    }
-}
-
 // Validation utilities
 bool PEUtils::isValidDOSMagic(quint16 magic)
 {
@@ -272,6 +290,80 @@ quint32 PEUtils::calculateDataDirectoryOffset(quint32 optionalHeaderOffset, quin
     return optionalHeaderOffset + optionalHeaderSize + (directoryIndex * sizeof(IMAGE_DATA_DIRECTORY));
 }
 
+bool PEUtils::findCheckSumOffset(const QByteArray &fileData, quint32 &checkSumOffset)
+{
+    if (fileData.size() < static_cast<qsizetype>(sizeof(IMAGE_DOS_HEADER))) {
+        return false;
+    }
+    
+    IMAGE_DOS_HEADER dosHeader;
+    memcpy(&dosHeader, fileData.constData(), sizeof(dosHeader));
+    if (!isValidDOSMagic(dosHeader.e_magic) || dosHeader.e_lfanew < 0) {
+        return false;
+    }
+    
+    // CheckSum sits at the same offset in PE32 and PE32+ optional headers
+    quint64 offset = static_cast<quint64>(dosHeader.e_lfanew) + sizeof(quint32) +
+                     sizeof(IMAGE_FILE_HEADER) + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum);
+    if (offset + sizeof(quint32) > static_cast<quint64>(fileData.size())) {
+        return false;
+    }
+    
+    checkSumOffset = static_cast<quint32>(offset);
+    return true;
+}
+
+quint32 PEUtils::calculatePEChecksum(const QByteArray &fileData, quint32 checkSumOffset)
+{
+    const uchar *data = reinterpret_cast<const uchar*>(fileData.constData());
+    const qint64 size = fileData.size();
+    
+    // Sum little-endian dwords into a 64-bit accumulator instead of folding
+    // every 16-bit word. Since 2^16 == 1 (mod 0xFFFF) the final fold gives the
+    // same one's-complement sum as CheckSumMappedFile, and the branch-free
+    // inner loop is simple enough for the compiler to vectorize.
+    const qint64 BLOCK_DWORDS = 1 << 28;
+    quint64 sum = 0;
+    qint64 pos = 0;
+    while (size - pos >= static_cast<qint64>(sizeof(quint32))) {
+        qint64 count = qMin((size - pos) / static_cast<qint64>(sizeof(quint32)), BLOCK_DWORDS);
+        quint64 blockSum = 0;
+        for (qint64 i = 0; i < count; ++i) {
+            quint32 dword;
+            memcpy(&dword, data + pos + i * sizeof(quint32), sizeof(dword));
+            blockSum += dword;
+        }
+        pos += count * sizeof(quint32);
+        
+        // Fold between blocks so the accumulator can never overflow
+        sum += (blockSum & 0xFFFFFFFF) + (blockSum >> 32);
+    }
+    
+    // Trailing bytes are zero padded, matching the odd-byte handling of the original
+    if (pos < size) {
+        quint32 tail = 0;
+        memcpy(&tail, data + pos, static_cast<size_t>(size - pos));
+        sum += tail;
+    }
+    
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    
+    // Remove the stored CheckSum words the same way CheckSumMappedFile does
+    quint16 partialSum = static_cast<quint16>(sum);
+    if (static_cast<quint64>(checkSumOffset) + sizeof(quint32) <= static_cast<quint64>(size)) {
+        quint16 adjust[2];
+        memcpy(adjust, data + checkSumOffset, sizeof(adjust));
+        for (quint16 word : adjust) {
+            partialSum -= (partialSum < word);
+            partialSum -= word;
+        }
+    }
+    
+    return static_cast<quint32>(partialSum) + static_cast<quint32>(size);
+}
+
 // ============================================================================
 // NEW UTILITY FUNCTIONS FOR ENHANCED PE SUPPORT
 // ============================================================================
@@ -343,103 +435,6 @@ bool PEUtils::isValidSubsystem(quint16 subsystem)
     }
 }
 
-quint32 PEUtils::calculateRichHeaderOffset(const IMAGE_DOS_HEADER &dosHeader)
-{
-    // Rich header is located after the DOS stub and before the PE header
-    // It starts after the DOS header (0x40) and ends before e_lfanew
-    // We need to search for the Rich signature "DanS" (0x536E6144) XORed with a key
-    // The signature appears as 0x6869 ("hi") when XORed
-    
-    // Start searching from end of DOS header (0x40) up to PE header
-    // Rich header typically starts around 0x80, but can vary
-    return 0x80; // Default location, but should be searched dynamically
-}
-
-bool PEUtils::findRichHeaderOffset(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader, quint32 &richOffset)
-{
-    // Rich header is located between DOS header end and PE header start
-    quint32 dosHeaderEnd = sizeof(IMAGE_DOS_HEADER); // 0x40
-    quint32 peHeaderStart = dosHeader.e_lfanew;
-    
-    // Rich header structure:
-    // - Starts with XOR key (dword)
-    // - Then "DanS" (0x536E6144) XORed with the key
-    // - Then version and count
-    // - Then entries
-    // - Ends with "Rich" (0x68636952) XORed with the key
-    
-    // Search for "DanS" signature (0x536E6144) XORed
-    const quint32 DAN_SIGNATURE = 0x536E6144; // "DanS"
-    const quint32 RICH_SIGNATURE = 0x68636952; // "Rich"
-    
-    // Search byte-by-byte for better accuracy (Rich Header can start at any 4-byte aligned offset)
-    for (quint32 offset = dosHeaderEnd; offset < peHeaderStart - 16; offset++) {
-        if (offset + 16 > fileData.size()) {
-            break;
-        }
-        
-        // Check if offset is 4-byte aligned (Rich Header must be dword-aligned)
-        if (offset % 4 != 0) {
-            continue;
-        }
-        
-        // Read potential XOR key and signature
-        const quint32 *data = reinterpret_cast<const quint32*>(fileData.data() + offset);
-        quint32 xorKey = data[0];
-        quint32 signature = data[1];
-        
-        // Check if signature XOR key gives us "DanS"
-        if ((signature ^ xorKey) == DAN_SIGNATURE) {
-            // Verify it's a valid Rich header by checking reasonable values
-            quint32 version = data[2];
-            quint32 count = data[3];
-            
-            if (count > 0 && count < 1000 && version < 0x10000) {
-                // Try to verify the end marker "Rich" exists later (but don't require it)
-                quint32 expectedEndOffset = offset + 16 + (count * 12); // 16 bytes header + entries
-                bool hasRichMarker = false;
-                
-                if (expectedEndOffset + 4 < peHeaderStart && expectedEndOffset + 4 < fileData.size()) {
-                    const quint32 *endData = reinterpret_cast<const quint32*>(fileData.data() + expectedEndOffset);
-                    quint32 richSignature = endData[0];
-                    if ((richSignature ^ xorKey) == RICH_SIGNATURE) {
-                        hasRichMarker = true;
-                    }
-                }
-                
-                // Accept if we have "DanS" signature and reasonable count, even without "Rich" marker
-                // (some files may have Rich Header without the end marker)
-                if (hasRichMarker || (expectedEndOffset < peHeaderStart && count > 0 && count < 100)) {
-                    richOffset = offset;
-                    return true;
-                }
-            }
-        }
-    }
-    
-    return false;
-}
-
-quint32 PEUtils::calculateRichHeaderSize(const QByteArray &fileData, quint32 richHeaderOffset)
-{
-    if (richHeaderOffset + 16 > fileData.size()) {
-        return 0;
-    }
-    
-    // Read the header to get count
-    const quint32 *data = reinterpret_cast<const quint32*>(fileData.data() + richHeaderOffset);
-    quint32 count = data[3]; // RichCount
-    
-    // Calculate size: 4 dwords (16 bytes) + entries (each entry is 12 bytes) + "Rich" marker (4 bytes) + checksum (4 bytes)
-    return 16 + (count * sizeof(IMAGE_RICH_ENTRY)) + 8;
-}
-
-bool PEUtils::hasRichHeader(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader)
-{
-    quint32 richOffset;
-    return findRichHeaderOffset(fileData, dosHeader, richOffset);
-}
-
 // ============================================================================
 // DATA DIRECTORY ACCESS UTILITIES (Proper Implementation)
 // ============================================================================
@@ -592,93 +587,6 @@ bool PEUtils::hasStrongNameSignature(const IMAGE_OPTIONAL_HEADER64 &optionalHead
 // LEGACY FUNCTIONS (Deprecated - kept for backward compatibility)
 // ============================================================================
 
-bool PEUtils::parseRichHeader(const QByteArray &fileData, quint32 offset, IMAGE_RICH_HEADER &richHeader)
-{
-    if (offset + 16 > fileData.size()) {
-        return false;
-    }
-    
-    // Rich header structure: [XOR Key][DanS XORed][Version][Count]
-    const quint32 *data = reinterpret_cast<const quint32*>(fileData.data() + offset);
-    
-    richHeader.XorKey = data[0];
-    richHeader.RichSignature = data[1]; // This is "DanS" XORed
-    richHeader.RichVersion = data[2];
-    richHeader.RichCount = data[3];
-    
-    return true;
-}
-
-QList<IMAGE_RICH_ENTRY> PEUtils::parseRichEntries(const QByteArray &fileData, quint32 offset, quint32 count)
-{
-    QList<IMAGE_RICH_ENTRY> entries;
-    
-    // Rich entries start after the 4 dwords (16 bytes) of header
-    quint32 entriesOffset = offset + 16;
-    
-    if (entriesOffset + (count * 12) > fileData.size()) { // Each entry is 12 bytes (3 dwords)
-        return entries;
-    }
-    
-    // Read XOR key from header
-    const quint32 *headerData = reinterpret_cast<const quint32*>(fileData.data() + offset);
-    quint32 xorKey = headerData[0];
-    
-    // Read entries (they are XORed, need to decrypt)
-    const quint32 *entryData = reinterpret_cast<const quint32*>(fileData.data() + entriesOffset);
-    
-    for (quint32 i = 0; i < count; ++i) {
-        IMAGE_RICH_ENTRY entry;
-        // Each entry is 12 bytes (3 dwords)
-        // Entry structure: [ProductId|ProductVersion][ProductCount][ProductTimestamp]
-        quint32 dword0 = entryData[i * 3] ^ xorKey;
-        quint32 dword1 = entryData[i * 3 + 1] ^ xorKey;
-        quint32 dword2 = entryData[i * 3 + 2] ^ xorKey;
-        
-        entry.ProductId = dword0 & 0xFFFF;
-        entry.ProductVersion = (dword0 >> 16) & 0xFFFF;
-        entry.ProductCount = dword1;
-        entry.ProductTimestamp = dword2;
-        
-        entries.append(entry);
-    }
-    
-    return entries;
-}
-
-QString PEUtils::getRichHeaderInfo(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader)
-{
-    quint32 richOffset;
-    if (!findRichHeaderOffset(fileData, dosHeader, richOffset)) {
-        return LANG("UI/rich_header_not_found");
-    }
-    
-    IMAGE_RICH_HEADER richHeader;
-    if (!parseRichHeader(fileData, richOffset, richHeader)) {
-        return LANG("UI/rich_header_parse_error");
-    }
-    
-    QList<IMAGE_RICH_ENTRY> entries = parseRichEntries(fileData, richOffset, richHeader.RichCount);
-    
-    QString info = QString("Rich Header Information:\n");
-    info += QString("XOR Key: %1\n").arg(formatHex(richHeader.XorKey));
-    info += QString("Signature: %1\n").arg(formatHex(richHeader.RichSignature));
-    info += QString("Version: %1\n").arg(formatHex(richHeader.RichVersion));
-    info += QString("Entry Count: %1\n\n").arg(richHeader.RichCount);
-    
-    info += "Product Entries:\n";
-    for (const IMAGE_RICH_ENTRY &entry : entries) {
-        info += QString("- %1 (v%2.%3) - Count: %4, Timestamp: %5\n")
-                .arg(getRichHeaderProductName(entry.ProductId))
-                .arg(entry.ProductVersion >> 8)
-                .arg(entry.ProductVersion & 0xFF)
-                .arg(entry.ProductCount)
-                .arg(formatTimestamp(entry.ProductTimestamp));
-    }
-    
-    return info;
-}
-
 QString PEUtils::getArchitectureString(quint16 machine, quint16 magic)
 {
     QString arch = getMachineType(machine);
@@ -765,6 +673,31 @@ QString PEUtils::formatVA(quint64 va)
     return QString("VA: %1").arg(formatHexInternal(va, 16));
 }
 
+QList<qint64> PEUtils::findPattern(const QByteArray &data, const QByteArray &pattern, bool caseSensitive)
+{
+    QList<qint64> offsets;
+    if (pattern.isEmpty() || data.isEmpty()) return offsets;
+    
+    QByteArray searchData = data;
+    QByteArray searchPattern = pattern;
+    
+    if (!caseSensitive) {
+        searchData = searchData.toLower();
+        searchPattern = searchPattern.toLower();
+    }
+    
+    qsizetype offset = 0;
+    while (true) {
+        qsizetype index = searchData.indexOf(searchPattern, offset);
+        if (index == -1) break;
+        
+        offsets.append(index);
+        offset = index + 1; // Continue searching from next position
+    }
+    
+    return offsets;
+}
+
 // ============================================================================
 // LEGACY FUNCTIONS (Deprecated - kept for backward compatibility)
 // ============================================================================
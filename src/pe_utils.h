@@ -34,8 +34,8 @@ public:
     static QString getFileCharacteristics(quint16 characteristics);
     static QString getResourceTypeName(quint32 typeId);
     static QString getDebugTypeName(quint32 typeId);
+    static QString getRelocationTypeName(quint8 type, quint16 machine);
     static QString getDLLCharacteristics(quint16 characteristics);
-    static QString getRichHeaderProductName(quint16 productId);
     
     // ============================================================================
     // VALIDATION UTILITIES
@@ -57,15 +57,13 @@ public:
     
     static quint32 calculateSectionTableOffset(quint32 peOffset, quint32 optionalHeaderSize);
     static quint32 calculateDataDirectoryOffset(quint32 optionalHeaderOffset, quint32 optionalHeaderSize, int directoryIndex);
-    static quint32 calculateRichHeaderOffset(const IMAGE_DOS_HEADER &dosHeader);
-    static quint32 calculateRichHeaderSize(const QByteArray &fileData, quint32 richHeaderOffset);
-    static bool findRichHeaderOffset(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader, quint32 &richOffset);
+    static bool findCheckSumOffset(const QByteArray &fileData, quint32 &checkSumOffset);
+    static quint32 calculatePEChecksum(const QByteArray &fileData, quint32 checkSumOffset);
     
     // ============================================================================
     // STRUCTURE DETECTION UTILITIES
     // ============================================================================
     
-    static bool hasRichHeader(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader);
     static bool hasLoadConfiguration(const IMAGE_OPTIONAL_HEADER32 &optionalHeader);
     static bool hasLoadConfiguration(const IMAGE_OPTIONAL_HEADER64 &optionalHeader);
     static bool hasTLS(const IMAGE_OPTIONAL_HEADER32 &optionalHeader);
@@ -75,14 +73,6 @@ public:
     static bool hasDelayImports(const IMAGE_OPTIONAL_HEADER32 &optionalHeader);
     static bool hasDelayImports(const IMAGE_OPTIONAL_HEADER64 &optionalHeader);
     
-    // ============================================================================
-    // RICH HEADER UTILITIES
-    // ============================================================================
-    
-    static bool parseRichHeader(const QByteArray &fileData, quint32 offset, IMAGE_RICH_HEADER &richHeader);
-    static QList<IMAGE_RICH_ENTRY> parseRichEntries(const QByteArray &fileData, quint32 offset, quint32 count);
-    static QString getRichHeaderInfo(const QByteArray &fileData, const IMAGE_DOS_HEADER &dosHeader);
-    
     // ============================================================================
     // ARCHITECTURE DETECTION
     // ============================================================================
@@ -115,6 +105,9 @@ public:
     static QString formatRVA(quint32 rva);
     static QString formatVA(quint64 va);
     
+    // Offsets of every (possibly overlapping) occurrence of pattern in data
+    static QList<qint64> findPattern(const QByteArray &data, const QByteArray &pattern, bool caseSensitive);
+    
     // ============================================================================
     // DATA DIRECTORY ACCESS UTILITIES (Proper Implementation)
     // ============================================================================
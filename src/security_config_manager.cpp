@@ -263,6 +263,7 @@ bool SecurityConfigManager::loadConfiguration()
     m_config.enableImportAnalysis = getBool("General/enable_import_analysis", true);
     m_config.enableResourceAnalysis = getBool("General/enable_resource_analysis", true);
     m_config.enableDigitalSignatureValidation = getBool("General/enable_digital_signature_validation", true);
+    m_config.enableChecksumValidation = getBool("General/enable_checksum_validation", true);
     m_config.enableAntiDebugDetection = getBool("General/enable_anti_debug_detection", true);
     m_config.enableAntiVMDetection = getBool("General/enable_anti_vm_detection", true);
     m_config.enablePackerDetection = getBool("General/enable_packer_detection", true);
@@ -384,6 +385,7 @@ void SecurityConfigManager::setDefaultConfiguration()
     m_config.enableImportAnalysis = true;
     m_config.enableResourceAnalysis = true;
     m_config.enableDigitalSignatureValidation = true;
+    m_config.enableChecksumValidation = true;
     m_config.enableAntiDebugDetection = true;
     m_config.enableAntiVMDetection = true;
     m_config.enablePackerDetection = true;
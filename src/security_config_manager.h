@@ -52,6 +52,7 @@ struct SecurityAnalysisConfig {
     bool enableImportAnalysis;
     bool enableResourceAnalysis;
     bool enableDigitalSignatureValidation;
+    bool enableChecksumValidation;
     bool enableAntiDebugDetection;
     bool enableAntiVMDetection;
     bool enablePackerDetection;
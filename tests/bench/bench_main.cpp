@@ -0,0 +1,15 @@
+#include <QtTest>
+#include <QApplication>
+#include "pe_bench.h"
+
+int main(int argc, char *argv[])
+{
+    // Tree benchmarks create widget items but never show them
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    PEBench bench;
+    return QTest::qExec(&bench, argc, argv);
+}
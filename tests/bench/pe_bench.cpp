@@ -0,0 +1,284 @@
+#include "pe_bench.h"
+#include "pe_parser_new.h"
+#include "pe_data_directory_parser.h"
+#include "pe_security_analyzer.h"
+#include "pe_utils.h"
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTreeWidgetItem>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+const char *const DIRECTORY_NAMES[16] = {
+    "export", "import", "resource", "exception", "security", "basereloc", "debug", "architecture",
+    "globalptr", "tls", "load_config", "bound_import", "iat", "delay_import", "com_descriptor", "reserved"
+};
+
+// Points a model at the headers inside data, as PEParserNew does after loading
+bool prepareModel(const QByteArray &data, PEDataModel &model, quint32 &dataDirectoryOffset)
+{
+    if (data.size() < static_cast<qsizetype>(sizeof(IMAGE_DOS_HEADER))) {
+        return false;
+    }
+    const IMAGE_DOS_HEADER *dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(data.constData());
+    const quint32 optionalHeaderOffset = dosHeader->e_lfanew + sizeof(quint32) + sizeof(IMAGE_FILE_HEADER);
+    if (optionalHeaderOffset + sizeof(IMAGE_OPTIONAL_HEADER64) > static_cast<quint64>(data.size())) {
+        return false;
+    }
+    const IMAGE_FILE_HEADER *fileHeader = reinterpret_cast<const IMAGE_FILE_HEADER*>(
+        data.constData() + dosHeader->e_lfanew + sizeof(quint32));
+    const IMAGE_OPTIONAL_HEADER *optionalHeader = reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(
+        data.constData() + optionalHeaderOffset);
+
+    model.clear();
+    model.setDOSHeader(dosHeader);
+    model.setFileHeader(fileHeader);
+    model.setOptionalHeader(optionalHeader);
+    const quint32 sectionTableOffset = optionalHeaderOffset + fileHeader->SizeOfOptionalHeader;
+    for (quint16 i = 0; i < fileHeader->NumberOfSections; ++i) {
+        model.addSection(reinterpret_cast<const IMAGE_SECTION_HEADER*>(
+            data.constData() + sectionTableOffset + i * sizeof(IMAGE_SECTION_HEADER)));
+    }
+
+    dataDirectoryOffset = optionalHeaderOffset + (optionalHeader->Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC
+                                                  ? offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory)
+                                                  : offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory));
+    return true;
+}
+
+bool parseDirectory(PEDataDirectoryParser &parser, int index, const IMAGE_DATA_DIRECTORY &dir, PEDataModel &model)
+{
+    switch (index) {
+        case IMAGE_DIRECTORY_ENTRY_EXPORT: return parser.parseExportDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_IMPORT: return parser.parseImportDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_RESOURCE: return parser.parseResourceDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_EXCEPTION: return parser.parseExceptionDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_SECURITY: return parser.parseCertificateDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_BASERELOC: return parser.parseBaseRelocationDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_DEBUG: return parser.parseDebugDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_ARCHITECTURE: return parser.parseArchitectureDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_GLOBALPTR: return parser.parseGlobalPointerDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_TLS: return parser.parseTLSDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG: return parser.parseLoadConfigDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT: return parser.parseBoundImportDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_IAT: return parser.parseImportAddressTableDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT: return parser.parseDelayImportDirectory(dir.VirtualAddress, dir.Size, model);
+        case IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR: return parser.parseCOMRuntimeDirectory(dir.VirtualAddress, dir.Size, model);
+        default: return true;
+    }
+}
+
+QByteArray readAll(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+QByteArray randomBytes(qsizetype size)
+{
+    QByteArray data(size, '\0');
+    QRandomGenerator generator(42);
+    generator.fillRange(reinterpret_cast<quint32*>(data.data()), size / sizeof(quint32));
+    return data;
+}
+
+} // namespace
+
+void PEBench::initTestCase()
+{
+    QVERIFY(m_corpusDir.isValid());
+
+    bool ok = false;
+    int maxThunks = qEnvironmentVariableIntValue("PEHINT_BENCH_MAX_THUNKS", &ok);
+    if (!ok || maxThunks <= 0) {
+        maxThunks = 100000;
+    }
+    const quint64 largeMB = qEnvironmentVariable("PEHINT_BENCH_LARGE_MB").toULongLong();
+
+    PESyntheticImage::Spec minimal;
+    minimal.importModules = 2;
+    minimal.importsPerModule = 8;
+    minimal.resourceFanout = 2;
+
+    PESyntheticImage::Spec sections = minimal;
+    sections.sectionCount = 96;
+
+    PESyntheticImage::Spec imports = minimal;
+    imports.importModules = qMin(100, maxThunks);
+    imports.importsPerModule = maxThunks / imports.importModules;
+
+    PESyntheticImage::Spec deepResources = minimal;
+    deepResources.resourceDepth = 6;
+    deepResources.resourceFanout = 4;
+
+    PESyntheticImage::Spec wideResources = minimal;
+    wideResources.resourceFanout = 32;
+
+    auto add = [this](const QString &name, PESyntheticImage::Spec spec, bool pe64) {
+        spec.pe64 = pe64;
+        m_corpus.append({QString("%1_%2").arg(pe64 ? "pe64" : "pe32", name), QString(), spec});
+    };
+    for (bool pe64 : {false, true}) {
+        add("minimal", minimal, pe64);
+        add("sections_96", sections, pe64);
+        add(QString("imports_%1").arg(imports.importModules * imports.importsPerModule), imports, pe64);
+        add("resources_deep", deepResources, pe64);
+        add("resources_wide", wideResources, pe64);
+    }
+    if (largeMB > 0) {
+        PESyntheticImage::Spec large = minimal;
+        large.sectionCount = 8;
+        large.fileSize = largeMB * 1024 * 1024;
+        add(QString("large_%1mb").arg(largeMB), large, true);
+    }
+
+    for (CorpusImage &image : m_corpus) {
+        image.path = m_corpusDir.filePath(image.name + ".exe");
+        QVERIFY2(PESyntheticImage::write(image.spec, image.path), qPrintable(image.path));
+    }
+}
+
+void PEBench::addCorpusRows()
+{
+    QTest::addColumn<QString>("path");
+    for (const CorpusImage &image : m_corpus) {
+        QTest::newRow(qPrintable(image.name)) << image.path;
+    }
+}
+
+void PEBench::loadFile_data()
+{
+    addCorpusRows();
+}
+
+void PEBench::loadFile()
+{
+    QFETCH(QString, path);
+    QBENCHMARK {
+        PEParserNew parser;
+        QVERIFY(parser.loadFile(path));
+    }
+}
+
+void PEBench::parseDataDirectories_data()
+{
+    addCorpusRows();
+}
+
+void PEBench::parseDataDirectories()
+{
+    QFETCH(QString, path);
+    const QByteArray data = readAll(path);
+    PEDataModel model;
+    quint32 dataDirectoryOffset = 0;
+    QVERIFY(prepareModel(data, model, dataDirectoryOffset));
+
+    QBENCHMARK {
+        PEDataDirectoryParser parser(data);
+        QVERIFY(parser.parseDataDirectories(model.getOptionalHeader(), dataDirectoryOffset, model));
+    }
+}
+
+void PEBench::parseDirectory_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<int>("directory");
+
+    for (const CorpusImage &image : m_corpus) {
+        PEDataModel model;
+        quint32 dataDirectoryOffset = 0;
+        QFile file(image.path);
+        const QByteArray headers = file.open(QIODevice::ReadOnly) ? file.read(0x10000) : QByteArray();
+        if (!prepareModel(headers, model, dataDirectoryOffset)) {
+            continue;
+        }
+        const IMAGE_DATA_DIRECTORY *directories = reinterpret_cast<const IMAGE_DATA_DIRECTORY*>(
+            headers.constData() + dataDirectoryOffset);
+        for (int i = 0; i < 16; ++i) {
+            if (directories[i].VirtualAddress != 0 && directories[i].Size != 0) {
+                QTest::addRow("%s/%s", qPrintable(image.name), DIRECTORY_NAMES[i]) << image.path << i;
+            }
+        }
+    }
+}
+
+void PEBench::parseDirectory()
+{
+    QFETCH(QString, path);
+    QFETCH(int, directory);
+    const QByteArray data = readAll(path);
+    PEDataModel model;
+    quint32 dataDirectoryOffset = 0;
+    QVERIFY(prepareModel(data, model, dataDirectoryOffset));
+    IMAGE_DATA_DIRECTORY dir;
+    std::memcpy(&dir, data.constData() + dataDirectoryOffset + directory * sizeof(IMAGE_DATA_DIRECTORY), sizeof(dir));
+
+    QBENCHMARK {
+        PEDataDirectoryParser parser(data);
+        QVERIFY(parseDirectory(parser, directory, dir, model));
+    }
+}
+
+void PEBench::calculateEntropy_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::newRow("random_64k") << randomBytes(64 * 1024);
+    QTest::newRow("random_1m") << randomBytes(1024 * 1024);
+    QTest::newRow("random_16m") << randomBytes(16 * 1024 * 1024);
+    QTest::newRow("zero_16m") << QByteArray(16 * 1024 * 1024, '\0');
+}
+
+void PEBench::calculateEntropy()
+{
+    QFETCH(QByteArray, data);
+    PESecurityAnalyzer analyzer;
+    QBENCHMARK {
+        analyzer.calculateEntropy(data);
+    }
+}
+
+void PEBench::findPattern_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("pattern");
+    QTest::addColumn<bool>("caseSensitive");
+
+    // One planted hit near the end plus whatever the random bytes contain
+    for (qsizetype size : {qsizetype(1024 * 1024), qsizetype(16 * 1024 * 1024)}) {
+        QByteArray data = randomBytes(size);
+        const QByteArray rare("PEHint\x01\x02", 8);
+        std::memcpy(data.data() + size - 64, rare.constData(), rare.size());
+        const QString label = QString::number(size / (1024 * 1024)) + "m";
+        QTest::addRow("%s/rare/case", qPrintable(label)) << data << rare << true;
+        QTest::addRow("%s/rare/nocase", qPrintable(label)) << data << rare << false;
+        QTest::addRow("%s/byte/case", qPrintable(label)) << data << QByteArray("\xCC", 1) << true;
+    }
+}
+
+void PEBench::findPattern()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, pattern);
+    QFETCH(bool, caseSensitive);
+    QBENCHMARK {
+        PEUtils::findPattern(data, pattern, caseSensitive);
+    }
+}
+
+void PEBench::structureTree_data()
+{
+    addCorpusRows();
+}
+
+void PEBench::structureTree()
+{
+    QFETCH(QString, path);
+    PEParserNew parser;
+    QVERIFY(parser.loadFile(path));
+    QBENCHMARK {
+        QList<QTreeWidgetItem*> items = parser.getPEStructureTree();
+        qDeleteAll(items);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef PE_BENCH_H
+#define PE_BENCH_H
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include "pe_synthetic_image.h"
+
+/**
+ * @brief Parser benchmarks over a generated corpus
+ *
+ * Every benchmark is data driven, one row per corpus image or input size,
+ * so results stay comparable across commits as long as row names do. Use
+ * QtTest's machine-readable loggers to record them, for example
+ *
+ *   PEHintBench -o bench.csv,csv
+ *   PEHintBench -o bench.xml,xml -iterations 20
+ *
+ * The corpus is generated into a temporary directory on start-up. Its size
+ * can be tuned through the environment:
+ *
+ *   PEHINT_BENCH_MAX_THUNKS   Import thunks in the largest image (100000)
+ *   PEHINT_BENCH_LARGE_MB     Adds a padded image of this size, e.g. 4096 (off)
+ */
+class PEBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // Whole-file parsing
+    void loadFile_data();
+    void loadFile();
+    void parseDataDirectories_data();
+    void parseDataDirectories();
+
+    // Individual directory parsers
+    void parseDirectory_data();
+    void parseDirectory();
+
+    // Analysis and search primitives
+    void calculateEntropy_data();
+    void calculateEntropy();
+    void findPattern_data();
+    void findPattern();
+
+    // UI model construction
+    void structureTree_data();
+    void structureTree();
+
+private:
+    struct CorpusImage {
+        QString name;
+        QString path;
+        PESyntheticImage::Spec spec;
+    };
+
+    void addCorpusRows();
+
+    QTemporaryDir m_corpusDir;
+    QList<CorpusImage> m_corpus;
+};
+
+#endif // PE_BENCH_H
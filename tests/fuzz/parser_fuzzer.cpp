@@ -0,0 +1,44 @@
+// libFuzzer entry point for PEParserNew::loadFromBuffer()
+//
+//   PEHintParserFuzzer -dict=pe.dict corpus/
+//   PEHINT_FUZZ_WRITE_SEEDS=corpus PEHintParserFuzzer -runs=0   (write seeds only)
+
+#include "pe_fuzz_budget.h"
+#include "pe_fuzz_seeds.h"
+#include "pe_parser_new.h"
+#include <QCoreApplication>
+#include <QByteArray>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+PEParserNew *s_parser = nullptr;
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    // LanguageManager resolves its catalogs next to the executable
+    static QCoreApplication app(*argc, *argv);
+
+    QString seedDirectory = qEnvironmentVariable("PEHINT_FUZZ_WRITE_SEEDS");
+    if (!seedDirectory.isEmpty() && PEFuzzSeeds::write(seedDirectory) < 0) {
+        std::fprintf(stderr, "Could not write seed corpus to %s\n", qPrintable(seedDirectory));
+    }
+
+    // One parser for the whole run; loadFromBuffer() starts from clear()
+    s_parser = new PEParserNew;
+    PEFuzzBudget::install();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // Wraps libFuzzer's buffer without copying, so reads past the input
+    // are caught by AddressSanitizer rather than hidden by a heap copy
+    const QByteArray input = QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size));
+
+    PEFuzzBudget::Scope budget("PEParserNew::loadFromBuffer");
+    s_parser->loadFromBuffer(input, QStringLiteral("fuzz-input"));
+    s_parser->clear();
+    return 0;
+}
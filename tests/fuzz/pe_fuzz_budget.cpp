@@ -0,0 +1,88 @@
+#include "pe_fuzz_budget.h"
+#include <sanitizer/allocator_interface.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+qint64 s_timeLimitMs = 1000;
+qint64 s_memoryLimitBytes = 256LL * 1024 * 1024;
+
+// Updated from every thread that allocates, including the thread pool the
+// parser hands section statistics to
+std::atomic<qint64> s_liveBytes{0};
+std::atomic<qint64> s_baselineBytes{0};
+std::atomic<bool> s_active{false};
+const char *s_stage = "";
+
+qint64 limitFromEnvironment(const char *name, qint64 defaultValue, qint64 unit)
+{
+    bool ok = false;
+    qint64 value = qEnvironmentVariableIntValue(name, &ok);
+    return (ok && value > 0) ? value * unit : defaultValue;
+}
+
+void onMalloc(const volatile void *, size_t size)
+{
+    qint64 live = s_liveBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed) + static_cast<qint64>(size);
+    if (!s_active.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    qint64 growth = live - s_baselineBytes.load(std::memory_order_relaxed);
+    // Only the first thread over the limit reports; stderr may allocate
+    if (growth > s_memoryLimitBytes && s_active.exchange(false)) {
+        std::fprintf(stderr, "==PEFuzzBudget== %s: live heap grew by %lld bytes, budget %lld bytes\n",
+                     s_stage, static_cast<long long>(growth), static_cast<long long>(s_memoryLimitBytes));
+        std::abort();
+    }
+}
+
+void onFree(const volatile void *pointer)
+{
+    // Called before the block is released, so its size is still known
+    if (pointer) {
+        s_liveBytes.fetch_sub(static_cast<qint64>(__sanitizer_get_allocated_size(pointer)), std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+void PEFuzzBudget::install()
+{
+    s_timeLimitMs = limitFromEnvironment("PEHINT_FUZZ_TIME_MS", s_timeLimitMs, 1);
+    s_memoryLimitBytes = limitFromEnvironment("PEHINT_FUZZ_MEMORY_MB", s_memoryLimitBytes, 1024 * 1024);
+    __sanitizer_install_malloc_and_free_hooks(onMalloc, onFree);
+}
+
+qint64 PEFuzzBudget::timeLimitMs()
+{
+    return s_timeLimitMs;
+}
+
+qint64 PEFuzzBudget::memoryLimitBytes()
+{
+    return s_memoryLimitBytes;
+}
+
+PEFuzzBudget::Scope::Scope(const char *stage)
+    : m_stage(stage)
+{
+    s_stage = stage;
+    s_baselineBytes.store(s_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    s_active.store(true);
+    m_timer.start();
+}
+
+PEFuzzBudget::Scope::~Scope()
+{
+    s_active.store(false);
+
+    qint64 elapsed = m_timer.elapsed();
+    if (elapsed > s_timeLimitMs) {
+        std::fprintf(stderr, "==PEFuzzBudget== %s: took %lld ms, budget %lld ms\n",
+                     m_stage, static_cast<long long>(elapsed), static_cast<long long>(s_timeLimitMs));
+        std::abort();
+    }
+}
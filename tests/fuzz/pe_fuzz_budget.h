@@ -0,0 +1,52 @@
+#ifndef PE_FUZZ_BUDGET_H
+#define PE_FUZZ_BUDGET_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+/**
+ * @brief Per-input wall-time and allocation budgets for the fuzz harnesses
+ *
+ * libFuzzer only catches crashes, hangs (-timeout, whole seconds) and single
+ * huge allocations (-malloc_limit_mb). Inputs that finish but take a second
+ * instead of a millisecond, or that grow the heap to hundreds of MB through
+ * many small allocations, are just as bad for a batch worker, so every input
+ * runs inside a Scope that aborts the process once either budget is
+ * exceeded. libFuzzer then stores the input as a crash reproducer.
+ *
+ * Allocations are tracked through the sanitizer allocator hooks, so the
+ * harnesses must be built with AddressSanitizer. Limits are read from the
+ * environment once:
+ *
+ *   PEHINT_FUZZ_TIME_MS     Wall time per input in milliseconds (1000)
+ *   PEHINT_FUZZ_MEMORY_MB   Live heap growth per input in MB (256)
+ */
+class PEFuzzBudget
+{
+public:
+    /**
+     * @brief Reads the limits and installs the allocator hooks
+     *
+     * Call once from LLVMFuzzerInitialize().
+     */
+    static void install();
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char *stage);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_stage;
+        QElapsedTimer m_timer;
+    };
+
+    static qint64 timeLimitMs();
+    static qint64 memoryLimitBytes();
+};
+
+#endif // PE_FUZZ_BUDGET_H
@@ -0,0 +1,48 @@
+#include "pe_fuzz_seeds.h"
+#include "pe_synthetic_image.h"
+#include <QDir>
+
+int PEFuzzSeeds::write(const QString &directory)
+{
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        return -1;
+    }
+
+    // Kept small: libFuzzer mutates whole inputs, so every byte of padding
+    // dilutes the mutations that reach the tables
+    PESyntheticImage::Spec base;
+    base.textSize = 0x200;
+    base.importModules = 2;
+    base.importsPerModule = 4;
+    base.exportCount = 9;
+    base.forwardedExports = 1;
+    base.resourceDepth = 3;
+    base.resourceFanout = 2;
+    base.relocationCount = 8;
+    base.tlsCallbacks = 1;
+    base.certificateSize = 32;
+    base.overlaySize = 16;
+
+    const quint32 malformations[] = {
+        PESyntheticImage::NoMalformation, PESyntheticImage::TruncatedTail,
+        PESyntheticImage::SectionCountOverflow, PESyntheticImage::UnterminatedImports,
+        PESyntheticImage::ResourceLoop, PESyntheticImage::HugeCounts,
+        PESyntheticImage::DirectoriesOutOfRange, PESyntheticImage::CertificateBeyondFile
+    };
+
+    int written = 0;
+    for (bool pe64 : {false, true}) {
+        for (quint32 malformation : malformations) {
+            PESyntheticImage::Spec spec = base;
+            spec.pe64 = pe64;
+            spec.malformations = malformation;
+            QString name = QString("seed_%1_%2.exe").arg(pe64 ? "pe64" : "pe32").arg(malformation, 2, 16, QChar('0'));
+            if (!PESyntheticImage::write(spec, dir.filePath(name))) {
+                return -1;
+            }
+            ++written;
+        }
+    }
+    return written;
+}
@@ -0,0 +1,23 @@
+#ifndef PE_FUZZ_SEEDS_H
+#define PE_FUZZ_SEEDS_H
+
+#include <QString>
+
+/**
+ * @brief Seed corpus for the fuzz harnesses
+ *
+ * Small PE32 and PE32+ images from PESyntheticImage, one with every
+ * directory the parser understands and one per malformation, so coverage
+ * starts past the header checks instead of at the MZ signature.
+ */
+class PEFuzzSeeds
+{
+public:
+    /**
+     * @brief Writes the seed images into a directory, creating it if needed
+     * @return Number of images written, or -1 on error
+     */
+    static int write(const QString &directory);
+};
+
+#endif // PE_FUZZ_SEEDS_H
@@ -0,0 +1,45 @@
+// libFuzzer entry point for PESecurityAnalyzer::analyzeData() on top of a
+// parse of the same input, the way the UI runs it after loading a file
+//
+//   PEHintSecurityFuzzer -dict=pe.dict corpus/
+
+#include "pe_fuzz_budget.h"
+#include "pe_fuzz_seeds.h"
+#include "pe_parser_new.h"
+#include "pe_security_analyzer.h"
+#include <QCoreApplication>
+#include <QByteArray>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+PEParserNew *s_parser = nullptr;
+PESecurityAnalyzer *s_analyzer = nullptr;
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    static QCoreApplication app(*argc, *argv);
+
+    QString seedDirectory = qEnvironmentVariable("PEHINT_FUZZ_WRITE_SEEDS");
+    if (!seedDirectory.isEmpty() && PEFuzzSeeds::write(seedDirectory) < 0) {
+        std::fprintf(stderr, "Could not write seed corpus to %s\n", qPrintable(seedDirectory));
+    }
+
+    // The analyzer loads its configuration once, in the constructor
+    s_parser = new PEParserNew;
+    s_analyzer = new PESecurityAnalyzer;
+    PEFuzzBudget::install();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    const QByteArray input = QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size));
+
+    PEFuzzBudget::Scope budget("PESecurityAnalyzer::analyzeData");
+    bool parsed = s_parser->loadFromBuffer(input, QStringLiteral("fuzz-input"));
+    s_analyzer->analyzeData(input, parsed ? &s_parser->getDataModel() : nullptr);
+    s_parser->clear();
+    return 0;
+}
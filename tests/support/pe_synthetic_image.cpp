@@ -0,0 +1,627 @@
+/**
+ * @file pe_synthetic_image.cpp
+ * @brief Synthetic PE image generator implementation
+ */
+
+#include "pe_synthetic_image.h"
+#include "pe_structures.h"
+#include <QBuffer>
+#include <QFile>
+#include <QList>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+constexpr quint32 PE_OFFSET = 0x80;
+constexpr qint64 CHUNK_SIZE = 1024 * 1024;
+
+// xorshift32; every byte of content comes from one of these
+class Random
+{
+public:
+    explicit Random(quint32 seed) : m_state(seed ? seed : 0x2545F491) {}
+
+    quint32 next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    void fill(char *data, qint64 size)
+    {
+        for (qint64 i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(next() >> 24);
+        }
+    }
+
+private:
+    quint32 m_state;
+};
+
+struct SectionImage {
+    const char *name;
+    quint32 characteristics;
+    QByteArray content;
+    quint32 rva = 0;
+    quint32 virtualSize = 0;
+    quint32 rawSize = 0;
+    quint64 rawOffset = 0;
+    bool grown = false;     // Raw data past the content uses Spec::fill
+};
+
+struct Layout {
+    QByteArray headers;
+    QList<SectionImage> sections;
+    QByteArray certificate;
+    quint64 certificateOffset = 0;
+    quint64 overlaySize = 0;
+    quint64 totalSize = 0;
+};
+
+quint64 alignUp(quint64 value, quint64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename T>
+void put(QByteArray &buffer, qsizetype offset, const T &value)
+{
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T get(const QByteArray &buffer, qsizetype offset)
+{
+    T value;
+    std::memcpy(&value, buffer.constData() + offset, sizeof(T));
+    return value;
+}
+
+void alignBuffer(QByteArray &buffer, int alignment)
+{
+    buffer.append(QByteArray(alignUp(buffer.size(), alignment) - buffer.size(), '\0'));
+}
+
+QByteArray buildText(quint32 size, Random &random)
+{
+    // Code-like bytes: mostly pseudo-random with runs of int3 padding
+    QByteArray text(size, '\0');
+    random.fill(text.data(), size);
+    for (quint32 i = 0x38; i < size; i += 0x40) {
+        std::memset(text.data() + i, 0xCC, qMin<quint32>(8, size - i));
+    }
+    return text;
+}
+
+// Descriptors, then every INT, then every IAT (contiguous for the IAT
+// directory), then DLL names and hint/name entries
+void appendImports(QByteArray &rdata, quint32 baseRVA, const PESyntheticImage::Spec &spec,
+                   IMAGE_DATA_DIRECTORY &importDir, IMAGE_DATA_DIRECTORY &iatDir)
+{
+    const int modules = spec.importModules;
+    if (modules <= 0) {
+        return;
+    }
+    const int perModule = qMax(spec.importsPerModule, 0);
+    const quint32 pointerSize = spec.pe64 ? 8 : 4;
+    const quint32 tableSize = (perModule + 1) * pointerSize;
+    alignBuffer(rdata, 8);
+    const quint32 start = rdata.size();
+    const quint32 intStart = start + alignUp((modules + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR), 8);
+    const quint32 iatStart = intStart + modules * tableSize;
+    rdata.resize(iatStart + modules * tableSize, '\0');
+
+    for (int module = 0; module < modules; ++module) {
+        IMAGE_IMPORT_DESCRIPTOR descriptor = {};
+        descriptor.OriginalFirstThunk = baseRVA + intStart + module * tableSize;
+        descriptor.FirstThunk = baseRVA + iatStart + module * tableSize;
+        descriptor.Name = baseRVA + rdata.size();
+        rdata.append(QString("synth%1.dll").arg(module).toLatin1()).append('\0');
+
+        for (int function = 0; function < perModule; ++function) {
+            alignBuffer(rdata, 2);
+            quint64 thunk = baseRVA + rdata.size();
+            quint16 hint = static_cast<quint16>(function);
+            rdata.append(reinterpret_cast<const char*>(&hint), sizeof(hint));
+            rdata.append(QString("Function%1_%2").arg(module).arg(function).toLatin1()).append('\0');
+
+            qsizetype slot = module * tableSize + function * pointerSize;
+            std::memcpy(rdata.data() + intStart + slot, &thunk, pointerSize);
+            std::memcpy(rdata.data() + iatStart + slot, &thunk, pointerSize);
+        }
+        put(rdata, start + module * sizeof(IMAGE_IMPORT_DESCRIPTOR), descriptor);
+    }
+
+    if (spec.malformations & PESyntheticImage::UnterminatedImports) {
+        put(rdata, start + modules * sizeof(IMAGE_IMPORT_DESCRIPTOR), get<IMAGE_IMPORT_DESCRIPTOR>(rdata, start));
+    }
+
+    importDir.VirtualAddress = baseRVA + start;
+    importDir.Size = (modules + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR);
+    iatDir.VirtualAddress = baseRVA + iatStart;
+    iatDir.Size = modules * tableSize;
+}
+
+// Directory, function table, name table, ordinal table, then strings. The
+// strings of forwarded exports lie inside the directory range, which is
+// how the loader tells them from code RVAs.
+void appendExports(QByteArray &rdata, quint32 baseRVA, quint32 textRVA, const PESyntheticImage::Spec &spec,
+                   IMAGE_DATA_DIRECTORY &exportDir)
+{
+    const int count = spec.exportCount;
+    if (count <= 0) {
+        return;
+    }
+    QList<int> named;
+    for (int i = 0; i < count; ++i) {
+        if (i % 8 != 7) {
+            named.append(i);
+        }
+    }
+
+    alignBuffer(rdata, 8);
+    const quint32 start = rdata.size();
+    const quint32 functions = start + sizeof(IMAGE_EXPORT_DIRECTORY);
+    const quint32 names = functions + count * sizeof(quint32);
+    const quint32 ordinals = names + named.size() * sizeof(quint32);
+    rdata.resize(ordinals + named.size() * sizeof(quint16), '\0');
+
+    IMAGE_EXPORT_DIRECTORY directory = {};
+    directory.TimeDateStamp = 0x5F000000;
+    directory.Name = baseRVA + rdata.size();
+    rdata.append(spec.pe64 ? "synthetic64.dll" : "synthetic32.dll").append('\0');
+    directory.OrdinalBase = 1;
+    directory.NumberOfFunctions = count;
+    directory.NumberOfNames = named.size();
+    directory.AddressOfFunctions = baseRVA + functions;
+    directory.AddressOfNames = baseRVA + names;
+    directory.AddressOfNameOrdinals = baseRVA + ordinals;
+    if (spec.malformations & PESyntheticImage::HugeCounts) {
+        directory.NumberOfFunctions = 0xFFFFFFFF;
+        directory.NumberOfNames = 0xFFFFFFFF;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        quint32 rva = textRVA + (static_cast<quint32>(i) * 0x10) % qMax<quint32>(spec.textSize, 0x10);
+        if (i < spec.forwardedExports) {
+            rva = baseRVA + rdata.size();
+            rdata.append(QString("NTDLL.RtlFunction%1").arg(i).toLatin1()).append('\0');
+        }
+        put(rdata, functions + i * sizeof(quint32), rva);
+    }
+    // Fixed-width names keep the name table sorted, as the loader requires
+    for (int j = 0; j < named.size(); ++j) {
+        put(rdata, names + j * sizeof(quint32), quint32(baseRVA + rdata.size()));
+        put(rdata, ordinals + j * sizeof(quint16), static_cast<quint16>(named[j]));
+        rdata.append(QString("Export%1").arg(named[j], 7, 10, QChar('0')).toLatin1()).append('\0');
+    }
+    put(rdata, start, directory);
+
+    exportDir.VirtualAddress = baseRVA + start;
+    exportDir.Size = rdata.size() - start;
+}
+
+template <typename TlsDirectory>
+void appendTls(QByteArray &rdata, quint32 baseRVA, quint64 imageBase, quint32 textRVA,
+               const PESyntheticImage::Spec &spec, IMAGE_DATA_DIRECTORY &tlsDir)
+{
+    using Pointer = std::conditional_t<std::is_same_v<TlsDirectory, IMAGE_TLS_DIRECTORY64>, quint64, quint32>;
+    alignBuffer(rdata, 8);
+    const quint32 start = rdata.size();
+    const quint32 index = start + sizeof(TlsDirectory);
+    const quint32 rawData = index + 8;
+    const quint32 callbacks = rawData + 16;
+    rdata.resize(callbacks + (spec.tlsCallbacks + 1) * sizeof(Pointer), '\0');
+
+    TlsDirectory directory = {};
+    directory.StartAddressOfRawData = imageBase + baseRVA + rawData;
+    directory.EndAddressOfRawData = imageBase + baseRVA + rawData + 16;
+    directory.AddressOfIndex = imageBase + baseRVA + index;
+    directory.AddressOfCallBacks = imageBase + baseRVA + callbacks;
+    put(rdata, start, directory);
+    for (int i = 0; i < spec.tlsCallbacks; ++i) {
+        Pointer callback = imageBase + textRVA + (static_cast<quint32>(i) * 0x40) % qMax<quint32>(spec.textSize, 0x40);
+        put(rdata, callbacks + i * sizeof(Pointer), callback);
+    }
+
+    tlsDir.VirtualAddress = baseRVA + start;
+    tlsDir.Size = sizeof(TlsDirectory);
+}
+
+// Emits one directory and, depth first, everything below it
+quint32 appendResourceLevel(QByteArray &rsrc, quint32 baseRVA, int level, const PESyntheticImage::Spec &spec,
+                            Random &random)
+{
+    const int fanout = spec.resourceFanout;
+    const quint32 directoryOffset = rsrc.size();
+    IMAGE_RESOURCE_DIRECTORY directory = {};
+    directory.NumberOfIdEntries = static_cast<quint16>(fanout);
+    rsrc.append(reinterpret_cast<const char*>(&directory), sizeof(directory));
+    const qsizetype entriesOffset = rsrc.size();
+    rsrc.append(QByteArray(fanout * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), '\0'));
+
+    for (int i = 0; i < fanout; ++i) {
+        quint32 target;
+        if (level + 1 < spec.resourceDepth) {
+            target = appendResourceLevel(rsrc, baseRVA, level + 1, spec, random) | 0x80000000;
+        } else {
+            target = rsrc.size();
+            IMAGE_RESOURCE_DATA_ENTRY data = {};
+            data.OffsetToData = baseRVA + target + sizeof(IMAGE_RESOURCE_DATA_ENTRY);
+            data.Size = 16 + random.next() % 48;
+            rsrc.append(reinterpret_cast<const char*>(&data), sizeof(data));
+            QByteArray payload(alignUp(data.Size, 4), '\0');
+            random.fill(payload.data(), data.Size);
+            rsrc.append(payload);
+        }
+        const quint32 entry[2] = {static_cast<quint32>(i + 1), target};
+        std::memcpy(rsrc.data() + entriesOffset + i * sizeof(entry), entry, sizeof(entry));
+    }
+    return directoryOffset;
+}
+
+QByteArray buildResources(quint32 baseRVA, const PESyntheticImage::Spec &spec, Random &random)
+{
+    QByteArray rsrc;
+    appendResourceLevel(rsrc, baseRVA, 0, spec, random);
+
+    const qsizetype rootEntries = sizeof(IMAGE_RESOURCE_DIRECTORY);
+    if (spec.malformations & PESyntheticImage::ResourceLoop) {
+        // The last entry of the first subdirectory leads back to the root
+        quint32 firstTarget = get<quint32>(rsrc, rootEntries + sizeof(quint32));
+        qsizetype loopEntry = rootEntries;
+        if (firstTarget & 0x80000000) {
+            loopEntry = (firstTarget & 0x7FFFFFFF) + sizeof(IMAGE_RESOURCE_DIRECTORY)
+                      + (spec.resourceFanout - 1) * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+        }
+        put(rsrc, loopEntry + sizeof(quint32), quint32(0x80000000));
+    }
+    if (spec.malformations & PESyntheticImage::HugeCounts) {
+        put(rsrc, offsetof(IMAGE_RESOURCE_DIRECTORY, NumberOfNamedEntries), quint16(0xFFFF));
+        put(rsrc, offsetof(IMAGE_RESOURCE_DIRECTORY, NumberOfIdEntries), quint16(0xFFFF));
+    }
+    return rsrc;
+}
+
+// One block per 4 KB page of .text, entries padded to a 32-bit boundary
+QByteArray buildRelocations(quint32 textRVA, const PESyntheticImage::Spec &spec)
+{
+    const quint32 pointerSize = spec.pe64 ? 8 : 4;
+    const quint16 type = spec.pe64 ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW;
+    const quint64 span = qMax<quint32>(spec.textSize, pointerSize) - pointerSize;
+
+    QByteArray reloc;
+    qsizetype blockStart = -1;
+    quint32 blockPage = 0;
+    auto closeBlock = [&]() {
+        if (blockStart < 0) {
+            return;
+        }
+        alignBuffer(reloc, 4);
+        IMAGE_BASE_RELOCATION header = {blockPage, static_cast<quint32>(reloc.size() - blockStart)};
+        put(reloc, blockStart, header);
+    };
+
+    for (int i = 0; i < spec.relocationCount; ++i) {
+        quint32 offset = static_cast<quint32>(span * i / spec.relocationCount) & ~1u;
+        quint32 page = textRVA + (offset & ~0xFFFu);
+        if (blockStart < 0 || page != blockPage) {
+            closeBlock();
+            blockStart = reloc.size();
+            blockPage = page;
+            reloc.append(QByteArray(sizeof(IMAGE_BASE_RELOCATION), '\0'));
+        }
+        quint16 entry = static_cast<quint16>((type << 12) | (offset & 0xFFF));
+        reloc.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    closeBlock();
+    return reloc;
+}
+
+template <typename OptionalHeader>
+QByteArray buildHeaders(const PESyntheticImage::Spec &spec, const QList<SectionImage> &sections,
+                        const IMAGE_DATA_DIRECTORY (&directories)[16], quint32 sizeOfHeaders, quint64 imageBase)
+{
+    QByteArray headers(sizeOfHeaders, '\0');
+
+    IMAGE_DOS_HEADER dosHeader = {};
+    dosHeader.e_magic = IMAGE_DOS_SIGNATURE;
+    dosHeader.e_cblp = 0x90;
+    dosHeader.e_cp = 3;
+    dosHeader.e_cparhdr = 4;
+    dosHeader.e_maxalloc = 0xFFFF;
+    dosHeader.e_sp = 0xB8;
+    dosHeader.e_lfarlc = 0x40;
+    dosHeader.e_lfanew = PE_OFFSET;
+    put(headers, 0, dosHeader);
+    put(headers, PE_OFFSET, quint32(IMAGE_NT_SIGNATURE));
+
+    IMAGE_FILE_HEADER fileHeader = {};
+    fileHeader.Machine = spec.pe64 ? IMAGE_FILE_MACHINE_AMD64 : IMAGE_FILE_MACHINE_I386;
+    fileHeader.NumberOfSections = static_cast<quint16>(sections.size());
+    if (spec.malformations & PESyntheticImage::SectionCountOverflow) {
+        fileHeader.NumberOfSections = 0xFFFF;
+    }
+    fileHeader.TimeDateStamp = 0x5F000000;
+    fileHeader.SizeOfOptionalHeader = sizeof(OptionalHeader);
+    fileHeader.Characteristics = spec.pe64 ? 0x0022 : 0x0102;   // Executable, large address aware / 32-bit
+    if (spec.exportCount > 0) {
+        fileHeader.Characteristics |= 0x2000;                   // DLL
+    }
+    put(headers, PE_OFFSET + sizeof(quint32), fileHeader);
+
+    OptionalHeader optionalHeader = {};
+    optionalHeader.Magic = spec.pe64 ? IMAGE_NT_OPTIONAL_HDR64_MAGIC : IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    optionalHeader.MajorLinkerVersion = 14;
+    optionalHeader.SizeOfCode = sections.first().rawSize;
+    optionalHeader.AddressOfEntryPoint = sections.first().rva;
+    optionalHeader.BaseOfCode = sections.first().rva;
+    if constexpr (!std::is_same_v<OptionalHeader, IMAGE_OPTIONAL_HEADER64>) {
+        optionalHeader.BaseOfData = sections.size() > 1 ? sections[1].rva : 0;
+    }
+    optionalHeader.ImageBase = imageBase;
+    optionalHeader.SectionAlignment = PESyntheticImage::SECTION_ALIGNMENT;
+    optionalHeader.FileAlignment = PESyntheticImage::FILE_ALIGNMENT;
+    optionalHeader.MajorOperatingSystemVersion = 6;
+    optionalHeader.MajorSubsystemVersion = 6;
+    optionalHeader.SizeOfImage = alignUp(static_cast<quint64>(sections.last().rva) + sections.last().virtualSize,
+                                         PESyntheticImage::SECTION_ALIGNMENT);
+    optionalHeader.SizeOfHeaders = sizeOfHeaders;
+    optionalHeader.Subsystem = IMAGE_SUBSYSTEM_WINDOWS_CUI;
+    optionalHeader.DllCharacteristics = IMAGE_DLLCHARACTERISTICS_DYNAMIC_BASE | IMAGE_DLLCHARACTERISTICS_NX_COMPAT;
+    optionalHeader.SizeOfStackReserve = 0x100000;
+    optionalHeader.SizeOfStackCommit = 0x1000;
+    optionalHeader.SizeOfHeapReserve = 0x100000;
+    optionalHeader.SizeOfHeapCommit = 0x1000;
+    optionalHeader.NumberOfRvaAndSizes = 16;
+    std::memcpy(optionalHeader.DataDirectory, directories, sizeof(optionalHeader.DataDirectory));
+    if (spec.malformations & PESyntheticImage::DirectoriesOutOfRange) {
+        optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT].VirtualAddress = optionalHeader.SizeOfImage + 0x1000;
+        optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_RESOURCE].VirtualAddress = optionalHeader.SizeOfImage + 0x2000;
+    }
+    const quint32 optionalHeaderOffset = PE_OFFSET + sizeof(quint32) + sizeof(IMAGE_FILE_HEADER);
+    put(headers, optionalHeaderOffset, optionalHeader);
+
+    quint32 sectionHeaderOffset = optionalHeaderOffset + sizeof(OptionalHeader);
+    for (const SectionImage &section : sections) {
+        IMAGE_SECTION_HEADER header = {};
+        std::strncpy(header.Name, section.name, sizeof(header.Name));
+        header.Misc.VirtualSize = section.virtualSize;
+        header.VirtualAddress = section.rva;
+        header.SizeOfRawData = section.rawSize;
+        header.PointerToRawData = static_cast<quint32>(section.rawOffset);
+        header.Characteristics = section.characteristics;
+        put(headers, sectionHeaderOffset, header);
+        sectionHeaderOffset += sizeof(IMAGE_SECTION_HEADER);
+    }
+    return headers;
+}
+
+Layout layoutImage(const PESyntheticImage::Spec &spec)
+{
+    Layout layout;
+    QList<SectionImage> &sections = layout.sections;
+    Random random(spec.seed);
+    IMAGE_DATA_DIRECTORY directories[16] = {};
+    const quint64 imageBase = spec.pe64 ? 0x140000000ULL : 0x400000ULL;
+
+    const bool hasResources = spec.resourceDepth > 0 && spec.resourceFanout > 0;
+    const bool hasRelocations = spec.relocationCount > 0;
+    const int sectionCount = qMax(spec.sectionCount, 2 + int(hasResources) + int(hasRelocations));
+    const quint32 headerSize = PE_OFFSET + sizeof(quint32) + sizeof(IMAGE_FILE_HEADER)
+                             + (spec.pe64 ? sizeof(IMAGE_OPTIONAL_HEADER64) : sizeof(IMAGE_OPTIONAL_HEADER32))
+                             + sectionCount * sizeof(IMAGE_SECTION_HEADER);
+    const quint32 sizeOfHeaders = alignUp(headerSize, PESyntheticImage::FILE_ALIGNMENT);
+
+    quint32 nextRVA = alignUp(sizeOfHeaders, PESyntheticImage::SECTION_ALIGNMENT);
+    auto place = [&](SectionImage &section) {
+        section.rva = nextRVA;
+        section.virtualSize = qMax<quint32>(section.content.size(), 1);
+        nextRVA = alignUp(static_cast<quint64>(section.rva) + section.virtualSize, PESyntheticImage::SECTION_ALIGNMENT);
+    };
+
+    sections.append({".text", IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ,
+                     buildText(spec.textSize, random)});
+    place(sections.last());
+    const quint32 textRVA = sections.last().rva;
+
+    sections.append({".rdata", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ, QByteArray()});
+    QByteArray &rdata = sections.last().content;
+    appendImports(rdata, nextRVA, spec, directories[IMAGE_DIRECTORY_ENTRY_IMPORT], directories[IMAGE_DIRECTORY_ENTRY_IAT]);
+    appendExports(rdata, nextRVA, textRVA, spec, directories[IMAGE_DIRECTORY_ENTRY_EXPORT]);
+    if (spec.tlsCallbacks > 0) {
+        if (spec.pe64) {
+            appendTls<IMAGE_TLS_DIRECTORY64>(rdata, nextRVA, imageBase, textRVA, spec, directories[IMAGE_DIRECTORY_ENTRY_TLS]);
+        } else {
+            appendTls<IMAGE_TLS_DIRECTORY32>(rdata, nextRVA, imageBase, textRVA, spec, directories[IMAGE_DIRECTORY_ENTRY_TLS]);
+        }
+    }
+    place(sections.last());
+
+    if (hasResources) {
+        sections.append({".rsrc", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ, buildResources(nextRVA, spec, random)});
+        directories[IMAGE_DIRECTORY_ENTRY_RESOURCE] = {nextRVA, static_cast<quint32>(sections.last().content.size())};
+        place(sections.last());
+    }
+
+    if (hasRelocations) {
+        sections.append({".reloc", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_DISCARDABLE,
+                         buildRelocations(textRVA, spec)});
+        directories[IMAGE_DIRECTORY_ENTRY_BASERELOC] = {nextRVA, static_cast<quint32>(sections.last().content.size())};
+        place(sections.last());
+    }
+
+    const int contentSections = sections.size();
+    while (sections.size() < sectionCount) {
+        sections.append({".data", IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_WRITE,
+                         QByteArray(PESyntheticImage::FILE_ALIGNMENT, '\0')});
+        place(sections.last());
+    }
+
+    quint64 rawOffset = sizeOfHeaders;
+    for (SectionImage &section : sections) {
+        section.rawOffset = rawOffset;
+        section.rawSize = alignUp(section.content.size(), PESyntheticImage::FILE_ALIGNMENT);
+        rawOffset += section.rawSize;
+    }
+
+    // Grow the last filler; RVAs and SizeOfImage stay well inside 32 bits
+    SectionImage &last = sections.last();
+    if (spec.fileSize > rawOffset && sections.size() > contentSections) {
+        quint64 limit = 0x7FFF0000ULL - last.rva;
+        quint64 grown = qMin<quint64>(spec.fileSize - last.rawOffset, limit) & ~quint64(PESyntheticImage::FILE_ALIGNMENT - 1);
+        if (grown > last.rawSize) {
+            rawOffset += grown - last.rawSize;
+            last.rawSize = grown;
+            last.virtualSize = grown;
+            last.grown = true;
+        }
+    }
+
+    if (spec.certificateSize > 0) {
+        const quint32 length = 8 + spec.certificateSize;
+        layout.certificate = QByteArray(alignUp(length, 8), '\0');
+        put(layout.certificate, 0, length);
+        put(layout.certificate, 4, quint16(0x0200));
+        put(layout.certificate, 6, quint16(WIN_CERT_TYPE_PKCS_SIGNED_DATA));
+        random.fill(layout.certificate.data() + 8, spec.certificateSize);
+        layout.certificateOffset = alignUp(rawOffset, 8);
+        directories[IMAGE_DIRECTORY_ENTRY_SECURITY] = {static_cast<quint32>(layout.certificateOffset),
+                                                       static_cast<quint32>(layout.certificate.size())};
+        if (spec.malformations & PESyntheticImage::CertificateBeyondFile) {
+            directories[IMAGE_DIRECTORY_ENTRY_SECURITY].Size += 0x10000000;
+        }
+        rawOffset = layout.certificateOffset + layout.certificate.size();
+    }
+
+    // The overlay takes up what the aligned, 32-bit-limited section growth cannot
+    layout.overlaySize = qMax<quint64>(spec.overlaySize, spec.fileSize > rawOffset ? spec.fileSize - rawOffset : 0);
+    layout.totalSize = rawOffset + spec.overlaySize;
+    if (spec.malformations & PESyntheticImage::TruncatedTail) {
+        layout.totalSize = last.rawOffset + last.rawSize / 2;
+    }
+
+    layout.headers = spec.pe64
+        ? buildHeaders<IMAGE_OPTIONAL_HEADER64>(spec, sections, directories, sizeOfHeaders, imageBase)
+        : buildHeaders<IMAGE_OPTIONAL_HEADER32>(spec, sections, directories, sizeOfHeaders, imageBase);
+    return layout;
+}
+
+// Writes front to back and stops at the layout's total size
+class ChunkWriter
+{
+public:
+    ChunkWriter(QIODevice &device, quint64 limit, quint32 seed)
+        : m_device(device)
+        , m_file(qobject_cast<QFile*>(&device))
+        , m_limit(limit)
+        , m_random(seed ^ 0x9E3779B9)
+    {
+        if (m_file && m_file->isSequential()) {
+            m_file = nullptr;
+        }
+    }
+
+    bool write(const char *data, quint64 size)
+    {
+        size = qMin(size, m_limit - m_written);
+        if (size > 0 && m_device.write(data, static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+            return false;
+        }
+        m_written += size;
+        return true;
+    }
+
+    bool write(const QByteArray &data) { return write(data.constData(), data.size()); }
+
+    bool fill(quint64 size, PESyntheticImage::Fill fill)
+    {
+        size = qMin(size, m_limit - m_written);
+        if (fill == PESyntheticImage::Fill::Zero && m_file) {
+            if (!m_file->seek(m_file->pos() + static_cast<qint64>(size))) {
+                return false;
+            }
+            m_written += size;
+            return true;
+        }
+
+        QByteArray chunk(qMin<quint64>(size, CHUNK_SIZE), '\0');
+        while (size > 0) {
+            const quint64 part = qMin<quint64>(size, chunk.size());
+            if (fill == PESyntheticImage::Fill::Random) {
+                m_random.fill(chunk.data(), static_cast<qint64>(part));
+            }
+            if (!write(chunk.constData(), part)) {
+                return false;
+            }
+            size -= part;
+        }
+        return true;
+    }
+
+    // Zero fill skipped at the very end leaves the file short
+    bool finish()
+    {
+        return !m_file || m_file->size() >= static_cast<qint64>(m_written) || m_file->resize(m_written);
+    }
+
+    quint64 written() const { return m_written; }
+
+private:
+    QIODevice &m_device;
+    QFile *m_file;
+    quint64 m_limit;
+    quint64 m_written = 0;
+    Random m_random;
+};
+
+} // namespace
+
+QByteArray PESyntheticImage::build(const Spec &spec)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    stream(spec, buffer);
+    return buffer.data();
+}
+
+qint64 PESyntheticImage::stream(const Spec &spec, QIODevice &device)
+{
+    const Layout layout = layoutImage(spec);
+    ChunkWriter writer(device, layout.totalSize, spec.seed);
+
+    bool ok = writer.write(layout.headers);
+    for (const SectionImage &section : layout.sections) {
+        ok = ok && writer.write(section.content);
+        const quint64 aligned = alignUp(section.content.size(), FILE_ALIGNMENT);
+        ok = ok && writer.fill(aligned - section.content.size(), Fill::Zero);
+        if (section.rawSize > aligned) {
+            ok = ok && writer.fill(section.rawSize - aligned, section.grown ? spec.fill : Fill::Zero);
+        }
+    }
+    if (!layout.certificate.isEmpty()) {
+        ok = ok && writer.fill(layout.certificateOffset - qMin(writer.written(), layout.certificateOffset), Fill::Zero);
+        ok = ok && writer.write(layout.certificate);
+    }
+    ok = ok && writer.fill(layout.overlaySize, spec.fill);
+    ok = ok && writer.finish();
+    return ok ? static_cast<qint64>(writer.written()) : -1;
+}
+
+bool PESyntheticImage::write(const Spec &spec, const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return stream(spec, file) >= 0;
+}
+
+quint64 PESyntheticImage::imageSize(const Spec &spec)
+{
+    return layoutImage(spec).totalSize;
+}
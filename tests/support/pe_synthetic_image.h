@@ -0,0 +1,98 @@
+/**
+ * @file pe_synthetic_image.h
+ * @brief Deterministic generator of synthetic PE32/PE32+ images
+ *
+ * Images are laid out like linker output: headers, then .text, .rdata
+ * (imports, exports, TLS), .rsrc, .reloc and as many .data filler sections
+ * as needed to reach the requested section count, at FileAlignment 0x200
+ * and SectionAlignment 0x1000. The certificate table and the overlay follow
+ * the last section. Every byte is derived from the Spec, including its
+ * seed, so the same Spec always produces the same image.
+ *
+ * Malformations are applied on top of an otherwise valid layout, so each
+ * one exercises exactly one defensive path of a parser.
+ *
+ * stream() writes the image front to back in bounded chunks; only the
+ * structured parts are held in memory, never the padding or the overlay.
+ */
+
+#ifndef PE_SYNTHETIC_IMAGE_H
+#define PE_SYNTHETIC_IMAGE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QtGlobal>
+
+class PESyntheticImage
+{
+public:
+    enum Malformation : quint32 {
+        NoMalformation = 0,
+        TruncatedTail = 0x01,           ///< Image ends halfway through the last section
+        SectionCountOverflow = 0x02,    ///< NumberOfSections claims 0xFFFF sections
+        UnterminatedImports = 0x04,     ///< Null import descriptor replaced by a copy of the first
+        ResourceLoop = 0x08,            ///< A resource subdirectory points back at the root
+        HugeCounts = 0x10,              ///< Export and resource counts set to their maximums
+        DirectoriesOutOfRange = 0x20,   ///< Import and resource RVAs point past SizeOfImage
+        CertificateBeyondFile = 0x40    ///< Security directory size exceeds the file
+    };
+
+    enum class Fill {
+        Zero,       ///< Written sparsely to files where possible
+        Random      ///< Seeded pseudo-random bytes, for real I/O
+    };
+
+    struct Spec {
+        quint32 seed = 1;
+        bool pe64 = false;
+        int sectionCount = 4;           ///< At least the sections needed for the content below
+        quint32 textSize = 0x10000;     ///< Raw size of .text
+
+        int importModules = 4;
+        int importsPerModule = 32;      ///< Name-imported thunks per module
+        int exportCount = 0;            ///< Every eighth export is ordinal-only
+        int forwardedExports = 0;       ///< Leading exports forwarded to NTDLL
+        int resourceDepth = 3;          ///< Directory levels; 0 omits .rsrc
+        int resourceFanout = 4;         ///< Entries per resource directory
+        int relocationCount = 0;        ///< Base relocations spread over .text
+        int tlsCallbacks = 0;           ///< > 0 adds a TLS directory
+        quint32 certificateSize = 0;    ///< WIN_CERTIFICATE payload bytes, 0 for none
+        quint64 overlaySize = 0;        ///< Bytes after the certificate table
+
+        quint64 fileSize = 0;           ///< Grow the last .data section towards this size, the overlay up to it; 0 for none
+        Fill fill = Fill::Zero;         ///< Content of that growth and of the overlay
+        quint32 malformations = NoMalformation;
+    };
+
+    /**
+     * @brief Builds the whole image in memory
+     *
+     * Meant for small images; use stream() or write() for large ones.
+     */
+    static QByteArray build(const Spec &spec);
+
+    /**
+     * @brief Writes the image to an open device
+     * @return Bytes written, or -1 on a write error
+     */
+    static qint64 stream(const Spec &spec, QIODevice &device);
+
+    /**
+     * @brief Writes the image to a file
+     *
+     * Zero fill is skipped over rather than written, which most file
+     * systems store sparsely, so multi-GB inputs are cheap to create.
+     */
+    static bool write(const Spec &spec, const QString &filePath);
+
+    /**
+     * @brief Size stream() will write for a spec
+     */
+    static quint64 imageSize(const Spec &spec);
+
+    static const quint32 FILE_ALIGNMENT = 0x200;
+    static const quint32 SECTION_ALIGNMENT = 0x1000;
+};
+
+#endif // PE_SYNTHETIC_IMAGE_H
@@ -122,6 +122,83 @@ void PEDataModelTest::testExports()
     QVERIFY(model.getExports().contains("ExportFunction1"));
 }
 
+void PEDataModelTest::testResourceEntries()
+{
+    PEDataModel model;
+    
+    PEDataModel::ResourceEntry icon;
+    icon.typeId = 3; // RT_ICON
+    icon.nameId = 1;
+    icon.languageId = 0x0409;
+    icon.dataRVA = 0x5000;
+    icon.fileOffset = 0x2000;
+    icon.size = 0x468;
+    
+    PEDataModel::ResourceEntry manifest;
+    manifest.typeId = 24; // RT_MANIFEST
+    manifest.name = "APP";
+    manifest.dataRVA = 0x5468;
+    manifest.size = 0x17D;
+    
+    model.setResourceEntries({icon, manifest});
+    
+    QCOMPARE(model.getResourceEntries().size(), 2);
+    QCOMPARE(model.getResourceEntries().at(0).languageId, static_cast<quint16>(0x0409));
+    QCOMPARE(model.getResourceEntries().at(1).name, QString("APP"));
+    
+    model.clear();
+    QVERIFY(model.getResourceEntries().isEmpty());
+}
+
+void PEDataModelTest::testRelocationRangeQuery()
+{
+    PEDataModel model;
+    
+    QList<quint64> relocations;
+    relocations << ((0x1000ULL << 8) | IMAGE_REL_BASED_DIR64)
+                << ((0x1008ULL << 8) | IMAGE_REL_BASED_DIR64)
+                << ((0x2000ULL << 8) | IMAGE_REL_BASED_HIGHLOW)
+                << ((0x2FF8ULL << 8) | IMAGE_REL_BASED_DIR64);
+    model.setRelocations(relocations);
+    
+    QList<quint64> page = model.getRelocationsInRange(0x1000, 0x2000);
+    QCOMPARE(page.size(), 2);
+    QCOMPARE(PEDataModel::relocationRVA(page.at(1)), 0x1008u);
+    QCOMPARE(PEDataModel::relocationType(page.at(1)), static_cast<quint8>(IMAGE_REL_BASED_DIR64));
+    
+    QCOMPARE(model.getRelocationsInRange(0x2000, 0x3000).size(), 2);
+    QVERIFY(model.getRelocationsInRange(0x3000, 0x4000).isEmpty());
+    QVERIFY(model.getRelocationsInRange(0x2000, 0x2000).isEmpty());
+}
+
+void PEDataModelTest::testRuntimeFunctionLookup()
+{
+    PEDataModel model;
+    
+    QList<PEDataModel::RuntimeFunctionEntry> functions;
+    PEDataModel::RuntimeFunctionEntry function;
+    function.beginAddress = 0x1000;
+    function.endAddress = 0x1040;
+    functions << function;
+    function.beginAddress = 0x1040;
+    function.endAddress = 0x10A0;
+    functions << function;
+    function.beginAddress = 0x1200;
+    function.endAddress = 0x1210;
+    functions << function;
+    model.setRuntimeFunctions(functions);
+    
+    QCOMPARE(model.findRuntimeFunction(0x1000), 0);
+    QCOMPARE(model.findRuntimeFunction(0x1040), 1);
+    QCOMPARE(model.findRuntimeFunction(0x109F), 1);
+    QCOMPARE(model.findRuntimeFunction(0x1205), 2);
+    
+    // Gaps between functions and addresses outside the table
+    QCOMPARE(model.findRuntimeFunction(0x10A0), -1);
+    QCOMPARE(model.findRuntimeFunction(0x0FFF), -1);
+    QCOMPARE(model.findRuntimeFunction(0x1210), -1);
+}
+
 void PEDataModelTest::testClear()
 {
     PEDataModel model;
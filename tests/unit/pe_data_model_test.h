@@ -29,6 +29,15 @@ private slots:
     void testImports();
     void testExports();
     
+    // Resource tests
+    void testResourceEntries();
+    
+    // Relocation tests
+    void testRelocationRangeQuery();
+    
+    // Exception directory tests
+    void testRuntimeFunctionLookup();
+    
     // Data model state tests
     void testClear();
     void testValidState();
@@ -1,9 +1,20 @@
 #include "pe_parser_test.h"
 #include "pe_utils.h"
 #include "pe_structures.h"
+#include "pe_data_directory_parser.h"
+#include "pe_clr_metadata.h"
+#include "pe_export_index.h"
+#include "pe_synthetic_image.h"
+#include "pe_embedded_scanner.h"
 #include <QFile>
 #include <QDir>
+#include <QFileInfo>
 #include <QDebug>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <cstddef>
+#include <cstring>
 
 void PEParserTest::initTestCase()
 {
@@ -100,6 +111,582 @@ void PEParserTest::testDataDirectoryParsing()
     QVERIFY(true);
 }
 
+void PEParserTest::testDebugEntryDecoding()
+{
+    QByteArray data(0x200, '\0');
+    auto putDword = [&data](int offset, quint32 value) {
+        memcpy(data.data() + offset, &value, sizeof(value));
+    };
+    auto putBytes = [&data](int offset, const QByteArray &bytes) {
+        memcpy(data.data() + offset, bytes.constData(), bytes.size());
+    };
+    
+    // RSDS record at 0x40
+    putDword(0x40, CV_SIGNATURE_RSDS);
+    putBytes(0x44, QByteArray::fromHex("b9db443817206749be7aa4a2c20430fa"));
+    putDword(0x54, 2);
+    putBytes(0x58, QByteArray("C:\\build\\app.pdb"));
+    
+    // POGO records at 0x100; the second record starts at the next 4-byte boundary
+    putDword(0x100, POGO_SIGNATURE_PGU);     // Bytes 00 'U' 'G' 'P' on disk
+    putDword(0x104, 0x1000);
+    putDword(0x108, 0x20);
+    putBytes(0x10C, QByteArray(".text$mn"));
+    putDword(0x118, 0x2000);
+    putDword(0x11C, 0x10);
+    putBytes(0x120, QByteArray(".rdata"));
+    
+    putDword(0x180, IMAGE_DLLCHARACTERISTICS_EX_CET_COMPAT | IMAGE_DLLCHARACTERISTICS_EX_FORWARD_CFI_COMPAT);
+    
+    putDword(0x190, 32);
+    putBytes(0x194, QByteArray(32, '\xAB'));
+    
+    PEDataDirectoryParser parser(data);
+    IMAGE_DEBUG_DIRECTORY debugDir = {};
+    
+    debugDir.Type = IMAGE_DEBUG_TYPE_CODEVIEW;
+    debugDir.SizeOfData = 0x18 + 18;
+    debugDir.PointerToRawData = 0x40;
+    PEDataModel::DebugEntry codeView = parser.decodeDebugEntry(debugDir);
+    QCOMPARE(codeView.codeViewFormat, QString("RSDS"));
+    QCOMPARE(codeView.pdbGuid, QString("{3844DBB9-2017-4967-BE7A-A4A2C20430FA}"));
+    QCOMPARE(codeView.pdbAge, quint32(2));
+    QCOMPARE(codeView.pdbPath, QString("C:\\build\\app.pdb"));
+    QCOMPARE(codeView.pdbKey, QString("3844DBB920174967BE7AA4A2C20430FA2"));
+    
+    debugDir.Type = IMAGE_DEBUG_TYPE_POGO;
+    debugDir.SizeOfData = 0x27;
+    debugDir.PointerToRawData = 0x100;
+    PEDataModel::DebugEntry pogo = parser.decodeDebugEntry(debugDir);
+    QCOMPARE(pogo.pogoFormat, QString("PGU"));
+    QCOMPARE(pogo.pogoEntries.size(), 2);
+    QCOMPARE(pogo.pogoEntries[0].name, QString(".text$mn"));
+    QCOMPARE(pogo.pogoEntries[1].rva, quint32(0x2000));
+    QCOMPARE(pogo.pogoEntries[1].name, QString(".rdata"));
+    
+    putDword(0x100, POGO_SIGNATURE_LTCG);
+    QCOMPARE(parser.decodeDebugEntry(debugDir).pogoFormat, QString("LTCG"));
+    
+    debugDir.Type = IMAGE_DEBUG_TYPE_EX_DLLCHARACTERISTICS;
+    debugDir.SizeOfData = 4;
+    debugDir.PointerToRawData = 0x180;
+    QCOMPARE(parser.decodeDebugEntry(debugDir).exDllCharacteristics, quint32(0x41));
+    
+    debugDir.Type = IMAGE_DEBUG_TYPE_REPRO;
+    debugDir.SizeOfData = 36;
+    debugDir.PointerToRawData = 0x190;
+    QCOMPARE(parser.decodeDebugEntry(debugDir).reproHash, QByteArray(32, '\xAB'));
+    
+    // A payload running past the end of the file is clamped, not read
+    debugDir.Type = IMAGE_DEBUG_TYPE_CODEVIEW;
+    debugDir.SizeOfData = 0x1000;
+    debugDir.PointerToRawData = 0x1F8;
+    QVERIFY(parser.decodeDebugEntry(debugDir).codeViewFormat.isEmpty());
+}
+
+void PEParserTest::testTLSCallbackEnumeration()
+{
+    // .text at RVA 0x1000 (file 0x200), .data at RVA 0x2000 (file 0x300)
+    QByteArray data(0x400, '\0');
+    IMAGE_SECTION_HEADER text = {};
+    memcpy(text.Name, ".text", 5);
+    text.Misc.VirtualSize = 0x100;
+    text.VirtualAddress = 0x1000;
+    text.SizeOfRawData = 0x100;
+    text.PointerToRawData = 0x200;
+    text.Characteristics = IMAGE_SCN_MEM_EXECUTE;
+    IMAGE_SECTION_HEADER dataSection = {};
+    memcpy(dataSection.Name, ".data", 5);
+    dataSection.Misc.VirtualSize = 0x100;
+    dataSection.VirtualAddress = 0x2000;
+    dataSection.SizeOfRawData = 0x100;
+    dataSection.PointerToRawData = 0x300;
+    
+    IMAGE_OPTIONAL_HEADER64 optionalHeader = {};
+    optionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    optionalHeader.ImageBase = 0x140000000ULL;
+    
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    model.addSection(&text);
+    model.addSection(&dataSection);
+    
+    // TLS directory at the start of .data; the callback array follows at RVA 0x2040
+    IMAGE_TLS_DIRECTORY64 tlsDir = {};
+    tlsDir.AddressOfCallBacks = 0x140002040ULL;
+    memcpy(data.data() + 0x300, &tlsDir, sizeof(tlsDir));
+    const quint64 callbackVAs[] = {0x140001010ULL, 0x140002080ULL, 0x100ULL, 0};
+    memcpy(data.data() + 0x340, callbackVAs, sizeof(callbackVAs));
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseTLSDirectory(0x2000, sizeof(IMAGE_TLS_DIRECTORY64), model));
+    
+    const QList<PEDataModel::TLSCallbackEntry> &callbacks = model.getTLSCallbacks();
+    QCOMPARE(callbacks.size(), 3);
+    QCOMPARE(callbacks[0].rva, quint32(0x1010));
+    QCOMPARE(callbacks[0].fileOffset, quint32(0x340));
+    QCOMPARE(callbacks[0].sectionIndex, 0);
+    QVERIFY(callbacks[0].executable);
+    QCOMPARE(callbacks[1].sectionIndex, 1);
+    QVERIFY(!callbacks[1].executable);
+    QCOMPARE(callbacks[2].rva, quint32(0));
+    QCOMPARE(callbacks[2].sectionIndex, -1);
+    
+    // An array without a terminator stops at the end of its section's raw data
+    QByteArray unterminated(0x400, '\x11');
+    memcpy(unterminated.data() + 0x300, &tlsDir, sizeof(tlsDir));
+    PEDataDirectoryParser unterminatedParser(unterminated);
+    QVERIFY(unterminatedParser.parseTLSDirectory(0x2000, sizeof(IMAGE_TLS_DIRECTORY64), model));
+    QCOMPARE(model.getTLSCallbacks().size(), (0x400 - 0x340) / 8);
+}
+
+void PEParserTest::testExceptionDirectory()
+{
+    // .text at RVA 0x1000 (file 0x200), .rdata with the table and unwind data at RVA 0x2000 (file 0x300)
+    QByteArray data(0x400, '\0');
+    IMAGE_SECTION_HEADER text = {};
+    memcpy(text.Name, ".text", 5);
+    text.Misc.VirtualSize = 0x100;
+    text.VirtualAddress = 0x1000;
+    text.SizeOfRawData = 0x100;
+    text.PointerToRawData = 0x200;
+    text.Characteristics = IMAGE_SCN_MEM_EXECUTE;
+    IMAGE_SECTION_HEADER rdata = {};
+    memcpy(rdata.Name, ".rdata", 6);
+    rdata.Misc.VirtualSize = 0x100;
+    rdata.VirtualAddress = 0x2000;
+    rdata.SizeOfRawData = 0x100;
+    rdata.PointerToRawData = 0x300;
+    
+    PEDataModel model;
+    model.addSection(&text);
+    model.addSection(&rdata);
+    
+    // Out of order, with zero padding at the end; the last entry chains
+    // through bit 0 of its unwind address to the entry at RVA 0x2000
+    const IMAGE_RUNTIME_FUNCTION_ENTRY entries[] = {
+        {0x1040, 0x1080, 0x2060},
+        {0x1000, 0x1040, 0x2050},
+        {0x1080, 0x10C0, 0x2001},
+        {0, 0, 0}
+    };
+    memcpy(data.data() + 0x300, entries, sizeof(entries));
+    
+    // Version 1 with an exception handler: one code, padded to two slots, then the handler RVA
+    const quint8 handlerInfo[] = {0x01 | UNW_FLAG_EHANDLER << 3, 4, 1, 0, 0x04, 0x42, 0, 0, 0x10, 0x10, 0, 0};
+    memcpy(data.data() + 0x350, handlerInfo, sizeof(handlerInfo));
+    // Chained: no codes, the parent RUNTIME_FUNCTION follows the header
+    const quint8 chainedInfo[] = {0x01 | UNW_FLAG_CHAININFO << 3, 0, 0, 0};
+    memcpy(data.data() + 0x360, chainedInfo, sizeof(chainedInfo));
+    memcpy(data.data() + 0x364, &entries[1], sizeof(entries[1]));
+    // Four codes announced, but the file ends after the header
+    const quint8 truncatedInfo[] = {0x01, 0, 4, 0};
+    memcpy(data.data() + 0x3FC, truncatedInfo, sizeof(truncatedInfo));
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseExceptionDirectory(0x2000, sizeof(entries), model));
+    
+    const QList<PEDataModel::RuntimeFunctionEntry> &functions = model.getRuntimeFunctions();
+    QCOMPARE(functions.size(), 3);
+    QCOMPARE(functions[0].beginAddress, quint32(0x1000));
+    QCOMPARE(functions[1].beginAddress, quint32(0x1040));
+    QCOMPARE(functions[2].beginAddress, quint32(0x1080));
+    QCOMPARE(model.findRuntimeFunction(0x1050), 1);
+    
+    PEDataModel::UnwindInfoEntry handler = parser.readUnwindInfo(functions[0], model.getSections());
+    QVERIFY(handler.valid);
+    QCOMPARE(handler.version, quint8(1));
+    QCOMPARE(handler.flags, quint8(UNW_FLAG_EHANDLER));
+    QCOMPARE(handler.sizeOfProlog, quint8(4));
+    QCOMPARE(handler.unwindCodes, QList<quint16>({0x4204}));
+    QCOMPARE(handler.exceptionHandlerRVA, quint32(0x1010));
+    
+    PEDataModel::UnwindInfoEntry chained = parser.readUnwindInfo(functions[1], model.getSections());
+    QVERIFY(chained.valid);
+    QCOMPARE(chained.flags, quint8(UNW_FLAG_CHAININFO));
+    QCOMPARE(chained.chainedFunction.beginAddress, quint32(0x1000));
+    QCOMPARE(chained.chainedFunction.unwindData, quint32(0x2050));
+    
+    PEDataModel::UnwindInfoEntry indirect = parser.readUnwindInfo(functions[2], model.getSections());
+    QVERIFY(indirect.valid);
+    QCOMPARE(indirect.flags, quint8(UNW_FLAG_CHAININFO));
+    QCOMPARE(indirect.chainedFunction.beginAddress, quint32(0x1040));
+    QCOMPARE(indirect.chainedFunction.unwindData, quint32(0x2060));
+    
+    // Codes past the end of the file, and a header outside every section
+    PEDataModel::RuntimeFunctionEntry truncated = {0x10C0, 0x10D0, 0x20FC};
+    QVERIFY(!parser.readUnwindInfo(truncated, model.getSections()).valid);
+    PEDataModel::RuntimeFunctionEntry unmapped = {0x10C0, 0x10D0, 0x3000};
+    QVERIFY(!parser.readUnwindInfo(unmapped, model.getSections()).valid);
+}
+
+void PEParserTest::testLoadConfigGuardTables()
+{
+    // .rdata at RVA 0x1000 (file 0x200) holds the directory and its tables
+    QByteArray data(0x600, '\0');
+    IMAGE_SECTION_HEADER rdata = {};
+    memcpy(rdata.Name, ".rdata", 6);
+    rdata.Misc.VirtualSize = 0x400;
+    rdata.VirtualAddress = 0x1000;
+    rdata.SizeOfRawData = 0x400;
+    rdata.PointerToRawData = 0x200;
+    
+    IMAGE_OPTIONAL_HEADER64 optionalHeader = {};
+    optionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    optionalHeader.ImageBase = 0x140000000ULL;
+    
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    model.addSection(&rdata);
+    
+    // One metadata byte per guard table entry
+    IMAGE_LOAD_CONFIG_DIRECTORY64 loadConfig = {};
+    loadConfig.Size = offsetof(IMAGE_LOAD_CONFIG_DIRECTORY64, GuardEHContinuationCount) + sizeof(quint64);
+    loadConfig.GuardFlags = IMAGE_GUARD_CF_INSTRUMENTED | IMAGE_GUARD_CF_FUNCTION_TABLE_PRESENT |
+                            (1u << IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+    loadConfig.GuardCFFunctionTable = 0x140001200ULL;
+    loadConfig.GuardCFFunctionCount = 3;
+    loadConfig.GuardLongJumpTargetTable = 0x140001300ULL;
+    loadConfig.GuardLongJumpTargetCount = 1;
+    loadConfig.GuardEHContinuationTable = 0x1400013F6ULL;  // Room for two entries before the end of the file
+    loadConfig.GuardEHContinuationCount = 4;
+    memcpy(data.data() + 0x200, &loadConfig, sizeof(loadConfig));
+    
+    const quint8 functionTable[] = {
+        0x00, 0x30, 0x00, 0x00, 0x00,
+        0x10, 0x20, 0x00, 0x00, IMAGE_GUARD_FLAG_FID_SUPPRESSED,
+        0x40, 0x20, 0x00, 0x00, IMAGE_GUARD_FLAG_EXPORT_SUPPRESSED
+    };
+    memcpy(data.data() + 0x400, functionTable, sizeof(functionTable));
+    const quint8 longJumpTable[] = {0x80, 0x25, 0x00, 0x00, 0x00};
+    memcpy(data.data() + 0x500, longJumpTable, sizeof(longJumpTable));
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseLoadConfigDirectory(0x1000, loadConfig.Size, model));
+    
+    const PEDataModel::LoadConfigDirectory &directory = model.getLoadConfigDirectory();
+    QVERIFY(directory.present);
+    QCOMPARE(directory.fileOffset, quint32(0x200));
+    QCOMPARE(directory.guardTableStride, quint32(1));
+    QCOMPARE(directory.guardCFFunctions.size(), 3);
+    QVERIFY(directory.guardCFFunctions.contains(0x2010));
+    QVERIFY(directory.guardCFFunctions.contains(0x3000));
+    QVERIFY(!directory.guardCFFunctions.contains(0x2011));
+    QCOMPARE(directory.suppressedFunctions.toVector(), QVector<quint32>({0x2010, 0x2040}));
+    QVERIFY(directory.longJumpTargets.contains(0x2580));
+    QVERIFY(directory.addressTakenIatEntries.isEmpty());
+    QCOMPARE(directory.guardEHContinuationCount, quint64(4));
+    QCOMPARE(directory.ehContinuationTargets.size(), 2);
+    QVERIFY(directory.truncated);
+    
+    // A Size that stops before GuardFlags leaves the guard fields unread
+    loadConfig.Size = offsetof(IMAGE_LOAD_CONFIG_DIRECTORY64, GuardCFCheckFunctionPointer);
+    memcpy(data.data() + 0x200, &loadConfig, sizeof(loadConfig));
+    PEDataDirectoryParser legacyParser(data);
+    QVERIFY(legacyParser.parseLoadConfigDirectory(0x1000, loadConfig.Size, model));
+    QCOMPARE(model.getLoadConfigDirectory().guardFlags, quint32(0));
+    QVERIFY(model.getLoadConfigDirectory().guardCFFunctions.isEmpty());
+    QVERIFY(!model.getLoadConfigDirectory().truncated);
+}
+
+void PEParserTest::testDelayAndBoundImports()
+{
+    // PE32 with headers up to 0x200 and .rdata at RVA 0x1000 (file 0x200)
+    QByteArray data(0x600, '\0');
+    IMAGE_SECTION_HEADER rdata = {};
+    memcpy(rdata.Name, ".rdata", 6);
+    rdata.Misc.VirtualSize = 0x400;
+    rdata.VirtualAddress = 0x1000;
+    rdata.SizeOfRawData = 0x400;
+    rdata.PointerToRawData = 0x200;
+    
+    IMAGE_OPTIONAL_HEADER32 optionalHeader = {};
+    optionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    optionalHeader.ImageBase = 0x400000;
+    optionalHeader.SizeOfHeaders = 0x200;
+    
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    model.addSection(&rdata);
+    
+    // A VA-based descriptor as written by VC6, then an RVA-based one
+    IMAGE_DELAYLOAD_DESCRIPTOR descriptors[3] = {};
+    descriptors[0].DllNameRVA = 0x401100;
+    descriptors[0].ImportAddressTableRVA = 0x401180;
+    descriptors[0].ImportNameTableRVA = 0x401120;
+    descriptors[1].Attributes.AllAttributes = 1;
+    descriptors[1].DllNameRVA = 0x1200;
+    descriptors[1].ImportAddressTableRVA = 0x1280;
+    descriptors[1].ImportNameTableRVA = 0x1220;
+    memcpy(data.data() + 0x200, descriptors, sizeof(descriptors));
+    
+    const quint32 vaNameTable[] = {0x401140, 0x80000005, 0};
+    memcpy(data.data() + 0x320, vaNameTable, sizeof(vaNameTable));
+    const quint32 rvaNameTable[] = {0x1240, 0};
+    memcpy(data.data() + 0x420, rvaNameTable, sizeof(rvaNameTable));
+    strcpy(data.data() + 0x300, "KERNEL32.dll");
+    strcpy(data.data() + 0x342, "IsDebuggerPresent");
+    strcpy(data.data() + 0x400, "USER32.dll");
+    strcpy(data.data() + 0x442, "MessageBoxA");
+    
+    // Bound imports in the headers: one descriptor with a forwarder reference
+    const quint8 boundImports[] = {
+        0x11, 0x11, 0x11, 0x11, 0x18, 0x00, 0x01, 0x00,
+        0x22, 0x22, 0x22, 0x22, 0x25, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    memcpy(data.data() + 0x180, boundImports, sizeof(boundImports));
+    strcpy(data.data() + 0x198, "KERNEL32.dll");
+    strcpy(data.data() + 0x1A5, "NTDLL.DLL");
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseDelayImportDirectory(0x1000, sizeof(descriptors), model));
+    
+    const QList<PEDataModel::DelayImportModule> &modules = model.getDelayImportModules();
+    QCOMPARE(modules.size(), 2);
+    QCOMPARE(modules[0].dllName, QString("KERNEL32.dll"));
+    QVERIFY(!modules[0].rvaBased);
+    QCOMPARE(modules[0].importAddressTableRVA, quint32(0x1180));
+    QCOMPARE(modules[1].dllName, QString("USER32.dll"));
+    QVERIFY(modules[1].rvaBased);
+    
+    const QList<PEDataModel::ImportFunctionEntry> kernel32 = model.getDelayImportFunctions().value("KERNEL32.dll");
+    QCOMPARE(kernel32.size(), 2);
+    QCOMPARE(kernel32[0].name, QString("IsDebuggerPresent"));
+    QCOMPARE(kernel32[0].thunkRVA, quint32(0x1180));
+    QVERIFY(kernel32[1].importedByOrdinal);
+    QCOMPARE(kernel32[1].ordinal, quint16(5));
+    QCOMPARE(model.getDelayImportFunctions().value("USER32.dll").first().name, QString("MessageBoxA"));
+    
+    QVERIFY(parser.parseBoundImportDirectory(0x180, sizeof(boundImports), model));
+    const QList<PEDataModel::BoundImportEntry> &bound = model.getBoundImports();
+    QCOMPARE(bound.size(), 1);
+    QCOMPARE(bound[0].moduleName, QString("KERNEL32.dll"));
+    QCOMPARE(bound[0].timeDateStamp, quint32(0x11111111));
+    QCOMPARE(bound[0].forwarders.size(), 1);
+    QCOMPARE(bound[0].forwarders[0].moduleName, QString("NTDLL.DLL"));
+    QCOMPARE(bound[0].forwarders[0].timeDateStamp, quint32(0x22222222));
+}
+
+void PEParserTest::testClrMetadata()
+{
+    // .text at RVA 0x2000 (file 0x200) holds the COR20 header and the metadata at RVA 0x2100
+    QByteArray data(0x800, '\0');
+    IMAGE_SECTION_HEADER text = {};
+    memcpy(text.Name, ".text", 5);
+    text.Misc.VirtualSize = 0x600;
+    text.VirtualAddress = 0x2000;
+    text.SizeOfRawData = 0x600;
+    text.PointerToRawData = 0x200;
+    
+    IMAGE_OPTIONAL_HEADER32 optionalHeader = {};
+    optionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    model.addSection(&text);
+    
+    IMAGE_COR20_HEADER corHeader = {};
+    corHeader.cb = sizeof(corHeader);
+    corHeader.MajorRuntimeVersion = 2;
+    corHeader.MinorRuntimeVersion = 5;
+    corHeader.MetaData.VirtualAddress = 0x2100;
+    corHeader.MetaData.Size = 0x400;
+    corHeader.Flags = COMIMAGE_FLAGS_ILONLY;
+    memcpy(data.data() + 0x200, &corHeader, sizeof(corHeader));
+    
+    char *root = data.data() + 0x300;
+    auto put16 = [](char *at, quint16 value) { memcpy(at, &value, sizeof(value)); };
+    auto put32 = [](char *at, quint32 value) { memcpy(at, &value, sizeof(value)); };
+    
+    // Metadata root with the version string and four stream headers
+    put32(root, CLR_METADATA_SIGNATURE);
+    put32(root + 12, 12);
+    memcpy(root + 16, "v4.0.30319", 10);
+    put16(root + 30, 4);
+    char *header = root + 32;
+    auto addStream = [&](quint32 offset, quint32 size, const char *name) {
+        put32(header, offset);
+        put32(header + 4, size);
+        strcpy(header + 8, name);
+        header += 8 + ((strlen(name) + 4) & ~3u);
+    };
+    addStream(0x100, 0x100, "#~");
+    addStream(0x200, 0x80, "#Strings");
+    addStream(0x280, 0x40, "#Blob");
+    addStream(0x2C0, 0x10, "#GUID");
+    
+    // Table stream: Module, TypeDef x2, MethodDef x3, AssemblyRef, ManifestResource; narrow heaps
+    char *tables = root + 0x100;
+    const quint64 valid = (1ULL << PEClrMetadata::Module) | (1ULL << PEClrMetadata::TypeDef) |
+                          (1ULL << PEClrMetadata::MethodDef) | (1ULL << PEClrMetadata::AssemblyRef) |
+                          (1ULL << PEClrMetadata::ManifestResource);
+    memcpy(tables + 8, &valid, sizeof(valid));
+    const quint32 rowCounts[] = {1, 2, 3, 1, 1};
+    memcpy(tables + 24, rowCounts, sizeof(rowCounts));
+    
+    // #Strings offsets: <Module>=1, Program=10, Demo=18, Main=23, mscorlib=28, app.resources=37
+    memcpy(root + 0x200, "\0<Module>\0Program\0Demo\0Main\0mscorlib\0app.resources\0", 51);
+    
+    char *row = tables + 44;
+    put16(row + 2, 1);                                  // Module: Generation, Name, Mvid, EncId, EncBaseId
+    row += 10;
+    row += 14;                                          // TypeDef 1 is <Module>
+    put16(row + 4, 10);                                 // TypeDef: Flags, Name, Namespace, Extends, FieldList, MethodList
+    put16(row + 6, 18);
+    put16(row + 12, 2);
+    row += 14;
+    for (int i = 0; i < 3; ++i, row += 14) {            // MethodDef: RVA, ImplFlags, Flags, Name, Signature, ParamList
+        put32(row, 0x2050 + i * 0x10);
+        put16(row + 8, 23);
+    }
+    put16(row, 4);                                      // AssemblyRef: versions, Flags, PublicKeyOrToken, Name, Culture, HashValue
+    put16(row + 12, 1);
+    put16(row + 14, 28);
+    row += 20;
+    put32(row, 0x40);                                   // ManifestResource: Offset, Flags, Name, Implementation
+    put16(row + 8, 37);
+    
+    memcpy(root + 0x281, "\x08\xb7\x7a\x5c\x56\x19\x34\xe0\x89", 9);
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseCOMRuntimeDirectory(0x2000, sizeof(corHeader), model));
+    QVERIFY(model.getClrRuntimeHeader().present);
+    QCOMPARE(model.getClrRuntimeHeader().header.MinorRuntimeVersion, quint16(5));
+    
+    const PEClrMetadata &metadata = model.getClrMetadata();
+    QVERIFY(metadata.isValid());
+    QVERIFY(!metadata.isTruncated());
+    QCOMPARE(metadata.version(), QString("v4.0.30319"));
+    QCOMPARE(metadata.streams().size(), 4);
+    QCOMPARE(metadata.rowCount(PEClrMetadata::TypeDef), quint32(2));
+    QCOMPARE(metadata.rowCount(PEClrMetadata::MemberRef), quint32(0));
+    
+    PEClrMetadata::TypeDefRow program = metadata.typeDef(2);
+    QCOMPARE(program.name, QString("Program"));
+    QCOMPARE(program.typeNamespace, QString("Demo"));
+    QCOMPARE(program.methodList, quint32(2));
+    QCOMPARE(metadata.methodDef(3).rva, quint32(0x2070));
+    QCOMPARE(metadata.methodDef(3).name, QString("Main"));
+    QVERIFY(metadata.methodDef(4).name.isEmpty());
+    
+    PEClrMetadata::AssemblyRefRow mscorlib = metadata.assemblyRef(1);
+    QCOMPARE(mscorlib.name, QString("mscorlib"));
+    QCOMPARE(mscorlib.majorVersion, quint16(4));
+    QCOMPARE(mscorlib.publicKeyOrToken.toHex(), QByteArray("b77a5c561934e089"));
+    QCOMPARE(metadata.manifestResource(1).name, QString("app.resources"));
+    QCOMPARE(metadata.manifestResource(1).offset, quint32(0x40));
+    
+    // Row counts beyond the end of the table stream are clamped
+    const quint32 hugeMethodCount = 1000000;
+    memcpy(tables + 32, &hugeMethodCount, sizeof(hugeMethodCount));
+    PEClrMetadata truncated = PEClrMetadata::open(data, 0x300, 0x400);
+    QVERIFY(truncated.isTruncated());
+    QVERIFY(truncated.rowCount(PEClrMetadata::MethodDef) < 20);
+}
+
+void PEParserTest::testExportIndexResolution()
+{
+    QList<PEDataModel::ExportFunctionEntry> kernel32(4);
+    kernel32[0].name = "HeapAlloc";
+    kernel32[0].ordinal = 1;
+    kernel32[0].rva = 0x1100;
+    kernel32[0].forwarder = "NTDLL.RtlAllocateHeap";
+    kernel32[1].name = "[ - ]";
+    kernel32[1].ordinal = 7;
+    kernel32[1].rva = 0x2000;
+    kernel32[2].name = "Sleep";
+    kernel32[2].ordinal = 5;
+    kernel32[2].rva = 0x3000;
+    kernel32[3].name = "Loop";
+    kernel32[3].ordinal = 9;
+    kernel32[3].rva = 0x1120;
+    kernel32[3].forwarder = "KERNEL32.Loop";
+    QList<PEDataModel::ExportFunctionEntry> ntdll(1);
+    ntdll[0].name = "RtlAllocateHeap";
+    ntdll[0].ordinal = 3;
+    ntdll[0].rva = 0x4000;
+    
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString indexPath = directory.filePath("exports.bin");
+    QVERIFY(PEExportIndex::write({{"KERNEL32.dll", kernel32}, {"ntdll.dll", ntdll}}, indexPath));
+    QSharedPointer<const PEExportIndex> index = PEExportIndex::load(indexPath);
+    QVERIFY(index);
+    QCOMPARE(index->moduleCount(), 2);
+    QCOMPARE(index->exportCount(), 5);
+    QCOMPARE(index->nameForOrdinal("kernel32.DLL", 5), QString("Sleep"));
+    QVERIFY(index->nameForOrdinal("KERNEL32.dll", 7).isEmpty());
+    QVERIFY(index->nameForOrdinal("USER32.dll", 5).isEmpty());
+    QCOMPARE(index->forwarderForName("KERNEL32.dll", "HeapAlloc"), QString("NTDLL.RtlAllocateHeap"));
+    QCOMPARE(index->resolveForwarderChain("KERNEL32.#1"), QString("NTDLL.RtlAllocateHeap"));
+    QCOMPARE(index->resolveForwarderChain("KERNEL32.Loop"), QString("KERNEL32.Loop"));
+    QVERIFY(!PEExportIndex::load(directory.filePath("missing.bin")));
+    
+    // PE32 importing KERNEL32 ordinals 5 and 1 and HeapAlloc by name; .rdata at RVA 0x1000 (file 0x200)
+    QByteArray data(0x600, '\0');
+    IMAGE_SECTION_HEADER rdata = {};
+    memcpy(rdata.Name, ".rdata", 6);
+    rdata.Misc.VirtualSize = 0x400;
+    rdata.VirtualAddress = 0x1000;
+    rdata.SizeOfRawData = 0x400;
+    rdata.PointerToRawData = 0x200;
+    
+    IMAGE_OPTIONAL_HEADER32 optionalHeader = {};
+    optionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    
+    IMAGE_IMPORT_DESCRIPTOR descriptor = {};
+    descriptor.OriginalFirstThunk = 0x1040;
+    descriptor.Name = 0x1080;
+    descriptor.FirstThunk = 0x1060;
+    memcpy(data.data() + 0x200, &descriptor, sizeof(descriptor));
+    const quint32 thunks[] = {0x80000005, 0x80000001, 0x10A0, 0};
+    memcpy(data.data() + 0x240, thunks, sizeof(thunks));
+    memcpy(data.data() + 0x260, thunks, sizeof(thunks));
+    strcpy(data.data() + 0x280, "KERNEL32.dll");
+    strcpy(data.data() + 0x2A2, "HeapAlloc");
+    
+    // Export directory whose second function points back into the directory
+    IMAGE_EXPORT_DIRECTORY exportDirectory = {};
+    exportDirectory.OrdinalBase = 1;
+    exportDirectory.NumberOfFunctions = 2;
+    exportDirectory.AddressOfFunctions = 0x1130;
+    memcpy(data.data() + 0x300, &exportDirectory, sizeof(exportDirectory));
+    const quint32 functions[] = {0x2000, 0x1140};
+    memcpy(data.data() + 0x330, functions, sizeof(functions));
+    strcpy(data.data() + 0x340, "NTDLL.RtlAllocateHeap");
+    
+    PEDataModel model;
+    model.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    model.addSection(&rdata);
+    PEDataModel unresolvedModel;
+    unresolvedModel.setOptionalHeader(reinterpret_cast<const IMAGE_OPTIONAL_HEADER*>(&optionalHeader));
+    unresolvedModel.addSection(&rdata);
+    
+    PEDataDirectoryParser parser(data);
+    QVERIFY(parser.parseImportDirectory(0x1000, 2 * sizeof(descriptor), unresolvedModel));
+    parser.setExportIndex(index.data());
+    QVERIFY(parser.parseImportDirectory(0x1000, 2 * sizeof(descriptor), model));
+    
+    const QList<PEDataModel::ImportFunctionEntry> imported = model.getImportFunctions().value("KERNEL32.dll");
+    QCOMPARE(imported.size(), 3);
+    QVERIFY(imported[0].importedByOrdinal);
+    QCOMPARE(imported[0].name, QString("Sleep"));
+    QVERIFY(imported[0].forwardedTo.isEmpty());
+    QCOMPARE(imported[1].name, QString("HeapAlloc"));
+    QCOMPARE(imported[1].forwardedTo, QString("NTDLL.RtlAllocateHeap"));
+    QCOMPARE(imported[2].forwardedTo, QString("NTDLL.RtlAllocateHeap"));
+    QCOMPARE(unresolvedModel.getImportFunctions().value("KERNEL32.dll")[0].name, QString("[ - ]"));
+    // Naming ordinals must not change the imphash
+    QCOMPARE(model.getImportHash(), unresolvedModel.getImportHash());
+    
+    QVERIFY(parser.parseExportDirectory(0x1100, 0x80, model));
+    const QList<PEDataModel::ExportFunctionEntry> &exports = model.getExportFunctions();
+    QCOMPARE(exports.size(), 2);
+    QVERIFY(exports[0].forwarder.isEmpty());
+    QCOMPARE(exports[1].forwarder, QString("NTDLL.RtlAllocateHeap"));
+}
+
 void PEParserTest::testLargeFileHandling()
 {
     PEParserNew parser;
@@ -144,6 +731,471 @@ void PEParserTest::testCorruptedFileHandling()
     }
 }
 
+void PEParserTest::testParseDiagnostics()
+{
+    PEDiagnostics diagnostics;
+    diagnostics.report(PEErrorType::TableTruncated, 0x200, "first");
+    diagnostics.report(PEErrorType::InvalidPESignature, 0x80);
+    QCOMPARE(diagnostics.size(), 2);
+    QCOMPARE(diagnostics.severity(0), PEErrorSeverity::Warning);
+    QCOMPARE(diagnostics.detail(0), QString("first"));
+    QCOMPARE(diagnostics.detail(1), QString());
+    QVERIFY(diagnostics.hasCriticalErrors());
+    QCOMPARE(diagnostics.count(PEErrorSeverity::Warning), 2);
+    QVERIFY(!diagnostics.error(0).recoverySuggestions.isEmpty());
+    
+    PEDiagnostics batch;
+    batch.report(PEErrorType::LimitExceeded, 0x10, "kept");
+    batch.merge(diagnostics);
+    batch.merge(diagnostics, "b.exe");
+    QCOMPARE(batch.size(), 5);
+    QCOMPARE(batch.detail(0), QString("kept"));
+    QCOMPARE(batch.detail(1), QString("first"));
+    QCOMPARE(batch.fileOffset(2), quint64(0x80));
+    QCOMPARE(batch.detail(3), QString("b.exe: first"));
+    QCOMPARE(batch.detail(4), QString("b.exe"));
+    
+    // Each parser keeps its own log, and reloading starts a fresh one
+    QString tempFile = QDir::temp().absoluteFilePath("test_bad_lfanew.exe");
+    QByteArray data(sizeof(IMAGE_DOS_HEADER), '\0');
+    data[0] = 'M';
+    data[1] = 'Z';
+    qint32 lfanew = 0x1000;
+    std::memcpy(data.data() + offsetof(IMAGE_DOS_HEADER, e_lfanew), &lfanew, sizeof(lfanew));
+    QFile file(tempFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+    
+    PEParserNew parser;
+    PEParserNew other;
+    QVERIFY(!parser.loadFile(tempFile));
+    QCOMPARE(parser.getDiagnostics().size(), 1);
+    QCOMPARE(parser.getDiagnostics().type(0), PEErrorType::InvalidDOSHeader);
+    QCOMPARE(parser.getDiagnostics().fileOffset(0), quint64(offsetof(IMAGE_DOS_HEADER, e_lfanew)));
+    QVERIFY(other.getDiagnostics().isEmpty());
+    QVERIFY(!parser.loadFile(tempFile));
+    QCOMPARE(parser.getDiagnostics().size(), 1);
+    
+    QFile::remove(tempFile);
+}
+
+void PEParserTest::testSyntheticImages()
+{
+    PESyntheticImage::Spec spec;
+    spec.seed = 7;
+    spec.sectionCount = 6;
+    spec.importModules = 3;
+    spec.importsPerModule = 50;
+    spec.exportCount = 40;
+    spec.forwardedExports = 2;
+    spec.resourceDepth = 3;
+    spec.resourceFanout = 3;
+    spec.relocationCount = 300;
+    spec.tlsCallbacks = 2;
+    spec.certificateSize = 100;
+    spec.overlaySize = 5000;
+    
+    // Same spec, same bytes; another seed changes content but not layout
+    const QByteArray image = PESyntheticImage::build(spec);
+    QCOMPARE(quint64(image.size()), PESyntheticImage::imageSize(spec));
+    QCOMPARE(PESyntheticImage::build(spec), image);
+    PESyntheticImage::Spec reseeded = spec;
+    reseeded.seed = 8;
+    QByteArray other = PESyntheticImage::build(reseeded);
+    QCOMPARE(other.size(), image.size());
+    QVERIFY(other != image);
+    
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    for (bool pe64 : {false, true}) {
+        spec.pe64 = pe64;
+        QString path = directory.filePath(pe64 ? "synthetic64.exe" : "synthetic32.exe");
+        QVERIFY(PESyntheticImage::write(spec, path));
+        QCOMPARE(quint64(QFileInfo(path).size()), PESyntheticImage::imageSize(spec));
+        
+        PEParserNew parser;
+        QVERIFY(parser.loadFile(path));
+        const PEDataModel &model = parser.getDataModel();
+        QCOMPARE(parser.getImportFunctionDetails().size(), 3);
+        QCOMPARE(parser.getImportFunctionDetails().value("synth1.dll").size(), 50);
+        QCOMPARE(parser.getExportFunctions().size(), 40);
+        QCOMPARE(parser.getExportFunctions()[1].forwarder, QString("NTDLL.RtlFunction1"));
+        QVERIFY(parser.getExportFunctions()[2].forwarder.isEmpty());
+        QCOMPARE(parser.getResourceEntries().size(), 27);
+        QCOMPARE(model.getRelocations().size(), 300);
+        QCOMPARE(model.getTLSCallbacks().size(), 2);
+        QCOMPARE(model.getCertificateInfo().size(), 1);
+        QVERIFY(parser.getDiagnostics().isEmpty());
+    }
+    
+    // Zero fill past the content is skipped, not written; the unaligned
+    // remainder after the certificate becomes overlay
+    PESyntheticImage::Spec padded;
+    padded.fileSize = 64 * 1024 * 1024 + 123;
+    padded.certificateSize = 100;
+    QCOMPARE(PESyntheticImage::imageSize(padded), padded.fileSize);
+    QString paddedPath = directory.filePath("padded.exe");
+    QVERIFY(PESyntheticImage::write(padded, paddedPath));
+    QCOMPARE(QFileInfo(paddedPath).size(), qint64(padded.fileSize));
+}
+
+void PEParserTest::testSyntheticMalformations()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const quint32 malformations[] = {
+        PESyntheticImage::TruncatedTail, PESyntheticImage::SectionCountOverflow,
+        PESyntheticImage::UnterminatedImports, PESyntheticImage::ResourceLoop,
+        PESyntheticImage::HugeCounts, PESyntheticImage::DirectoriesOutOfRange,
+        PESyntheticImage::CertificateBeyondFile
+    };
+    
+    for (quint32 malformation : malformations) {
+        PESyntheticImage::Spec spec;
+        spec.exportCount = 16;
+        spec.certificateSize = 64;
+        spec.malformations = malformation;
+        QString path = directory.filePath(QString("malformed_%1.exe").arg(malformation));
+        QVERIFY(PESyntheticImage::write(spec, path));
+        
+        // Every variant must be rejected or parsed, never crash
+        PEParserNew parser;
+        bool loaded = parser.loadFile(path);
+        if (malformation == PESyntheticImage::TruncatedTail) {
+            // The certificate table was cut off with the tail; the rest still parses
+            QVERIFY(loaded);
+            QCOMPARE(parser.getDiagnostics().size(), 1);
+            QCOMPARE(parser.getDiagnostics().type(0), PEErrorType::DataDirectoryCorrupted);
+            QVERIFY(parser.getDataModel().getCertificateInfo().isEmpty());
+            QCOMPARE(parser.getExportFunctions().size(), 16);
+        } else if (malformation == PESyntheticImage::UnterminatedImports) {
+            // The walk runs past the duplicate into the thunk tables and stops on its own
+            QVERIFY(loaded);
+            QVERIFY(parser.getImportModules().size() > 4);
+            QCOMPARE(parser.getImportModules().at(4), QString("synth0.dll"));
+            QCOMPARE(parser.getImportFunctionDetails().value("synth0.dll").size(), 32);
+        } else if (malformation == PESyntheticImage::HugeCounts) {
+            // A capped function table still does not fit the file; the resource
+            // root reads past its real entries without losing them
+            QVERIFY(loaded);
+            QVERIFY(parser.getExportFunctions().isEmpty());
+            QVERIFY(parser.getResourceEntries().size() >= 64);
+        } else if (malformation == PESyntheticImage::CertificateBeyondFile) {
+            // The table is clamped to the file and its one real entry is kept
+            QVERIFY(loaded);
+            QVERIFY(parser.getDiagnostics().isEmpty());
+            QCOMPARE(parser.getDataModel().getCertificateInfo().size(), 1);
+        } else if (malformation == PESyntheticImage::SectionCountOverflow) {
+            QVERIFY(!loaded);
+            QCOMPARE(parser.getDiagnostics().type(0), PEErrorType::SectionTableCorrupted);
+        } else if (malformation == PESyntheticImage::DirectoriesOutOfRange) {
+            QVERIFY(loaded);
+            QCOMPARE(parser.getDiagnostics().size(), 2);
+            QCOMPARE(parser.getDiagnostics().type(0), PEErrorType::DataDirectoryCorrupted);
+        } else if (malformation == PESyntheticImage::ResourceLoop) {
+            QVERIFY(loaded);
+            QVERIFY(parser.getResourceEntries().size() < 64);
+        }
+    }
+}
+
+void PEParserTest::testLoadFromBuffer()
+{
+    PESyntheticImage::Spec spec;
+    spec.exportCount = 12;
+    spec.relocationCount = 20;
+    const QByteArray image = PESyntheticImage::build(spec);
+    
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString path = directory.filePath("buffer.exe");
+    QVERIFY(PESyntheticImage::write(spec, path));
+    
+    PEParserNew fromFile;
+    PEParserNew fromBuffer;
+    QVERIFY(fromFile.loadFile(path));
+    QVERIFY(fromBuffer.loadFromBuffer(image, "buffer.exe"));
+    QCOMPARE(fromBuffer.getFilePath(), QString("buffer.exe"));
+    QCOMPARE(fromBuffer.getFileSize(), qint64(image.size()));
+    QCOMPARE(fromBuffer.getImportFunctionDetails().size(), fromFile.getImportFunctionDetails().size());
+    QCOMPARE(fromBuffer.getExportFunctions().size(), fromFile.getExportFunctions().size());
+    QCOMPARE(fromBuffer.getDataModel().getRelocations(), fromFile.getDataModel().getRelocations());
+    QCOMPARE(fromBuffer.getDataModel().getFileContentDigest().sha256, fromFile.getDataModel().getFileContentDigest().sha256);
+    
+    // The caller's buffer is shared, not copied, and so is a raw view like the carved images get
+    QVERIFY(fromBuffer.getFileData().constData() == image.constData());
+    QVERIFY(fromBuffer.loadFromBuffer(QByteArray::fromRawData(image.constData(), image.size())));
+    QVERIFY(fromBuffer.getFileData().constData() == image.constData());
+    
+    // An import table running into the end of the data stops there
+    spec.malformations = PESyntheticImage::UnterminatedImports;
+    QVERIFY(fromBuffer.loadFromBuffer(PESyntheticImage::build(spec)));
+    QVERIFY(!fromBuffer.loadFromBuffer(image.left(0x40)));
+}
+
+void PEParserTest::testParseProfile()
+{
+    PESyntheticImage::Spec spec;
+    spec.exportCount = 8;
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString path = directory.filePath("profile.exe");
+    QVERIFY(PESyntheticImage::write(spec, path));
+    
+    PEParserNew parser;
+    QVERIFY(parser.loadFile(path));
+    const PEParseProfile &profile = parser.getParseProfile();
+    
+    QHash<QString, PEParseProfile::Stage> stages;
+    for (const PEParseProfile::Stage &stage : profile.stages()) {
+        stages.insert(stage.name, stage);
+    }
+    for (const char *name : {"read", "dos_header", "pe_headers", "sections", "data_directories",
+                             "directory/import", "directory/export", "directory/resource", "content_digests"}) {
+        QVERIFY2(stages.contains(name), name);
+    }
+    QCOMPARE(stages["read"].bytes, qint64(PESyntheticImage::imageSize(spec)));
+    QCOMPARE(stages["directory/import"].depth, 1);
+    QCOMPARE(stages["directory/import"].category, QString("directory"));
+    QVERIFY(stages["directory/import"].startNs >= stages["data_directories"].startNs);
+    QVERIFY(stages["data_directories"].durationNs >= stages["directory/import"].durationNs);
+    QVERIFY(profile.totalNs() > 0);
+    
+    QJsonObject json = profile.toJson();
+    QCOMPARE(json["stages"].toArray().size(), profile.stages().size());
+    
+    // One lane name event plus one complete event per stage
+    QJsonArray events;
+    profile.appendTraceEvents(events, 3, 1000, path);
+    QCOMPARE(events.size(), profile.stages().size() + 1);
+    QCOMPARE(events[0].toObject()["ph"].toString(), QString("M"));
+    QCOMPARE(events[1].toObject()["ph"].toString(), QString("X"));
+    QCOMPARE(events[1].toObject()["tid"].toInt(), 3);
+    QVERIFY(events[1].toObject()["ts"].toDouble() >= 1000);
+    
+    // A new load starts a new profile
+    const int stageCount = profile.stages().size();
+    QVERIFY(parser.loadFile(path));
+    QCOMPARE(parser.getParseProfile().stages().size(), stageCount);
+}
+
+void PEParserTest::testStreamingParse()
+{
+    PESyntheticImage::Spec spec;
+    spec.pe64 = true;
+    spec.exportCount = 30;
+    spec.forwardedExports = 3;
+    spec.relocationCount = 200;
+    spec.tlsCallbacks = 2;
+    spec.certificateSize = 64;
+    spec.overlaySize = 4096;
+    spec.fileSize = 8 * 1024 * 1024;
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString path = directory.filePath("streamed.exe");
+    QVERIFY(PESyntheticImage::write(spec, path));
+    
+    PEParserNew full;
+    full.setMemoryLimit(0);
+    QVERIFY(full.loadFile(path));
+    QVERIFY(!full.isStreaming());
+    
+    PEParserNew streamed;
+    streamed.setMemoryLimit(1024 * 1024);
+    QVERIFY(streamed.loadFile(path));
+    QVERIFY(streamed.isStreaming());
+    QVERIFY(streamed.isLargeFile());
+    
+    // Still a view of the mapping: a raw view owns no allocation, a detached copy would
+    QCOMPARE(streamed.getFileData().size(), qsizetype(spec.fileSize));
+    QCOMPARE(streamed.getFileData().capacity(), qsizetype(0));
+    
+    // Same stages over the same bytes, so the models must not differ
+    const PEDataModel &a = full.getDataModel();
+    const PEDataModel &b = streamed.getDataModel();
+    QCOMPARE(b.getSections().size(), a.getSections().size());
+    QCOMPARE(b.getImports(), a.getImports());
+    QCOMPARE(streamed.getImportFunctionDetails().keys(), full.getImportFunctionDetails().keys());
+    QCOMPARE(streamed.getExportFunctions().size(), full.getExportFunctions().size());
+    QCOMPARE(streamed.getExportFunctions()[1].forwarder, full.getExportFunctions()[1].forwarder);
+    QCOMPARE(streamed.getResourceEntries().size(), full.getResourceEntries().size());
+    QCOMPARE(b.getRelocations(), a.getRelocations());
+    QCOMPARE(b.getTLSCallbacks().size(), a.getTLSCallbacks().size());
+    QCOMPARE(b.getCertificateInfo(), a.getCertificateInfo());
+    QCOMPARE(streamed.getImportHash(), full.getImportHash());
+    QCOMPARE(streamed.getExportHash(), full.getExportHash());
+    QCOMPARE(b.getFileContentDigest().sha256, a.getFileContentDigest().sha256);
+    QCOMPARE(b.getFileContentDigest().histogram, a.getFileContentDigest().histogram);
+    QCOMPARE(b.getSectionContentDigests().size(), a.getSectionContentDigests().size());
+    for (int i = 0; i < a.getSectionContentDigests().size(); ++i) {
+        QCOMPARE(b.getSectionContentDigests()[i].md5, a.getSectionContentDigests()[i].md5);
+    }
+    QCOMPARE(streamed.getDiagnostics().size(), full.getDiagnostics().size());
+    
+    // Resource payloads are still readable on demand after the pages were dropped
+    QVERIFY(!streamed.getResourceEntries().isEmpty());
+    const PEDataModel::ResourceEntry &resource = streamed.getResourceEntries().last();
+    QCOMPARE(streamed.getResourceData(resource), full.getResourceData(full.getResourceEntries().last()));
+    
+    QCOMPARE(streamed.getFileData().capacity(), qsizetype(0));
+    
+    streamed.clear();
+    QVERIFY(!streamed.isStreaming());
+}
+
+// Serves a buffer as a pipe would: sequential, a few kilobytes per read
+class SequentialBuffer : public QIODevice
+{
+public:
+    explicit SequentialBuffer(const QByteArray &data) : m_data(data) { open(QIODevice::ReadOnly); }
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return m_data.size() - m_position + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin<qint64>(qMin<qint64>(maxSize, 4096), m_data.size() - m_position);
+        std::memcpy(data, m_data.constData() + m_position, static_cast<size_t>(size));
+        m_position += size;
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray m_data;
+    qint64 m_position = 0;
+};
+
+void PEParserTest::testLoadFromDevice()
+{
+    PESyntheticImage::Spec spec;
+    spec.exportCount = 12;
+    spec.relocationCount = 20;
+    spec.overlaySize = 4096;
+    spec.fileSize = 3 * 1024 * 1024;
+    const QByteArray image = PESyntheticImage::build(spec);
+    
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString path = directory.filePath("device.exe");
+    QVERIFY(PESyntheticImage::write(spec, path));
+    
+    PEParserNew fromFile;
+    QVERIFY(fromFile.loadFile(path));
+    
+    // A stream that fits the limit is read into memory
+    PEParserNew fromStream;
+    SequentialBuffer small(image);
+    QVERIFY(fromStream.loadFromDevice(&small, "-"));
+    QVERIFY(!fromStream.isStreaming());
+    QCOMPARE(fromStream.getFilePath(), QString("-"));
+    QCOMPARE(fromStream.getFileSize(), qint64(image.size()));
+    QCOMPARE(fromStream.getExportFunctions().size(), fromFile.getExportFunctions().size());
+    QCOMPARE(fromStream.getDataModel().getFileContentDigest().sha256, fromFile.getDataModel().getFileContentDigest().sha256);
+    
+    // One that does not is spilled to a temporary file and parsed from a mapping
+    PEParserNew spilled;
+    spilled.setMemoryLimit(1024 * 1024);
+    SequentialBuffer large(image);
+    QVERIFY(spilled.loadFromDevice(&large, "-"));
+    QVERIFY(spilled.isStreaming());
+    QCOMPARE(spilled.getFileSize(), qint64(image.size()));
+    QCOMPARE(spilled.getImportFunctionDetails().keys(), fromFile.getImportFunctionDetails().keys());
+    QCOMPARE(spilled.getExportFunctions().size(), fromFile.getExportFunctions().size());
+    QCOMPARE(spilled.getDataModel().getRelocations(), fromFile.getDataModel().getRelocations());
+    QCOMPARE(spilled.getDataModel().getFileContentDigest().sha256, fromFile.getDataModel().getFileContentDigest().sha256);
+    QCOMPARE(spilled.getDataModel().getSectionContentDigests().size(), fromFile.getDataModel().getSectionContentDigests().size());
+    
+    // Named files are mapped in place rather than copied
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    PEParserNew fromDevice;
+    fromDevice.setMemoryLimit(1024 * 1024);
+    QVERIFY(fromDevice.loadFromDevice(&file, path));
+    QVERIFY(fromDevice.isStreaming());
+    QCOMPARE(fromDevice.getDataModel().getFileContentDigest().sha256, fromFile.getDataModel().getFileContentDigest().sha256);
+    
+    QVERIFY(!fromDevice.loadFromDevice(nullptr, "-"));
+}
+
+void PEParserTest::testEmbeddedImages()
+{
+    PESyntheticImage::Spec outerSpec;
+    outerSpec.certificateSize = 64;
+    PESyntheticImage::Spec innerSpec;
+    innerSpec.seed = 2;
+    innerSpec.pe64 = true;
+    innerSpec.exportCount = 4;
+    PESyntheticImage::Spec innermostSpec;
+    innermostSpec.seed = 3;
+    innermostSpec.textSize = 0x200;
+    innermostSpec.importModules = 1;
+    innermostSpec.resourceDepth = 0;
+    const QByteArray outer = PESyntheticImage::build(outerSpec);
+    const QByteArray innermost = PESyntheticImage::build(innermostSpec);
+    QByteArray inner = PESyntheticImage::build(innerSpec);
+    
+    // Signed, nothing appended: the certificate table is not overlay
+    PEParserNew parser;
+    QVERIFY(parser.loadFromBuffer(outer));
+    QCOMPARE(parser.getOverlay().offset, qint64(outer.size() - 72));
+    QCOMPARE(parser.getOverlay().size, qint64(0));
+    QVERIFY(parser.getEmbeddedImages().isEmpty());
+    
+    // Store the innermost image in .text and point the first resource of the inner one at it
+    QVERIFY(parser.loadFromBuffer(inner));
+    QVERIFY(!parser.getResourceEntries().isEmpty());
+    const PEDataModel::ResourceEntry resource = parser.getResourceEntries().first();
+    const IMAGE_SECTION_HEADER text = *parser.getDataModel().getSections().first();
+    QVERIFY(quint32(innermost.size()) <= text.SizeOfRawData);
+    inner.replace(text.PointerToRawData, innermost.size(), innermost);
+    const quint32 payload[2] = {text.VirtualAddress, quint32(innermost.size())};
+    inner.replace(resource.fileOffset - sizeof(IMAGE_RESOURCE_DATA_ENTRY), sizeof(payload),
+                  QByteArray(reinterpret_cast<const char*>(payload), sizeof(payload)));
+    
+    // A stray "MZ" whose e_lfanew leads nowhere, then the inner image
+    QByteArray junk(0x100, '\x11');
+    junk.replace(0x10, 2, "MZ");
+    const QByteArray file = outer + junk + inner;
+    QVERIFY(parser.loadFromBuffer(file, "installer.exe"));
+    const PEDataModel::Overlay &overlay = parser.getOverlay();
+    QCOMPARE(overlay.size, qint64(junk.size() + inner.size()));
+    QCOMPARE(overlay.ranges.size(), 1);
+    QCOMPARE(overlay.ranges[0].first, qint64(outer.size()));
+    
+    const QList<PEDataModel::EmbeddedImage> &images = parser.getEmbeddedImages();
+    QCOMPARE(images.size(), 2);
+    QCOMPARE(images[0].fileOffset, qint64(outer.size() + junk.size()));
+    QCOMPARE(images[0].size, qint64(inner.size()));
+    QCOMPARE(images[0].container, QString("overlay"));
+    QCOMPARE(images[0].depth, 0);
+    QVERIFY(images[0].parsed);
+    QCOMPARE(images[0].machine, quint16(IMAGE_FILE_MACHINE_AMD64));
+    QCOMPARE(images[1].fileOffset, images[0].fileOffset + text.PointerToRawData);
+    QCOMPARE(images[1].size, qint64(innermost.size()));
+    QCOMPARE(images[1].container, QString("resource"));
+    QCOMPARE(images[1].depth, 1);
+    
+    PEParserNew alone;
+    QVERIFY(alone.loadFromBuffer(innermost));
+    QCOMPARE(images[1].sha256, alone.getFileContentDigest().sha256);
+    QCOMPARE(images[1].importHash, alone.getImportHash());
+    
+    QCOMPARE(PEEmbeddedScanner::carvedImageSize(innermost.constData(), innermost.size()), qint64(innermost.size()));
+    QCOMPARE(PEEmbeddedScanner::carvedImageSize(innermost.constData(), 0x100), qint64(0));
+    QCOMPARE(PEEmbeddedScanner::carvedImageSize(junk.constData() + 0x10, junk.size() - 0x10), qint64(0));
+    
+    // Resource data outside every section has no file offset and must not be scanned as [0, size)
+    QByteArray unmapped = PESyntheticImage::build(innerSpec);
+    const quint32 outside[2] = {0x7FFF0000, quint32(unmapped.size())};
+    unmapped.replace(resource.fileOffset - sizeof(IMAGE_RESOURCE_DATA_ENTRY), sizeof(outside),
+                     QByteArray(reinterpret_cast<const char*>(outside), sizeof(outside)));
+    QVERIFY(parser.loadFromBuffer(unmapped));
+    QCOMPARE(parser.getResourceEntries().first().fileOffset, quint32(0));
+    QVERIFY(parser.getEmbeddedImages().isEmpty());
+}
+
 void PEParserTest::testRVAtoFileOffset()
 {
     PEParserNew parser;
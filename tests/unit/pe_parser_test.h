@@ -29,6 +29,13 @@ private slots:
     
     // Data Directory tests
     void testDataDirectoryParsing();
+    void testDebugEntryDecoding();
+    void testTLSCallbackEnumeration();
+    void testExceptionDirectory();
+    void testLoadConfigGuardTables();
+    void testDelayAndBoundImports();
+    void testClrMetadata();
+    void testExportIndexResolution();
     
     // Large file tests
     void testLargeFileHandling();
@@ -37,6 +44,14 @@ private slots:
     // Error handling tests
     void testInvalidFileHandling();
     void testCorruptedFileHandling();
+    void testParseDiagnostics();
+    void testSyntheticImages();
+    void testSyntheticMalformations();
+    void testLoadFromBuffer();
+    void testParseProfile();
+    void testStreamingParse();
+    void testLoadFromDevice();
+    void testEmbeddedImages();
     
     // Utility tests
     void testRVAtoFileOffset();
@@ -1,4 +1,8 @@
 #include "pe_security_analyzer_test.h"
+#include "pe_authenticode.h"
+#include "pe_structures.h"
+#include "pe_synthetic_image.h"
+#include <QBuffer>
 #include <QDebug>
 #include <QRandomGenerator>
 #include <cmath>
@@ -224,6 +228,88 @@ void PESecurityAnalyzerTest::testAntiVMDetection()
     QVERIFY(!result.isEmpty());
 }
 
+void PESecurityAnalyzerTest::testAuthenticodeSignedDigestParsing()
+{
+    auto der = [](quint8 tag, const QByteArray &content) {
+        QByteArray element(1, static_cast<char>(tag));
+        if (content.size() < 0x80) {
+            element.append(static_cast<char>(content.size()));
+        } else {
+            element.append(static_cast<char>(0x82));
+            element.append(static_cast<char>((content.size() >> 8) & 0xFF));
+            element.append(static_cast<char>(content.size() & 0xFF));
+        }
+        return element + content;
+    };
+    
+    // Minimal Authenticode SignedData carrying a SHA-256 SpcIndirectDataContent
+    const QByteArray digest(32, static_cast<char>(0xAB));
+    QByteArray algorithmId = der(0x30, der(0x06, QByteArray::fromHex("608648016503040201")) + der(0x05, QByteArray()));
+    QByteArray digestInfo = der(0x30, algorithmId + der(0x04, digest));
+    QByteArray indirectData = der(0x30, der(0x30, der(0x06, QByteArray::fromHex("2b06010401823702010f"))) + digestInfo);
+    QByteArray encapContent = der(0x30, der(0x06, QByteArray::fromHex("2b060104018237020104")) + der(0xA0, indirectData));
+    QByteArray signedData = der(0x30, der(0x02, QByteArray(1, 0x01)) + der(0x31, QByteArray()) + encapContent);
+    QByteArray contentInfo = der(0x30, der(0x06, QByteArray::fromHex("2a864886f70d010702")) + der(0xA0, signedData));
+    
+    // Wrap it in an 8-byte aligned WIN_CERTIFICATE entry
+    QByteArray certificateTable;
+    quint32 length = 8 + contentInfo.size();
+    quint16 revision = 0x0200;
+    quint16 type = WIN_CERT_TYPE_PKCS_SIGNED_DATA;
+    certificateTable.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    certificateTable.append(reinterpret_cast<const char*>(&revision), sizeof(revision));
+    certificateTable.append(reinterpret_cast<const char*>(&type), sizeof(type));
+    certificateTable.append(contentInfo);
+    while (certificateTable.size() % 8 != 0) {
+        certificateTable.append('\0');
+    }
+    
+    QByteArray pkcs7 = PEAuthenticode::extractPKCS7(certificateTable);
+    QCOMPARE(pkcs7, contentInfo);
+    
+    QCryptographicHash::Algorithm algorithm = QCryptographicHash::Md5;
+    QByteArray signedDigest;
+    QVERIFY(PEAuthenticode::parseSignedDigest(pkcs7, algorithm, signedDigest));
+    QCOMPARE(algorithm, QCryptographicHash::Sha256);
+    QCOMPARE(signedDigest, digest);
+    
+    // Truncated blobs must be rejected rather than read past the end
+    QVERIFY(!PEAuthenticode::parseSignedDigest(pkcs7.left(pkcs7.size() - 1), algorithm, signedDigest));
+}
+
+void PESecurityAnalyzerTest::testAuthenticodeImageHash()
+{
+    // Unaligned images with and without a certificate table, so the padding is exercised
+    PESyntheticImage::Spec plain;
+    plain.overlaySize = 3;
+    PESyntheticImage::Spec withCertificate = plain;
+    withCertificate.certificateSize = 100;
+    withCertificate.overlaySize = 13;
+    
+    for (const PESyntheticImage::Spec &spec : {plain, withCertificate}) {
+        QByteArray image = PESyntheticImage::build(spec);
+        QBuffer buffer(&image);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        PEAuthenticode::ImageLayout layout = PEAuthenticode::readLayout(&buffer);
+        QVERIFY(layout.valid);
+        QCOMPARE(layout.certificateTableSize != 0, spec.certificateSize != 0);
+        
+        // Reference: drop the excluded ranges back to front, then pad with zeros
+        QByteArray hashed = image;
+        if (layout.certificateTableSize != 0) {
+            hashed.remove(layout.certificateTableOffset, layout.certificateTableSize);
+        }
+        hashed.remove(layout.securityDirectoryOffset, sizeof(IMAGE_DATA_DIRECTORY));
+        hashed.remove(layout.checkSumOffset, sizeof(quint32));
+        const qint64 unpadded = image.size() - layout.certificateTableSize;
+        QVERIFY(unpadded % 8 != 0);
+        hashed.append(QByteArray(8 - unpadded % 8, '\0'));
+        
+        QCOMPARE(PEAuthenticode::computeImageHash(&buffer, layout, QCryptographicHash::Sha256),
+                 QCryptographicHash::hash(hashed, QCryptographicHash::Sha256));
+    }
+}
+
 void PESecurityAnalyzerTest::testSecurityCheckConfiguration()
 {
     PESecurityAnalyzer analyzer;
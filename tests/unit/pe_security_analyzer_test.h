@@ -38,6 +38,10 @@ private slots:
     void testAntiDebugDetection();
     void testAntiVMDetection();
     
+    // Digital signature tests
+    void testAuthenticodeSignedDigestParsing();
+    void testAuthenticodeImageHash();
+    
     // Configuration tests
     void testSecurityCheckConfiguration();
     void testSensitivityLevelConfiguration();
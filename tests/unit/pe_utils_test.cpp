@@ -1,6 +1,22 @@
 #include "pe_utils_test.h"
 #include "pe_utils.h"
+#include "pe_fingerprint.h"
+#include "pe_fuzzy_hash.h"
+#include "pe_content_statistics.h"
+#include "pe_hash_index.h"
+#include "pe_rich_header.h"
+#include "pe_rva_set.h"
+#include "async_log_writer.h"
+#include "language_manager.h"
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
 
 void PEUtilsTest::initTestCase()
 {
@@ -60,6 +76,439 @@ void PEUtilsTest::testDataDirectoryOffsetCalculation()
     QCOMPARE(dataDirOffset, expected);
 }
 
+void PEUtilsTest::testPEChecksumCalculation()
+{
+    // Odd-sized image so the trailing byte path is exercised too
+    QByteArray image(0x401, Qt::Uninitialized);
+    for (int i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<char>((i * 131 + 7) & 0xFF);
+    }
+    IMAGE_DOS_HEADER dosHeader = {};
+    dosHeader.e_magic = 0x5A4D;
+    dosHeader.e_lfanew = 0x80;
+    memcpy(image.data(), &dosHeader, sizeof(dosHeader));
+    
+    quint32 checkSumOffset = 0;
+    QVERIFY(PEUtils::findCheckSumOffset(image, checkSumOffset));
+    QCOMPARE(checkSumOffset, quint32(0x80 + 4 + sizeof(IMAGE_FILE_HEADER) + 64));
+    
+    // Word-by-word reference with the CheckSum field treated as zero
+    QByteArray reference = image;
+    memset(reference.data() + checkSumOffset, 0, sizeof(quint32));
+    reference.append('\0');
+    quint32 sum = 0;
+    for (int i = 0; i + 1 < reference.size(); i += 2) {
+        quint16 word;
+        memcpy(&word, reference.constData() + i, sizeof(word));
+        sum += word;
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    quint32 expected = (sum & 0xFFFF) + static_cast<quint32>(image.size());
+    
+    QCOMPARE(PEUtils::calculatePEChecksum(image, checkSumOffset), expected);
+    
+    // The stored value must not influence the result
+    quint32 stored = 0xDEADBEEF;
+    memcpy(image.data() + checkSumOffset, &stored, sizeof(stored));
+    QCOMPARE(PEUtils::calculatePEChecksum(image, checkSumOffset), expected);
+    
+    QVERIFY(!PEUtils::findCheckSumOffset(image.left(0x90), checkSumOffset));
+}
+
+void PEUtilsTest::testImportExportHash()
+{
+    auto named = [](const QString &name) {
+        PEDataModel::ImportFunctionEntry entry;
+        entry.name = name;
+        return entry;
+    };
+    auto byOrdinal = [](quint16 ordinal) {
+        PEDataModel::ImportFunctionEntry entry;
+        entry.importedByOrdinal = true;
+        entry.ordinal = ordinal;
+        entry.name = QStringLiteral("[ - ]");
+        return entry;
+    };
+    
+    // Known ordinals resolve to names, unknown ones become "ordN"; only
+    // .dll/.ocx/.sys extensions are stripped from the module name
+    QStringList entries;
+    entries << PEFingerprint::importHashEntry("KERNEL32.dll", named("GetProcAddress"))
+            << PEFingerprint::importHashEntry("KERNEL32.dll", named("LoadLibraryA"))
+            << PEFingerprint::importHashEntry("WS2_32.dll", byOrdinal(115))
+            << PEFingerprint::importHashEntry("OLEAUT32.DLL", byOrdinal(9999))
+            << PEFingerprint::importHashEntry("CUSTOM.BIN", byOrdinal(3));
+    QCOMPARE(entries.at(2), QString("ws2_32.wsastartup"));
+    QCOMPARE(entries.at(4), QString("custom.bin.ord3"));
+    QCOMPARE(PEFingerprint::calculateImportHash(entries), QString("960505448b6193e49816bd7ce65baf1c"));
+    QVERIFY(PEFingerprint::calculateImportHash(QStringList()).isEmpty());
+    
+    // Export hash ignores order and ordinal-only exports
+    QList<PEDataModel::ExportFunctionEntry> exports(3);
+    exports[0].name = "Beta";
+    exports[1].name = "[ - ]";
+    exports[2].name = "alpha";
+    QCOMPARE(PEFingerprint::calculateExportHash(exports), QString("c8fbb1c3b7e8f755c60cac6b63724700"));
+}
+
+void PEUtilsTest::testFuzzyHash()
+{
+    QByteArray data(8192, Qt::Uninitialized);
+    quint32 state = 12345;
+    for (int i = 0; i < data.size(); ++i) {
+        state = state * 1103515245u + 12345u;
+        data[i] = static_cast<char>(state >> 24);
+    }
+    
+    // Chunking must not change the result
+    PEFuzzyHash whole;
+    whole.update(data.constData(), data.size());
+    PEFuzzyHash chunked;
+    for (int offset = 0; offset < data.size(); offset += 3) {
+        chunked.update(data.constData() + offset, qMin(3, static_cast<int>(data.size()) - offset));
+    }
+    PEFuzzyHash::Digest digest = whole.digest();
+    QVERIFY(digest.valid);
+    QCOMPARE(chunked.digest().toString(), digest.toString());
+    QVERIFY(whole.entropy() > 7.5);
+    
+    QString text = digest.toString();
+    QCOMPARE(text.size(), 70);
+    QCOMPARE(PEFuzzyHash::Digest::fromString(text).toString(), text);
+    QVERIFY(!PEFuzzyHash::Digest::fromString(text.left(69)).valid);
+    
+    // A small edit stays much closer than unrelated content
+    QByteArray edited = data;
+    for (int i = 1000; i < 1064; ++i) {
+        edited[i] = 0;
+    }
+    QByteArray unrelated = data;
+    std::reverse(unrelated.begin(), unrelated.end());
+    PEFuzzyHash::Digest editedDigest = PEFuzzyHash::Digest::fromString(PEFuzzyHash::hashData(edited));
+    PEFuzzyHash::Digest unrelatedDigest = PEFuzzyHash::Digest::fromString(PEFuzzyHash::hashData(unrelated));
+    QCOMPARE(PEFuzzyHash::distance(digest, digest), 0);
+    QCOMPARE(PEFuzzyHash::distance(digest, editedDigest), PEFuzzyHash::distance(editedDigest, digest));
+    QVERIFY(PEFuzzyHash::distance(digest, editedDigest) < PEFuzzyHash::distance(digest, unrelatedDigest));
+    
+    QVector<PEFuzzyHash::Digest> corpus = {unrelatedDigest, PEFuzzyHash::Digest(), editedDigest, digest};
+    QList<QPair<int, int>> matches = PEFuzzyHash::findSimilar(digest, corpus, PEFuzzyHash::distance(digest, editedDigest));
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches.at(0).first, 3);
+    QCOMPARE(matches.at(1).first, 2);
+    
+    // Uniform or short input has no meaningful digest
+    QVERIFY(PEFuzzyHash::hashData(QByteArray(4096, '\0')).isEmpty());
+    QVERIFY(PEFuzzyHash::hashData(data.left(PEFuzzyHash::MIN_INPUT_SIZE - 1)).isEmpty());
+}
+
+void PEUtilsTest::testContentStatistics()
+{
+    // Two zero runs long enough to count (32 and a trailing 20), one that is not (8)
+    QByteArray data = QByteArray(32, '\0') + QByteArray("Hello, world\n") + QByteArray(8, '\0')
+                    + QByteArray(10, '\x90') + QByteArray(20, '\0');
+    QCOMPARE(data.size(), 83);
+    
+    PEDataModel::ContentDigest digest = PEContentStatistics::analyzeData(data);
+    QCOMPARE(digest.size, qint64(83));
+    QCOMPARE(digest.md5, QString("24fce5a773114c0eaca2f16613654ca1"));
+    QCOMPARE(digest.sha256, QString("2f1d51a3ae952184d333c4600608f7bd867b84a9164bab1314528f47c38b3e21"));
+    QCOMPARE(digest.histogram.size(), 256);
+    QCOMPARE(digest.histogram[0], quint64(60));
+    QCOMPARE(digest.histogram[0x90], quint64(10));
+    QCOMPARE(digest.zeroRunCoverage, 52.0 / 83.0);
+    QCOMPARE(digest.printableRatio, 13.0 / 83.0);
+    
+    // Chunk boundaries inside a zero run must not split it
+    PEContentStatistics chunked;
+    for (int offset = 0; offset < data.size(); offset += 5) {
+        chunked.update(data.constData() + offset, qMin(5, static_cast<int>(data.size()) - offset));
+    }
+    PEDataModel::ContentDigest chunkedDigest = chunked.result();
+    QCOMPARE(chunkedDigest.sha256, digest.sha256);
+    QCOMPARE(chunkedDigest.zeroRunCoverage, digest.zeroRunCoverage);
+    QCOMPARE(chunkedDigest.entropy, digest.entropy);
+
+    // Pieces appended in order, with the hashes fed separately, match one pass;
+    // cuts fall inside zero runs and leave pieces shorter than a window
+    QByteArray large;
+    quint32 state = 0x12345678;
+    for (int i = 0; i < 4096; ++i) {
+        state = state * 1103515245u + 12345u;
+        large.append(static_cast<char>(state >> 16));
+        if (i % 1000 == 0) {
+            large.append(QByteArray(40, '\0'));
+        }
+    }
+    large.prepend(QByteArray(24, '\0'));
+    const PEDataModel::ContentDigest single = PEContentStatistics::analyzeData(large);
+    QVERIFY(!single.similarityHash.isEmpty());
+
+    const QList<qint64> cuts = {10, 12, 13, 14, 30, 1050, 1051, 1053, 2000, 3000, large.size() - 2};
+    PEContentStatistics merged(PEContentStatistics::Mode::Mergeable);
+    PEContentStatistics ordered(PEContentStatistics::Mode::OrderedHashes);
+    qint64 start = 0;
+    for (qint64 end : cuts + QList<qint64>{large.size()}) {
+        PEContentStatistics piece(PEContentStatistics::Mode::Mergeable);
+        piece.update(large.constData() + start, end - start);
+        ordered.update(large.constData() + start, end - start);
+        merged.append(piece);
+        start = end;
+    }
+    const PEDataModel::ContentDigest mergedDigest = merged.result(ordered);
+    QCOMPARE(mergedDigest.size, single.size);
+    QCOMPARE(mergedDigest.md5, single.md5);
+    QCOMPARE(mergedDigest.sha256, single.sha256);
+    QCOMPARE(mergedDigest.similarityHash, single.similarityHash);
+    QCOMPARE(mergedDigest.histogram, single.histogram);
+    QCOMPARE(mergedDigest.entropy, single.entropy);
+    QCOMPARE(mergedDigest.zeroRunCoverage, single.zeroRunCoverage);
+    QCOMPARE(mergedDigest.printableRatio, single.printableRatio);
+
+    PEDataModel::ContentDigest empty = PEContentStatistics::analyzeData(QByteArray());
+    QCOMPARE(empty.size, qint64(0));
+    QVERIFY(empty.md5.isEmpty());
+}
+
+void PEUtilsTest::testHashIndex()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    PEHashIndex index(directory.filePath("index"));
+    const QString hash = "0123456789abcdef0123456789abcdef";
+    const QString first = QFileInfo(directory.filePath("first.exe")).absoluteFilePath();
+    const QString second = QFileInfo(directory.filePath("second.exe")).absoluteFilePath();
+
+    // Samples are only appended; repeats are dropped when the bucket is read
+    QVERIFY(index.addSample(PEHashIndex::HashKind::ImportHash, hash, first));
+    QVERIFY(index.addSample(PEHashIndex::HashKind::ImportHash, hash.toUpper(), second));
+    QVERIFY(index.addSample(PEHashIndex::HashKind::ImportHash, hash, first));
+    QCOMPARE(index.findSamples(PEHashIndex::HashKind::ImportHash, hash), QStringList({first, second}));
+    QVERIFY(index.findSamples(PEHashIndex::HashKind::ExportHash, hash).isEmpty());
+
+    // Hashes become file names
+    QVERIFY(!index.addSample(PEHashIndex::HashKind::ImportHash, "../escape", first));
+    QVERIFY(index.findSamples(PEHashIndex::HashKind::ImportHash, "../escape").isEmpty());
+}
+
+void PEUtilsTest::testRichHeader()
+{
+    // DOS header and stub, Rich header at 0x80, PE header at 0xB8
+    QByteArray data(0xB8, '\0');
+    data[0] = 'M';
+    data[1] = 'Z';
+    quint32 peOffset = 0xB8;
+    memcpy(data.data() + 0x3C, &peOffset, sizeof(peOffset));
+    const char stubMessage[] = "This program cannot be run in DOS mode.\r\r\n$";
+    memcpy(data.data() + 0x4E, stubMessage, sizeof(stubMessage) - 1);
+    
+    // Key precomputed from the stub above and these entries
+    const quint32 key = 0xA64E1933;
+    const quint32 entries[][2] = {
+        {0x0105u << 16 | 30133, 12},    // Utc1900_CPP, VS2019 16.11
+        {0x0102u << 16 | 35207, 1},     // Linker1400, VS2022 17.14
+        {0x0001u << 16, 40},            // Import0
+        {0x0093u << 16 | 30729, 3}      // Implib900, VS2008 SP1
+    };
+    QList<quint32> dwords = {0x536E6144 ^ key, key, key, key};
+    for (const auto &entry : entries) {
+        dwords << (entry[0] ^ key) << (entry[1] ^ key);
+    }
+    dwords << 0x68636952 << key;
+    for (int i = 0; i < dwords.size(); ++i) {
+        memcpy(data.data() + 0x80 + i * 4, &dwords[i], sizeof(quint32));
+    }
+    
+    PERichHeader::Info info = PERichHeader::decode(data, peOffset);
+    QVERIFY(info.found);
+    QCOMPARE(info.offset, quint32(0x80));
+    QCOMPARE(info.size, quint32(0x38));
+    QCOMPARE(info.xorKey, key);
+    QVERIFY(info.checksumValid);
+    QCOMPARE(info.hash, QString("8ec900df8558c031b28d5772f7b2d8e7"));
+    QCOMPARE(info.entries.size(), 4);
+    QCOMPARE(info.entries[0].productId, quint16(0x0105));
+    QCOMPARE(info.entries[0].buildNumber, quint16(30133));
+    QCOMPARE(info.entries[0].count, quint32(12));
+    QCOMPARE(info.entries[3].fileOffset, quint32(0xA8));
+    
+    QCOMPARE(PERichHeader::productName(0x0105), QString("Utc1900_CPP"));
+    QCOMPARE(PERichHeader::toolchainName(0x0105, 30133), QString("Visual Studio 2019 16.11"));
+    QCOMPARE(PERichHeader::toolchainName(0x0102, 35207), QString("Visual Studio 2022 17.14"));
+    QCOMPARE(PERichHeader::toolchainName(0x0093, 30729), QString("Visual Studio 2008 SP1"));
+    QVERIFY(PERichHeader::toolchainName(0x0001, 0).isEmpty());
+    QVERIFY(PERichHeader::productName(0xFFFF).startsWith("Unknown"));
+    QCOMPARE(PERichHeader::toolchainName(0x0110, 33519), QString("Visual Studio 2022 17.9"));
+    
+    // Editing the stub breaks the checksum but not the decoding
+    data[0x50] = static_cast<char>(data[0x50] ^ 1);
+    PERichHeader::Info tampered = PERichHeader::decode(data, peOffset);
+    QVERIFY(tampered.found);
+    QVERIFY(!tampered.checksumValid);
+    QCOMPARE(tampered.hash, info.hash);
+    
+    // Nothing is read at or past e_lfanew
+    QVERIFY(!PERichHeader::decode(data, 0x80).found);
+}
+
+void PEUtilsTest::testRvaSet()
+{
+    // Unsorted input with duplicates, spanning several blocks and large gaps
+    QVector<quint32> values;
+    for (quint32 i = 0; i < 300; ++i) {
+        values.append(0x1000 + (299 - i) * 0x10);
+    }
+    values.append(0x1000);
+    values.append(0xFFFFFFF0);
+    values.append(0);
+    
+    PERvaSet set = PERvaSet::fromValues(values);
+    QCOMPARE(set.size(), 302);
+    QVERIFY(set.contains(0));
+    QVERIFY(set.contains(0x1000));
+    QVERIFY(set.contains(0x1000 + 64 * 0x10));     // First value of a block
+    QVERIFY(set.contains(0x1000 + 299 * 0x10));
+    QVERIFY(set.contains(0xFFFFFFF0));
+    QVERIFY(!set.contains(0x1008));
+    QVERIFY(!set.contains(0xFFF));
+    QVERIFY(!set.contains(0xFFFFFFFF));
+    
+    QVector<quint32> decoded = set.toVector();
+    QCOMPARE(decoded.size(), 302);
+    QVERIFY(std::is_sorted(decoded.begin(), decoded.end()));
+    QVERIFY(set.memoryUsage() < static_cast<qsizetype>(decoded.size() * sizeof(quint32)));
+    
+    QVERIFY(PERvaSet().isEmpty());
+    QVERIFY(!PERvaSet().contains(0));
+}
+
+void PEUtilsTest::testAsyncLogWriter()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString logPath = directory.filePath("test.log");
+    
+    AsyncLogWriter::Options options;
+    options.maxFileSize = 64 * 1024 * 1024;    // No rotation while counting records
+    options.maxFiles = 3;
+    options.capacity = 64;
+    options.flushIntervalMs = 10000;    // Only explicit flushes and early wakes write
+    
+    // Records of every file the log rotated through
+    auto readAllLogs = [&directory]() {
+        QByteArray contents;
+        for (const QString &name : QDir(directory.path()).entryList({"test*.log"}, QDir::Files)) {
+            QFile file(directory.filePath(name));
+            if (file.open(QIODevice::ReadOnly)) {
+                contents += file.readAll();
+            }
+        }
+        return contents;
+    };
+    
+    {
+        AsyncLogWriter writer(logPath, options);
+        QVERIFY(writer.isOpen());
+        writer.appendRaw("=== banner ===");
+        QVERIFY(writer.append("INFO", "Test", "first", "some details"));
+        QVERIFY(writer.flush());
+        
+        QFile log(logPath);
+        QVERIFY(log.open(QIODevice::ReadOnly));
+        QList<QByteArray> lines = log.readAll().split('\n');
+        QCOMPARE(lines[0], QByteArray("=== banner ==="));
+        QVERIFY(lines[1].endsWith("] [INFO] [Test] first"));
+        QCOMPARE(lines[2], QByteArray("  Details: some details"));
+        log.close();
+        
+        // Producers on several threads; the ring is small, so some records may be dropped
+        QList<QThread*> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.append(QThread::create([&writer, t]() {
+                for (int i = 0; i < 200; ++i) {
+                    writer.append("DEBUG", "Producer", QString("thread %1 record %2").arg(t).arg(i));
+                }
+            }));
+            producers.last()->start();
+        }
+        for (QThread *producer : producers) {
+            producer->wait();
+            delete producer;
+        }
+        QVERIFY(writer.flush());
+        QCOMPARE(quint64(readAllLogs().count("] [DEBUG] [Producer] thread ")), 800 - writer.droppedCount());
+    }
+    
+    // Enough batches to rotate past maxFiles
+    options.maxFileSize = 4096;
+    {
+        AsyncLogWriter writer(logPath, options);
+        QVERIFY(writer.isOpen());
+        for (int batch = 0; batch < 20; ++batch) {
+            for (int i = 0; i < 32; ++i) {
+                writer.append("INFO", "Rotation", QString("batch %1 record %2").arg(batch).arg(i));
+            }
+            QVERIFY(writer.flush());
+        }
+    }
+    
+    QVERIFY(QFile::exists(logPath));
+    QVERIFY(QFile::exists(directory.filePath("test.1.log")));
+    QVERIFY(QFile::exists(directory.filePath("test.2.log")));
+    QVERIFY(!QFile::exists(directory.filePath("test.3.log")));
+    QVERIFY(QFileInfo(directory.filePath("test.1.log")).size() <= options.maxFileSize);
+    
+    // The newest records survive in the current file
+    QFile current(logPath);
+    QVERIFY(current.open(QIODevice::ReadOnly));
+    QVERIFY(current.readAll().contains("batch 19 record 31"));
+}
+
+void PEUtilsTest::testLanguageCatalog()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    auto writeConfig = [&directory](const QString &name, const QByteArray &contents) {
+        QFile file(directory.filePath(name));
+        return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+    };
+    QVERIFY(writeConfig("language_config.ini",
+                        "[General]\ndefault_language=en\navailable_languages=en,pt\n\n"
+                        "[UI]\nstatus_ready=Ready\nstatus_error=Error in {file}\n"));
+    QVERIFY(writeConfig("language_config_pt.ini", "[UI]\nstatus_ready=Pronto\n"));
+    
+    LanguageManager &manager = LanguageManager::getInstance();
+    QVERIFY(manager.initialize(directory.filePath("language_config.ini")));
+    QCOMPARE(manager.getCurrentLanguage(), QString("en"));
+    
+    // LANG_ID resolves to the slot the default language assigned
+    const int readyId = manager.stringId("UI/status_ready");
+    QVERIFY(readyId >= 0);
+    QCOMPARE(LANG_ID("UI/status_ready"), readyId);
+    QCOMPARE(LANG("UI/status_ready"), QString("Ready"));
+    QCOMPARE(LANG_PARAM("UI/status_error", "file", "a.exe"), QString("Error in a.exe"));
+    
+    // Unknown keys have no slot and come back unchanged
+    QCOMPARE(manager.stringId("UI/no_such_string"), -1);
+    QCOMPARE(LANG_ID("UI/no_such_string"), -1);
+    QCOMPARE(LANG("UI/no_such_string"), QString("UI/no_such_string"));
+    QCOMPARE(manager.string(-1, "UI/status_ready"), QString("UI/status_ready"));
+    
+    // A switch refills the catalog in place; ids stay valid
+    QSignalSpy languageChanged(&manager, &LanguageManager::languageChanged);
+    QVERIFY(manager.setLanguage("pt"));
+    QCOMPARE(languageChanged.count(), 1);
+    QCOMPARE(manager.stringId("UI/status_ready"), readyId);
+    QCOMPARE(LANG("UI/status_ready"), QString("Pronto"));
+    
+    // Keys the translation lacks fall back to the key, not to English
+    QCOMPARE(LANG_PARAM("UI/status_error", "file", "a.exe"), QString("UI/status_error"));
+    
+    QVERIFY(manager.setLanguage("en"));
+    QCOMPARE(languageChanged.count(), 2);
+    QCOMPARE(LANG("UI/status_ready"), QString("Ready"));
+    QCOMPARE(LANG_PARAM("UI/status_error", "file", "a.exe"), QString("Error in a.exe"));
+}
+
 void PEUtilsTest::testHexFormatting()
 {
     QString hex1 = PEUtils::formatHex(0x5A4D);
@@ -78,5 +527,22 @@ void PEUtilsTest::testRVAFormatting()
     QVERIFY(rva2.contains("400000", Qt::CaseInsensitive));
 }
 
+void PEUtilsTest::testRelocationTypeNames()
+{
+    QCOMPARE(PEUtils::getRelocationTypeName(IMAGE_REL_BASED_DIR64, IMAGE_FILE_MACHINE_AMD64), QString("DIR64"));
+    
+    // Architecture-specific types resolve per machine and are unknown elsewhere
+    QCOMPARE(PEUtils::getRelocationTypeName(5, IMAGE_FILE_MACHINE_ARMNT), QString("ARM_MOV32"));
+    QCOMPARE(PEUtils::getRelocationTypeName(5, IMAGE_FILE_MACHINE_R4000), QString("MIPS_JMPADDR"));
+    QCOMPARE(PEUtils::getRelocationTypeName(5, IMAGE_FILE_MACHINE_RISCV64), QString("RISCV_HIGH20"));
+    QCOMPARE(PEUtils::getRelocationTypeName(7, IMAGE_FILE_MACHINE_THUMB), QString("THUMB_MOV32"));
+    QCOMPARE(PEUtils::getRelocationTypeName(7, IMAGE_FILE_MACHINE_RISCV32), QString("RISCV_LOW12I"));
+    QCOMPARE(PEUtils::getRelocationTypeName(8, IMAGE_FILE_MACHINE_RISCV64), QString("RISCV_LOW12S"));
+    QCOMPARE(PEUtils::getRelocationTypeName(9, IMAGE_FILE_MACHINE_MIPS16), QString("MIPS_JMPADDR16"));
+    QCOMPARE(PEUtils::getRelocationTypeName(5, IMAGE_FILE_MACHINE_AMD64), QString("TYPE_5"));
+    QCOMPARE(PEUtils::getRelocationTypeName(7, IMAGE_FILE_MACHINE_I386), QString("TYPE_7"));
+    QCOMPARE(PEUtils::getRelocationTypeName(8, IMAGE_FILE_MACHINE_ARM64), QString("TYPE_8"));
+}
+
 #include "pe_utils_test.moc"
 
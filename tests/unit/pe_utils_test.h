@@ -20,10 +20,20 @@ private slots:
     // Calculation tests
     void testSectionTableOffsetCalculation();
     void testDataDirectoryOffsetCalculation();
+    void testPEChecksumCalculation();
+    void testImportExportHash();
+    void testFuzzyHash();
+    void testContentStatistics();
+    void testHashIndex();
+    void testRichHeader();
+    void testRvaSet();
+    void testAsyncLogWriter();
+    void testLanguageCatalog();
     
     // Formatting tests
     void testHexFormatting();
     void testRVAFormatting();
+    void testRelocationTypeNames();
 
 private:
 };